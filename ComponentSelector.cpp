@@ -141,8 +141,18 @@ ComponentSelector::~ComponentSelector()
 
 }
 
+// Si la librera ya tiene pgina se sustituye (la librera de modelos del
+// proyecto crece al construir sus documentos)
 void ComponentSelector::insertLibrary( LMLibrary * library )
 {
+	for( int i=0; i < count(); i++ )
+		if( itemLabel( i ) == library->name() ){
+			QWidget * page = item( i );
+			removeItem( page );
+			delete page;
+			break;
+		}
+
 	QListBox * lb = new QListBox( this );
 
 	// Aadimos los componentes
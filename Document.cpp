@@ -68,7 +68,10 @@ bool Document::initialize()
 	lpHDLGen = new HDLGenerator( canvas );
 
 	// Interconexiones
-	connect( this, SIGNAL( changed() ), lpHDLGen, SLOT( setDataChanged() ) );
+	// Los desplazamientos no alteran la netlist: slo los cambios de estructura
+	// invalidan la cach del generador (el grafo del modelo lo actualiza el
+	// propio editor, ver LogicEditor::modelGraph)
+	connect( this, SIGNAL( netlistChanged(LEItem*) ), lpHDLGen, SLOT( setDataChanged() ) );
 
 	isUntitled = true;
 	return true;
@@ -128,7 +131,7 @@ bool Document::open()
 	// Carga desde fichero
 	QString fileName = QFileDialog::getOpenFileName(
 						QDir::current().absPath(),
-						tr("Documentos de LogicEditor (*.lem)"),
+						tr("Documentos de LogicEditor (*.lem *.lmb)"),
 						this,
 						"openModelDialog",
 						tr("Abrir modelo...") );
@@ -136,10 +139,17 @@ bool Document::open()
 	if( fileName.isEmpty() )
 		return false;
 
-	QRegExp rx( "*.lem" );
+	// El formato del documento lo determina la extensin
+	QRegExp rx( "*.lem" ), rxBin( "*.lmb" );
 	rx.setWildcard( true );
-	if( rx.exactMatch( fileName ) )
+	rxBin.setWildcard( true );
+	if( rx.exactMatch( fileName ) ){
 		fileName.truncate( fileName.length()-4 );
+		setModelFormat( XmlFormat );
+	}else if( rxBin.exactMatch( fileName ) ){
+		fileName.truncate( fileName.length()-4 );
+		setModelFormat( BinaryFormat );
+	}
 
 	// Ttulo de la ventana
 	setName( fileName );
@@ -154,11 +164,11 @@ bool Document::save()
 	if( isUntitled )
 		return saveAs();
 
-	QFile file( QString("%1.lem").arg( name() ) );
+	QFile file( name() + modelExtension( modelFormat() ) );
 	if( !file.open( IO_WriteOnly ) )
 		return false;
 		
-	if( !LogicEditor::save( &file ) ){
+	if( !LogicEditor::save( &file, modelFormat() ) ){
 		file.close();
 		return false;
 	}
@@ -173,7 +183,7 @@ bool Document::saveAs()
 {
 	QString fileName = QFileDialog::getSaveFileName(
 						QDir::current().absPath(),
-						tr("Modelo de LogicEditor (*.lem)"),
+						tr("Modelo de LogicEditor (*.lem);;Modelo binario de LogicEditor (*.lmb)"),
 						this,
 						"saveModelDialog",
 						tr("Guardar modelo como...") );
@@ -192,10 +202,16 @@ bool Document::saveAs()
 	// Tratamiento del nombre de fichero/documento
 	fileName = dir.dirName();
 
-	QRegExp rx( "*.lem" );
+	QRegExp rx( "*.lem" ), rxBin( "*.lmb" );
 	rx.setWildcard( true );
-	if( rx.exactMatch( fileName ) )
+	rxBin.setWildcard( true );
+	if( rx.exactMatch( fileName ) ){
+		fileName.truncate( fileName.length()-4 );
+		setModelFormat( XmlFormat );
+	}else if( rxBin.exactMatch( fileName ) ){
 		fileName.truncate( fileName.length()-4 );
+		setModelFormat( BinaryFormat );
+	}
 
 	setName( fileName );
 	setCaption( fileName );
@@ -223,6 +239,15 @@ bool Document::load()
 	isChanged = false;
 	isUntitled = false;
 
+	// Si no existe el modelo XML se busca su versin binaria
+	if( modelFormat() == XmlFormat
+		&& !QFile::exists( name() + modelExtension( XmlFormat ) )
+		&& QFile::exists( name() + modelExtension( BinaryFormat ) ) )
+		setModelFormat( BinaryFormat );
+
+	if( modelFormat() == BinaryFormat )
+		return LogicEditor::loadBinary( name() + modelExtension( BinaryFormat ) );
+
 	QFile file( QString("%1.lem").arg(name()) );
 	if( !file.open( IO_ReadOnly) )
 		return false;
@@ -41,6 +41,24 @@
 
 extern Application * app;
 
+// Pgina de la librera de modelos del proyecto en el selector de componentes
+static void showModelsLibrary( ComponentSelector * selector, Project * project )
+{
+	if( project->modelsLibrary() )
+		selector->insertLibrary( project->modelsLibrary() );
+}
+
+static void hideModelsLibrary( ComponentSelector * selector )
+{
+	for( int i=0; i < selector->count(); i++ )
+		if( selector->itemLabel( i ) == MODELS_LIBRARY_NAME ){
+			QWidget * page = selector->item( i );
+			selector->removeItem( page );
+			delete page;
+			break;
+		}
+}
+
 EditorWindow::EditorWindow() : QMainWindow()
 {
 	setIcon( QPixmap::fromMimeSource("img/icon-prj.png") );
@@ -336,21 +354,25 @@ bool EditorWindow::loadLibraries()
 void EditorWindow::afterProjectCreated()
 {
 	enableProjectFeatures();
+	showModelsLibrary( lpSelector, workspace );
 }
 
 void EditorWindow::afterProjectOpened()
 {
 	enableProjectFeatures();
+	showModelsLibrary( lpSelector, workspace );
 }
 
 void EditorWindow::afterProjectSaved()
 {
-	//TODO: implementar aqu lo que ocurre tras guardar el proyecto
+	// Los modelos construidos desde el ltimo guardado ya tienen componente
+	showModelsLibrary( lpSelector, workspace );
 }
 
 void EditorWindow::afterProjectClosed()
 {
 	enableProjectFeatures( false );
+	hideModelsLibrary( lpSelector );
 }
 
 void EditorWindow::afterDocumentInstancied( Document * doc )
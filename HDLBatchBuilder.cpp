@@ -0,0 +1,265 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLBatchBuilder.cpp: implementation of the HDLBatchBuilder class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLBatchBuilder.h"
+
+#include <qfile.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qdom.h>
+#include <qdatetime.h>
+#include <stdio.h>
+
+#include "Project.h"
+#include "HDLModelGraph.h"
+#include "HDLModelReader.h"
+#include "HDLModelSnapshot.h"
+#include "HDLBuildScheduler.h"
+
+// Localiza el directorio dirName de where, crendolo si no existe
+static bool makeDir( const QString & where, const QString & dirName, QDir & dir )
+{
+	dir.setPath( where );
+	if( !dir.cd( dirName ) ){
+		dir.mkdir( dirName );
+		if( !dir.cd( dirName ) )
+			return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLBatchBuilder::HDLBatchBuilder( QObject * parent, const char * name )
+	: QObject( parent, name ), hierarchy( libs )
+{
+	workerCount = HDLBuildScheduler::DefaultWorkers;
+	indentation = 0;
+	built = 0;
+}
+
+// Se cargan todos los ficheros del directorio en el mismo orden que el
+// editor, de forma que los componentes sin librera se resuelven igual
+int HDLBatchBuilder::loadLibraries( const QString & libDir )
+{
+	QDir dir( libDir );
+	if( !dir.exists() ){
+		printError( tr("No existe el directorio de libreras %1").arg(libDir) );
+		return 0;
+	}
+
+	dir.setFilter( QDir::Files );
+
+	int count = 0;
+	const QFileInfoList * list = dir.entryInfoList();
+	if( list )
+		for( QFileInfoListIterator it( *list ); it.current(); ++it )
+			if( libs.loadLibrary( QDir::convertSeparators( it.current()->absFilePath() ) ) )
+				count++;
+
+	return count;
+}
+
+LibraryManager & HDLBatchBuilder::libraryManager()
+{
+	return libs;
+}
+
+void HDLBatchBuilder::setWorkers( int count )
+{
+	workerCount = QMAX( count, 1 );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin
+//////////////////////////////////////////////////////////////////////
+
+bool HDLBatchBuilder::build( const QString & projectFile )
+{
+	QStringList docs;
+	QTime time;
+	time.start();
+
+	if( !loadProject( projectFile, docs ) )
+		return false;
+
+	printOutput( tr("Construyendo todos los componentes de %1").arg(projectFile) );
+
+	QDir hdlDir, sigDir;
+	if( !makeDir( projectPath, VHDL_PROJECT_FOLDER, hdlDir ) ){
+		printError( tr(" No se puede crear el directorio %1 en %2").arg(VHDL_PROJECT_FOLDER).arg(projectPath) );
+		return false;
+	}
+	if( !makeDir( projectPath, SIM_PROJECT_FOLDER, sigDir ) ){
+		printError( tr(" No se puede crear el directorio %1 en %2").arg(SIM_PROJECT_FOLDER).arg(projectPath) );
+		return false;
+	}
+
+	state.load( projectPath );
+	readTimes.clear();
+	built = 0;
+
+	// Los submodelos se construyen antes que los documentos que los
+	// instancian (ver Project::buildHierarchyHDL)
+	hierarchy.attach( projectPath, docs );
+
+	QMap<QString, QStringList> children;
+	QStringList::const_iterator it;
+	for( it = docs.begin(); it != docs.end(); ++it )
+		children.insert( *it, hierarchy.submodels( *it ) );
+
+	QValueList<QStringList> levels;
+	QStringList cyclic;
+	if( !HDLModelHierarchy::levels( docs, children, levels, cyclic ) )
+		printError( tr("Instanciacin recursiva de modelos: no se construirn %1").arg( cyclic.join(", ") ) );
+
+	indent( 1 );
+	for( QValueList<QStringList>::iterator itLevel = levels.begin(); itLevel != levels.end(); ++itLevel ){
+		HDLBuildScheduler scheduler;
+		scheduler.setWorkers( workerCount );
+		scheduler.setOutputDirs( hdlDir.absPath(), sigDir.absPath() );
+		connect( &scheduler, SIGNAL(errorMessage(const QString&)), this, SLOT(printError(const QString&)) );
+		connect( &scheduler, SIGNAL(outputMessage(const QString&)), this, SLOT(printOutput(const QString&)) );
+		connect( &scheduler, SIGNAL(indentMessage(int)), this, SLOT(indent(int)) );
+		connect( &scheduler, SIGNAL(modelBuilt(const QString&, const QString&, const QString&)),
+				 this, SLOT(recordModelHDL(const QString&, const QString&, const QString&)) );
+		connect( &scheduler, SIGNAL(modelTime(const QString&, int)), this, SLOT(reportTime(const QString&, int)) );
+
+		// Los modelos se leen aqu mientras los hilos generan los anteriores
+		for( it = (*itLevel).begin(); it != (*itLevel).end(); ++it )
+			scheduler.addJob( *it, loadModel( *it ) );
+
+		scheduler.finish();
+	}
+	indent( -1 );
+
+	state.save();
+	hierarchy.detach();
+
+	printOutput( tr("%1 de %2 componentes generados en %3 ms").arg(built).arg(docs.count()).arg(time.elapsed()) );
+	printOutput( "" );
+
+	return built == (int)docs.count();
+}
+
+// Lista de documentos del proyecto (ver Project::loadProject)
+bool HDLBatchBuilder::loadProject( const QString & projectFile, QStringList & docs )
+{
+	int errLine, errCol;
+	QString errStr;
+	QDomDocument doc;
+
+	QFile device( projectFile );
+	if( !device.open( IO_ReadOnly ) ){
+		printError( tr("No es posible abrir el proyecto %1").arg(projectFile) );
+		return false;
+	}
+
+	if( !doc.setContent( &device, true, &errStr, &errLine, &errCol ) ){
+		printError( tr("Error cargando el proyecto %1 en la lnea %2, columna %3: %4").arg(projectFile).arg(errLine).arg(errCol).arg(errStr) );
+		return false;
+	}
+
+	QDomElement root = doc.documentElement();
+	if( root.tagName().lower() != "project" ){
+		printError( tr("Error cargando proyecto: %1 no es un fichero de proyecto reconocido.").arg(projectFile) );
+		return false;
+	}
+
+	for( QDomNode node = root.firstChild(); !node.isNull(); node = node.nextSibling() )
+		if( node.toElement().tagName().lower() == "document" ){
+			QString data = node.toElement().attribute( "name", QString::null );
+			if( data != QString::null )
+				docs.append( data );
+		}
+
+	projectPath = QFileInfo( projectFile ).dirPath( true );
+	return true;
+}
+
+// Lectura del modelo y captura de su contenido. Como en el editor, la
+// entidad toma el nombre indicado en el modelo o, si no lo indica, el
+// del documento
+HDLModelSnapshot * HDLBatchBuilder::loadModel( const QString & doc )
+{
+	QTime time;
+	time.start();
+
+	HDLModelGraph graph;
+	HDLModelReader reader( libs, graph );
+	if( !reader.readFile( HDLModelReader::modelFile( projectPath, doc ).filePath() ) )
+		return NULL;
+
+	QString entity = reader.modelName().isNull() ? doc : reader.modelName();
+
+	HDLModelSnapshot * snapshot = new HDLModelSnapshot;
+	snapshot->capture( entity, graph );
+
+	readTimes.insert( doc, time.elapsed() );
+	return snapshot;
+}
+
+void HDLBatchBuilder::recordModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash )
+{
+	state.setModelHDL( doc, netlistHash, hdlHash, HDLModelReader::modelFile( projectPath, doc ).lastModified() );
+	state.setHash( "interfaces:" + doc, hierarchy.interfacesHash( hierarchy.submodels( doc ) ) );
+
+	// Interfaz del modelo como componente para los niveles siguientes
+	hierarchy.updateComponent( doc );
+	built++;
+}
+
+void HDLBatchBuilder::reportTime( const QString & doc, int msecs )
+{
+	printOutput( tr(" Tiempo: lectura %1 ms, generacin %2 ms").arg(readTimes[doc]).arg(msecs) );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mensajes
+//////////////////////////////////////////////////////////////////////
+
+void HDLBatchBuilder::printOutput( const QString & msg )
+{
+	QString indentString;
+	if( indentation > 0 )
+		indentString.fill( ' ', indentation * IndentSize );
+
+	fprintf( stdout, "%s\n", (const char*)( indentString + msg ).local8Bit() );
+	fflush( stdout );
+}
+
+void HDLBatchBuilder::printError( const QString & msg )
+{
+	QString indentString;
+	if( indentation > 0 )
+		indentString.fill( ' ', indentation * IndentSize );
+
+	fprintf( stderr, "%s\n", (const char*)( indentString + msg ).local8Bit() );
+}
+
+void HDLBatchBuilder::indent( int indentation )
+{
+	this->indentation += indentation;
+}
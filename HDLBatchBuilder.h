@@ -0,0 +1,94 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLBatchBuilder.h: interface for the HDLBatchBuilder class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLBATCHBUILDER_H_)
+#define _HDLBATCHBUILDER_H_
+
+#include <qobject.h>
+#include <qstringlist.h>
+#include <qmap.h>
+
+#include "LibraryManager.h"
+#include "HDLBuildState.h"
+#include "HDLModelHierarchy.h"
+
+class HDLModelSnapshot;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLBatchBuilder
+//
+//	Generacin del HDL de proyectos sin interfaz grfica (ver hdlbuild.cpp).
+//
+//	Lee el proyecto (.lep) y sus modelos (.lem o .lmb) con HDLModelReader,
+//	sin crear documentos, lienzos ni widgets, y escribe vhdl/*.vhd y
+//	sim/*.sig con HDLBuildScheduler, igual que Project::buildAllHDL. Tambin
+//	registra el estado de construccin del proyecto, de forma que el editor
+//	reconoce los ficheros generados como al da.
+//
+//	Los mensajes se escriben en la salida estndar (los errores en la de
+//	errores), junto con el tiempo de lectura y de generacin de cada modelo.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLBatchBuilder : public QObject
+{
+Q_OBJECT
+
+public:
+	enum { IndentSize = 2 };
+
+	HDLBatchBuilder( QObject * parent=0, const char * name=0 );
+
+	// Carga las libreras del directorio libDir. Devuelve cuntas se cargaron
+	int loadLibraries( const QString & libDir );
+	LibraryManager & libraryManager();
+
+	void setWorkers( int count );
+
+	// Genera el HDL de todos los documentos del proyecto projectFile.
+	// Devuelve true si se generan todos
+	bool build( const QString & projectFile );
+
+private slots:
+	void printOutput( const QString & msg );
+	void printError( const QString & msg );
+	void indent( int indentation );
+
+	void recordModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash );
+	void reportTime( const QString & doc, int msecs );
+
+private:
+	bool loadProject( const QString & projectFile, QStringList & docs );
+	HDLModelSnapshot * loadModel( const QString & doc );
+
+	LibraryManager libs;
+	HDLModelHierarchy hierarchy;
+	HDLBuildState state;
+	QString projectPath;
+	int workerCount;
+	int indentation;
+	int built;
+
+	// Tiempo de lectura de cada documento del proyecto en curso
+	QMap<QString, int> readTimes;
+};
+
+#endif
@@ -0,0 +1,351 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLBuildScheduler.cpp: implementation of the HDLBuildScheduler class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLBuildScheduler.h"
+
+#include <qapplication.h>
+#include <qthread.h>
+#include <qfile.h>
+#include <qdir.h>
+#include <qtextstream.h>
+#include <qdeepcopy.h>
+#include <qdatetime.h>
+
+#include "HDLModelSnapshot.h"
+#include "HDLBuildState.h"
+#include "HDLNetlistOptimizer.h"
+
+// Trabajo de generacin de un documento
+struct HDLBuildJob
+{
+	enum Result { NoSnapshot, CaptureError, HDLFileError, HDLError, SigFileError, Done };
+
+	HDLBuildJob() : snapshot( NULL ), result( NoSnapshot ), msecs( 0 ), finished( false ),
+		optimize( false ) {}
+	~HDLBuildJob() { delete snapshot; }
+
+	QString docName;
+	QString hdlFile, sigFile;
+	QString netlistHash, hdlHash;
+	QString errorString;	// Error de captura
+	HDLModelSnapshot * snapshot;
+	Result result;
+	int msecs;			// Tiempo de generacin
+	bool finished;
+
+	// Optimizacin de la netlist (ver HDLNetlistOptimizer)
+	bool optimize;
+	HDLNetlistOptimizer::Report report;
+};
+
+#ifdef QT_THREAD_SUPPORT
+// Hilo de trabajo: toma trabajos de la cola hasta que se cierra
+class HDLBuildWorker : public QThread
+{
+public:
+	HDLBuildWorker( HDLBuildScheduler * scheduler ) : sched( scheduler ) {}
+
+protected:
+	void run()
+	{
+		HDLBuildJob * job;
+		while( (job = sched->takeJob()) ){
+			HDLBuildScheduler::runJob( job );
+			sched->jobFinished( job );
+		}
+	}
+
+private:
+	HDLBuildScheduler * sched;
+};
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLBuildScheduler::HDLBuildScheduler( QObject * parent, const char * name )
+	: QObject( parent, name )
+{
+	workerCount = DefaultWorkers;
+	nextJob = 0;
+	flushed = 0;
+	closed = false;
+	succeeded = false;
+
+	jobs.setAutoDelete( true );
+#ifdef QT_THREAD_SUPPORT
+	workers.setAutoDelete( true );
+#endif
+}
+
+HDLBuildScheduler::~HDLBuildScheduler()
+{
+	stopWorkers();
+}
+
+void HDLBuildScheduler::setWorkers( int count )
+{
+	workerCount = QMAX( count, 1 );
+}
+
+void HDLBuildScheduler::setOutputDirs( const QString & hdlPath, const QString & sigPath )
+{
+	this->hdlPath = hdlPath;
+	this->sigPath = sigPath;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Cola de trabajos
+//////////////////////////////////////////////////////////////////////
+
+void HDLBuildScheduler::addJob( const QString & docName, HDLModelSnapshot * snapshot )
+{
+	// Las rutas se resuelven aqu: los hilos no usan QDir ni comparten cadenas
+	HDLBuildJob * job = new HDLBuildJob;
+	job->docName = docName;
+	job->snapshot = snapshot;
+	if( snapshot )
+		job->errorString = QDeepCopy<QString>( snapshot->errorString() );
+	job->optimize = HDLNetlistOptimizer::isEnabled();
+	job->hdlFile = QDeepCopy<QString>( QDir( hdlPath ).filePath( QString("%1.vhd").arg(docName) ) );
+	job->sigFile = QDeepCopy<QString>( QDir( sigPath ).filePath( QString("%1.sig").arg(docName) ) );
+
+#ifdef QT_THREAD_SUPPORT
+	mutex.lock();
+	jobs.append( job );
+	uint pending = jobs.count() - nextJob;
+	jobQueued.wakeOne();
+	mutex.unlock();
+
+	// Los hilos se crean a medida que hay trabajo para ellos
+	if( (int)workers.count() < workerCount && pending > 0 ){
+		HDLBuildWorker * worker = new HDLBuildWorker( this );
+		workers.append( worker );
+		worker->start();
+	}
+#else
+	jobs.append( job );
+	runJob( job );
+	job->finished = true;
+#endif
+
+	flush();
+}
+
+bool HDLBuildScheduler::finish()
+{
+#ifdef QT_THREAD_SUPPORT
+	mutex.lock();
+	closed = true;
+	jobQueued.wakeAll();
+
+	// Se emiten los mensajes segn terminan los trabajos, sin bloquear
+	// la interfaz grfica mientras tanto
+	while( flushed < jobs.count() ){
+		if( !jobs.at( flushed )->finished )
+			jobDone.wait( &mutex, 50 );
+
+		mutex.unlock();
+		flush();
+		qApp->processEvents();
+		mutex.lock();
+	}
+	mutex.unlock();
+
+	stopWorkers();
+#else
+	closed = true;
+	flush();
+#endif
+
+	return succeeded || jobs.isEmpty();
+}
+
+HDLBuildJob * HDLBuildScheduler::takeJob()
+{
+#ifdef QT_THREAD_SUPPORT
+	QMutexLocker locker( &mutex );
+
+	while( nextJob >= jobs.count() && !closed )
+		jobQueued.wait( &mutex );
+
+	if( nextJob >= jobs.count() )
+		return NULL;
+
+	return jobs.at( nextJob++ );
+#else
+	return NULL;
+#endif
+}
+
+void HDLBuildScheduler::jobFinished( HDLBuildJob * job )
+{
+#ifdef QT_THREAD_SUPPORT
+	QMutexLocker locker( &mutex );
+	job->finished = true;
+	jobDone.wakeAll();
+#else
+	job->finished = true;
+#endif
+}
+
+void HDLBuildScheduler::stopWorkers()
+{
+#ifdef QT_THREAD_SUPPORT
+	mutex.lock();
+	closed = true;
+	jobQueued.wakeAll();
+	mutex.unlock();
+
+	for( HDLBuildWorker * worker = workers.first(); worker; worker = workers.next() )
+		worker->wait();
+	workers.clear();
+#endif
+}
+
+// Generacin efectiva (en un hilo de trabajo)
+void HDLBuildScheduler::runJob( HDLBuildJob * job )
+{
+	if( !job->snapshot ){
+		job->result = HDLBuildJob::NoSnapshot;
+		return;
+	}
+	if( !job->errorString.isNull() ){
+		job->result = HDLBuildJob::CaptureError;
+		return;
+	}
+
+	QTime time;
+	time.start();
+
+	QFile hdlFile( job->hdlFile );
+	if( !hdlFile.open( IO_WriteOnly ) ){
+		job->result = HDLBuildJob::HDLFileError;
+		return;
+	}
+
+	// El hash identifica la netlist del documento, no la optimizada
+	job->netlistHash = job->snapshot->hash();
+
+	if( job->optimize )
+		HDLNetlistOptimizer::optimizeVerified( *job->snapshot, &job->report );
+
+	QTextStream hdlOut( &hdlFile );
+	if( !job->snapshot->writeHDL( hdlOut ) ){
+		job->result = HDLBuildJob::HDLError;
+		return;
+	}
+	hdlFile.close();
+
+	job->hdlHash = HDLBuildState::hashFile( job->hdlFile );
+
+	QFile sigFile( job->sigFile );
+	if( !sigFile.open( IO_WriteOnly ) ){
+		job->result = HDLBuildJob::SigFileError;
+		return;
+	}
+
+	QTextStream sigOut( &sigFile );
+	job->snapshot->writeSignals( sigOut );
+	sigFile.close();
+
+	job->result = HDLBuildJob::Done;
+	job->msecs = time.elapsed();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mensajes (hilo principal)
+//////////////////////////////////////////////////////////////////////
+
+void HDLBuildScheduler::flush()
+{
+	for( ;; ){
+#ifdef QT_THREAD_SUPPORT
+		mutex.lock();
+#endif
+		HDLBuildJob * job = NULL;
+		if( flushed < jobs.count() && jobs.at( flushed )->finished )
+			job = jobs.at( flushed );
+#ifdef QT_THREAD_SUPPORT
+		mutex.unlock();
+#endif
+
+		if( !job )
+			break;
+
+		emitMessages( job );
+		flushed++;
+	}
+}
+
+void HDLBuildScheduler::emitMessages( HDLBuildJob * job )
+{
+	emit outputMessage( tr( "Analizando %1...").arg(job->docName) );
+	emit indentMessage( 1 );
+
+	switch( job->result ){
+	case HDLBuildJob::NoSnapshot:
+		emit errorMessage( tr(" No se puede acceder al documento %1. Imposible continuar.").arg(job->docName) );
+		break;
+
+	case HDLBuildJob::CaptureError:
+		emit errorMessage( " " + job->errorString );
+		emit errorMessage( tr(" Fallo al construir HDL. Imposible continuar") );
+		break;
+
+	case HDLBuildJob::HDLFileError:
+		emit errorMessage( tr(" No se puede crear el fichero %1").arg(job->hdlFile) );
+		emit errorMessage( tr(" Fallo al construir HDL. Imposible continuar") );
+		break;
+
+	case HDLBuildJob::HDLError:
+		emit outputMessage( tr("Generando fichero HDL '%1.vhd'...").arg(job->docName) );
+		emit errorMessage( tr("    No hay seales externas, no se puede crear la interfaz del componente.") );
+		emit errorMessage( tr(" Fallo al construir HDL. Imposible continuar") );
+		break;
+
+	case HDLBuildJob::SigFileError:
+		emit outputMessage( tr(" Fichero %1.vhd Generado").arg(job->docName) );
+		emit errorMessage( tr(" No se puede crear el fichero %1").arg(job->sigFile) );
+		emit errorMessage( tr(" Fallo al construir fichero de seales. Pueden haber problemas durante la simulacin.") );
+		break;
+
+	case HDLBuildJob::Done:
+		if( job->optimize ){
+			emit outputMessage( job->report.summary() );
+			if( !job->report.rejection().isNull() )
+				emit errorMessage( job->report.rejection() );
+		}
+		emit outputMessage( tr(" Fichero %1.vhd Generado").arg(job->docName) );
+		emit outputMessage( tr(" Fichero %1.sig Generado").arg(job->docName) );
+		emit modelBuilt( job->docName, job->netlistHash, job->hdlHash );
+		emit modelTime( job->docName, job->msecs );
+		succeeded = true;
+		break;
+	}
+
+	emit indentMessage( -1 );
+
+	// El snapshot ya no es necesario
+	delete job->snapshot;
+	job->snapshot = NULL;
+}
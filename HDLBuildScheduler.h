@@ -0,0 +1,110 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLBuildScheduler.h: interface for the HDLBuildScheduler class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLBUILDSCHEDULER_H_)
+#define _HDLBUILDSCHEDULER_H_
+
+#include <qobject.h>
+#include <qptrlist.h>
+#include <qmutex.h>
+#include <qwaitcondition.h>
+
+class HDLModelSnapshot;
+class HDLBuildWorker;
+struct HDLBuildJob;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLBuildScheduler
+//
+//	Generacin en paralelo de los ficheros .vhd y .sig de varios documentos.
+//
+//	Cada trabajo parte de un HDLModelSnapshot capturado en el hilo principal
+//	y se vuelca en un conjunto de hilos de trabajo usando rutas absolutas
+//	(no depende del directorio actual del proceso). Los mensajes de cada
+//	trabajo se emiten desde el hilo principal y en el orden en que se
+//	encolaron los documentos, independientemente del orden en que terminen.
+//
+//	Sin soporte de hilos (QT_THREAD_SUPPORT) los trabajos se ejecutan en
+//	el momento de encolarlos.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLBuildScheduler : public QObject
+{
+Q_OBJECT
+
+	friend class HDLBuildWorker;
+
+public:
+	enum { DefaultWorkers = 4 };
+
+	HDLBuildScheduler( QObject * parent=0, const char * name=0 );
+	~HDLBuildScheduler();
+
+	void setWorkers( int count );
+	void setOutputDirs( const QString & hdlPath, const QString & sigPath );
+
+	// Encola la generacin del documento docName. El planificador se queda
+	// con el snapshot; si es NULL el documento no pudo cargarse
+	void addJob( const QString & docName, HDLModelSnapshot * snapshot );
+
+	// Espera a que terminen todos los trabajos emitiendo sus mensajes.
+	// Devuelve true si al menos un documento no fracasa (o no hay ninguno)
+	bool finish();
+
+signals:
+	void errorMessage(const QString&);
+	void outputMessage(const QString&);
+	void indentMessage(int indentation);
+
+	// Se emite (en orden) por cada documento generado con xito
+	void modelBuilt( const QString & docName, const QString & netlistHash, const QString & hdlHash );
+	// Tiempo empleado en generar los ficheros del documento
+	void modelTime( const QString & docName, int msecs );
+
+private:
+	// Hilos de trabajo
+	HDLBuildJob * takeJob();
+	void jobFinished( HDLBuildJob * job );
+	static void runJob( HDLBuildJob * job );
+
+	// Emite los mensajes de los trabajos terminados que tienen su turno
+	void flush();
+	void emitMessages( HDLBuildJob * job );
+	void stopWorkers();
+
+	QString hdlPath, sigPath;
+	int workerCount;
+
+	QPtrList<HDLBuildJob> jobs;
+	uint nextJob;		// Siguiente trabajo a repartir
+	uint flushed;		// Trabajos cuyos mensajes ya se han emitido
+	bool closed;
+	bool succeeded;
+
+#ifdef QT_THREAD_SUPPORT
+	QPtrList<HDLBuildWorker> workers;
+	QMutex mutex;
+	QWaitCondition jobQueued;
+	QWaitCondition jobDone;
+#endif
+};
+
+#endif
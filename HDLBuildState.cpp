@@ -0,0 +1,212 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLBuildState.cpp: implementation of the HDLBuildState class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLBuildState.h"
+
+#include <qfile.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qtextstream.h>
+#include <qstringlist.h>
+#include <qdatetime.h>
+
+const char * HDLBuildState::FileName = "build.state";
+
+// FNV-1a de 64 bits
+static const Q_UINT64 fnvOffset = ((Q_UINT64)0xcbf29ce4 << 32) | 0x84222325;
+static const Q_UINT64 fnvPrime = ((Q_UINT64)0x00000100 << 32) | 0x000001b3;
+
+static void fnvUpdate( Q_UINT64 & h, const char * data, uint len )
+{
+	for( uint i=0; i < len; i++ ){
+		h ^= (unsigned char) data[i];
+		h *= fnvPrime;
+	}
+}
+
+static QString fnvString( Q_UINT64 h )
+{
+	QString str;
+	return str.sprintf( "%08x%08x", (Q_UINT32)(h >> 32), (Q_UINT32)h );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLBuildState::HDLBuildState()
+{
+	changed = false;
+}
+
+HDLBuildState::HDLBuildState( const QString & dirPath )
+{
+	changed = false;
+	load( dirPath );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Persistencia
+//////////////////////////////////////////////////////////////////////
+
+bool HDLBuildState::load( const QString & dirPath )
+{
+	pth = dirPath;
+	hashes.clear();
+	changed = false;
+
+	QFile file( QDir( dirPath ).filePath( FileName ) );
+	if( !file.open( IO_ReadOnly ) )
+		return false;
+
+	// Una entrada por lnea: clave<TAB>hash
+	QTextStream in( &file );
+	in.setEncoding( QTextStream::UnicodeUTF8 );
+	while( !in.atEnd() ){
+		QString line = in.readLine();
+		if( line.isEmpty() || line[0] == '#' )
+			continue;
+
+		int sep = line.findRev( '\t' );
+		if( sep > 0 )
+			hashes.insert( line.left( sep ), line.mid( sep+1 ) );
+	}
+
+	return true;
+}
+
+bool HDLBuildState::save()
+{
+	if( !changed )
+		return true;
+
+	if( pth.isEmpty() )
+		return false;
+
+	QFile file( QDir( pth ).filePath( FileName ) );
+	if( !file.open( IO_WriteOnly ) )
+		return false;
+
+	QTextStream out( &file );
+	out.setEncoding( QTextStream::UnicodeUTF8 );
+	out << "# Interface Editor build state\n";
+	for( QMap<QString, QString>::ConstIterator it = hashes.begin(); it != hashes.end(); ++it )
+		out << it.key() << "\t" << it.data() << "\n";
+
+	changed = false;
+	return true;
+}
+
+QString HDLBuildState::path() const
+{
+	return pth;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Entradas
+//////////////////////////////////////////////////////////////////////
+
+QString HDLBuildState::hash( const QString & key ) const
+{
+	QMap<QString, QString>::ConstIterator it = hashes.find( key );
+	return ( it != hashes.end() ) ? it.data() : QString::null;
+}
+
+void HDLBuildState::setHash( const QString & key, const QString & hash )
+{
+	if( hash.isNull() ){
+		remove( key );
+		return;
+	}
+
+	QMap<QString, QString>::Iterator it = hashes.find( key );
+	if( it != hashes.end() && it.data() == hash )
+		return;
+
+	hashes.replace( key, hash );
+	changed = true;
+}
+
+void HDLBuildState::remove( const QString & key )
+{
+	if( hashes.contains( key ) ){
+		hashes.remove( key );
+		changed = true;
+	}
+}
+
+void HDLBuildState::setModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash, const QDateTime & modelTime )
+{
+	setHash( "netlist:" + doc, netlistHash );
+	setHash( "vhdl:" + doc, hdlHash );
+	setHash( "modeltime:" + doc, QString::number( modelTime.toTime_t() ) );
+}
+
+void HDLBuildState::setCompiled( const QString & source, const QString & hash )
+{
+	setHash( "compiled:" + QFileInfo( source ).fileName(), hash );
+}
+
+bool HDLBuildState::isCompiled( const QString & source, const QString & binary ) const
+{
+	QFileInfo binFile( binary );
+	if( !binFile.exists() )
+		return false;
+
+	QFileInfo srcFile( source );
+	QString compiled = hash( "compiled:" + srcFile.fileName() );
+	if( compiled.isNull() )
+		return binFile.lastModified() >= srcFile.lastModified();
+
+	return compiled == hashFile( source );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Hash de contenidos
+//////////////////////////////////////////////////////////////////////
+
+QString HDLBuildState::hashData( const char * data, uint len )
+{
+	Q_UINT64 h = fnvOffset;
+	fnvUpdate( h, data, len );
+	return fnvString( h );
+}
+
+QString HDLBuildState::hashString( const QString & str )
+{
+	QCString utf8 = str.utf8();
+	return hashData( utf8.data(), utf8.length() );
+}
+
+QString HDLBuildState::hashFile( const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) )
+		return QString::null;
+
+	Q_UINT64 h = fnvOffset;
+	char buffer[8192];
+	Q_LONG len;
+	while( (len = file.readBlock( buffer, sizeof(buffer) )) > 0 )
+		fnvUpdate( h, buffer, len );
+
+	return fnvString( h );
+}
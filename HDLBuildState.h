@@ -0,0 +1,86 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLBuildState.h: interface for the HDLBuildState class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLBUILDSTATE_H_)
+#define _HDLBUILDSTATE_H_
+
+#include <qstring.h>
+#include <qmap.h>
+
+class QDateTime;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLBuildState
+//
+//	Estado persistente de construccin de un directorio (proyecto o
+//	librera): asocia claves ("netlist:modelo", "vhdl:modelo"...) con el
+//	hash del contenido que se us en la ltima construccin.
+//
+//	Permite decidir si hay que regenerar o recompilar por el contenido y
+//	no por la fecha de modificacin, de forma que guardar un modelo sin
+//	cambios semnticos (mover un dispositivo) no provoca reconstrucciones.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLBuildState
+{
+public:
+	HDLBuildState();
+	HDLBuildState( const QString & dirPath );
+
+	// Carga el estado del directorio (vaco si todava no existe)
+	bool load( const QString & dirPath );
+	// Guarda el estado si ha cambiado desde la carga
+	bool save();
+
+	QString path() const;
+
+	// Hash registrado para key (QString::null si no existe)
+	QString hash( const QString & key ) const;
+	void setHash( const QString & key, const QString & hash );
+	void remove( const QString & key );
+
+	// Registro de la generacin del HDL de un modelo: hash de su netlist,
+	// del .vhd generado y fecha del fichero del modelo (ver
+	// Project::checkHDLuptoDate)
+	void setModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash, const QDateTime & modelTime );
+
+	// Registro de la compilacin de un fuente del directorio: hash del
+	// contenido que compil vcom con xito (ver HDLProcCompiler). Un binario
+	// est al da si el fuente conserva ese contenido; sin registro se
+	// compara la fecha del binario con la del fuente
+	void setCompiled( const QString & source, const QString & hash );
+	bool isCompiled( const QString & source, const QString & binary ) const;
+
+	// Hash (FNV-1a de 64 bits, en hexadecimal) de un bloque, una cadena o
+	// el contenido de un fichero (QString::null si no puede leerse)
+	static QString hashData( const char * data, uint len );
+	static QString hashString( const QString & str );
+	static QString hashFile( const QString & fileName );
+
+	static const char * FileName;
+
+private:
+	QString pth;
+	QMap<QString, QString> hashes;
+	bool changed;
+};
+
+#endif
@@ -0,0 +1,88 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLGateKind.cpp: implementation of the HDLGateKind class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLGateKind.h"
+
+HDLGateKind::Kind HDLGateKind::classify( const HDLModelSnapshot::Component & cmp )
+{
+	// Pins de control (los nombres de pin no distinguen maysculas)
+	bool clk = false, oe = false, enable = false;
+	QValueList<HDLModelSnapshot::Port>::const_iterator itPort;
+	for( itPort = cmp.pins.begin(); itPort != cmp.pins.end(); ++itPort ){
+		QString pinName = (*itPort).name.upper();
+		if( pinName == "CLK" )
+			clk = true;
+		else if( pinName == "OE" )
+			oe = true;
+		else if( pinName == "E*" )
+			enable = true;
+	}
+
+	QString type = cmp.name.upper();
+	if( type == "VCC" )
+		return Vcc;
+	if( type == "GND" )
+		return Gnd;
+	if( clk )
+		return Register;
+	if( oe )
+		return TriBuffer;
+	if( type.startsWith( "MUX" ) && enable )
+		return Decoder;
+	if( type == "INV" || type == "NOT" )
+		return Inv;
+	if( type.startsWith( "BUF" ) )
+		return Buf;
+	if( type.startsWith( "NAND" ) )
+		return Nand;
+	if( type.startsWith( "AND" ) )
+		return And;
+	if( type.startsWith( "XNOR" ) )
+		return Xnor;
+	if( type.startsWith( "XOR" ) )
+		return Xor;
+	if( type.startsWith( "NOR" ) )
+		return Nor;
+	if( type.startsWith( "OR" ) )
+		return Or;
+
+	return Opaque;
+}
+
+bool HDLGateKind::isCombinational( Kind kind )
+{
+	return kind != Register && kind != TriBuffer;
+}
+
+bool HDLGateKind::isSimpleGate( Kind kind )
+{
+	return kind != Opaque && kind != Register && kind != TriBuffer && kind != Decoder;
+}
+
+int HDLGateKind::pinIndex( const QString & pinName, const QString & prefix )
+{
+	if( !pinName.startsWith( prefix ) )
+		return -1;
+
+	bool ok;
+	int k = pinName.mid( prefix.length() ).toInt( &ok );
+	return ok ? k : -1;
+}
@@ -0,0 +1,66 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLGateKind.h: interface for the HDLGateKind class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLGATEKIND_H_)
+#define _HDLGATEKIND_H_
+
+#include <qstring.h>
+
+#include "HDLModelSnapshot.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLGateKind
+//
+//	Reconocimiento de las primitivas de las libreras estndar a partir de
+//	la declaracin de su componente, comn a los evaluadores de netlist
+//	(HDLGateSimulator, HDLTruthTable y HDLNetlistOptimizer):
+//
+//	  - VCC y GND por nombre.
+//	  - Registros (pin CLK) y buffers triestado (pin OE), con pares de
+//	    datos I<k> -> O<k>.
+//	  - Decodificadores MUXn con habilitacin E*, entradas de seleccin
+//	    I<k> y salidas O<k>.
+//	  - Puertas por prefijo del nombre: INV/NOT, BUF, NAND, AND, XNOR,
+//	    XOR, NOR y OR (en ese orden, NAND antes que AND...).
+//
+//	Cada evaluador decide qu tipos admite; el resto son Opaque.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLGateKind
+{
+public:
+	enum Kind { Opaque, Inv, Buf, And, Nand, Or, Nor, Xor, Xnor, Vcc, Gnd, Register, TriBuffer, Decoder };
+
+	// Tipo de primitiva del componente (Opaque si no es ninguna)
+	static Kind classify( const HDLModelSnapshot::Component & cmp );
+
+	// Registros y buffers triestado guardan estado o dejan la red en alta
+	// impedancia: no tienen tabla de verdad
+	static bool isCombinational( Kind kind );
+
+	// Puertas de una salida sin pins de control (INV ... OR, VCC y GND)
+	static bool isSimpleGate( Kind kind );
+
+	// ndice k de un pin de nombre <prefijo><k> (-1 si no sigue ese formato)
+	static int pinIndex( const QString & pinName, const QString & prefix );
+};
+
+#endif
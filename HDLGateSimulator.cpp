@@ -0,0 +1,543 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLGateSimulator.cpp: implementation of the HDLGateSimulator class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLGateSimulator.h"
+
+#include <qobject.h>
+
+#include "HDLModelSnapshot.h"
+
+static char logicNot( char v )
+{
+	return ( v == '0' ) ? '1' : ( v == '1' ) ? '0' : 'U';
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLGateSimulator::HDLGateSimulator()
+{
+	stamp = 0;
+	now = 0;
+	pending = 0;
+	events = 0;
+}
+
+QString HDLGateSimulator::errorString() const
+{
+	return errStr;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin del circuito
+//////////////////////////////////////////////////////////////////////
+
+bool HDLGateSimulator::load( const HDLModelSnapshot & snapshot )
+{
+	netIds.clear();
+	netValues.clear();
+	netDrivers.clear();
+	netFanout.clear();
+	driverNets.clear();
+	driverValues.clear();
+	driverNext.clear();
+	forcedDrivers.clear();
+	gates.clear();
+	gateStamps.clear();
+	errStr = QString::null;
+
+	// Redes: puertos de la entidad y seales internas. Slo se simulan
+	// redes escalares (los buses requieren el simulador HDL)
+	QValueList<HDLModelSnapshot::Port>::const_iterator itPort;
+	for( itPort = snapshot.portList().begin(); itPort != snapshot.portList().end(); ++itPort ){
+		if( (*itPort).width > 1 ){
+			errStr = QObject::tr("El puerto %1 es un bus: no puede simularse a nivel de puerta.").arg( (*itPort).name );
+			return false;
+		}
+		net( (*itPort).name );
+	}
+
+	QStringList::const_iterator itSig;
+	for( itSig = snapshot.signalList().begin(); itSig != snapshot.signalList().end(); ++itSig ){
+		if( snapshot.signalWidth( *itSig ) > 1 ){
+			errStr = QObject::tr("La seal %1 es un bus: no puede simularse a nivel de puerta.").arg( *itSig );
+			return false;
+		}
+		net( *itSig );
+	}
+
+	// Componentes por nombre
+	QMap<QString, const HDLModelSnapshot::Component *> comps;
+	QValueList<HDLModelSnapshot::Component>::const_iterator itCmp;
+	for( itCmp = snapshot.componentList().begin(); itCmp != snapshot.componentList().end(); ++itCmp )
+		comps.insert( (*itCmp).name, &(*itCmp) );
+
+	// Una puerta por instancia
+	QValueList<HDLModelSnapshot::Instance>::const_iterator itInst;
+	for( itInst = snapshot.instanceList().begin(); itInst != snapshot.instanceList().end(); ++itInst ){
+		const HDLModelSnapshot::Component * cmp = comps[ (*itInst).component ];
+		if( !cmp ){
+			errStr = QObject::tr("El componente %1 no est declarado.").arg( (*itInst).component );
+			return false;
+		}
+
+		// Red de cada pin (la lista de pins del componente y el mapeado
+		// de la instancia siguen el mismo orden)
+		const QValueList<HDLModelSnapshot::Port> & pins = cmp->pins;
+		QMap<QString, int> pinNets;
+		QStringList inPins, outPins;
+		uint i = 0;
+		for( itPort = pins.begin(); itPort != pins.end(); ++itPort, ++i ){
+			QString sigName = ( i < (*itInst).portMap.count() ) ? (*itInst).portMap[i] : QString::null;
+			QString pinName = (*itPort).name.upper();
+
+			pinNets.insert( pinName, sigName.isNull() ? -1 : net( sigName ) );
+			if( (*itPort).mode == HDLModelSnapshot::Out )
+				outPins.append( pinName );
+			else
+				inPins.append( pinName );
+		}
+
+		// Modelo de comportamiento segn el componente
+		Gate gate;
+		gate.control = -1;
+		gate.lastControl = 'U';
+
+		gate.type = HDLGateKind::classify( *cmp );
+		if( gate.type == HDLGateKind::Opaque ){
+			errStr = QObject::tr("No existe modelo de simulacin para el componente %1 (instancia %2).").arg( cmp->name ).arg( (*itInst).name );
+			return false;
+		}
+
+		QStringList::iterator itPin;
+		switch( gate.type ){
+		case HDLGateKind::Register:
+		case HDLGateKind::TriBuffer:
+			// Pares de datos I<k> -> O<k> gobernados por CLK u OE
+			gate.control = pinNets[ gate.type == HDLGateKind::Register ? "CLK" : "OE" ];
+			for( itPin = inPins.begin(); itPin != inPins.end(); ++itPin ){
+				int k = HDLGateKind::pinIndex( *itPin, "I" );
+				if( k == -1 || !pinNets.contains( QString("O%1").arg(k) ) )
+					continue;
+
+				gate.inputs.push_back( pinNets[*itPin] );
+				gate.outputs.push_back( addDriver( pinNets[ QString("O%1").arg(k) ] ) );
+			}
+			break;
+
+		case HDLGateKind::Decoder:
+			// Entradas de seleccin I<k> y salidas O<k> por ndice
+			gate.control = pinNets[ "E*" ];
+			gate.inputs.resize( inPins.count() - 1, -1 );
+			gate.outputs.resize( outPins.count(), -1 );
+			for( itPin = inPins.begin(); itPin != inPins.end(); ++itPin ){
+				int k = HDLGateKind::pinIndex( *itPin, "I" );
+				if( k >= 0 && k < (int)gate.inputs.count() )
+					gate.inputs[k] = pinNets[*itPin];
+			}
+			for( itPin = outPins.begin(); itPin != outPins.end(); ++itPin ){
+				int k = HDLGateKind::pinIndex( *itPin, "O" );
+				if( k >= 0 && k < (int)gate.outputs.count() )
+					gate.outputs[k] = addDriver( pinNets[*itPin] );
+			}
+			break;
+
+		default:
+			for( itPin = inPins.begin(); itPin != inPins.end(); ++itPin )
+				gate.inputs.push_back( pinNets[*itPin] );
+			for( itPin = outPins.begin(); itPin != outPins.end(); ++itPin )
+				gate.outputs.push_back( addDriver( pinNets[*itPin] ) );
+			break;
+		}
+
+		gate.state.resize( gate.outputs.count(), 'U' );
+
+		// Abanico de salida de las redes ledas por la puerta
+		int id = gates.count();
+		QValueVector<int>::iterator itNet;
+		for( itNet = gate.inputs.begin(); itNet != gate.inputs.end(); ++itNet )
+			if( *itNet != -1 && !netFanout[*itNet].contains( id ) )
+				netFanout[*itNet].append( id );
+		if( gate.control != -1 && !netFanout[gate.control].contains( id ) )
+			netFanout[gate.control].append( id );
+
+		gates.push_back( gate );
+	}
+
+	gateStamps.resize( gates.count(), 0 );
+
+	reset();
+	return true;
+}
+
+int HDLGateSimulator::net( const QString & name )
+{
+	QMap<QString, int>::iterator it = netIds.find( name );
+	if( it != netIds.end() )
+		return it.data();
+
+	int id = netValues.count();
+	netIds.insert( name, id );
+	netValues.push_back( 'U' );
+	netDrivers.push_back( QValueList<int>() );
+	netFanout.push_back( QValueList<int>() );
+
+	return id;
+}
+
+int HDLGateSimulator::addDriver( int net )
+{
+	if( net == -1 )
+		return -1;
+
+	int id = driverNets.count();
+	driverNets.push_back( net );
+	driverValues.push_back( 'U' );
+	driverNext.push_back( 'U' );
+	netDrivers[net].append( id );
+
+	return id;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Simulacin
+//////////////////////////////////////////////////////////////////////
+
+void HDLGateSimulator::reset()
+{
+	uint i;
+
+	for( i=0; i < netValues.count(); i++ )
+		netValues[i] = 'U';
+
+	for( i=0; i < driverValues.count(); i++ )
+		driverValues[i] = driverNext[i] = 'U';
+
+	// Las entradas forzadas quedan liberadas
+	for( QMap<int, int>::iterator itF = forcedDrivers.begin(); itF != forcedDrivers.end(); ++itF )
+		driverValues[itF.data()] = driverNext[itF.data()] = 'Z';
+
+	for( i=0; i < gates.count(); i++ ){
+		gates[i].lastControl = 'U';
+		for( uint k=0; k < gates[i].state.count(); k++ )
+			gates[i].state[k] = 'U';
+	}
+
+	wheel.clear();
+	wheel.resize( WheelSize );
+	now = 0;
+	pending = 0;
+	events = 0;
+
+	// Evaluacin inicial (constantes y puertas con entradas determinadas)
+	for( i=0; i < gates.count(); i++ )
+		evaluate( i );
+	run();
+}
+
+bool HDLGateSimulator::force( const QString & signal, char value )
+{
+	QMap<QString, int>::iterator it = netIds.find( signal );
+	if( it == netIds.end() )
+		return false;
+
+	int n = it.data();
+	QMap<int, int>::iterator itF = forcedDrivers.find( n );
+	int d;
+	if( itF == forcedDrivers.end() ){
+		d = addDriver( n );
+		forcedDrivers.insert( n, d );
+	}else
+		d = itF.data();
+
+	if( value != '0' && value != '1' && value != 'Z' && value != 'X' )
+		value = 'U';
+
+	driverNext[d] = value;
+	schedule( d, value, 0 );
+
+	return true;
+}
+
+bool HDLGateSimulator::run()
+{
+	uint limit = now + MaxTime;
+
+	while( pending > 0 ){
+		if( now >= limit ){
+			errStr = QObject::tr("El circuito no se estabiliza (oscilacin) en %1 unidades de tiempo.").arg( (uint)MaxTime );
+			return false;
+		}
+
+		QValueList<Event> & bucket = wheel[ now % WheelSize ];
+		if( bucket.isEmpty() ){
+			now++;
+			continue;
+		}
+
+		QValueList<Event> current = bucket;
+		bucket.clear();
+		pending -= current.count();
+
+		// Aplicacin de los eventos y seleccin (sin repetir) de las
+		// puertas afectadas
+		QValueList<int> touched;
+		stamp++;
+		for( QValueList<Event>::iterator itEv = current.begin(); itEv != current.end(); ++itEv ){
+			events++;
+			driverValues[ (*itEv).driver ] = (*itEv).value;
+
+			int n = driverNets[ (*itEv).driver ];
+			char v = resolve( n );
+			if( v == netValues[n] )
+				continue;
+			netValues[n] = v;
+
+			for( QValueList<int>::iterator itG = netFanout[n].begin(); itG != netFanout[n].end(); ++itG )
+				if( gateStamps[*itG] != stamp ){
+					gateStamps[*itG] = stamp;
+					touched.append( *itG );
+				}
+		}
+
+		for( QValueList<int>::iterator itT = touched.begin(); itT != touched.end(); ++itT )
+			evaluate( *itT );
+
+		now++;
+	}
+
+	return true;
+}
+
+// Valor de una red a partir de sus excitadores
+char HDLGateSimulator::resolve( int net ) const
+{
+	const QValueList<int> & drivers = netDrivers[net];
+	if( drivers.count() == 1 )
+		return driverValues[ drivers.first() ];
+
+	char v = 'Z';
+	for( QValueList<int>::const_iterator it = drivers.begin(); it != drivers.end(); ++it ){
+		char d = driverValues[*it];
+		if( d == 'Z' )
+			continue;
+		if( v == 'Z' )
+			v = d;
+		else if( v != d )
+			return 'X';
+	}
+
+	return v;
+}
+
+// Valor lgico con el que una puerta lee una red
+char HDLGateSimulator::input( int net ) const
+{
+	if( net == -1 )
+		return 'U';
+
+	char v = netValues[net];
+	return ( v == '0' || v == '1' ) ? v : 'U';
+}
+
+void HDLGateSimulator::evaluate( int g )
+{
+	Gate & gate = gates[g];
+	char r, v;
+	uint i;
+
+	switch( gate.type ){
+	case HDLGateKind::Vcc:
+		r = '1';
+		break;
+
+	case HDLGateKind::Gnd:
+		r = '0';
+		break;
+
+	case HDLGateKind::Inv:
+	case HDLGateKind::Buf:
+		r = gate.inputs.isEmpty() ? 'U' : input( gate.inputs[0] );
+		if( gate.type == HDLGateKind::Inv )
+			r = logicNot( r );
+		break;
+
+	case HDLGateKind::And:
+	case HDLGateKind::Nand:
+		r = '1';
+		for( i=0; i < gate.inputs.count(); i++ ){
+			v = input( gate.inputs[i] );
+			if( v == '0' ){
+				r = '0';
+				break;
+			}
+			if( v != '1' )
+				r = 'U';
+		}
+		if( gate.type == HDLGateKind::Nand )
+			r = logicNot( r );
+		break;
+
+	case HDLGateKind::Or:
+	case HDLGateKind::Nor:
+		r = '0';
+		for( i=0; i < gate.inputs.count(); i++ ){
+			v = input( gate.inputs[i] );
+			if( v == '1' ){
+				r = '1';
+				break;
+			}
+			if( v != '0' )
+				r = 'U';
+		}
+		if( gate.type == HDLGateKind::Nor )
+			r = logicNot( r );
+		break;
+
+	case HDLGateKind::Xor:
+	case HDLGateKind::Xnor:
+		r = '0';
+		for( i=0; i < gate.inputs.count(); i++ ){
+			v = input( gate.inputs[i] );
+			if( v == 'U' ){
+				r = 'U';
+				break;
+			}
+			if( v == '1' )
+				r = logicNot( r );
+		}
+		if( gate.type == HDLGateKind::Xnor )
+			r = logicNot( r );
+		break;
+
+	case HDLGateKind::Register:
+		// Captura en el flanco de subida del reloj
+		v = input( gate.control );
+		if( gate.lastControl == '0' && v == '1' )
+			for( i=0; i < gate.inputs.count(); i++ )
+				gate.state[i] = input( gate.inputs[i] );
+		gate.lastControl = v;
+
+		for( i=0; i < gate.outputs.count(); i++ )
+			setOutput( gate, i, gate.state[i] );
+		return;
+
+	case HDLGateKind::TriBuffer:
+		// OE activo a nivel bajo
+		v = input( gate.control );
+		for( i=0; i < gate.outputs.count(); i++ )
+			setOutput( gate, i, ( v == '0' ) ? input( gate.inputs[i] ) : ( v == '1' ) ? 'Z' : 'U' );
+		return;
+
+	case HDLGateKind::Decoder:{
+		// E* activo a nivel bajo: slo se activa la salida seleccionada
+		v = input( gate.control );
+		int selected = 0;
+		bool known = ( v == '0' );
+		for( i=0; known && i < gate.inputs.count(); i++ ){
+			char s = input( gate.inputs[i] );
+			if( s == 'U' )
+				known = false;
+			else if( s == '1' )
+				selected |= 1 << i;
+		}
+
+		for( i=0; i < gate.outputs.count(); i++ )
+			if( v == '1' )
+				setOutput( gate, i, '0' );
+			else if( known )
+				setOutput( gate, i, ( (int)i == selected ) ? '1' : '0' );
+			else
+				setOutput( gate, i, 'U' );
+		return;
+	}
+	}
+
+	for( i=0; i < gate.outputs.count(); i++ )
+		setOutput( gate, i, r );
+}
+
+void HDLGateSimulator::setOutput( Gate & gate, uint output, char value )
+{
+	int d = gate.outputs[output];
+	if( d == -1 || driverNext[d] == value )
+		return;
+
+	driverNext[d] = value;
+	schedule( d, value, GateDelay );
+}
+
+void HDLGateSimulator::schedule( int driver, char value, uint delay )
+{
+	Event ev;
+	ev.driver = driver;
+	ev.value = value;
+
+	wheel[ (now + delay) % WheelSize ].append( ev );
+	pending++;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consulta
+//////////////////////////////////////////////////////////////////////
+
+char HDLGateSimulator::value( const QString & signal ) const
+{
+	QMap<QString, int>::const_iterator it = netIds.find( signal );
+	return ( it != netIds.end() ) ? netValues[ it.data() ] : 'U';
+}
+
+QStringList HDLGateSimulator::signalNames() const
+{
+	return netIds.keys();
+}
+
+bool HDLGateSimulator::simulate( const SignalValues & inputs, SignalValues & outputs )
+{
+	for( SignalValues::const_iterator iti = inputs.begin(); iti != inputs.end(); ++iti )
+		if( !force( iti.key(), (char)iti.data() ) ){
+			errStr = QObject::tr("La seal %1 no existe en el modelo.").arg( iti.key() );
+			return false;
+		}
+
+	bool ok = run();
+
+	if( outputs.isEmpty() ){
+		for( QMap<QString, int>::const_iterator itn = netIds.begin(); itn != netIds.end(); ++itn )
+			outputs.insert( itn.key(), netValues[ itn.data() ] );
+	}else{
+		for( SignalValues::iterator ito = outputs.begin(); ito != outputs.end(); ++ito )
+			ito.data() = value( ito.key() );
+	}
+
+	return ok;
+}
+
+uint HDLGateSimulator::time() const
+{
+	return now;
+}
+
+unsigned long HDLGateSimulator::eventCount() const
+{
+	return events;
+}
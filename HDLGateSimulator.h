@@ -0,0 +1,136 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLGateSimulator.h: interface for the HDLGateSimulator class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLGATESIMULATOR_H_)
+#define _HDLGATESIMULATOR_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+#include <qmap.h>
+
+#include "HDLProcess.h"
+#include "HDLGateKind.h"
+
+class HDLModelSnapshot;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLGateSimulator
+//
+//	Simulador de eventos a nivel de puerta, alternativo a HDLProcSimulator
+//	(vsim) cuando el modelo slo instancia primitivas de las libreras
+//	estndar (INV, AND/OR/NAND/NOR/XOR-n, Vcc, GND, registros, buffers
+//	triestado y decodificadores MUXn).
+//
+//	Parte de la netlist capturada en un HDLModelSnapshot. Cada red se
+//	resuelve a partir de sus excitadores (salidas de puertas o entradas
+//	forzadas) y los cambios se propagan con una rueda de tiempos: cada
+//	puerta tiene un retardo de GateDelay unidades.
+//
+//	Los valores son los de VHDL std_logic reducidos: '0', '1', 'U'
+//	(desconocido), 'X' (conflicto) y 'Z' (alta impedancia).
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLGateSimulator
+{
+public:
+	enum { GateDelay = 1, WheelSize = 64, MaxTime = 100000 };
+
+	HDLGateSimulator();
+
+	// Construye el circuito. Devuelve false si el modelo instancia un
+	// componente sin modelo de comportamiento (ver errorString)
+	bool load( const HDLModelSnapshot & snapshot );
+	QString errorString() const;
+
+	// Todas las redes a 'U' y registros sin valor
+	void reset();
+
+	// Fuerza el valor de una seal ('Z' la libera)
+	bool force( const QString & signal, char value );
+
+	// Avanza hasta que no quedan eventos. Devuelve false si el circuito
+	// no se estabiliza en MaxTime unidades (oscilacin)
+	bool run();
+
+	char value( const QString & signal ) const;
+	QStringList signalNames() const;
+
+	// Misma interfaz que HDLProcSimulator: fuerza inputs, simula y
+	// recoge outputs (todas las seales si outputs est vaco)
+	bool simulate( const SignalValues & inputs, SignalValues & outputs );
+
+	// Estadsticas
+	uint time() const;
+	unsigned long eventCount() const;
+
+private:
+	struct Gate{
+		HDLGateKind::Kind type;
+		QValueVector<int> inputs;	// Redes de entrada (-1 sin conectar)
+		QValueVector<int> outputs;	// Excitadores de salida (-1 sin conectar)
+		int control;				// Red de CLK, OE o E* (-1 si no tiene)
+		char lastControl;
+		QValueVector<char> state;	// Contenido del registro
+	};
+
+	struct Event{
+		int driver;
+		char value;
+	};
+
+	int net( const QString & name );
+	int addDriver( int net );
+	char resolve( int net ) const;
+	char input( int net ) const;
+
+	void evaluate( int gate );
+	void setOutput( Gate & gate, uint output, char value );
+	void schedule( int driver, char value, uint delay );
+
+	QString errStr;
+
+	// Redes
+	QMap<QString, int> netIds;
+	QValueVector<char> netValues;
+	QValueVector< QValueList<int> > netDrivers;
+	QValueVector< QValueList<int> > netFanout;
+
+	// Excitadores: valor actual y ltimo valor planificado
+	QValueVector<int> driverNets;
+	QValueVector<char> driverValues;
+	QValueVector<char> driverNext;
+	QMap<int, int> forcedDrivers;
+
+	// Puertas
+	QValueVector<Gate> gates;
+	QValueVector<uint> gateStamps;
+	uint stamp;
+
+	// Rueda de tiempos
+	QValueVector< QValueList<Event> > wheel;
+	uint now;
+	uint pending;
+	unsigned long events;
+};
+
+#endif
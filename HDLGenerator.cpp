@@ -19,6 +19,7 @@
 #include "HDLGenerator.h"
 
 #include <qcanvas.h>
+#include <qmap.h>
 
 #include "LEDevice.h"
 #include "LEWireLine.h"
@@ -27,6 +28,53 @@
 #include "LEItem.h"
 #include "LMComponent.h"
 #include "LogicEditor.h"
+#include "HDLNetlist.h"
+#include "HDLModelSnapshot.h"
+#include "HDLNetlistOptimizer.h"
+
+// Devuelve el LogicEditor propietario del lienzo (NULL si no existe).
+// Su netlist se mantiene al da con cada edicin y evita recorrer el lienzo
+static LogicEditor * dataEditor( QCanvas * canvas )
+{
+	if( canvas && canvas->parent() && canvas->parent()->inherits( "LogicEditor" ) )
+		return (LogicEditor*) canvas->parent();
+
+	return NULL;
+}
+
+// Extrae en netlist las redes y dispositivos de los elementos del lienzo
+// (sin editor) en un nico recorrido, uniendo los extremos de cada cable
+// y los puntos de conexin enlazados
+static void fillNetlist( HDLNetlist & netlist, QCanvasItemList * items )
+{
+	QCanvasItemList::iterator itItm;
+	for( itItm = items->begin(); itItm != items->end(); itItm++ )
+		if( (*itItm)->rtti() == LEDevice::RTTI )
+			netlist.insertDevice( (LEDevice*)*itItm );
+		else if( (*itItm)->rtti() == LEWireLine::RTTI )
+			netlist.insertWireLine( (LEWireLine*)*itItm );
+		else if( (*itItm)->rtti() == LEConnectionPoint::RTTI ){
+			// Conexiones simtricas puntoDeConexin-puntoDeConexin (LEDevice duplicados)
+			LEConnectionPoint * cp = (LEConnectionPoint*)*itItm;
+			for( LEItem * item = cp->connectionList().first(); item; item = cp->connectionList().next() )
+				if( item->rtti() == LEConnectionPoint::RTTI )
+					netlist.insertLink( cp, (LEConnectionPoint*)item );
+		}
+}
+
+// Captura el modelo para su volcado (ver HDLModelSnapshot, que resuelve
+// tambin el ancho de los buses y las porciones de cada pin). El grafo del
+// editor se mantiene al da con cada edicin, no se reconstruye aqu
+static bool captureModel( QCanvas * canvas, QCanvasItemList * items, const QString & entity, HDLModelSnapshot & snapshot )
+{
+	LogicEditor * editor = dataEditor( canvas );
+	if( editor )
+		return snapshot.capture( entity, editor );
+
+	HDLNetlist netlist;
+	fillNetlist( netlist, items );
+	return snapshot.capture( entity, netlist );
+}
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -61,7 +109,8 @@ void HDLGenerator::setDataOrigin( QCanvas * dataOrigin )
 
 // Marca la cache como Not At Date, de forma
 // que la prxima vez que sea necesaria deber
-// recalcularse
+// recalcularse. Las listas slo se recalculan al pedir las dependencias:
+// el volcado captura el grafo del editor, que se actualiza por partes
 void HDLGenerator::setDataChanged()
 {
 	if( this->itms ){
@@ -89,21 +138,28 @@ bool HDLGenerator::buildInstances()
 		return false;
 	}
 
-	itms = new QCanvasItemList( dtOrgn->allItems() );
+	QPtrList<LEDevice> devs;
+	LogicEditor * editor = dataEditor( dtOrgn );
+	if( editor )
+		devs = editor->netlist().devices();
+	else{
+		if( !itms )
+			itms = new QCanvasItemList( dtOrgn->allItems() );
 		
-	QCanvasItemList::iterator it;
-	for( it = itms->begin(); it != itms->end(); it++ )
-		if( (*it)->rtti() == LEDevice::RTTI ){
-			LEDevice * dev = (LEDevice*)*it;
-
-			// Slo se insertan los elementos originales (no los duplicados)
-			if( LogicEditor::extractDupNameIndex( dev->name() ) == -1 ){
-
-				if( dev->componentReference()->isExternSolving() )
-					extInsts.append( dev );
-				else
-					insts.append( dev );
-			}
+		QCanvasItemList::iterator it;
+		for( it = itms->begin(); it != itms->end(); it++ )
+			if( (*it)->rtti() == LEDevice::RTTI )
+				devs.append( (LEDevice*)*it );
+	}
+
+	for( LEDevice * dev = devs.first(); dev; dev = devs.next() )
+		// Slo se insertan los elementos originales (no los duplicados)
+		if( LogicEditor::extractDupNameIndex( dev->name() ) == -1 ){
+
+			if( dev->componentReference()->isExternSolving() )
+				extInsts.append( dev );
+			else
+				insts.append( dev );
 		}
 
 	instsAtDate = true;
@@ -132,150 +188,68 @@ bool HDLGenerator::buildSignals()
  
 	emit outputMessage( tr(" Generando seales...") );
 
+	// Redes del modelo: la netlist del editor se mantiene al da con cada
+	// edicin. Sin editor se extraen en un nico recorrido de los elementos
+	// uniendo los extremos de cada cable y los puntos de conexin enlazados
+	HDLNetlist localNetlist;
+	LogicEditor * editor = dataEditor( dtOrgn );
+	HDLNetlist & netlist = editor ? editor->netlist() : localNetlist;
+	if( !editor )
+		fillNetlist( localNetlist, itms );
+
+	// Item con el que se mapea cada red (indexado por el identificador de red)
+	QMap<int, LEItem*> extNets;
+	QMap<int, LEItem*> intNets;
+
 	LEDevice* it;
 
-	// Instancias externas
+	// Instancias externas: toda red conectada al pin se mapear con el propio
+	// pin (el primero en ser recorrido si la red alcanza varios)
 	for( it = extInsts.first(); it; it = extInsts.next() )
-	{   // Para cada instancia de componente externa
+	{
 		QPtrList<LEPin>& lsPin = it->pinList();
-		for( LEPin* pin = lsPin.first(); pin; pin = lsPin.next() )
-		{   // Para cada pin de la instancia de componente
-			
-			// Toda conexin al pin se mapear con el propio pin
-			LEItem * mappedItem = pin;
-			
-			// Recorremos el grafo de cables conectados a este pin (directamente o atravs de bifurcaciones)
-			QPtrList<LEConnectionPoint> activeNodes;
-			QPtrList<LEConnectionPoint> oldNodes;
-			
-			// Inicialmente tomamos el punto de conexin del pin y sus conexiones directas
-			if( pin->connectionPoint() ){
-				// Punto de conexin del pin
-				activeNodes.append( pin->connectionPoint() );
-
-				// Conexiones directas del pin (conexiones simtricas puntoDeConexin-puntoDeConexin: Se dan en los LEDevice duplicados)
-				for( LEItem * item = pin->connectionPoint()->connectionList().first(); item; item=pin->connectionPoint()->connectionList().next() )
-					if( item->rtti() == LEConnectionPoint::RTTI )
-						activeNodes.append( (LEConnectionPoint*)item );
-			}
-
-			while( !activeNodes.isEmpty() ){
-				LEConnectionPoint * cp = activeNodes.take();
-
-				// Iteramos cada cable conectado al nodo activo CP
-				for( LEItem * item = cp->connectionList().first(); item; item=cp->connectionList().next() ){  
-					if( item->rtti() == LEWireLine::RTTI )
-					{	
-						LEWireLine *wl = (LEWireLine*)item;
-						
-						// Mapeamos el cable con el nombre del pin (evitando repetir entradas)
-						if( !extSigs.contains( wl->name() ) )
-							extSigs.insert( wl->resolvName('_'), mappedItem );
-
-						// Exploramos el grafo en busca de nuevos nodos activos 
-						if( cp == wl->leftConnection() ){
-							// Insertamos en la lista de nodos activos el CP derecho (el opuesto al actual)
-
-							if( wl->rightConnection() )
-								// Evitamos procesar mltiples veces el mismo CP
-								if( !oldNodes.contains( wl->rightConnection() ) )
-									// Evitamos duplicar ocurrencias en la lista activeNodes
-									if( !activeNodes.contains( wl->rightConnection() ) )
-										activeNodes.append( wl->rightConnection() );
-						}else{
-							// Insertamos en la lista de nodos activos el CP izquierdo (el opuesto al acutal)
-							
-							if( wl->leftConnection() )
-								// Evitamos procesar mltiples veces el mismo CP
-								if( !oldNodes.contains( wl->leftConnection() ) )
-									// Evitamos duplicar ocurrencias en la lista activeNodes
-									if( !activeNodes.contains( wl->leftConnection() ) )
-										activeNodes.append( wl->leftConnection() );
-						}
-					}
-				}/*para cada LEWireLine*/
-				
-				// Aadimos el nodo CP a oldNodes para evitar volver a procesarlo
-				oldNodes.append( cp );
-
-			}/*mientas hayan Nodos activos*/
-				
-		}/*para cada LEPin*/
-
-	}/*para cada Instancia Externa*/
-
-
-	// Instancias internas
+		for( LEPin* pin = lsPin.first(); pin; pin = lsPin.next() ){
+			int n = netlist.net( pin->connectionPoint() );
+			if( n != -1 && !extNets.contains( n ) )
+				extNets.insert( n, pin );
+		}
+	}
+
+	// Instancias internas: el Item-alias de la red es el primer cable
+	// encontrado desde el primer pin que la alcanza
 	for( it = insts.first(); it; it = insts.next() )
-	{   // Para cada instancia de componente interna
-	
+	{
 		QPtrList<LEPin>& lsPin = it->pinList();
-		for( LEPin* pin = lsPin.first(); pin; pin = lsPin.next() )
-		{   // Para cada pin de la instancia de componente
-			
-			LEItem * mappedItem = NULL;
-			
-			// Recorremos el grafo de cables conectados a este pin (directamente o atravs de bifurcaciones)
-			QPtrList<LEConnectionPoint> activeNodes;
-			QPtrList<LEConnectionPoint> oldNodes;
-			
-			// Inicialmente tomamos el punto de conexin del pin
-			if( pin->connectionPoint() )
-				activeNodes.append( pin->connectionPoint() );
-			while( !activeNodes.isEmpty() ){
-				LEConnectionPoint * cp = activeNodes.take();
-				
-				// Iteramos cada cable conectado al nodo activo CP
-				for( LEItem * item = cp->connectionList().first(); item; item=cp->connectionList().next() ){  
-					if( item->rtti() == LEWireLine::RTTI )
-					{	
-						LEWireLine *wl = (LEWireLine*)item;
-						
-						// Comprobaciones previas
-						if( extSigs.contains( wl->resolvName('_') ) )
-							// Este cable ya ha sido mapeado como externo, abortamos la exploracin
-							break;
-						else
-							// Primer idenficador del cable encontrado, ser su Item-alias
-							if( !mappedItem )
-								mappedItem = wl;
-
-
-						// Mapeamos el cable con el nombre del pin (evitando repetir entradas)
-						if( !sigs.contains( wl->resolvName('_') ) )
-							sigs.insert( wl->resolvName('_'), mappedItem );
-							
-						// Exploramos el grafo en busca de nuevos nodos activos 
-						if( cp == wl->leftConnection() ){
-							// Insertamos en la lista de nodos activos el CP derecho (el opuesto al actual)
-
-							if( wl->rightConnection() )
-								// Evitamos procesar mltiples veces el mismo CP
-								if( !oldNodes.contains( wl->rightConnection() ) )
-									// Evitamos duplicar ocurrencias en la lista activeNodes
-									if( !activeNodes.contains( wl->rightConnection() ) )
-										activeNodes.append( wl->rightConnection() );
-						}else{
-							// Insertamos en la lista de nodos activos el CP izquierdo (el opuesto al acutal)
-							
-							if( wl->leftConnection() )
-								// Evitamos procesar mltiples veces el mismo CP
-								if( !oldNodes.contains( wl->leftConnection() ) )
-									// Evitamos duplicar ocurrencias en la lista activeNodes
-									if( !activeNodes.contains( wl->leftConnection() ) )
-										activeNodes.append( wl->leftConnection() );
-						}
-					}
-				}/*para cada LEWireLine*/
-				
-				// Aadimos el nodo CP a oldNodes para evitar volver a procesarlo
-				oldNodes.append( cp );
-
-			}/*mientas hayan Nodos activos*/
-				
-		}/*para cada LEPin*/
-
-	}/*para cada Instancia Interna*/
+		for( LEPin* pin = lsPin.first(); pin; pin = lsPin.next() ){
+			int n = netlist.net( pin->connectionPoint() );
+			if( n == -1 || extNets.contains( n ) || intNets.contains( n ) )
+				continue;
+
+			ConnectionList & cnncts = pin->connectionPoint()->connectionList();
+			for( LEItem * item = cnncts.first(); item; item = cnncts.next() )
+				if( item->rtti() == LEWireLine::RTTI ){
+					intNets.insert( n, item );
+					break;
+				}
+		}
+	}
+
+	// Mapeado de cada cable con el Item de su red
+	for( QPtrDictIterator<LEWireLine> itWl( netlist.wireLines() ); itWl.current(); ++itWl ){
+		LEWireLine * wl = itWl.current();
+		int n = netlist.net( wl );
+		if( n == -1 )
+			continue;
+
+		QMap<int, LEItem*>::iterator itNet = extNets.find( n );
+		if( itNet != extNets.end() )
+			extSigs.insert( wl->resolvName('_'), itNet.data() );
+		else{
+			itNet = intNets.find( n );
+			if( itNet != intNets.end() )
+				sigs.insert( wl->resolvName('_'), itNet.data() );
+		}
+	}
 
 	emit outputMessage( tr("    Todas las seales resueltas") );
 
@@ -325,166 +299,46 @@ bool HDLGenerator::buildDependences()
 // Construye el cdigo HDL asociado al diseo volcndolo
 // en dataOut.
 //
-// Requiere que todas las listas hayan sido construidos, as
-// que invocar a las funciones build*
+// Captura directamente el modelo (con editor, su grafo vivo), sin
+// reconstruir las listas de instancias y seales
 bool HDLGenerator::buildHDL(  const QString & entity, QTextOStream * dataOut )
 {
 	if( !dataOut )
 		return false;
 
-	// Nos aseguramos de que todas las listas hayan sido construidas
-	// buildInstances( ); // La llamada de estos mtodos est implcita en
-	// buildSignals( );	  // buildDependences() si la cachno est al da
-	buildDependences( );
-
-	// Verificacin de condiciones
-	if( portExtSignals.count() <= 0 ){
-		emit outputMessage( tr("Generando fichero HDL '%1.vhd'...").arg(entity) );
-		emit errorMessage( tr("    No hay seales externas, no se puede crear la interfaz del componente.") );
+	if( !dtOrgn ){
+		emit errorMessage( tr("Imposible generar HDL: El origen de datos no ha sido establecido.") );
 		return false;
 	}
-	
-	// ENTITY
-	*dataOut << "ENTITY " << entity << " IS\n";
-	SignalMapper::iterator it = extSigs.begin();
-	QString sigName = it.data()->resolvName('_');
-	
-	LEItem* portItem = portExtSignals.first();
-	if( portItem ){
-		*dataOut << "\tPORT( " << portItem->resolvName('_');
-		if( portItem->rtti() == LEPin::RTTI )
-			switch( ((LEPin*)portItem)->accessMode() ){
-			case LEPin::Input:
-				*dataOut << " : OUT BIT";
-				break;
-			case LEPin::Output:
-				*dataOut << " : IN BIT";
-				break;
-			case LEPin::InputOutput:
-				*dataOut << " : INOUT BIT";
-				break;
-			}
-		
+	if( !dataEditor( dtOrgn ) && !itms )
+		itms = new QCanvasItemList( dtOrgn->allItems() );
 
-		for( portItem=portExtSignals.next(); portItem ; portItem=portExtSignals.next() ){
-				*dataOut << "; " << portItem->resolvName('_');
-				if( portItem->rtti() == LEPin::RTTI )
-					switch( ((LEPin*)portItem)->accessMode() ){
-					case LEPin::Input:
-						*dataOut << " : OUT BIT";
-						break;
-					case LEPin::Output:
-						*dataOut << " : IN BIT";
-						break;
-					case LEPin::InputOutput:
-						*dataOut << " : INOUT BIT";
-						break;
-					}
-		}			
-
-		
-		*dataOut << ");\nEND " << entity << ";\n\n";
+	// Captura del modelo (sin pasar por las listas de instancias y seales)
+	HDLModelSnapshot snapshot;
+	if( !captureModel( dtOrgn, itms, entity, snapshot ) ){
+		emit outputMessage( tr("Generando fichero HDL '%1.vhd'...").arg(entity) );
+		emit errorMessage( "    " + snapshot.errorString() );
+		return false;
 	}
 
-	// ARCHITECTURE
-	*dataOut << "ARCHITECTURE estructural OF " << entity << " IS\n";
-	
-	// Enumeracin de componentes requeridos
-	for( LMComponent * cmp = comps.first(); cmp; cmp=comps.next() ){
-
-		// COMPONENT
-		*dataOut << "\tCOMPONENT " << cmp->name() << "\n";
-		
-		// PORT (...
-		PinList::iterator pinIt = cmp->pinList().begin();
-		
-		*dataOut << "\t\tPORT( " << (*pinIt).name() << " : ";
-
-		if( (*pinIt).accessMode() == LEPin::Input )
-			*dataOut << "IN";
-		else if( (*pinIt).accessMode() == LEPin::Output )
-			*dataOut << "OUT";
-		else
-			*dataOut << "INOUT";
-		*dataOut << " BIT";
-
-		for( ++pinIt; pinIt != cmp->pinList().end(); ++pinIt ){
-			*dataOut << "; " << (*pinIt).name() << " : ";
-
-			if( (*pinIt).accessMode() == LEPin::Input )
-				*dataOut << "IN";
-			else if( (*pinIt).accessMode() == LEPin::Output )
-				*dataOut << "OUT";
-			else
-				*dataOut << "INOUT";
-			*dataOut << " BIT";
-		}
-		*dataOut << ");\n\tEND COMPONENT;\n";
-	}
-	*dataOut << "\n";
-
-	// SIGNAL
-	if( sigs.count() > 0 ){
-		it = sigs.begin();
-		sigName = it.data()->resolvName('_');
-		*dataOut << "\tSIGNAL " << sigName;
-		for( ++it; it != sigs.end(); ++it )
-			if( it.data()->resolvName('_') != sigName ){
-				sigName = it.data()->resolvName('_');
-				*dataOut << ", " << sigName;
-			}
-		*dataOut << ": BIT;\n\n";
+	// Verificacin de condiciones
+	if( snapshot.portList().isEmpty() ){
+		emit outputMessage( tr("Generando fichero HDL '%1.vhd'...").arg(entity) );
+		emit errorMessage( tr("    No hay seales externas, no se puede crear la interfaz del componente.") );
+		return false;
 	}
 
-	// BEGIN
-	*dataOut << "\tBEGIN\n";
-
-	for( LEDevice * lpDev = insts.first(); lpDev; lpDev = insts.next() ){
-		*dataOut << "\t\t" << lpDev->name() << " : " << lpDev->componentReference()->name() << " PORT MAP( " ;
-		LEPin * lpPin = lpDev->pinList().first();
-		LEItem * lpCnnct = NULL;
-
-		// Bsqueda de un cable conectado al pin
-		for( lpCnnct = lpPin->connectionPoint()->connectionList().first(); lpCnnct; lpCnnct = lpPin->connectionPoint()->connectionList().next() )
-			if( lpCnnct->rtti() == LEWireLine::RTTI )
-				break;
-		
-		// Obtenemos el nombre mapeado del cable (primero comprobamos si est conectado a una seal externa)
-		if( lpCnnct ){
-			SignalMapper::iterator sigIt = extSigs.find( lpCnnct->name() );
-			if( sigIt == extSigs.end() ){
-				sigIt = sigs.find( lpCnnct->name() );
-				if( sigIt != sigs.end() )
-					*dataOut << sigs[ lpCnnct->name() ]->resolvName('_');
-			}else
-				*dataOut << extSigs[ lpCnnct->name() ]->resolvName('_');
-		}
-			
-
-		for( lpPin = lpDev->pinList().next(); lpPin; lpPin = lpDev->pinList().next() ){
-			// Bsqueda de un cable conectado al pin
-			for( lpCnnct = lpPin->connectionPoint()->connectionList().first(); lpCnnct; lpCnnct = lpPin->connectionPoint()->connectionList().next() )
-				if( lpCnnct->rtti() == LEWireLine::RTTI )
-					break;
-			
-			// Obtenemos el nombre mapeado del cable (primero comprobamos si est conectado a una seal externa)
-			if( lpCnnct ){
-				SignalMapper::iterator sigIt = extSigs.find( lpCnnct->name() );
-				if( sigIt == extSigs.end() ){
-					sigIt = sigs.find( lpCnnct->name() );
-					if( sigIt != sigs.end() )
-						*dataOut << ", " << sigs[ lpCnnct->name() ]->resolvName('_');
-				}else
-					*dataOut << ", " << extSigs[ lpCnnct->name() ]->resolvName('_');
-			}
-		}
+	if( HDLNetlistOptimizer::isEnabled() ){
+		HDLNetlistOptimizer::Report report;
+		HDLNetlistOptimizer::optimizeVerified( snapshot, &report );
 
-		*dataOut << ");\n\n";
-		
+		emit outputMessage( report.summary() );
+		if( !report.rejection().isNull() )
+			emit errorMessage( report.rejection() );
 	}
 
-	// END
-	*dataOut << "END estructural;";
+	// Volcado (con los buses como BIT_VECTOR)
+	snapshot.writeHDL( *dataOut );
 	
 	emit outputMessage( tr(" Fichero %1.vhd Generado").arg(entity) );
 	return true;
@@ -493,72 +347,35 @@ bool HDLGenerator::buildHDL(  const QString & entity, QTextOStream * dataOut )
 // Construye la lista de seales asociada al modelo en XML, volcndolo
 // en dataOut.
 //
-// Requiere que la lista {extSignals} haya sido generada, as que
-// se invocarn las funciones build pertinentes
+// Como buildHDL, captura directamente el modelo
 bool HDLGenerator::buildSignalsFile( const QString & entity, QTextOStream * dataOut )
 {
 	if( !dataOut )
 		return false;
 
-	// Nos aseguramos de que las listas {extSignals} y el mapa portExtSignals
-	// hayan sido construidos
-	//
-	// buildInstances( ); // Se obvia, si es preciso ser invocado por buildSignals
-	buildSignals( );
+	if( !dtOrgn ){
+		emit errorMessage( tr("Imposible generar HDL: El origen de datos no ha sido establecido.") );
+		return false;
+	}
+	if( !dataEditor( dtOrgn ) && !itms )
+		itms = new QCanvasItemList( dtOrgn->allItems() );
 
 	emit outputMessage( tr(" Generando fichero de seales '%1.sig'...").arg(entity) );
 
+	HDLModelSnapshot snapshot;
+	if( !captureModel( dtOrgn, itms, entity, snapshot ) ){
+		emit errorMessage( "  " + snapshot.errorString() );
+		return false;
+	}
+
 	// Verificacin de condiciones
-	if( portExtSignals.count() <= 0 ){
+	if( snapshot.portList().isEmpty() ){
 		emit errorMessage( tr("  No hay seales externas, no se puede continuar.") );
 		return false;
 	}
 	
-	// Cabecera <signals>
-	*dataOut << "<signals entity=\"" << entity << "\">\n\n";
-
-	// Entradas <signal>
-	SignalMapper::iterator it = extSigs.begin();
-	QString sigName = it.data()->resolvName('_');
-	
-	LEItem* portItem = portExtSignals.first();
-	if( portItem ){
-		*dataOut << "\t<signal accessMode=\"";
-		if( portItem->rtti() == LEPin::RTTI )
-			switch( ((LEPin*)portItem)->accessMode() ){
-			case LEPin::Input:
-				*dataOut << "OUT";
-				break;
-			case LEPin::Output:
-				*dataOut << "IN";
-				break;
-			case LEPin::InputOutput:
-				*dataOut << "INOUT";
-				break;
-			}
-		*dataOut << "\">" << portItem->resolvName('_') << "</signal>\n";
-
-		for( portItem=portExtSignals.next(); portItem ; portItem=portExtSignals.next() ){
-			*dataOut << "\t<signal accessMode=\"";
-			if( portItem->rtti() == LEPin::RTTI )
-				switch( ((LEPin*)portItem)->accessMode() ){
-				case LEPin::Input:
-					*dataOut << "OUT";
-					break;
-				case LEPin::Output:
-					*dataOut << "IN";
-					break;
-				case LEPin::InputOutput:
-					*dataOut << "INOUT";
-					break;
-				}
-			*dataOut << "\">" << portItem->resolvName('_') << "</signal>\n";
-		}			
-
-	}	
-
-	// Cierrre </signals>
-	*dataOut << "\n</signals>\n\n";
+	// Entradas <signal> (con el ancho de los buses)
+	snapshot.writeSignals( *dataOut );
 
 	emit outputMessage( tr("Generando fichero HDL '%1.vhd'... Generado").arg(entity) );
 
@@ -0,0 +1,316 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLJobScheduler.cpp: implementation of the HDLJobScheduler class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLJobScheduler.h"
+#include "HDLProcess.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLJobScheduler::HDLJobScheduler( QObject * parent, const char * name )
+: QObject( parent, name )
+{
+	maxWorkers = DefaultWorkers;
+	running = 0;
+	remaining = 0;
+	started = false;
+	failed = false;
+}
+
+HDLJobScheduler::~HDLJobScheduler()
+{
+	// Los procesos que siguen en marcha se detienen
+	for( uint i=0; i < jobs.count(); i++ )
+		if( jobs[i].proc ){
+			if( jobs[i].state == Running )
+				jobs[i].proc->kill();
+			delete jobs[i].proc;
+		}
+}
+
+void HDLJobScheduler::setWorkers( int count )
+{
+	maxWorkers = QMAX( count, 1 );
+}
+
+int HDLJobScheduler::workers() const
+{
+	return maxWorkers;
+}
+
+void HDLJobScheduler::setEnvironment( const QStringList & env )
+{
+	this->env = env;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin del grafo
+//////////////////////////////////////////////////////////////////////
+
+int HDLJobScheduler::addJob( HDLProcess * proc, const QString & label, bool mustSucceed )
+{
+	Job job;
+	job.label = label;
+	job.proc = proc;
+	job.mustSucceed = mustSucceed;
+	job.state = Waiting;
+	job.pending = 0;
+	job.msecs = 0;
+
+	int id = jobs.count();
+	jobs.push_back( job );
+	procJobs.insert( proc, id );
+
+	// Manejadores de mensajes
+	connect( proc, SIGNAL(errorMessage(const QString&)), this, SIGNAL(errorMessage(const QString&)) );
+	connect( proc, SIGNAL(outputMessage(const QString&)), this, SIGNAL(outputMessage(const QString&)) );
+
+	connect( proc, SIGNAL(success()), this, SLOT(processSuccess()) );
+	connect( proc, SIGNAL(failure()), this, SLOT(processFailure()) );
+
+	return id;
+}
+
+void HDLJobScheduler::addDependence( int job, int requiredJob )
+{
+	if( job == requiredJob || job < 0 || requiredJob < 0 || job >= (int)jobs.count() || requiredJob >= (int)jobs.count() )
+		return;
+
+	// Las dependencias repetidas se ignoran
+	if( jobs[requiredJob].dependents.contains( job ) )
+		return;
+
+	jobs[requiredJob].dependents.append( job );
+	jobs[job].pending++;
+}
+
+void HDLJobScheduler::setJobLock( int job, const QString & lock )
+{
+	if( job >= 0 && job < (int)jobs.count() )
+		jobs[job].lock = lock;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Ejecucin
+//////////////////////////////////////////////////////////////////////
+
+bool HDLJobScheduler::start()
+{
+	if( started )
+		return false;
+
+	started = true;
+	remaining = jobs.count();
+
+	if( jobs.isEmpty() ){
+		emit finished( true );
+		return true;
+	}
+
+	checkCycles();
+
+	for( uint i=0; i < jobs.count(); i++ )
+		if( jobs[i].state == Waiting && jobs[i].pending == 0 )
+			ready.append( i );
+
+	schedule();
+
+	return true;
+}
+
+bool HDLJobScheduler::isRunning() const
+{
+	return started && remaining > 0;
+}
+
+// Los trabajos que forman parte de un ciclo (o dependen de uno) nunca
+// podran iniciarse: se cancelan. Devuelve false si haba alguno
+bool HDLJobScheduler::checkCycles()
+{
+	QValueVector<int> pending( jobs.count() );
+	QValueList<int> queue;
+	uint i, visited = 0;
+
+	for( i=0; i < jobs.count(); i++ ){
+		pending[i] = jobs[i].pending;
+		if( pending[i] == 0 )
+			queue.append( i );
+	}
+
+	// Orden topolgico (Kahn)
+	while( !queue.isEmpty() ){
+		int job = queue.first();
+		queue.remove( queue.begin() );
+		visited++;
+
+		for( QValueList<int>::iterator it = jobs[job].dependents.begin(); it != jobs[job].dependents.end(); ++it )
+			if( --pending[*it] == 0 )
+				queue.append( *it );
+	}
+
+	if( visited == jobs.count() )
+		return true;
+
+	for( i=0; i < jobs.count(); i++ )
+		if( pending[i] > 0 ){
+			emit errorMessage( tr("> %1 cancelado: dependencia circular.").arg(jobs[i].label) );
+			jobs[i].state = Cancelled;
+			procJobs.remove( jobs[i].proc );
+			delete jobs[i].proc;
+			jobs[i].proc = NULL;
+			remaining--;
+			emit jobFinished( i, false, 0 );
+		}
+
+	failed = true;
+	return false;
+}
+
+// Inicia, en orden, los trabajos listos cuyo cerrojo est libre (los
+// dems esperan a que termine el que lo tiene)
+void HDLJobScheduler::schedule()
+{
+	while( running < maxWorkers ){
+		QValueList<int>::iterator it = ready.begin();
+		while( it != ready.end() && !jobs[*it].lock.isNull() && locks.contains( jobs[*it].lock ) )
+			++it;
+		if( it == ready.end() )
+			break;
+
+		int job = *it;
+		ready.remove( it );
+		launch( job );
+	}
+
+	if( remaining == 0 && running == 0 && started ){
+		started = false;
+		emit finished( !failed );
+	}
+}
+
+void HDLJobScheduler::launch( int job )
+{
+	jobs[job].state = Running;
+	jobs[job].timer.start();
+	running++;
+	if( !jobs[job].lock.isNull() )
+		locks.append( jobs[job].lock );
+
+	emit jobStarted( job );
+
+	// El proceso puede terminar durante start() (si est al da)
+	bool ok = env.isEmpty() ? jobs[job].proc->start() : jobs[job].proc->start( &env );
+	if( !ok && jobs[job].state == Running ){
+		emit errorMessage( tr("> No se puede iniciar %1.").arg(jobs[job].label) );
+		finishJob( job, false );
+	}
+}
+
+void HDLJobScheduler::finishJob( int job, bool ok )
+{
+	if( jobs[job].state != Running )
+		return;
+
+	running--;
+	remaining--;
+	jobs[job].msecs = jobs[job].timer.elapsed();
+	if( !jobs[job].lock.isNull() )
+		locks.remove( locks.find( jobs[job].lock ) );
+
+	// El proceso se destruye al volver al bucle de eventos
+	procJobs.remove( jobs[job].proc );
+	jobs[job].proc->deleteLater();
+	jobs[job].proc = NULL;
+
+	emit outputMessage( tr("> %1: %2 s").arg(jobs[job].label).arg( jobs[job].msecs / 1000.0, 0, 'f', 2 ) );
+
+	if( ok || !jobs[job].mustSucceed ){
+		jobs[job].state = Succeeded;
+
+		for( QValueList<int>::iterator it = jobs[job].dependents.begin(); it != jobs[job].dependents.end(); ++it )
+			if( --jobs[*it].pending == 0 && jobs[*it].state == Waiting )
+				ready.append( *it );
+	}else{
+		jobs[job].state = Failed;
+		failed = true;
+		cancelDependents( job );
+	}
+
+	emit jobFinished( job, jobs[job].state == Succeeded, jobs[job].msecs );
+
+	schedule();
+}
+
+void HDLJobScheduler::cancelDependents( int job )
+{
+	for( QValueList<int>::iterator it = jobs[job].dependents.begin(); it != jobs[job].dependents.end(); ++it )
+		if( jobs[*it].state == Waiting ){
+			emit errorMessage( tr("> %1 cancelado: %2 ha fallado.").arg(jobs[*it].label).arg(jobs[job].label) );
+
+			jobs[*it].state = Cancelled;
+			procJobs.remove( jobs[*it].proc );
+			delete jobs[*it].proc;
+			jobs[*it].proc = NULL;
+			remaining--;
+
+			emit jobFinished( *it, false, 0 );
+			cancelDependents( *it );
+		}
+}
+
+void HDLJobScheduler::processSuccess()
+{
+	QMap<const QObject*, int>::iterator it = procJobs.find( sender() );
+	if( it != procJobs.end() )
+		finishJob( it.data(), true );
+}
+
+void HDLJobScheduler::processFailure()
+{
+	QMap<const QObject*, int>::iterator it = procJobs.find( sender() );
+	if( it != procJobs.end() )
+		finishJob( it.data(), false );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consulta
+//////////////////////////////////////////////////////////////////////
+
+int HDLJobScheduler::jobCount() const
+{
+	return jobs.count();
+}
+
+HDLJobScheduler::JobState HDLJobScheduler::jobState( int job ) const
+{
+	return jobs[job].state;
+}
+
+QString HDLJobScheduler::jobLabel( int job ) const
+{
+	return jobs[job].label;
+}
+
+int HDLJobScheduler::jobTime( int job ) const
+{
+	return jobs[job].msecs;
+}
@@ -0,0 +1,136 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLJobScheduler.h: interface for the HDLJobScheduler class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLJOBSCHEDULER_H_)
+#define _HDLJOBSCHEDULER_H_
+
+#include <qobject.h>
+#include <qstringlist.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+#include <qdatetime.h>
+#include <qmap.h>
+
+class HDLProcess;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLJobScheduler
+//
+//	Planificador de procesos de compilacin (vlib, vcom...) organizados en
+//	un grafo de dependencias.
+//
+//	Cada trabajo es un HDLProcess ya configurado que slo se inicia cuando
+//	han terminado todos los trabajos de los que depende. Los trabajos
+//	independientes se ejecutan a la vez hasta el lmite de procesos
+//	establecido. Si un trabajo fracasa se cancelan todos los que dependen
+//	de l (salvo que su fracaso se haya declarado tolerable, como ocurre
+//	con vlib sobre una librera existente).
+//
+//	Los trabajos con el mismo cerrojo (setJobLock) nunca se ejecutan a la
+//	vez aunque sean independientes: varios vcom sobre una misma librera
+//	de trabajo se serializan y slo se paraleliza entre libreras.
+//
+//	El entorno de los procesos puede fijarse con setEnvironment, de forma
+//	que un PATH con guiones sustitutos de vlib/vcom permite ejecutar el
+//	grafo sin ModelSim.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLJobScheduler : public QObject
+{
+Q_OBJECT
+
+public:
+	enum { DefaultWorkers = 2 };
+	enum JobState { Waiting, Running, Succeeded, Failed, Cancelled };
+
+	HDLJobScheduler( QObject * parent=0, const char * name=0 );
+	~HDLJobScheduler();
+
+	// Nmero mximo de procesos simultneos
+	void setWorkers( int count );
+	int workers() const;
+
+	// Entorno completo de los procesos (vaco: el de la aplicacin)
+	void setEnvironment( const QStringList & env );
+
+	// Aade un trabajo (el planificador se queda con el proceso) y
+	// devuelve su identificador
+	int addJob( HDLProcess * proc, const QString & label, bool mustSucceed=true );
+	void addDependence( int job, int requiredJob );
+
+	// Cerrojo del trabajo (QString::null: ninguno)
+	void setJobLock( int job, const QString & lock );
+
+	// Inicia la ejecucin del grafo. Devuelve false si no se puede iniciar
+	bool start();
+	bool isRunning() const;
+
+	int jobCount() const;
+	JobState jobState( int job ) const;
+	QString jobLabel( int job ) const;
+	int jobTime( int job ) const;	// Tiempo de ejecucin en ms
+
+signals:
+	void errorMessage(const QString&);
+	void outputMessage(const QString&);
+
+	void jobStarted( int job );
+	void jobFinished( int job, bool ok, int msecs );
+
+	// Todos los trabajos han terminado (ok si ninguno ha fracasado)
+	void finished( bool ok );
+
+private slots:
+	void processSuccess();
+	void processFailure();
+
+private:
+	struct Job{
+		QString label;
+		HDLProcess * proc;
+		bool mustSucceed;
+		JobState state;
+		QValueList<int> dependents;
+		int pending;			// Dependencias sin terminar
+		QString lock;
+		QTime timer;
+		int msecs;
+	};
+
+	void schedule();
+	void launch( int job );
+	void finishJob( int job, bool ok );
+	void cancelDependents( int job );
+	bool checkCycles();
+
+	QValueVector<Job> jobs;
+	QMap<const QObject*, int> procJobs;
+	QValueList<int> ready;
+	QStringList locks;			// Cerrojos de los trabajos en ejecucin
+	QStringList env;
+	int maxWorkers;
+	int running;
+	int remaining;
+	bool started;
+	bool failed;
+};
+
+#endif
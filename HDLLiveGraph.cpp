@@ -0,0 +1,277 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLLiveGraph.cpp: implementation of the HDLLiveGraph class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLLiveGraph.h"
+
+#include "HDLNetlist.h"
+#include "LEDevice.h"
+#include "LEWireLine.h"
+#include "LEPin.h"
+#include "LEConnectionPoint.h"
+#include "LMComponent.h"
+
+// Por debajo de este nmero de elementos eliminados no se reconstruye
+#define MIN_REMOVED_ITEMS	64
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLLiveGraph::HDLLiveGraph( HDLNetlist & netlist )
+	: netlst( netlist ), liveItems( 0 ), removedItems( 0 )
+{
+}
+
+void HDLLiveGraph::reset()
+{
+	grph.clear();
+	newDevs.clear();
+	dirtyDevs.clear();
+	dirtyWires.clear();
+	liveItems = 0;
+	removedItems = 0;
+
+	// Los cambios pendientes quedan incluidos en la reconstruccin
+	netlst.takeChangedPoints();
+
+	for( QPtrDictIterator<LEWireLine> itWl( netlst.wireLines() ); itWl.current(); ++itWl ){
+		LEWireLine * wl = itWl.current();
+		wl->graphIdx = grph.addWire( wl->resolvName('_'), wl->busWidth(), wl->sliceOffset() );
+		grph.setWireNet( wl->graphIdx, netlst.net( wl ) );
+		liveItems++;
+	}
+
+	QPtrListIterator<LEDevice> itDev( netlst.devices() );
+	for( ; itDev.current(); ++itDev ){
+		itDev.current()->graphIdx = -1;
+		newDevs.append( itDev.current() );
+	}
+
+	sync();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Altas y bajas
+//////////////////////////////////////////////////////////////////////
+
+void HDLLiveGraph::insertDevice( LEDevice * dev )
+{
+	if( dev->graphIdx == -1 && newDevs.findRef( dev ) == -1 )
+		newDevs.append( dev );
+
+	updateNets();
+}
+
+void HDLLiveGraph::removeDevice( LEDevice * dev )
+{
+	dirtyDevs.remove( dev );
+	if( newDevs.removeRef( dev ) ){
+		updateNets();
+		return;
+	}
+
+	if( dev->graphIdx != -1 ){
+		grph.removeDevice( dev->graphIdx );
+		dev->graphIdx = -1;
+		liveItems--;
+		removedItems++;
+
+		QPtrList<LEPin> & pins = dev->pinList();
+		for( LEPin * pin = pins.first(); pin; pin = pins.next() )
+			pin->graphIdx = -1;
+	}
+
+	updateNets();
+}
+
+void HDLLiveGraph::insertWireLine( LEWireLine * wl )
+{
+	if( wl->graphIdx == -1 ){
+		wl->graphIdx = grph.addWire( QString::null );
+		liveItems++;
+		markDirty( wl );
+	}
+
+	updateNets();
+}
+
+void HDLLiveGraph::removeWireLine( LEWireLine * wl )
+{
+	dirtyWires.remove( wl );
+
+	if( wl->graphIdx != -1 ){
+		grph.removeWire( wl->graphIdx );
+		wl->graphIdx = -1;
+		liveItems--;
+		removedItems++;
+	}
+
+	// Los pins de sus extremos pasan al siguiente cable conectado
+	if( wl->leftConnection() )
+		updatePin( wl->leftConnection() );
+	if( wl->rightConnection() )
+		updatePin( wl->rightConnection() );
+
+	updateNets();
+}
+
+void HDLLiveGraph::updateItem( LEItem * item )
+{
+	if( item->graphIdx != -1 ){
+		if( item->rtti() == LEDevice::RTTI ){
+			if( dirtyDevs.count() > dirtyDevs.size() )
+				dirtyDevs.resize( 2*dirtyDevs.size() + 1 );
+			dirtyDevs.replace( item, (LEDevice*)item );
+		}else if( item->rtti() == LEWireLine::RTTI )
+			markDirty( (LEWireLine*)item );
+	}
+
+	updateNets();
+}
+
+void HDLLiveGraph::markDirty( LEWireLine * wl )
+{
+	if( dirtyWires.count() > dirtyWires.size() )
+		dirtyWires.resize( 2*dirtyWires.size() + 1 );
+	dirtyWires.replace( wl, wl );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Redes
+//////////////////////////////////////////////////////////////////////
+
+// Los puntos de conexin pueden desaparecer tras la edicin (pins de un
+// dispositivo eliminado), as que los cambios se aplican al momento
+void HDLLiveGraph::updateNets()
+{
+	QPtrList<LEConnectionPoint> points = netlst.takeChangedPoints();
+	for( LEConnectionPoint * cp = points.first(); cp; cp = points.next() )
+		updatePoint( cp );
+}
+
+// Red del pin de cp (si es de un dispositivo del grafo) y de los cables
+// conectados a cp
+void HDLLiveGraph::updatePoint( LEConnectionPoint * cp )
+{
+	updatePin( cp );
+
+	ConnectionList & cnncts = cp->connectionList();
+	for( LEItem * item = cnncts.first(); item; item = cnncts.next() )
+		if( item->rtti() == LEWireLine::RTTI && item->graphIdx != -1 )
+			grph.setWireNet( item->graphIdx, netlst.net( (LEWireLine*)item ) );
+}
+
+void HDLLiveGraph::updatePin( LEConnectionPoint * cp )
+{
+	int pin = pinIndex( cp );
+	if( pin == -1 )
+		return;
+
+	grph.setPinNet( pin, netlst.net( cp ) );
+	grph.setPinWire( pin, firstWire( cp ) );
+}
+
+// Nombre, bus y red del cable, y cable de los pins de sus extremos
+void HDLLiveGraph::updateWire( LEWireLine * wl )
+{
+	int w = wl->graphIdx;
+	grph.setWireName( w, wl->resolvName('_') );
+	grph.setWireBus( w, wl->busWidth(), wl->sliceOffset() );
+	grph.setWireNet( w, netlst.net( wl ) );
+
+	if( wl->leftConnection() )
+		updatePin( wl->leftConnection() );
+	if( wl->rightConnection() )
+		updatePin( wl->rightConnection() );
+}
+
+// Primer cable registrado de la lista de conexiones de cp (como
+// HDLModelGraph::build)
+int HDLLiveGraph::firstWire( LEConnectionPoint * cp ) const
+{
+	ConnectionList & cnncts = cp->connectionList();
+	for( LEItem * item = cnncts.first(); item; item = cnncts.next() )
+		if( item->rtti() == LEWireLine::RTTI && item->graphIdx != -1 )
+			return item->graphIdx;
+
+	return -1;
+}
+
+// ndice en el grafo del pin al que pertenece cp (-1 si no es un pin o su
+// dispositivo no est en el grafo)
+int HDLLiveGraph::pinIndex( LEConnectionPoint * cp )
+{
+	LEItem * parent = cp->parent();
+	if( !parent || parent->rtti() != LEPin::RTTI )
+		return -1;
+
+	return parent->graphIdx;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consulta
+//////////////////////////////////////////////////////////////////////
+
+const HDLModelGraph & HDLLiveGraph::graph()
+{
+	if( removedItems > MIN_REMOVED_ITEMS && removedItems > liveItems )
+		reset();
+	else
+		sync();
+
+	return grph;
+}
+
+// Resuelve los elementos pendientes. Los dispositivos nuevos se aaden en
+// orden de registro, el mismo que el de la netlist
+void HDLLiveGraph::sync()
+{
+	updateNets();
+
+	for( QPtrDictIterator<LEWireLine> itWl( dirtyWires ); itWl.current(); ++itWl )
+		updateWire( itWl.current() );
+	dirtyWires.clear();
+
+	for( QPtrDictIterator<LEDevice> itDev( dirtyDevs ); itDev.current(); ++itDev )
+		grph.setDeviceName( itDev.current()->graphIdx, itDev.current()->resolvName() );
+	dirtyDevs.clear();
+
+	// Un dispositivo an sin componente queda pendiente junto con los
+	// posteriores, para no alterar el orden
+	while( !newDevs.isEmpty() && newDevs.getFirst()->componentReference() ){
+		LEDevice * dev = newDevs.getFirst();
+		dev->graphIdx = grph.addDevice( dev->resolvName(), (LMComponent*)dev->componentReference() );
+		liveItems++;
+
+		// Pins emparejados por nombre con los del componente
+		int paired = 0;
+		QPtrList<LEPin> & pins = dev->pinList();
+		for( LEPin * lpPin = pins.first(); lpPin; lpPin = pins.next() ){
+			lpPin->graphIdx = grph.findPin( dev->graphIdx, lpPin->name() );
+			if( lpPin->graphIdx != -1 )
+				paired++;
+			updatePin( lpPin->connectionPoint() );
+		}
+		grph.setDeviceMismatch( dev->graphIdx, paired != grph.pinCount( dev->graphIdx ) || paired != (int)pins.count() );
+
+		newDevs.removeFirst();
+	}
+}
@@ -0,0 +1,103 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLLiveGraph.h: interface for the HDLLiveGraph class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLLIVEGRAPH_H_)
+#define _HDLLIVEGRAPH_H_
+
+#include <qptrlist.h>
+#include <qptrdict.h>
+
+#include "HDLModelGraph.h"
+
+class HDLNetlist;
+class LEItem;
+class LEDevice;
+class LEWireLine;
+class LEConnectionPoint;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLLiveGraph
+//
+//	HDLModelGraph del modelo de un editor, mantenido al da con cada edicin
+//	en lugar de reconstruirse en cada captura.
+//
+//	Los cambios de red los registra la netlist (HDLNetlist::setTrackChanges)
+//	y se aplican al momento, slo sobre los pins y cables de los puntos de
+//	conexin afectados: el coste de una edicin es proporcional al tamao
+//	de las redes que modifica, no al del modelo. Los dispositivos y cables
+//	nuevos, renombrados o con otro bus se anotan y se resuelven en la
+//	siguiente consulta (graph()), cuando ya tienen componente, pins y
+//	nombre definitivo (se registran en el editor antes de completarse).
+//
+//	Los dispositivos, pins y cables guardan su ndice en el grafo
+//	(LEItem::graphIndex): el grafo no mantiene tablas de items a ndices y
+//	los items no duplican el estado de red, que se consulta en el grafo.
+//
+//	Los elementos eliminados quedan marcados en el grafo; cuando superan a
+//	los vivos el grafo se reconstruye desde la netlist (reasignando los
+//	ndices). El grafo vivo no guarda la geometra (posiciones y vrtices):
+//	slo alimenta la captura del modelo (HDLModelSnapshot).
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLLiveGraph
+{
+public:
+	HDLLiveGraph( HDLNetlist & netlist );
+
+	// Reconstruye el grafo completo a partir de la netlist
+	void reset();
+
+	// Altas y bajas. Deben invocarse tras actualizar la netlist
+	void insertDevice( LEDevice * dev );
+	void removeDevice( LEDevice * dev );
+	void insertWireLine( LEWireLine * wl );
+	void removeWireLine( LEWireLine * wl );
+
+	// El item ha cambiado de nombre, de bus o de conexiones
+	void updateItem( LEItem * item );
+
+	// Aplica los cambios de red registrados por la netlist
+	void updateNets();
+
+	// Grafo al da
+	const HDLModelGraph & graph();
+
+private:
+	void sync();
+	void markDirty( LEWireLine * wl );
+	void updatePoint( LEConnectionPoint * cp );
+	void updatePin( LEConnectionPoint * cp );
+	void updateWire( LEWireLine * wl );
+	int firstWire( LEConnectionPoint * cp ) const;
+	static int pinIndex( LEConnectionPoint * cp );
+
+	HDLNetlist & netlst;
+	HDLModelGraph grph;
+
+	// Pendientes de resolver en la siguiente consulta
+	QPtrList<LEDevice> newDevs;
+	QPtrDict<LEDevice> dirtyDevs;
+	QPtrDict<LEWireLine> dirtyWires;
+
+	int liveItems, removedItems;
+};
+
+#endif
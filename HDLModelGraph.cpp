@@ -0,0 +1,354 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelGraph.cpp: implementation of the HDLModelGraph class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLModelGraph.h"
+
+#include <qmap.h>
+
+#include "LEDevice.h"
+#include "LEWireLine.h"
+#include "LEPin.h"
+#include "LEConnectionPoint.h"
+#include "LMComponent.h"
+#include "HDLNetlist.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLModelGraph::HDLModelGraph()
+	: nets( 0 )
+{
+}
+
+void HDLModelGraph::clear()
+{
+	devNames.clear();
+	devComponents.clear();
+	devFirstPins.clear();
+	devXs.clear();
+	devYs.clear();
+	devMismatches.clear();
+
+	pinDevices.clear();
+	pinNames.clear();
+	pinNets.clear();
+	pinWires.clear();
+
+	wlNames.clear();
+	wlNets.clear();
+	wlWidths.clear();
+	wlSlices.clear();
+	wlFirstVertexs.clear();
+
+	vertexXs.clear();
+	vertexYs.clear();
+
+	nets = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin
+//////////////////////////////////////////////////////////////////////
+
+// Las redes son las de la netlist y el cable de cada pin el primero
+// registrado de su lista de conexiones (el orden en que se conectaron).
+// Los pins del lienzo se asignan por nombre a los del componente
+void HDLModelGraph::build( HDLNetlist & netlist )
+{
+	clear();
+
+	QMap<LEWireLine*, int> wireIndex;
+	for( QPtrDictIterator<LEWireLine> itWl( netlist.wireLines() ); itWl.current(); ++itWl ){
+		LEWireLine * wl = itWl.current();
+
+		QPointArray points( wl->vertexCount() );
+		for( int v=0; v < wl->vertexCount(); v++ )
+			points.setPoint( v, wl->vertex( v ) );
+
+		int i = addWire( wl->resolvName('_'), wl->busWidth(), wl->sliceOffset(), points );
+		setWireNet( i, netlist.net( wl ) );
+		wireIndex.insert( wl, i );
+	}
+
+	LEDevice * dev;
+	for( QPtrListIterator<LEDevice> itDev( netlist.devices() ); (dev = itDev.current()); ++itDev ){
+		int d = addDevice( dev->resolvName(), (LMComponent*)dev->componentReference(), QPoint( (int)dev->x(), (int)dev->y() ) );
+
+		int paired = 0;
+		QPtrList<LEPin> & pins = dev->pinList();
+		for( LEPin * lpPin = pins.first(); lpPin; lpPin = pins.next() ){
+			int pin = findPin( d, lpPin->name() );
+			if( pin == -1 )
+				continue;
+
+			paired++;
+			setPinNet( pin, netlist.net( lpPin->connectionPoint() ) );
+
+			ConnectionList & cnncts = lpPin->connectionPoint()->connectionList();
+			for( LEItem * item = cnncts.first(); item; item = cnncts.next() )
+				if( item->rtti() == LEWireLine::RTTI ){
+					QMap<LEWireLine*, int>::iterator it = wireIndex.find( (LEWireLine*)item );
+					if( it != wireIndex.end() ){
+						pinWires[pin] = it.data();
+						break;
+					}
+				}
+		}
+
+		setDeviceMismatch( d, paired != pinCount( d ) || paired != (int)pins.count() );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Dispositivos
+//////////////////////////////////////////////////////////////////////
+
+int HDLModelGraph::addDevice( const QString & name, LMComponent * component, const QPoint & offset )
+{
+	int dev = devNames.size();
+
+	devNames.push_back( name );
+	devComponents.push_back( component );
+	devFirstPins.push_back( pinDevices.size() );
+	devXs.push_back( offset.x() );
+	devYs.push_back( offset.y() );
+	devMismatches.push_back( false );
+
+	PinList::const_iterator it;
+	for( it = component->pinList().begin(); it != component->pinList().end(); ++it ){
+		pinDevices.push_back( dev );
+		pinNames.push_back( (*it).name() );
+		pinNets.push_back( -1 );
+		pinWires.push_back( -1 );
+	}
+
+	return dev;
+}
+
+void HDLModelGraph::removeDevice( int dev )
+{
+	devComponents[dev] = 0;
+
+	int pin = devFirstPins[dev], end = pin + pinCount( dev );
+	for( ; pin < end; pin++ ){
+		pinNets[pin] = -1;
+		pinWires[pin] = -1;
+	}
+}
+
+void HDLModelGraph::setDeviceName( int dev, const QString & name )
+{
+	devNames[dev] = name;
+}
+
+void HDLModelGraph::setDeviceMismatch( int dev, bool mismatch )
+{
+	devMismatches[dev] = mismatch;
+}
+
+bool HDLModelGraph::interfaceMatches( int dev ) const
+{
+	LMComponent * cmp = devComponents[dev];
+	if( !cmp || devMismatches[dev] || pinCount( dev ) != (int)cmp->pinList().count() )
+		return false;
+
+	int pin = devFirstPins[dev];
+	PinList::const_iterator it;
+	for( it = cmp->pinList().begin(); it != cmp->pinList().end(); ++it, pin++ )
+		if( pinNames[pin] != (*it).name() )
+			return false;
+
+	return true;
+}
+
+int HDLModelGraph::deviceCount() const
+{
+	return devNames.size();
+}
+
+const QString & HDLModelGraph::deviceName( int dev ) const
+{
+	return devNames[dev];
+}
+
+LMComponent * HDLModelGraph::deviceComponent( int dev ) const
+{
+	return devComponents[dev];
+}
+
+QPoint HDLModelGraph::deviceOffset( int dev ) const
+{
+	return QPoint( devXs[dev], devYs[dev] );
+}
+
+int HDLModelGraph::firstPin( int dev ) const
+{
+	return devFirstPins[dev];
+}
+
+int HDLModelGraph::pinCount( int dev ) const
+{
+	int end = ( dev + 1 < (int)devFirstPins.size() ) ? devFirstPins[dev + 1] : pinDevices.size();
+	return end - devFirstPins[dev];
+}
+
+// Los dispositivos tienen pocos pins: bsqueda lineal
+int HDLModelGraph::findPin( int dev, const QString & name ) const
+{
+	int pin = devFirstPins[dev], end = pin + pinCount( dev );
+	for( ; pin < end; pin++ )
+		if( pinNames[pin] == name )
+			return pin;
+
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pins
+//////////////////////////////////////////////////////////////////////
+
+int HDLModelGraph::pinCount() const
+{
+	return pinDevices.size();
+}
+
+int HDLModelGraph::pinDevice( int pin ) const
+{
+	return pinDevices[pin];
+}
+
+const QString & HDLModelGraph::pinName( int pin ) const
+{
+	return pinNames[pin];
+}
+
+int HDLModelGraph::pinNet( int pin ) const
+{
+	return pinNets[pin];
+}
+
+int HDLModelGraph::pinWire( int pin ) const
+{
+	return pinWires[pin];
+}
+
+void HDLModelGraph::setPinNet( int pin, int net )
+{
+	pinNets[pin] = net;
+	if( net >= nets )
+		nets = net + 1;
+}
+
+void HDLModelGraph::setPinWire( int pin, int wire )
+{
+	pinWires[pin] = wire;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Cables
+//////////////////////////////////////////////////////////////////////
+
+int HDLModelGraph::addWire( const QString & name, int busWidth, int sliceOffset, const QPointArray & points )
+{
+	wlNames.push_back( name );
+	wlNets.push_back( -1 );
+	wlWidths.push_back( busWidth );
+	wlSlices.push_back( sliceOffset );
+	wlFirstVertexs.push_back( vertexXs.size() );
+
+	for( uint i=0; i < points.size(); i++ ){
+		vertexXs.push_back( points.point( i ).x() );
+		vertexYs.push_back( points.point( i ).y() );
+	}
+
+	return wlNames.size() - 1;
+}
+
+void HDLModelGraph::removeWire( int wire )
+{
+	wlNets[wire] = -1;
+}
+
+void HDLModelGraph::setWireName( int wire, const QString & name )
+{
+	wlNames[wire] = name;
+}
+
+void HDLModelGraph::setWireBus( int wire, int busWidth, int sliceOffset )
+{
+	wlWidths[wire] = busWidth;
+	wlSlices[wire] = sliceOffset;
+}
+
+int HDLModelGraph::wireCount() const
+{
+	return wlNames.size();
+}
+
+const QString & HDLModelGraph::wireName( int wire ) const
+{
+	return wlNames[wire];
+}
+
+int HDLModelGraph::wireNet( int wire ) const
+{
+	return wlNets[wire];
+}
+
+int HDLModelGraph::wireBusWidth( int wire ) const
+{
+	return wlWidths[wire];
+}
+
+int HDLModelGraph::wireSliceOffset( int wire ) const
+{
+	return wlSlices[wire];
+}
+
+QPointArray HDLModelGraph::wirePoints( int wire ) const
+{
+	int first = wlFirstVertexs[wire];
+	int end = ( wire + 1 < (int)wlFirstVertexs.size() ) ? wlFirstVertexs[wire + 1] : vertexXs.size();
+
+	QPointArray points( end - first );
+	for( int i = first; i < end; i++ )
+		points.setPoint( i - first, vertexXs[i], vertexYs[i] );
+
+	return points;
+}
+
+void HDLModelGraph::setWireNet( int wire, int net )
+{
+	wlNets[wire] = net;
+	if( net >= nets )
+		nets = net + 1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Redes
+//////////////////////////////////////////////////////////////////////
+
+int HDLModelGraph::netCount() const
+{
+	return nets;
+}
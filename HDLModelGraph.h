@@ -0,0 +1,178 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelGraph.h: interface for the HDLModelGraph class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLMODELGRAPH_H_)
+#define _HDLMODELGRAPH_H_
+
+#include <qstring.h>
+#include <qpoint.h>
+#include <qpointarray.h>
+#include <qvaluevector.h>
+
+class LMComponent;
+class LMPinDescription;
+class HDLNetlist;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLModelGraph
+//
+//	Modelo compacto, sin items del lienzo: dispositivos, pins y cables se
+//	identifican con enteros consecutivos y cada propiedad se guarda en un
+//	vector propio (un vector por campo, no un objeto por elemento).
+//
+//	Los pins de un dispositivo ocupan ndices globales consecutivos, a
+//	partir de firstPin(), en el orden de la descripcin de su componente;
+//	de cada pin slo se guarda su dispositivo, su red y el primer cable
+//	conectado (tres enteros frente a un LEPin y su LEConnectionPoint), y el
+//	nombre del pin del componente en el momento de insertar el dispositivo.
+//	Los pins del lienzo se emparejan por nombre (findPin), no por posicin:
+//	si la interfaz del componente cambia despus de colocar el dispositivo,
+//	sus pins dejan de coincidir (interfaceMatches) en lugar de conectarse
+//	a otros puertos. Los vrtices de todos los cables se guardan seguidos.
+//
+//	Se construye a partir de la netlist de un editor (build) o directamente
+//	desde el fichero del modelo (HDLModelReader), de forma que los
+//	documentos que no se muestran no necesitan crear editor ni lienzo. Las
+//	redes se identifican con enteros no negativos (-1 = sin red) menores
+//	que netCount(), de forma que pueden indexar vectores.
+//
+//	El grafo del editor se mantiene vivo (HDLLiveGraph): los elementos
+//	eliminados no se compactan, quedan marcados (dispositivo sin componente,
+//	cable sin red) y los ndices del resto no cambian.
+//
+//	En los documentos abiertos el modelo editable siguen siendo los items
+//	del lienzo (LEDevice, LEPin, LEWireLine): el grafo se deriva de ellos y
+//	los items no leen su nombre, geometra ni conexiones del grafo. El coste
+//	por pin de ambas representaciones se mide en
+//	tests/modelgraph/bench_HDLModelGraph.cpp.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLModelGraph
+{
+public:
+	HDLModelGraph();
+
+	void clear();
+
+	// Construye el grafo con los dispositivos y cables registrados en netlist
+	void build( HDLNetlist & netlist );
+
+	//////////////////////////////////////////////////////////////////////
+	// Dispositivos
+	//////////////////////////////////////////////////////////////////////
+
+	// Inserta el dispositivo y sus pins (sin red ni cable). Devuelve su ndice
+	int addDevice( const QString & name, LMComponent * component, const QPoint & offset=QPoint() );
+
+	// Marca el dispositivo como eliminado (deviceComponent() pasa a ser
+	// NULL) y desconecta sus pins
+	void removeDevice( int dev );
+	void setDeviceName( int dev, const QString & name );
+
+	// Los pins del dispositivo en el lienzo no son los de su componente
+	// (sobran o faltan pins al emparejarlos por nombre)
+	void setDeviceMismatch( int dev, bool mismatch );
+
+	// Los pins del dispositivo coinciden en nmero, orden y nombre con los
+	// del componente actual, y todos se emparejaron con los del lienzo
+	bool interfaceMatches( int dev ) const;
+
+	int deviceCount() const;
+	const QString & deviceName( int dev ) const;
+	LMComponent * deviceComponent( int dev ) const;
+	QPoint deviceOffset( int dev ) const;
+
+	// Pins del dispositivo: [firstPin(dev), firstPin(dev) + pinCount(dev))
+	int firstPin( int dev ) const;
+	int pinCount( int dev ) const;
+
+	// Pin del dispositivo con el nombre dado (-1 si el componente no lo tiene)
+	int findPin( int dev, const QString & name ) const;
+
+	//////////////////////////////////////////////////////////////////////
+	// Pins (ndices globales)
+	//////////////////////////////////////////////////////////////////////
+
+	int pinCount() const;
+	int pinDevice( int pin ) const;
+	const QString & pinName( int pin ) const;
+	int pinNet( int pin ) const;
+	int pinWire( int pin ) const;		// Primer cable conectado (-1 si no hay ninguno)
+	void setPinNet( int pin, int net );
+	void setPinWire( int pin, int wire );
+
+	//////////////////////////////////////////////////////////////////////
+	// Cables
+	//////////////////////////////////////////////////////////////////////
+
+	// Inserta el cable (sin red). Devuelve su ndice
+	int addWire( const QString & name, int busWidth=1, int sliceOffset=-1, const QPointArray & points=QPointArray() );
+
+	// Marca el cable como eliminado (sin red)
+	void removeWire( int wire );
+	void setWireName( int wire, const QString & name );
+	void setWireBus( int wire, int busWidth, int sliceOffset );
+
+	int wireCount() const;
+	const QString & wireName( int wire ) const;
+	int wireNet( int wire ) const;
+	int wireBusWidth( int wire ) const;
+	int wireSliceOffset( int wire ) const;
+	QPointArray wirePoints( int wire ) const;
+	void setWireNet( int wire, int net );
+
+	//////////////////////////////////////////////////////////////////////
+	// Redes
+	//////////////////////////////////////////////////////////////////////
+
+	// Cota de los identificadores de red: todos son menores que netCount()
+	// (no todos los valores intermedios tienen por qu usarse)
+	int netCount() const;
+
+private:
+	// Dispositivos
+	QValueVector<QString> devNames;
+	QValueVector<LMComponent*> devComponents;
+	QValueVector<int> devFirstPins;
+	QValueVector<int> devXs, devYs;
+	QValueVector<bool> devMismatches;
+
+	// Pins
+	QValueVector<int> pinDevices;
+	QValueVector<QString> pinNames;
+	QValueVector<int> pinNets;
+	QValueVector<int> pinWires;
+
+	// Cables
+	QValueVector<QString> wlNames;
+	QValueVector<int> wlNets;
+	QValueVector<int> wlWidths;
+	QValueVector<int> wlSlices;
+	QValueVector<int> wlFirstVertexs;
+
+	// Vrtices de todos los cables
+	QValueVector<int> vertexXs, vertexYs;
+
+	int nets;
+};
+
+#endif
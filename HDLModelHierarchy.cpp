@@ -0,0 +1,226 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelHierarchy.cpp: implementation of the HDLModelHierarchy class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLModelHierarchy.h"
+
+#include <qfile.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qdatetime.h>
+#include <qdom.h>
+
+#include "Project.h"
+#include "LibraryManager.h"
+#include "HDLBuildState.h"
+#include "HDLModelGraph.h"
+#include "HDLModelReader.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLModelHierarchy::HDLModelHierarchy( LibraryManager & libraries )
+	: libs( libraries )
+{
+	lib = NULL;
+}
+
+HDLModelHierarchy::~HDLModelHierarchy()
+{
+	detach();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Librera de modelos
+//////////////////////////////////////////////////////////////////////
+
+// Los modelos se compilan en la librera del proyecto (BIN_PROJECT_FOLDER).
+// La librera se crea una sola vez y se reutiliza en los siguientes
+// proyectos: sus componentes se actualizan en lugar de recrearse
+LMLibrary * HDLModelHierarchy::attach( const QString & projectPath, const QStringList & docs )
+{
+	detach();
+
+	pth = projectPath;
+	if( !lib )
+		lib = libs.createLibrary( MODELS_LIBRARY_NAME, LMLibrary::HDL, BIN_PROJECT_FOLDER );
+
+	for( QStringList::const_iterator it = docs.begin(); it != docs.end(); ++it )
+		updateComponent( *it );
+
+	return lib;
+}
+
+// La librera no se elimina: los dispositivos de los documentos cerrados
+// (que no se destruyen) siguen apuntando a sus componentes
+void HDLModelHierarchy::detach()
+{
+	pth = QString::null;
+	children.clear();
+	childrenTimes.clear();
+}
+
+LMLibrary * HDLModelHierarchy::library() const
+{
+	return lib;
+}
+
+// Sin fichero de seales (modelo an no construido) no hay componente
+LMComponent * HDLModelHierarchy::updateComponent( const QString & doc )
+{
+	if( !lib || pth.isNull() )
+		return NULL;
+
+	QDir sigDir( pth );
+	if( !sigDir.cd( SIM_PROJECT_FOLDER ) )
+		return NULL;
+
+	QFile file( sigDir.filePath( QString("%1.sig").arg(doc) ) );
+	if( !file.open( IO_ReadOnly ) )
+		return NULL;
+
+	QDomDocument dom;
+	if( !dom.setContent( &file ) || dom.documentElement().tagName() != "signals" ){
+		qWarning( "Error cargando modelo: '" + file.name() + "' no es un fichero de seales vlido." );
+		return NULL;
+	}
+
+	LMComponent cmp( lib );
+	if( !cmp.parseSignals( dom.documentElement() ) )
+		return NULL;
+
+	return libs.insertComponent( lib, cmp );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Jerarqua
+//////////////////////////////////////////////////////////////////////
+
+// Slo se vuelve a leer el modelo si su fichero ha cambiado
+QStringList HDLModelHierarchy::submodels( const QString & doc )
+{
+	QFileInfo modelFile = HDLModelReader::modelFile( pth, doc );
+	uint modelTime = modelFile.lastModified().toTime_t();
+
+	QMap<QString, uint>::const_iterator itTime = childrenTimes.find( doc );
+	if( itTime != childrenTimes.end() && itTime.data() == modelTime )
+		return children[doc];
+
+	HDLModelGraph graph;
+	HDLModelReader reader( libs, graph );
+	QStringList list;
+	if( reader.readFile( modelFile.filePath() ) )
+		list = reader.references( MODELS_LIBRARY_NAME );
+
+	children.insert( doc, list );
+	childrenTimes.insert( doc, modelTime );
+
+	return list;
+}
+
+QString HDLModelHierarchy::interfacesHash( const QStringList & submodels ) const
+{
+	if( submodels.isEmpty() )
+		return QString::null;
+
+	QDir sigDir( pth );
+	sigDir.cd( SIM_PROJECT_FOLDER );
+
+	QString data;
+	for( QStringList::const_iterator it = submodels.begin(); it != submodels.end(); ++it )
+		data += *it + "\t" + HDLBuildState::hashFile( sigDir.filePath( QString("%1.sig").arg(*it) ) ) + "\n";
+
+	return HDLBuildState::hashString( data );
+}
+
+// Los submodelos que no estn en docs no se tienen en cuenta (ya estn
+// construidos o no pertenecen al proyecto)
+bool HDLModelHierarchy::levels( const QStringList & docs, const QMap<QString, QStringList> & children,
+								QValueList<QStringList> & levels, QStringList & cyclic )
+{
+	QStringList pending = docs;
+	levels.clear();
+
+	while( !pending.isEmpty() ){
+		QStringList level;
+
+		QStringList::const_iterator it;
+		for( it = pending.begin(); it != pending.end(); ++it ){
+			bool ready = true;
+
+			QMap<QString, QStringList>::const_iterator itChildren = children.find( *it );
+			if( itChildren != children.end() )
+				for( QStringList::const_iterator itChild = itChildren.data().begin(); itChild != itChildren.data().end(); ++itChild )
+					if( pending.contains( *itChild ) ){
+						ready = false;
+						break;
+					}
+
+			if( ready )
+				level.append( *it );
+		}
+
+		// Ningn documento pendiente puede construirse: ciclo
+		if( level.isEmpty() ){
+			cyclic = pending;
+			return false;
+		}
+
+		for( it = level.begin(); it != level.end(); ++it )
+			pending.remove( *it );
+
+		levels.append( level );
+	}
+
+	cyclic.clear();
+	return true;
+}
+
+QStringList HDLModelHierarchy::dependents( const QStringList & docs, const QStringList & all,
+										   const QMap<QString, QStringList> & children )
+{
+	QStringList result = docs;
+
+	// Se aaden padres hasta que no aparece ninguno nuevo
+	bool changed = true;
+	while( changed ){
+		changed = false;
+
+		for( QStringList::const_iterator it = all.begin(); it != all.end(); ++it ){
+			if( result.contains( *it ) )
+				continue;
+
+			QMap<QString, QStringList>::const_iterator itChildren = children.find( *it );
+			if( itChildren == children.end() )
+				continue;
+
+			for( QStringList::const_iterator itChild = itChildren.data().begin(); itChild != itChildren.data().end(); ++itChild )
+				if( result.contains( *itChild ) ){
+					result.append( *it );
+					changed = true;
+					break;
+				}
+		}
+	}
+
+	return result;
+}
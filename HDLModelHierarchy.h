@@ -0,0 +1,94 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelHierarchy.h: interface for the HDLModelHierarchy class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLMODELHIERARCHY_H_)
+#define _HDLMODELHIERARCHY_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qmap.h>
+#include <qvaluelist.h>
+
+class LibraryManager;
+class LMLibrary;
+class LMComponent;
+
+// Librera con los modelos del proyecto como componentes
+#define MODELS_LIBRARY_NAME "Modelos"
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLModelHierarchy
+//
+//	Modelos jerrquicos: cada documento del proyecto puede instanciarse en
+//	otro como un componente de la librera MODELS_LIBRARY_NAME, cuya
+//	interfaz se toma del fichero de seales (sim/documento.sig) generado
+//	junto con su HDL. El HDL del padre slo instancia la entidad del hijo,
+//	as que cada submodelo se genera y compila una nica vez.
+//
+//	Mantiene la librera de modelos, los submodelos de cada documento
+//	(memorizados segn la fecha de su fichero) y el orden de construccin
+//	por niveles: un documento se construye despus de sus submodelos, de
+//	forma que su interfaz ya est al da.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLModelHierarchy
+{
+public:
+	HDLModelHierarchy( LibraryManager & libraries );
+	~HDLModelHierarchy();
+
+	// Asocia la librera de modelos al proyecto projectPath con los ficheros
+	// de seales ya generados de docs, y la desasocia (sin eliminarla)
+	LMLibrary * attach( const QString & projectPath, const QStringList & docs );
+	void detach();
+	LMLibrary * library() const;
+
+	// Actualiza el componente de doc a partir de su fichero de seales
+	LMComponent * updateComponent( const QString & doc );
+
+	// Submodelos instanciados por doc segn su fichero de modelo
+	QStringList submodels( const QString & doc );
+
+	// Hash de las interfaces (ficheros .sig) de los submodelos
+	QString interfacesHash( const QStringList & submodels ) const;
+
+	// Reparto de docs en niveles (cada documento despus de sus submodelos).
+	// Devuelve false si hay ciclos: los documentos implicados se devuelven
+	// en cyclic y no forman parte de ningn nivel
+	static bool levels( const QStringList & docs, const QMap<QString, QStringList> & children,
+						QValueList<QStringList> & levels, QStringList & cyclic );
+
+	// docs y los documentos de all que los instancian directa o indirectamente
+	static QStringList dependents( const QStringList & docs, const QStringList & all,
+								   const QMap<QString, QStringList> & children );
+
+private:
+	LibraryManager & libs;
+	LMLibrary * lib;
+	QString pth;
+
+	// Submodelos memorizados y fecha del modelo del que se obtuvieron
+	QMap<QString, QStringList> children;
+	QMap<QString, uint> childrenTimes;
+};
+
+#endif
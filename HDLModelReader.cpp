@@ -0,0 +1,416 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelReader.cpp: implementation of the HDLModelReader class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLModelReader.h"
+
+#include <qobject.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qdir.h>
+
+#include "LEItem.h"
+#include "LogicEditor.h"
+#include "LMComponent.h"
+#include "LEBinaryModel.h"
+#include "LibraryManager.h"
+#include "HDLModelGraph.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLModelReader::HDLModelReader( LibraryManager & libraries, HDLModelGraph & target )
+	: libs( libraries ), graph( target )
+{
+	depth = 0;
+	nameCount = 0;
+}
+
+void HDLModelReader::clear()
+{
+	graph.clear();
+	mdlName = QString::null;
+	errStr = QString::null;
+	depth = 0;
+	refs.clear();
+	deviceNames.clear();
+	wireNames.clear();
+	parents.clear();
+	wireEnds.clear();
+	pendingWireLines.clear();
+}
+
+bool HDLModelReader::read( QIODevice * device )
+{
+	QXmlInputSource source( device );
+	QXmlSimpleReader reader;
+
+	reader.setContentHandler( this );
+	reader.setErrorHandler( this );
+
+	return reader.parse( &source );
+}
+
+// Los registros del modelo binario se cargan en orden: todos los
+// dispositivos preceden a los cables, as que no hay aplazamientos
+bool HDLModelReader::readBinary( const QString & fileName )
+{
+	LEBinaryModel model;
+	int i;
+
+	clear();
+
+	if( !model.map( fileName ) ){
+		errStr = QObject::tr("Error cargando modelo: '%1' no es un modelo binario vlido.").arg(fileName);
+		qWarning( errStr );
+		return false;
+	}
+
+	mdlName = model.modelName();
+
+	for( i=0; i < model.deviceCount(); i++ ){
+		const LEBinaryModel::DeviceRecord & rec = model.device( i );
+		addDevice( model.string( rec.name ), model.string( rec.library ), model.string( rec.component ), QPoint( rec.x, rec.y ) );
+	}
+
+	for( i=0; i < model.wireLineCount(); i++ ){
+		const LEBinaryModel::WireLineRecord & rec = model.wireLine( i );
+		addWireLine( model.string( rec.name ), model.string( rec.leftConnection ), model.string( rec.rightConnection ),
+					 rec.busWidth, rec.sliceOffset, model.vertexs( rec ) );
+	}
+
+	resolveNets();
+
+	return true;
+}
+
+QFileInfo HDLModelReader::modelFile( const QString & projectPath, const QString & doc )
+{
+	QDir projectDir( projectPath );
+
+	QFileInfo lemFile( projectDir, QString("%1.lem").arg(doc) );
+	if( !lemFile.exists() )
+		lemFile.setFile( projectDir, QString("%1.lmb").arg(doc) );
+
+	return lemFile;
+}
+
+bool HDLModelReader::readFile( const QString & fileName )
+{
+	if( QFileInfo( fileName ).extension( false ).lower() == "lmb" )
+		return readBinary( fileName );
+
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) ){
+		clear();
+		errStr = QObject::tr("No es posible abrir el modelo %1").arg(fileName);
+		return false;
+	}
+
+	return read( &file );
+}
+
+QString HDLModelReader::modelName() const
+{
+	return mdlName;
+}
+
+QStringList HDLModelReader::references( const QString & libName ) const
+{
+	QMap<QString, QStringList>::const_iterator it = refs.find( libName );
+	return ( it == refs.end() ) ? QStringList() : it.data();
+}
+
+//////////////////////////////////////////////////////////////////////
+// QXmlContentHandler
+//////////////////////////////////////////////////////////////////////
+
+bool HDLModelReader::startDocument()
+{
+	clear();
+	return true;
+}
+
+bool HDLModelReader::startElement( const QString & namespaceURI, const QString & localName,
+								   const QString & qName, const QXmlAttributes & atts )
+{
+	QString tag = ( localName.isEmpty() ? qName : localName ).lower();
+
+	depth++;
+
+	if( depth == 1 ){
+		// Autentificacin de formato
+		if( tag != "model" ){
+			errStr = QObject::tr("Error cargando librera: El fichero no es un modelo.");
+			qWarning( errStr );
+			return false;
+		}
+
+		if( atts.index( "name" ) != -1 )
+			mdlName = atts.value( "name" );
+
+	}else if( depth == 2 ){
+
+		// Elementos del modelo
+		if( tag == "device" ){
+			if( atts.value( "library" ).isEmpty() || atts.value( "template" ).isEmpty() )
+				qWarning( QObject::tr("Error cargando modelo: <device> sin 'library' o 'template'.") );
+			else
+				addDevice( atts.value( "name" ), atts.value( "library" ), atts.value( "template" ),
+						   LogicEditor::parsePoint( atts.value( "offset" ) ) );
+		}else if( tag == "wireline" ){
+			// Si algn extremo hace referencia a un dispositivo an no cargado
+			// el cable se aplaza hasta el final del documento
+			if( isResolvable( atts.value( "leftConnection" ) ) && isResolvable( atts.value( "rightConnection" ) ) )
+				addWireLine( atts );
+			else
+				pendingWireLines.append( atts );
+		}
+	}
+
+	return true;
+}
+
+bool HDLModelReader::endElement( const QString & namespaceURI, const QString & localName, const QString & qName )
+{
+	depth--;
+	return true;
+}
+
+// Resolucin de los cables aplazados (los extremos que siguen sin
+// resolverse quedan desconectados) y de las redes
+bool HDLModelReader::endDocument()
+{
+	QValueList<QXmlAttributes>::iterator it;
+	for( it = pendingWireLines.begin(); it != pendingWireLines.end(); ++it )
+		addWireLine( *it );
+
+	pendingWireLines.clear();
+
+	resolveNets();
+
+	return true;
+}
+
+QString HDLModelReader::errorString()
+{
+	return errStr;
+}
+
+//////////////////////////////////////////////////////////////////////
+// QXmlErrorHandler
+//////////////////////////////////////////////////////////////////////
+
+bool HDLModelReader::fatalError( const QXmlParseException & exception )
+{
+	if( errStr.isEmpty() ){
+		errStr = exception.message();
+		qWarning( QObject::tr("Error cargando el modelo en la lnea %d, columna %d: %s"),
+				  exception.lineNumber(), exception.columnNumber(), errStr.latin1() );
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Carga de elementos
+//////////////////////////////////////////////////////////////////////
+
+// Nombre definitivo de un item: el indicado si es vlido (nico y distinto
+// del de cualquier componente de librera) o, como hace el editor, el
+// nombre base seguido de un contador
+QString HDLModelReader::itemName( const QString & name, const QString & baseName )
+{
+	QString finalName = name;
+
+	if( finalName.isEmpty() )
+		finalName = baseName;
+
+	while( deviceNames.contains( finalName ) || wireNames.contains( finalName ) || libs.findComponent( finalName ) )
+		finalName = baseName + QString::number( ++nameCount );
+
+	return finalName;
+}
+
+bool HDLModelReader::addDevice( const QString & name, const QString & strLib, const QString & strCmp, const QPoint & offset )
+{
+	if( !refs[strLib].contains( strCmp ) )
+		refs[strLib].append( strCmp );
+
+	LMLibrary * lib = libs.find( strLib );
+	if( !lib ){
+		qWarning( QObject::tr("Error cargando modelo: La librera '%1' no existe en el proyecto actual.").arg(strLib) );
+		return false;
+	}
+
+	LMComponent * cmp = lib->find( strCmp );
+	if( !cmp ){
+		qWarning( QObject::tr("Error cargando modelo: El componente '%1' no existe en la librera '%2'.").arg(strCmp).arg(strLib) );
+		return false;
+	}
+
+	QString devName = itemName( name, cmp->name() );
+	int dev = graph.addDevice( devName, cmp, offset );
+	deviceNames.insert( devName, dev );
+
+	// Los pins no forman parte de ninguna red hasta que se les conecta un cable
+	for( int i=0; i < graph.pinCount( dev ); i++ )
+		parents.push_back( -1 );
+
+	return true;
+}
+
+// Como en el editor, un cable con geometra incorrecta se descarta y uno
+// sin geometra slo se crea si ambos extremos existen
+bool HDLModelReader::addWireLine( const QXmlAttributes & atts )
+{
+	QString left = atts.value( "leftConnection" );
+	QString right = atts.value( "rightConnection" );
+	QPointArray points;
+
+	if( !atts.value( "points" ).isEmpty() ){
+		if( !LMComponent::parseShapeString( atts.value( "points" ), points ) ){
+			qWarning( QObject::tr("Error cargando modelo: Imposible cargar <wireline>, formato de linea incorrecto.") );
+			return false;
+		}
+	}else if( resolvePin( left ) == -1 || resolvePin( right ) == -1 )
+		return false;
+
+	int busWidth = 1, sliceOffset = -1;
+	if( !atts.value( "width" ).isEmpty() )
+		busWidth = atts.value( "width" ).toInt();
+	if( !atts.value( "slice" ).isEmpty() )
+		sliceOffset = atts.value( "slice" ).toInt();
+
+	addWireLine( atts.value( "name" ), left, right, busWidth, sliceOffset, points );
+	return true;
+}
+
+void HDLModelReader::addWireLine( const QString & name, const QString & left, const QString & right,
+								  int busWidth, int sliceOffset, const QPointArray & points )
+{
+	QString wlName = itemName( name, "WireLine" );
+	int wl = graph.addWire( wlName, ( busWidth < 1 ) ? 1 : busWidth, ( sliceOffset < 0 ) ? -1 : sliceOffset, points );
+	wireNames.insert( wlName, wl );
+	wireEnds.push_back( -1 );
+
+	int leftPin = resolvePin( left );
+	int rightPin = resolvePin( right );
+
+	// Cable conectado a un pin que el componente ya no tiene: la interfaz
+	// ha cambiado desde que se guard el modelo
+	if( leftPin == -1 && resolveDevice( left ) != -1 )
+		graph.setDeviceMismatch( resolveDevice( left ), true );
+	if( rightPin == -1 && resolveDevice( right ) != -1 )
+		graph.setDeviceMismatch( resolveDevice( right ), true );
+
+	if( leftPin != -1 )
+		connect( wl, leftPin );
+	if( rightPin != -1 )
+		connect( wl, rightPin );
+
+	// Un cable une sus dos extremos en una misma red
+	if( leftPin != -1 && rightPin != -1 ){
+		int i = find( leftPin ), j = find( rightPin );
+		if( i != j )
+			parents[j] = i;
+	}
+}
+
+int HDLModelReader::resolveDevice( const QString & cnnctName ) const
+{
+	if( cnnctName.isEmpty() )
+		return -1;
+
+	QStringList names = QStringList::split( QString("%1").arg(ITEM_NAME_SEPARATOR), cnnctName );
+	if( names.count() != 2 )
+		return -1;
+
+	QMap<QString, int>::const_iterator itDev = deviceNames.find( names[0] );
+	if( itDev == deviceNames.end() )
+		return -1;
+
+	return itDev.data();
+}
+
+int HDLModelReader::resolvePin( const QString & cnnctName ) const
+{
+	int dev = resolveDevice( cnnctName );
+	if( dev == -1 )
+		return -1;
+
+	// Primer pin con ese nombre (como LEDevice::findPin)
+	QStringList names = QStringList::split( QString("%1").arg(ITEM_NAME_SEPARATOR), cnnctName );
+	return graph.findPin( dev, names[1] );
+}
+
+bool HDLModelReader::isResolvable( const QString & cnnctName ) const
+{
+	if( cnnctName.isEmpty() || cnnctName == "null" )
+		return true;
+
+	return resolvePin( cnnctName ) != -1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Redes
+//////////////////////////////////////////////////////////////////////
+
+void HDLModelReader::connect( int wire, int pin )
+{
+	if( parents[pin] == -1 )
+		parents[pin] = pin;
+
+	if( wireEnds[wire] == -1 )
+		wireEnds[wire] = pin;
+
+	// El cable del pin es el primero que se le conect
+	if( graph.pinWire( pin ) == -1 )
+		graph.setPinWire( pin, wire );
+}
+
+int HDLModelReader::find( int pin )
+{
+	int root = pin;
+	while( parents[root] != root )
+		root = parents[root];
+
+	// Compresin del camino
+	while( parents[pin] != root ){
+		int next = parents[pin];
+		parents[pin] = root;
+		pin = next;
+	}
+
+	return root;
+}
+
+// La red de cada pin y cable es el representante de su clase
+void HDLModelReader::resolveNets()
+{
+	int i;
+	for( i=0; i < graph.pinCount(); i++ )
+		graph.setPinNet( i, ( parents[i] == -1 ) ? -1 : find( i ) );
+
+	for( i=0; i < graph.wireCount(); i++ )
+		graph.setWireNet( i, ( wireEnds[i] == -1 ) ? -1 : find( wireEnds[i] ) );
+}
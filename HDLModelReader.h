@@ -0,0 +1,123 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLModelReader.h: interface for the HDLModelReader class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLMODELREADER_H_)
+#define _HDLMODELREADER_H_
+
+#include <qxml.h>
+#include <qfileinfo.h>
+#include <qmap.h>
+#include <qstringlist.h>
+#include <qvaluelist.h>
+#include <qvaluevector.h>
+
+class LibraryManager;
+class HDLModelGraph;
+class QIODevice;
+class QPoint;
+class QPointArray;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLModelReader
+//
+//	Lectura de un modelo (.lem o .lmb) en un HDLModelGraph, sin editor,
+//	lienzo ni items grficos: es la carga que emplea la construccin del
+//	HDL sin interfaz grfica (HDLBatchBuilder).
+//
+//	Reproduce la carga de LogicEditor (LEModelReader y loadBinary) en lo
+//	que afecta a la conectividad: los cables cuyos extremos hacen
+//	referencia a dispositivos an no cargados se aplazan hasta el final
+//	del documento y el primer cable de cada pin es el primero que se le
+//	conect. Las redes se calculan con una estructura union-find sobre
+//	los ndices globales de los pins del grafo.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLModelReader : public QXmlDefaultHandler
+{
+public:
+	HDLModelReader( LibraryManager & libraries, HDLModelGraph & target );
+
+	bool read( QIODevice * device );
+	bool readBinary( const QString & fileName );
+	// Lectura de un fichero .lem o .lmb segn su extensin
+	bool readFile( const QString & fileName );
+
+	// Fichero del modelo doc de un proyecto (XML o, en su defecto, binario)
+	static QFileInfo modelFile( const QString & projectPath, const QString & doc );
+
+	// Nombre del modelo (QString::null si el fichero no lo indica)
+	QString modelName() const;
+
+	// Componentes de la librera libName referenciados por el modelo,
+	// existan o no (ver HDLModelHierarchy)
+	QStringList references( const QString & libName ) const;
+
+	// QXmlContentHandler
+	bool startDocument();
+	bool startElement( const QString & namespaceURI, const QString & localName,
+					   const QString & qName, const QXmlAttributes & atts );
+	bool endElement( const QString & namespaceURI, const QString & localName, const QString & qName );
+	bool endDocument();
+	QString errorString();
+
+	// QXmlErrorHandler
+	bool fatalError( const QXmlParseException & exception );
+
+private:
+	void clear();
+	QString itemName( const QString & name, const QString & baseName );
+
+	// Carga de elementos
+	bool addDevice( const QString & name, const QString & strLib, const QString & strCmp, const QPoint & offset );
+	bool addWireLine( const QXmlAttributes & atts );
+	void addWireLine( const QString & name, const QString & left, const QString & right,
+					  int busWidth, int sliceOffset, const QPointArray & points );
+
+	// Resolucin de un extremo 'dispositivo.pin' (-1 si no existe)
+	int resolveDevice( const QString & cnnctName ) const;
+	int resolvePin( const QString & cnnctName ) const;
+	bool isResolvable( const QString & cnnctName ) const;
+
+	// Conexin de un cable a un pin y clculo final de las redes
+	void connect( int wire, int pin );
+	int find( int pin );
+	void resolveNets();
+
+	LibraryManager & libs;
+	HDLModelGraph & graph;
+
+	QString mdlName;
+	int depth;
+	int nameCount;
+	QString errStr;
+
+	QMap<QString, QStringList> refs;
+	QMap<QString, int> deviceNames;
+	QMap<QString, int> wireNames;
+	QValueVector<int> parents;			// Union-find de los pins
+	QValueVector<int> wireEnds;			// Pin de cada cable (-1 si no tiene)
+
+	// Cables aplazados hasta el final del documento
+	QValueList<QXmlAttributes> pendingWireLines;
+};
+
+#endif
@@ -0,0 +1,560 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLModelSnapshot.cpp: implementation of the HDLModelSnapshot class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLModelSnapshot.h"
+
+#include <qobject.h>
+#include <qtextstream.h>
+#include <qdeepcopy.h>
+#include <qmap.h>
+#include <qvaluevector.h>
+
+#include "LEPin.h"
+#include "LMComponent.h"
+#include "LogicEditor.h"
+#include "HDLModelGraph.h"
+#include "HDLBuildState.h"
+
+// Las cadenas del snapshot no comparten datos con las del modelo
+static QString deepCopy( const QString & str )
+{
+	return QDeepCopy<QString>( str );
+}
+
+// Sentido de un pin visto desde el puerto de la entidad (invertido)
+static HDLModelSnapshot::PortMode portMode( const LMPinDescription & pin )
+{
+	switch( pin.accessMode() ){
+	case LEPin::Input:
+		return HDLModelSnapshot::Out;
+	case LEPin::Output:
+		return HDLModelSnapshot::In;
+	default:
+		return HDLModelSnapshot::InOut;
+	}
+}
+
+// Seal de un pin de pinWidth bits conectado a una red de netWidth bits
+// mediante un cable: la red completa o, si el pin es ms estrecho, la
+// porcin que indica el cable (desde el bit 0 si no lo indica). Requiere
+// que la porcin quepa en la red (ver sliceFits)
+static QString sliceName( const QString & sigName, int netWidth, int pinWidth, int sliceOffset )
+{
+	if( pinWidth == netWidth )
+		return sigName;
+
+	int offset = ( sliceOffset >= 0 ) ? sliceOffset : 0;
+	if( pinWidth == 1 )
+		return QString( "%1(%2)" ).arg( sigName ).arg( offset );
+
+	return QString( "%1(%2 DOWNTO %3)" ).arg( sigName ).arg( offset + pinWidth - 1 ).arg( offset );
+}
+
+static bool sliceFits( int netWidth, int pinWidth, int sliceOffset )
+{
+	if( pinWidth >= netWidth )
+		return pinWidth == netWidth;
+
+	int offset = ( sliceOffset >= 0 ) ? sliceOffset : 0;
+	return offset <= netWidth - pinWidth;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLModelSnapshot::HDLModelSnapshot()
+{
+}
+
+QString HDLModelSnapshot::entity() const
+{
+	return ent;
+}
+
+const QValueList<HDLModelSnapshot::Port> & HDLModelSnapshot::portList() const
+{
+	return ports;
+}
+
+const QValueList<HDLModelSnapshot::Component> & HDLModelSnapshot::componentList() const
+{
+	return comps;
+}
+
+const QStringList & HDLModelSnapshot::signalList() const
+{
+	return sigs;
+}
+
+const QValueList<HDLModelSnapshot::Instance> & HDLModelSnapshot::instanceList() const
+{
+	return insts;
+}
+
+QString HDLModelSnapshot::errorString() const
+{
+	return errStr;
+}
+
+int HDLModelSnapshot::signalWidth( const QString & signal ) const
+{
+	QMap<QString, int>::const_iterator it = sigWidths.find( signal );
+	return ( it != sigWidths.end() ) ? it.data() : 1;
+}
+
+QString HDLModelSnapshot::hash() const
+{
+	QString data;
+	QTextStream out( &data, IO_WriteOnly );
+
+	out << ent << "\n";
+
+	QValueList<Port>::const_iterator itPort;
+	for( itPort = ports.begin(); itPort != ports.end(); ++itPort ){
+		out << "port\t" << (*itPort).name << "\t" << (int)(*itPort).mode;
+		if( (*itPort).width > 1 )
+			out << "\t" << (*itPort).width;
+		out << "\n";
+	}
+
+	QValueList<Component>::const_iterator itCmp;
+	for( itCmp = comps.begin(); itCmp != comps.end(); ++itCmp ){
+		out << "component\t" << (*itCmp).name << "\n";
+		for( itPort = (*itCmp).pins.begin(); itPort != (*itCmp).pins.end(); ++itPort ){
+			out << "pin\t" << (*itPort).name << "\t" << (int)(*itPort).mode;
+			if( (*itPort).width > 1 )
+				out << "\t" << (*itPort).width;
+			out << "\n";
+		}
+	}
+
+	QStringList::const_iterator itStr;
+	for( itStr = sigs.begin(); itStr != sigs.end(); ++itStr ){
+		out << "signal\t" << *itStr;
+		if( signalWidth( *itStr ) > 1 )
+			out << "\t" << signalWidth( *itStr );
+		out << "\n";
+	}
+
+	QValueList<Instance>::const_iterator itInst;
+	for( itInst = insts.begin(); itInst != insts.end(); ++itInst ){
+		out << "instance\t" << (*itInst).name << "\t" << (*itInst).component << "\n";
+		for( itStr = (*itInst).portMap.begin(); itStr != (*itInst).portMap.end(); ++itStr )
+			out << "map\t" << ( (*itStr).isNull() ? QString("-") : "=" + *itStr ) << "\n";
+	}
+
+	return HDLBuildState::hashString( data );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Captura
+//////////////////////////////////////////////////////////////////////
+
+bool HDLModelSnapshot::capture( const QString & entity, LogicEditor * editor )
+{
+	if( !editor ){
+		ports.clear();
+		comps.clear();
+		sigs.clear();
+		sigWidths.clear();
+		insts.clear();
+		errStr = QString::null;
+		return false;
+	}
+
+	return capture( entity, editor->modelGraph() );
+}
+
+// Captura a partir de una netlist con los dispositivos y cables del modelo
+bool HDLModelSnapshot::capture( const QString & entity, HDLNetlist & netlist )
+{
+	HDLModelGraph graph;
+	graph.build( netlist );
+
+	return capture( entity, graph );
+}
+
+bool HDLModelSnapshot::capture( const QString & entity, const HDLModelGraph & graph )
+{
+	ports.clear();
+	comps.clear();
+	sigs.clear();
+	sigWidths.clear();
+	insts.clear();
+	errStr = QString::null;
+
+	ent = deepCopy( entity );
+
+	// Instancias (slo los dispositivos originales, no los duplicados ni
+	// los eliminados del grafo vivo del editor)
+	QValueList<int> intDevs, extDevs;
+	QValueList<int>::iterator itDev;
+	int i;
+	for( i=0; i < graph.deviceCount(); i++ )
+		if( graph.deviceComponent(i) && LogicEditor::extractDupNameIndex( graph.deviceName(i) ) == -1 ){
+			// Componente con una interfaz distinta de la del dispositivo colocado
+			// (p.ej. un submodelo cuyos puertos han cambiado): no se empareja
+			if( !graph.interfaceMatches(i) ){
+				errStr = QObject::tr("Los pins de %1 no coinciden con la interfaz actual de %2: vuelva a insertar el componente.")
+					.arg( graph.deviceName(i) ).arg( graph.deviceComponent(i)->name() );
+				return false;
+			}
+
+			if( graph.deviceComponent(i)->isExternSolving() )
+				extDevs.append( i );
+			else
+				intDevs.append( i );
+		}
+
+	// Tablas indexadas por red: pin externo con el que se mapea (o, para las
+	// redes internas, el primer cable del primer pin que la alcanza), ancho
+	// (el mayor de los de sus cables y su pin externo) y nombre de su seal
+	int netCount = graph.netCount();
+	QValueVector<int> extPins( netCount, -1 );
+	QValueVector<const LMPinDescription*> extDescs( netCount, 0 );
+	QValueVector<int> intWires( netCount, -1 );
+	QValueVector<int> netWidths( netCount, 0 );
+	QValueVector<QString> netNames( netCount );
+
+	for( itDev = extDevs.begin(); itDev != extDevs.end(); ++itDev ){
+		PinList::const_iterator itPin = graph.deviceComponent( *itDev )->pinList().begin();
+		int pin = graph.firstPin( *itDev ), end = pin + graph.pinCount( *itDev );
+		for( ; pin < end; pin++, ++itPin ){
+			int n = graph.pinNet( pin );
+			if( n != -1 && extPins[n] == -1 ){
+				extPins[n] = pin;
+				extDescs[n] = &(*itPin);
+				netWidths[n] = (*itPin).busWidth();
+			}
+		}
+	}
+
+	for( itDev = intDevs.begin(); itDev != intDevs.end(); ++itDev ){
+		int pin = graph.firstPin( *itDev ), end = pin + graph.pinCount( *itDev );
+		for( ; pin < end; pin++ ){
+			int n = graph.pinNet( pin );
+			if( n == -1 || extPins[n] != -1 || intWires[n] != -1 )
+				continue;
+
+			intWires[n] = graph.pinWire( pin );
+		}
+	}
+
+	// Cables de las redes mapeadas, por nombre: el orden de declaracin de
+	// puertos y seales
+	QMap<QString, int> wlSorted;
+	for( i=0; i < graph.wireCount(); i++ ){
+		int n = graph.wireNet( i );
+		if( n == -1 )
+			continue;
+
+		if( netWidths[n] < graph.wireBusWidth( i ) )
+			netWidths[n] = graph.wireBusWidth( i );
+
+		if( extPins[n] != -1 || intWires[n] != -1 )
+			wlSorted.insert( graph.wireName( i ), n );
+	}
+
+	// Puerto de la entidad (un puerto por red, en el orden de sus cables)
+	QMap<QString, int>::iterator itWl;
+	for( itWl = wlSorted.begin(); itWl != wlSorted.end(); ++itWl ){
+		int n = itWl.data();
+		if( extPins[n] == -1 || !netNames[n].isNull() )
+			continue;
+
+		Port port;
+		port.name = deepCopy( graph.deviceName( graph.pinDevice( extPins[n] ) ) + "_" + extDescs[n]->name() );
+		port.mode = portMode( *extDescs[n] );
+		port.width = netWidths[n];
+		ports.append( port );
+
+		netNames[n] = port.name;
+	}
+
+	// Seales internas (una por red, en el orden de sus cables)
+	for( itWl = wlSorted.begin(); itWl != wlSorted.end(); ++itWl ){
+		int n = itWl.data();
+		if( !netNames[n].isNull() )
+			continue;
+
+		netNames[n] = deepCopy( graph.wireName( intWires[n] ) );
+		sigs.append( netNames[n] );
+		if( netWidths[n] > 1 )
+			sigWidths.insert( netNames[n], netWidths[n] );
+	}
+
+	// Componentes e instancias
+	QPtrList<LMComponent> cmpRefs;
+	for( itDev = intDevs.begin(); itDev != intDevs.end(); ++itDev ){
+		LMComponent * cmp = graph.deviceComponent( *itDev );
+
+		if( !cmpRefs.containsRef( cmp ) ){
+			cmpRefs.append( cmp );
+			addComponent( cmp );
+		}
+
+		Instance inst;
+		inst.name = deepCopy( graph.deviceName( *itDev ) );
+		inst.component = deepCopy( cmp->name() );
+
+		PinList::const_iterator itPin = cmp->pinList().begin();
+		int pin = graph.firstPin( *itDev ), end = pin + graph.pinCount( *itDev );
+		for( ; pin < end; pin++, ++itPin ){
+			QString sigName;
+
+			// La seal del pin es la de la red de su cable
+			int w = graph.pinWire( pin );
+			int n = ( w != -1 ) ? graph.wireNet( w ) : -1;
+			if( n != -1 && !netNames[n].isNull() ){
+				if( sliceFits( netWidths[n], (*itPin).busWidth(), graph.wireSliceOffset( w ) ) )
+					sigName = sliceName( netNames[n], netWidths[n], (*itPin).busWidth(), graph.wireSliceOffset( w ) );
+				else if( errStr.isNull() )
+					errStr = QObject::tr("El pin %1 de %2 (%3 bits) no cabe en la seal %4 (%5 bits, desde el bit %6).")
+						.arg( (*itPin).name() ).arg( inst.name ).arg( (*itPin).busWidth() )
+						.arg( netNames[n] ).arg( netWidths[n] ).arg( QMAX( graph.wireSliceOffset( w ), 0 ) );
+			}
+
+			inst.portMap.append( sigName );
+		}
+
+		insts.append( inst );
+	}
+
+	return errStr.isNull();
+}
+
+void HDLModelSnapshot::addComponent( LMComponent * cmp )
+{
+	Component comp;
+	comp.name = deepCopy( cmp->name() );
+
+	for( PinList::iterator it = cmp->pinList().begin(); it != cmp->pinList().end(); ++it ){
+		Port pin;
+		pin.name = deepCopy( (*it).name() );
+		pin.width = (*it).busWidth();
+
+		if( (*it).accessMode() == LEPin::Input )
+			pin.mode = In;
+		else if( (*it).accessMode() == LEPin::Output )
+			pin.mode = Out;
+		else
+			pin.mode = InOut;
+
+		comp.pins.append( pin );
+	}
+
+	comps.append( comp );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Volcado
+//////////////////////////////////////////////////////////////////////
+
+// Volcado por bloques: el texto se acumula en un buffer que se vuelca en
+// el stream cada BufferSize caracteres (y al destruirse), en lugar de
+// pasar por el codec del QTextStream en cada fragmento
+class HDLWriter
+{
+public:
+	enum { BufferSize = 64*1024 };
+
+	HDLWriter( QTextStream & out ) : stream( out )
+	{
+		buffer.reserve( BufferSize + 1024 );
+	}
+
+	~HDLWriter()
+	{
+		flush();
+	}
+
+	HDLWriter & operator<<( const QString & str )
+	{
+		buffer += str;
+		if( buffer.length() >= BufferSize )
+			flush();
+		return *this;
+	}
+
+	HDLWriter & operator<<( const char * str )
+	{
+		buffer += str;
+		if( buffer.length() >= BufferSize )
+			flush();
+		return *this;
+	}
+
+	HDLWriter & operator<<( int n )
+	{
+		return *this << QString::number( n );
+	}
+
+	void flush()
+	{
+		if( !buffer.isEmpty() ){
+			stream << buffer;
+
+			// truncate() libera la memoria: un bloque por volcado
+			buffer.truncate( 0 );
+			buffer.reserve( BufferSize + 1024 );
+		}
+	}
+
+private:
+	QTextStream & stream;
+	QString buffer;
+};
+
+static const char * modeName( HDLModelSnapshot::PortMode mode )
+{
+	switch( mode ){
+	case HDLModelSnapshot::In:
+		return "IN";
+	case HDLModelSnapshot::Out:
+		return "OUT";
+	case HDLModelSnapshot::InOut:
+		return "INOUT";
+	default:
+		return "";
+	}
+}
+
+// Tipo VHDL de una red de width bits
+static QString typeName( int width )
+{
+	if( width <= 1 )
+		return "BIT";
+
+	return QString( "BIT_VECTOR(%1 DOWNTO 0)" ).arg( width - 1 );
+}
+
+// Lista PORT( ... ); de la entidad o de un componente
+static void writePorts( HDLWriter & out, const char * indent, const QValueList<HDLModelSnapshot::Port> & ports )
+{
+	out << indent << "PORT( ";
+
+	QValueList<HDLModelSnapshot::Port>::const_iterator itPort;
+	for( itPort = ports.begin(); itPort != ports.end(); ++itPort ){
+		if( itPort != ports.begin() )
+			out << "; ";
+
+		out << (*itPort).name;
+		if( (*itPort).mode != HDLModelSnapshot::None )
+			out << " : " << modeName( (*itPort).mode ) << " " << typeName( (*itPort).width );
+	}
+
+	out << ");\n";
+}
+
+bool HDLModelSnapshot::writeHDL( QTextStream & dataOut ) const
+{
+	if( ports.isEmpty() )
+		return false;
+
+	HDLWriter out( dataOut );
+
+	// ENTITY
+	out << "ENTITY " << ent << " IS\n";
+	writePorts( out, "\t", ports );
+	out << "END " << ent << ";\n\n";
+
+	// ARCHITECTURE
+	out << "ARCHITECTURE estructural OF " << ent << " IS\n";
+
+	// Enumeracin de componentes requeridos
+	QValueList<Component>::const_iterator itCmp;
+	for( itCmp = comps.begin(); itCmp != comps.end(); ++itCmp ){
+		out << "\tCOMPONENT " << (*itCmp).name << "\n";
+		if( !(*itCmp).pins.isEmpty() )
+			writePorts( out, "\t\t", (*itCmp).pins );
+		out << "\tEND COMPONENT;\n";
+	}
+	out << "\n";
+
+	// SIGNAL (una seal por red). Una declaracin por ancho, empezando
+	// por las seales escalares
+	if( !sigs.isEmpty() ){
+		QMap<int, QStringList> groups;
+		for( QStringList::const_iterator itSig = sigs.begin(); itSig != sigs.end(); ++itSig )
+			groups[ signalWidth( *itSig ) ].append( *itSig );
+
+		QMap<int, QStringList>::const_iterator itGroup;
+		for( itGroup = groups.begin(); itGroup != groups.end(); ++itGroup ){
+			out << "\tSIGNAL ";
+
+			QStringList::const_iterator itName;
+			for( itName = itGroup.data().begin(); itName != itGroup.data().end(); ++itName ){
+				if( itName != itGroup.data().begin() )
+					out << ", ";
+				out << *itName;
+			}
+
+			out << ": " << typeName( itGroup.key() ) << ";\n";
+		}
+		out << "\n";
+	}
+
+	// BEGIN
+	out << "\tBEGIN\n";
+
+	QValueList<Instance>::const_iterator itInst;
+	for( itInst = insts.begin(); itInst != insts.end(); ++itInst ){
+		out << "\t\t" << (*itInst).name << " : " << (*itInst).component << " PORT MAP( ";
+
+		QStringList::const_iterator itMap = (*itInst).portMap.begin();
+		if( itMap != (*itInst).portMap.end() ){
+			out << *itMap;
+			for( ++itMap; itMap != (*itInst).portMap.end(); ++itMap )
+				if( !(*itMap).isNull() )
+					out << ", " << *itMap;
+		}
+
+		out << ");\n\n";
+	}
+
+	// END
+	out << "END estructural;";
+
+	return true;
+}
+
+bool HDLModelSnapshot::writeSignals( QTextStream & dataOut ) const
+{
+	if( ports.isEmpty() )
+		return false;
+
+	HDLWriter out( dataOut );
+
+	out << "<signals entity=\"" << ent << "\">\n\n";
+
+	QValueList<Port>::const_iterator itPort;
+	for( itPort = ports.begin(); itPort != ports.end(); ++itPort ){
+		out << "\t<signal accessMode=\"" << modeName( (*itPort).mode ) << "\"";
+		if( (*itPort).width > 1 )
+			out << " width=\"" << (*itPort).width << "\"";
+		out << ">" << (*itPort).name << "</signal>\n";
+	}
+
+	out << "\n</signals>\n\n";
+
+	return true;
+}
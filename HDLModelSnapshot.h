@@ -0,0 +1,131 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLModelSnapshot.h: interface for the HDLModelSnapshot class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLMODELSNAPSHOT_H_)
+#define _HDLMODELSNAPSHOT_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluelist.h>
+#include <qmap.h>
+
+class LogicEditor;
+class HDLNetlist;
+class HDLModelGraph;
+class LMComponent;
+class QTextStream;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLModelSnapshot
+//
+//	Copia independiente de la interfaz grfica de todo lo que necesita la
+//	generacin de los ficheros .vhd y .sig de un modelo: puerto de la
+//	entidad, componentes, seales internas e instancias con su mapeado.
+//
+//	Las redes pueden ser buses: su ancho es el mayor de los de sus cables
+//	(y del pin externo que las mapea) y se declaran como BIT_VECTOR. Un pin
+//	ms estrecho que su red se mapea con la porcin indicada por el cable
+//	que lo conecta (LEWireLine::sliceOffset). Un pin ms ancho que su red, o
+//	cuya porcin se sale de ella, es un error de captura (ver errorString).
+//	Las concatenaciones (un pin alimentado por bits de varias redes) no
+//	estn soportadas: requieren que un pin pueda pertenecer a ms de una
+//	red en HDLModelReader, HDLNetlist y HDLLiveGraph, y quedan aplazadas.
+//
+//	La captura resuelve las redes con tablas indexadas por red (ver
+//	HDLModelGraph::netCount), de forma que la seal de cada pin de una
+//	instancia es una consulta directa. El volcado escribe en bloques
+//	grandes sobre el stream destino.
+//
+//	Se captura en el hilo principal a partir de la netlist del editor y
+//	slo contiene copias profundas de cadenas, as que puede volcarse desde
+//	cualquier hilo mientras el documento sigue editndose.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLModelSnapshot
+{
+	friend class HDLNetlistOptimizer;
+
+public:
+	// Sentido de un puerto (None si el item mapeado no es un pin)
+	enum PortMode { None, In, Out, InOut };
+
+	struct Port{
+		QString name;
+		PortMode mode;
+		int width;		// Nmero de bits (1 = BIT)
+	};
+
+	struct Component{
+		QString name;
+		QValueList<Port> pins;
+	};
+
+	struct Instance{
+		QString name;
+		QString component;
+		QStringList portMap;	// Seal (o porcin) de cada pin (QString::null si no tiene)
+	};
+
+	HDLModelSnapshot();
+
+	// Captura el modelo del editor, de una netlist o de un grafo ledo sin
+	// interfaz grfica (ver HDLModelGraph). Devuelve false si algn pin no
+	// cabe en la red a la que se conecta
+	bool capture( const QString & entity, LogicEditor * editor );
+	bool capture( const QString & entity, HDLNetlist & netlist );
+	bool capture( const QString & entity, const HDLModelGraph & graph );
+
+	// Error de la ltima captura (QString::null si no lo hubo)
+	QString errorString() const;
+
+	QString entity() const;
+
+	// Contenido capturado
+	const QValueList<Port> & portList() const;
+	const QValueList<Component> & componentList() const;
+	const QStringList & signalList() const;
+	const QValueList<Instance> & instanceList() const;
+
+	// Nmero de bits de una seal interna (1 si no es un bus)
+	int signalWidth( const QString & signal ) const;
+
+	// Hash del contenido capturado: identifica la netlist del modelo con
+	// independencia de su geometra
+	QString hash() const;
+
+	// Volcado. Devuelven false si el modelo no tiene seales externas
+	bool writeHDL( QTextStream & out ) const;
+	bool writeSignals( QTextStream & out ) const;
+
+private:
+	void addComponent( LMComponent * cmp );
+
+	QString ent;
+	QValueList<Port> ports;
+	QValueList<Component> comps;
+	QStringList sigs;
+	QMap<QString, int> sigWidths;	// Slo las seales de ms de un bit
+	QValueList<Instance> insts;
+
+	QString errStr;
+};
+
+#endif
@@ -0,0 +1,332 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLNetlist.cpp: implementation of the HDLNetlist class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLNetlist.h"
+
+#include "LEWireLine.h"
+#include "LEConnectionPoint.h"
+#include "LEDevice.h"
+#include "LEPin.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLNetlist::HDLNetlist()
+	: trackChanges( false )
+{
+}
+
+void HDLNetlist::clear()
+{
+	nodes.clear();
+	points.clear();
+	parents.clear();
+	ranks.clear();
+	nexts.clear();
+	freeNodes.clear();
+	devs.clear();
+	wires.clear();
+	changedPoints.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Dispositivos
+//////////////////////////////////////////////////////////////////////
+
+void HDLNetlist::insertDevice( LEDevice * dev )
+{
+	if( devs.findRef( dev ) == -1 )
+		devs.append( dev );
+}
+
+// Elimina el dispositivo y los nodos de sus pines, recalculando slo
+// las redes a las que estaban conectados
+void HDLNetlist::removeDevice( LEDevice * dev )
+{
+	devs.removeRef( dev );
+
+	QPtrList<LEPin> & pins = dev->pinList();
+	for( LEPin * pin = pins.first(); pin; pin = pins.next() ){
+		int i = lookup( pin->connectionPoint() );
+		if( i != -1 )
+			rebuild( i, true );
+	}
+}
+
+QPtrList<LEDevice> & HDLNetlist::devices()
+{
+	return devs;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin de las redes
+//////////////////////////////////////////////////////////////////////
+
+// Registra el cable y une sus extremos. Un cable con un nico extremo
+// conectado se limita a registrar ese nodo
+void HDLNetlist::insertWireLine( LEWireLine * wl )
+{
+	int left = -1, right = -1;
+
+	wires.replace( wl, wl );
+
+	if( wl->leftConnection() )
+		left = node( wl->leftConnection() );
+	if( wl->rightConnection() )
+		right = node( wl->rightConnection() );
+
+	if( left != -1 && right != -1 )
+		join( left, right );
+}
+
+// Elimina el cable, recalculando la red que una. Ambos extremos
+// pertenecen a la misma red, por lo que basta con recalcular una
+void HDLNetlist::removeWireLine( LEWireLine * wl )
+{
+	if( !wires.take( wl ) )
+		return;
+
+	if( wl->leftConnection() )
+		split( wl->leftConnection() );
+	else if( wl->rightConnection() )
+		split( wl->rightConnection() );
+}
+
+QPtrDict<LEWireLine> & HDLNetlist::wireLines()
+{
+	return wires;
+}
+
+// Une dos puntos de conexin enlazados directamente (dispositivos duplicados)
+void HDLNetlist::insertLink( LEConnectionPoint * cp1, LEConnectionPoint * cp2 )
+{
+	join( node( cp1 ), node( cp2 ) );
+}
+
+void HDLNetlist::split( LEConnectionPoint * cp )
+{
+	int i = lookup( cp );
+	if( i != -1 )
+		rebuild( i, false );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consulta
+//////////////////////////////////////////////////////////////////////
+
+int HDLNetlist::net( LEConnectionPoint * cp )
+{
+	int i = lookup( cp );
+	if( i == -1 )
+		return -1;
+
+	return find( i );
+}
+
+int HDLNetlist::net( LEWireLine * wl )
+{
+	// Ambos extremos pertenecen a la misma red, basta con uno de ellos
+	if( wl->leftConnection() )
+		return net( wl->leftConnection() );
+	if( wl->rightConnection() )
+		return net( wl->rightConnection() );
+
+	return -1;
+}
+
+int HDLNetlist::nodeCount() const
+{
+	return nodes.count();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Registro de cambios
+//////////////////////////////////////////////////////////////////////
+
+void HDLNetlist::setTrackChanges( bool track )
+{
+	trackChanges = track;
+	changedPoints.clear();
+}
+
+QPtrList<LEConnectionPoint> HDLNetlist::takeChangedPoints()
+{
+	QPtrList<LEConnectionPoint> list;
+	for( QPtrDictIterator<LEConnectionPoint> it( changedPoints ); it.current(); ++it )
+		list.append( it.current() );
+
+	changedPoints.clear();
+	return list;
+}
+
+void HDLNetlist::markChanged( int i )
+{
+	if( changedPoints.count() > changedPoints.size() )
+		changedPoints.resize( 2*changedPoints.size() + 1 );
+	changedPoints.replace( points[i], points[i] );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Union-find
+//////////////////////////////////////////////////////////////////////
+
+// Devuelve el ndice del nodo asociado a cp, crendolo si no existe
+// (reutiliza los ndices de los nodos eliminados)
+int HDLNetlist::node( LEConnectionPoint * cp )
+{
+	int i = lookup( cp );
+	if( i != -1 )
+		return i;
+
+	if( !freeNodes.isEmpty() ){
+		i = freeNodes.first();
+		freeNodes.remove( freeNodes.begin() );
+		points[i] = cp;
+		parents[i] = i;
+		ranks[i] = 0;
+		nexts[i] = i;
+	}else{
+		i = parents.count();
+		points.push_back( cp );
+		parents.push_back( i );
+		ranks.push_back( 0 );
+		nexts.push_back( i );
+	}
+	nodes.insert( cp, i );
+
+	if( trackChanges )
+		markChanged( i );
+
+	return i;
+}
+
+int HDLNetlist::lookup( LEConnectionPoint * cp ) const
+{
+	QMap<LEConnectionPoint*, int>::const_iterator it = nodes.find( cp );
+	if( it == nodes.end() )
+		return -1;
+
+	return it.data();
+}
+
+// Representante de la clase de i (con compresin de caminos)
+int HDLNetlist::find( int i )
+{
+	int root = i;
+	while( parents[root] != root )
+		root = parents[root];
+
+	while( parents[i] != root ){
+		int next = parents[i];
+		parents[i] = root;
+		i = next;
+	}
+
+	return root;
+}
+
+// Unin por rango de las clases de i y j. Los anillos de miembros de
+// ambas clases se fusionan intercambiando sus sucesores
+void HDLNetlist::join( int i, int j )
+{
+	i = find( i );
+	j = find( j );
+	if( i == j )
+		return;
+
+	// Tras la unin, los miembros de la clase absorbida cambian de red
+	int absorbed = ( ranks[i] < ranks[j] ) ? i : j;
+	if( trackChanges ){
+		int k = absorbed;
+		do{
+			markChanged( k );
+			k = nexts[k];
+		}while( k != absorbed );
+	}
+
+	int next = nexts[i];
+	nexts[i] = nexts[j];
+	nexts[j] = next;
+
+	if( absorbed == i )
+		parents[i] = j;
+	else{
+		parents[j] = i;
+		if( ranks[i] == ranks[j] )
+			ranks[i]++;
+	}
+}
+
+// Recalcula la red que contiene al nodo i a partir de la conectividad
+// actual de sus miembros (opcionalmente eliminando el nodo i). El coste
+// es proporcional al tamao de la red, no al del modelo
+void HDLNetlist::rebuild( int i, bool excludeNode )
+{
+	QValueList<int> members;
+	QValueList<int>::iterator it;
+
+	int k = i;
+	do{
+		members.append( k );
+		k = nexts[k];
+	}while( k != i );
+
+	for( it = members.begin(); it != members.end(); ++it ){
+		if( trackChanges )
+			markChanged( *it );
+		parents[*it] = *it;
+		ranks[*it] = 0;
+		nexts[*it] = *it;
+	}
+
+	if( excludeNode ){
+		nodes.remove( points[i] );
+		points[i] = 0;
+		freeNodes.append( i );
+	}
+
+	for( it = members.begin(); it != members.end(); ++it ){
+		if( excludeNode && *it == i )
+			continue;
+
+		LEConnectionPoint * cp = points[*it];
+		ConnectionList & cnncts = cp->connectionList();
+		for( LEItem * item = cnncts.first(); item; item = cnncts.next() ){
+			int j = -1;
+
+			if( item->rtti() == LEWireLine::RTTI ){
+				// Slo cuentan los cables registrados y conectados a cp
+				LEWireLine * wl = (LEWireLine*) item;
+				if( !wires.find( wl ) )
+					continue;
+				if( wl->leftConnection() == cp && wl->rightConnection() )
+					j = lookup( wl->rightConnection() );
+				else if( wl->rightConnection() == cp && wl->leftConnection() )
+					j = lookup( wl->leftConnection() );
+			}else if( item->rtti() == LEConnectionPoint::RTTI )
+				j = lookup( (LEConnectionPoint*) item );
+
+			if( j != -1 )
+				join( *it, j );
+		}
+	}
+}
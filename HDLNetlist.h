@@ -0,0 +1,120 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// HDLNetlist.h: interface for the HDLNetlist class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLNETLIST_H_)
+#define _HDLNETLIST_H_
+
+#include <qmap.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+#include <qptrlist.h>
+#include <qptrdict.h>
+
+class LEConnectionPoint;
+class LEWireLine;
+class LEDevice;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLNetlist
+//
+//	Extraccin de las redes (nets) de un modelo.
+//
+//	Cada LEConnectionPoint es un nodo de una estructura union-find. Un
+//	LEWireLine une los nodos de sus dos extremos y una conexin simtrica
+//	puntoDeConexin-puntoDeConexin (LEDevice duplicados) une ambos puntos.
+//	Una red es una clase de equivalencia de nodos, identificada por el
+//	ndice de su representante.
+//
+//	La netlist puede construirse en un nico recorrido del modelo o
+//	mantenerse viva, actualizndose con cada edicin: la unin de redes
+//	es inmediata y la desconexin slo recalcula la red afectada (los
+//	miembros de cada red forman un anillo que permite recorrerla sin
+//	visitar el resto del modelo).
+//
+//	Adems registra los dispositivos (en orden de insercin) y los cables
+//	del modelo, de forma que HDLGenerator no necesita recorrer el lienzo.
+//
+//	Opcionalmente registra los puntos de conexin cuya red ha cambiado
+//	(ver HDLLiveGraph, que slo actualiza esos puntos tras cada edicin).
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLNetlist
+{
+public:
+	HDLNetlist();
+
+	void clear();
+
+	// Dispositivos registrados
+	void insertDevice( LEDevice * dev );
+	void removeDevice( LEDevice * dev );
+	QPtrList<LEDevice> & devices();
+
+	// Cables registrados. Insertar un cable ya registrado actualiza
+	// la unin de sus extremos
+	void insertWireLine( LEWireLine * wl );
+	void removeWireLine( LEWireLine * wl );
+	QPtrDict<LEWireLine> & wireLines();
+
+	// Une dos puntos de conexin enlazados directamente (dispositivos duplicados)
+	void insertLink( LEConnectionPoint * cp1, LEConnectionPoint * cp2 );
+
+	// Recalcula la red que contiene a cp a partir de la conectividad
+	// actual de los items (tras una desconexin)
+	void split( LEConnectionPoint * cp );
+
+	// Identificador de la red a la que pertenece el punto de conexin o el
+	// cable (-1 si no pertenece a ninguna red)
+	int net( LEConnectionPoint * cp );
+	int net( LEWireLine * wl );
+
+	// Nmero de nodos (puntos de conexin) registrados
+	int nodeCount() const;
+
+	// Registro de cambios: con el registro activo, cada punto de conexin
+	// cuya red cambia (unin, reclculo o eliminacin) se anota hasta la
+	// siguiente llamada a takeChangedPoints()
+	void setTrackChanges( bool track );
+	QPtrList<LEConnectionPoint> takeChangedPoints();
+
+private:
+	int node( LEConnectionPoint * cp );
+	int lookup( LEConnectionPoint * cp ) const;
+	int find( int i );
+	void join( int i, int j );
+	void rebuild( int i, bool excludeNode );
+	void markChanged( int i );
+
+	QMap<LEConnectionPoint*, int> nodes;
+	QValueVector<LEConnectionPoint*> points;
+	QValueVector<int> parents;
+	QValueVector<int> ranks;
+	QValueVector<int> nexts;
+	QValueList<int> freeNodes;
+
+	QPtrList<LEDevice> devs;
+	QPtrDict<LEWireLine> wires;
+
+	bool trackChanges;
+	QPtrDict<LEConnectionPoint> changedPoints;
+};
+
+#endif
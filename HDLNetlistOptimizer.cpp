@@ -0,0 +1,659 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLNetlistOptimizer.cpp: implementation of the HDLNetlistOptimizer class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLNetlistOptimizer.h"
+
+#include <qstringlist.h>
+#include <qobject.h>
+
+#include "HDLTruthTable.h"
+
+bool HDLNetlistOptimizer::enabled = false;
+
+// Red a la que pertenece una seal o una porcin de bus ("bus(3)")
+static QString netName( const QString & signal )
+{
+	int pos = signal.find( '(' );
+	return ( pos < 0 ) ? signal : signal.left( pos );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLNetlistOptimizer::HDLNetlistOptimizer()
+	: instsBefore( 0 ), instsAfter( 0 ), nNetsBefore( 0 ), nNetsAfter( 0 )
+{
+}
+
+void HDLNetlistOptimizer::setEnabled( bool enabled )
+{
+	HDLNetlistOptimizer::enabled = enabled;
+}
+
+bool HDLNetlistOptimizer::isEnabled()
+{
+	return enabled;
+}
+
+int HDLNetlistOptimizer::instancesBefore() const
+{
+	return instsBefore;
+}
+
+int HDLNetlistOptimizer::instancesAfter() const
+{
+	return instsAfter;
+}
+
+int HDLNetlistOptimizer::netsBefore() const
+{
+	return nNetsBefore;
+}
+
+int HDLNetlistOptimizer::netsAfter() const
+{
+	return nNetsAfter;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Optimizacin
+//////////////////////////////////////////////////////////////////////
+
+int HDLNetlistOptimizer::optimize( HDLModelSnapshot & snapshot )
+{
+	load( snapshot );
+
+	instsBefore = snapshot.insts.count();
+	nNetsBefore = snapshot.ports.count() + snapshot.sigs.count();
+
+	// Cada transformacin puede habilitar otras: se repiten hasta que
+	// ninguna cambia la netlist
+	int applied = 0, n;
+	do{
+		n = propagateConstants();
+		n += removeInverterPairs();
+		n += mergeGates();
+		n += removeDeadGates();
+		applied += n;
+	}while( n > 0 );
+
+	store( snapshot );
+
+	return applied;
+}
+
+void HDLNetlistOptimizer::load( const HDLModelSnapshot & snapshot )
+{
+	cells.clear();
+	ports.clear();
+	widths.clear();
+
+	QValueList<HDLModelSnapshot::Port>::const_iterator itPort;
+	for( itPort = snapshot.ports.begin(); itPort != snapshot.ports.end(); ++itPort ){
+		ports.insert( (*itPort).name, (*itPort).mode );
+		if( (*itPort).width > 1 )
+			widths.insert( (*itPort).name, (*itPort).width );
+	}
+
+	QStringList::const_iterator itSig;
+	for( itSig = snapshot.sigs.begin(); itSig != snapshot.sigs.end(); ++itSig )
+		if( snapshot.signalWidth( *itSig ) > 1 )
+			widths.insert( *itSig, snapshot.signalWidth( *itSig ) );
+
+	QMap<QString, const HDLModelSnapshot::Component *> comps;
+	QValueList<HDLModelSnapshot::Component>::const_iterator itCmp;
+	for( itCmp = snapshot.comps.begin(); itCmp != snapshot.comps.end(); ++itCmp )
+		comps.insert( (*itCmp).name, &(*itCmp) );
+
+	QValueList<HDLModelSnapshot::Instance>::const_iterator itInst;
+	for( itInst = snapshot.insts.begin(); itInst != snapshot.insts.end(); ++itInst ){
+		Cell cell;
+		cell.inst = *itInst;
+		cell.type = HDLGateKind::Opaque;
+		cell.removed = false;
+
+		const HDLModelSnapshot::Component * cmp = comps[ (*itInst).component ];
+		if( !cmp ){
+			// Sin declaracin: todos sus pines se consideran ledos y excitados
+			for( uint i=0; i < (*itInst).portMap.count(); i++ ){
+				cell.inputs.append( i );
+				cell.outputs.append( i );
+			}
+			cells.push_back( cell );
+			continue;
+		}
+
+		// Pines ledos y excitados (mismo orden en el componente y en el mapeado)
+		bool gate = true;
+		int i = 0;
+		for( itPort = cmp->pins.begin(); itPort != cmp->pins.end() && i < (int)(*itInst).portMap.count(); ++itPort, ++i ){
+			if( (*itPort).mode != HDLModelSnapshot::Out )
+				cell.inputs.append( i );
+			if( (*itPort).mode != HDLModelSnapshot::In )
+				cell.outputs.append( i );
+
+			QString pinName = (*itPort).name.upper();
+			if( (*itPort).width > 1 || (*itPort).mode == HDLModelSnapshot::InOut ||
+				pinName == "CLK" || pinName == "OE" || pinName == "E*" )
+				gate = false;
+		}
+
+		// Puertas lgicas (ver HDLGateKind)
+		HDLGateKind::Kind kind = HDLGateKind::classify( *cmp );
+		if( gate && HDLGateKind::isSimpleGate( kind ) )
+			cell.type = kind;
+
+		// Una nica salida; las constantes sin entradas, los inversores y
+		// buffers con una
+		if( cell.type != HDLGateKind::Opaque ){
+			bool valid = ( cell.outputs.count() == 1 );
+			if( cell.type == HDLGateKind::Vcc || cell.type == HDLGateKind::Gnd )
+				valid = valid && cell.inputs.isEmpty();
+			else if( cell.type == HDLGateKind::Inv || cell.type == HDLGateKind::Buf )
+				valid = valid && cell.inputs.count() == 1;
+			else
+				valid = valid && !cell.inputs.isEmpty();
+
+			if( !valid )
+				cell.type = HDLGateKind::Opaque;
+		}
+
+		cells.push_back( cell );
+	}
+}
+
+void HDLNetlistOptimizer::store( HDLModelSnapshot & snapshot )
+{
+	QMap<QString, bool> usedNets, usedComps;
+
+	snapshot.insts.clear();
+	for( uint i=0; i < cells.count(); i++ ){
+		if( cells[i].removed )
+			continue;
+
+		const HDLModelSnapshot::Instance & inst = cells[i].inst;
+		snapshot.insts.append( inst );
+		usedComps.insert( inst.component, true );
+
+		for( QStringList::const_iterator it = inst.portMap.begin(); it != inst.portMap.end(); ++it )
+			if( !(*it).isNull() )
+				usedNets.insert( netName( *it ), true );
+	}
+
+	// Seales y componentes que ya no se utilizan
+	QStringList::iterator itSig = snapshot.sigs.begin();
+	while( itSig != snapshot.sigs.end() )
+		if( usedNets.contains( *itSig ) )
+			++itSig;
+		else{
+			snapshot.sigWidths.remove( *itSig );
+			itSig = snapshot.sigs.remove( itSig );
+		}
+
+	QValueList<HDLModelSnapshot::Component>::iterator itCmp = snapshot.comps.begin();
+	while( itCmp != snapshot.comps.end() )
+		if( usedComps.contains( (*itCmp).name ) )
+			++itCmp;
+		else
+			itCmp = snapshot.comps.remove( itCmp );
+
+	instsAfter = snapshot.insts.count();
+	nNetsAfter = snapshot.ports.count() + snapshot.sigs.count();
+
+	cells.clear();
+	drivers.clear();
+	readers.clear();
+}
+
+// Calcula las puertas que excitan cada red (-1 si es una entrada de la
+// entidad) y el nmero de pines que la leen (ms uno si es una salida)
+void HDLNetlistOptimizer::index()
+{
+	drivers.clear();
+	readers.clear();
+
+	QMap<QString, HDLModelSnapshot::PortMode>::iterator itPort;
+	for( itPort = ports.begin(); itPort != ports.end(); ++itPort ){
+		if( itPort.data() != HDLModelSnapshot::Out )
+			drivers[ itPort.key() ].append( -1 );
+		if( itPort.data() != HDLModelSnapshot::In )
+			readers[ itPort.key() ]++;
+	}
+
+	for( uint i=0; i < cells.count(); i++ ){
+		if( cells[i].removed )
+			continue;
+
+		const QStringList & portMap = cells[i].inst.portMap;
+		QValueList<int>::const_iterator it;
+		for( it = cells[i].inputs.begin(); it != cells[i].inputs.end(); ++it )
+			if( !portMap[*it].isNull() )
+				readers[ netName( portMap[*it] ) ]++;
+		for( it = cells[i].outputs.begin(); it != cells[i].outputs.end(); ++it )
+			if( !portMap[*it].isNull() )
+				drivers[ netName( portMap[*it] ) ].append( i );
+	}
+}
+
+bool HDLNetlistOptimizer::isBit( const QString & net ) const
+{
+	return !net.isNull() && net.find( '(' ) < 0 && !widths.contains( net );
+}
+
+bool HDLNetlistOptimizer::isPort( const QString & net ) const
+{
+	return ports.contains( net );
+}
+
+QString HDLNetlistOptimizer::output( const Cell & cell ) const
+{
+	return cell.inst.portMap[ cell.outputs.first() ];
+}
+
+// Evala una puerta con las redes constantes conocidas. Devuelve su valor
+// (0  1) si es constante, 2 si equivale a una de sus entradas (alias) y
+// -1 en otro caso
+int HDLNetlistOptimizer::fold( const Cell & cell, const QMap<QString, int> & consts, QString & alias ) const
+{
+	if( cell.type == HDLGateKind::Vcc )
+		return 1;
+	if( cell.type == HDLGateKind::Gnd )
+		return 0;
+	if( cell.type == HDLGateKind::Opaque )
+		return -1;
+
+	QStringList unknown;
+	int ones = 0, zeros = 0;
+	for( QValueList<int>::const_iterator it = cell.inputs.begin(); it != cell.inputs.end(); ++it ){
+		const QString & net = cell.inst.portMap[*it];
+		QMap<QString, int>::const_iterator c = consts.find( net );
+		if( !net.isNull() && c != consts.end() )
+			c.data() ? ones++ : zeros++;
+		else
+			unknown.append( net );
+	}
+
+	int inverted = ( cell.type == HDLGateKind::Inv || cell.type == HDLGateKind::Nand || cell.type == HDLGateKind::Nor || cell.type == HDLGateKind::Xnor ) ? 1 : 0;
+	int value = -1;
+
+	switch( cell.type ){
+	case HDLGateKind::Inv:
+	case HDLGateKind::Buf:
+		if( unknown.isEmpty() )
+			value = ones;
+		else if( cell.type == HDLGateKind::Buf ){
+			alias = unknown.first();
+			return 2;
+		}
+		break;
+
+	case HDLGateKind::And:
+	case HDLGateKind::Nand:
+		if( zeros > 0 )
+			value = 0;
+		else if( unknown.isEmpty() )
+			value = 1;
+		else if( unknown.count() == 1 && !inverted ){
+			alias = unknown.first();
+			return 2;
+		}
+		break;
+
+	case HDLGateKind::Or:
+	case HDLGateKind::Nor:
+		if( ones > 0 )
+			value = 1;
+		else if( unknown.isEmpty() )
+			value = 0;
+		else if( unknown.count() == 1 && !inverted ){
+			alias = unknown.first();
+			return 2;
+		}
+		break;
+
+	case HDLGateKind::Xor:
+	case HDLGateKind::Xnor:
+		if( unknown.isEmpty() )
+			value = ones % 2;
+		else if( unknown.count() == 1 && ones % 2 == inverted ){
+			alias = unknown.first();
+			return 2;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return ( value < 0 ) ? -1 : ( value ^ inverted );
+}
+
+// Elimina la puerta cell, cuya salida es equivalente a la red equiv. Sus
+// lectores pasan a leer equiv; si la salida es un puerto de la entidad es
+// equiv la que toma su nombre (slo si no es un puerto ni la lee nadie
+// ms). Requiere un index() actualizado
+bool HDLNetlistOptimizer::substitute( int cell, const QString & equiv )
+{
+	QString out = output( cells[cell] );
+	if( !isBit( out ) || !isBit( equiv ) || out == equiv || drivers[out].count() != 1 )
+		return false;
+
+	if( !isPort( out ) ){
+		cells[cell].removed = true;
+		rename( out, equiv );
+		return true;
+	}
+
+	if( isPort( equiv ) || drivers[equiv].count() != 1 )
+		return false;
+
+	int others = readers[equiv];
+	for( QValueList<int>::iterator it = cells[cell].inputs.begin(); it != cells[cell].inputs.end(); ++it )
+		if( cells[cell].inst.portMap[*it] == equiv )
+			others--;
+	if( others > 0 )
+		return false;
+
+	cells[cell].removed = true;
+	rename( equiv, out );
+	return true;
+}
+
+void HDLNetlistOptimizer::rename( const QString & from, const QString & to )
+{
+	for( uint i=0; i < cells.count(); i++ ){
+		if( cells[i].removed )
+			continue;
+
+		QStringList & portMap = cells[i].inst.portMap;
+		for( QStringList::iterator it = portMap.begin(); it != portMap.end(); ++it )
+			if( *it == from )
+				*it = to;
+	}
+}
+
+// Sustituye las puertas de valor constante por la salida de una instancia
+// VCC o GND y las que equivalen a una de sus entradas (buffers, AND con
+// VCC...) por esa entrada
+int HDLNetlistOptimizer::propagateConstants()
+{
+	int applied = 0;
+
+	for( ;; ){
+		index();
+
+		// Redes de valor constante (excitadas por una nica puerta)
+		QMap<QString, int> consts;
+		QString alias;
+		uint i;
+		bool changed = true;
+		while( changed ){
+			changed = false;
+			for( i=0; i < cells.count(); i++ ){
+				if( cells[i].removed || cells[i].type == HDLGateKind::Opaque )
+					continue;
+
+				QString out = output( cells[i] );
+				if( !isBit( out ) || consts.contains( out ) || drivers[out].count() != 1 )
+					continue;
+
+				int value = fold( cells[i], consts, alias );
+				if( value == 0 || value == 1 ){
+					consts.insert( out, value );
+					changed = true;
+				}
+			}
+		}
+
+		// Redes de referencia: las salidas de VCC y GND
+		QString source[2];
+		for( i=0; i < cells.count(); i++ )
+			if( !cells[i].removed && ( cells[i].type == HDLGateKind::Vcc || cells[i].type == HDLGateKind::Gnd ) ){
+				QString out = output( cells[i] );
+				int value = ( cells[i].type == HDLGateKind::Vcc ) ? 1 : 0;
+				if( source[value].isNull() && isBit( out ) && drivers[out].count() == 1 )
+					source[value] = out;
+			}
+
+		bool found = false;
+		for( i=0; i < cells.count() && !found; i++ ){
+			if( cells[i].removed || cells[i].type == HDLGateKind::Opaque || cells[i].type == HDLGateKind::Vcc || cells[i].type == HDLGateKind::Gnd )
+				continue;
+
+			int value = fold( cells[i], consts, alias );
+			if( value == 2 )
+				found = substitute( i, alias );
+			else if( value >= 0 && !source[value].isNull() )
+				found = substitute( i, source[value] );
+		}
+
+		if( !found )
+			break;
+		applied++;
+	}
+
+	return applied;
+}
+
+// INV(INV(x)) equivale a x
+int HDLNetlistOptimizer::removeInverterPairs()
+{
+	int applied = 0;
+
+	for( ;; ){
+		index();
+
+		bool found = false;
+		for( uint i=0; i < cells.count() && !found; i++ ){
+			if( cells[i].removed || cells[i].type != HDLGateKind::Inv )
+				continue;
+
+			QString mid = cells[i].inst.portMap[ cells[i].inputs.first() ];
+			if( !isBit( mid ) || drivers[mid].count() != 1 || drivers[mid].first() < 0 )
+				continue;
+
+			const Cell & prev = cells[ drivers[mid].first() ];
+			if( prev.type == HDLGateKind::Inv )
+				found = substitute( i, prev.inst.portMap[ prev.inputs.first() ] );
+		}
+
+		if( !found )
+			break;
+		applied++;
+	}
+
+	return applied;
+}
+
+// Las puertas del mismo componente con las mismas entradas (en cualquier
+// orden: todas son conmutativas) son equivalentes
+int HDLNetlistOptimizer::mergeGates()
+{
+	int applied = 0;
+
+	for( ;; ){
+		index();
+
+		QMap<QString, int> gates;
+		bool found = false;
+		for( uint i=0; i < cells.count() && !found; i++ ){
+			if( cells[i].removed || cells[i].type == HDLGateKind::Opaque )
+				continue;
+
+			QString out = output( cells[i] );
+			if( !isBit( out ) || drivers[out].count() != 1 )
+				continue;
+
+			QStringList inputs;
+			QValueList<int>::iterator it;
+			for( it = cells[i].inputs.begin(); it != cells[i].inputs.end(); ++it )
+				if( cells[i].inst.portMap[*it].isNull() )
+					break;
+				else
+					inputs.append( cells[i].inst.portMap[*it] );
+			if( it != cells[i].inputs.end() )
+				continue;
+
+			inputs.sort();
+			QString key = cells[i].inst.component + "|" + inputs.join( "," );
+
+			QMap<QString, int>::iterator itGate = gates.find( key );
+			if( itGate == gates.end() ){
+				gates.insert( key, i );
+				continue;
+			}
+
+			// Se conserva la primera salvo que slo la segunda excite un puerto
+			found = substitute( i, output( cells[ itGate.data() ] ) ) ||
+					substitute( itGate.data(), out );
+		}
+
+		if( !found )
+			break;
+		applied++;
+	}
+
+	return applied;
+}
+
+// Elimina las puertas desde las que no se alcanza ningn puerto de salida
+// de la entidad ni ninguna instancia que no sea una puerta lgica
+int HDLNetlistOptimizer::removeDeadGates()
+{
+	index();
+
+	QMap<QString, bool> liveNets;
+	QValueVector<bool> liveCells( cells.count(), false );
+	QStringList pending;
+	uint i;
+
+	QMap<QString, HDLModelSnapshot::PortMode>::iterator itPort;
+	for( itPort = ports.begin(); itPort != ports.end(); ++itPort )
+		if( itPort.data() != HDLModelSnapshot::In )
+			pending.append( itPort.key() );
+
+	for( i=0; i < cells.count(); i++ )
+		if( !cells[i].removed && cells[i].type == HDLGateKind::Opaque ){
+			liveCells[i] = true;
+			for( QValueList<int>::iterator it = cells[i].inputs.begin(); it != cells[i].inputs.end(); ++it )
+				if( !cells[i].inst.portMap[*it].isNull() )
+					pending.append( netName( cells[i].inst.portMap[*it] ) );
+		}
+
+	// Recorrido hacia atrs desde las redes observables
+	while( !pending.isEmpty() ){
+		QString net = pending.first();
+		pending.remove( pending.begin() );
+		if( liveNets.contains( net ) )
+			continue;
+		liveNets.insert( net, true );
+
+		QMap<QString, QValueList<int> >::iterator itDrv = drivers.find( net );
+		if( itDrv == drivers.end() )
+			continue;
+
+		for( QValueList<int>::iterator itCell = itDrv.data().begin(); itCell != itDrv.data().end(); ++itCell ){
+			if( *itCell < 0 || liveCells[*itCell] )
+				continue;
+
+			liveCells[*itCell] = true;
+			const Cell & cell = cells[*itCell];
+			for( QValueList<int>::const_iterator it = cell.inputs.begin(); it != cell.inputs.end(); ++it )
+				if( !cell.inst.portMap[*it].isNull() )
+					pending.append( netName( cell.inst.portMap[*it] ) );
+		}
+	}
+
+	int applied = 0;
+	for( i=0; i < cells.count(); i++ )
+		if( !cells[i].removed && !liveCells[i] ){
+			cells[i].removed = true;
+			applied++;
+		}
+
+	return applied;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Equivalencia
+//////////////////////////////////////////////////////////////////////
+
+HDLNetlistOptimizer::Check HDLNetlistOptimizer::verify( const HDLModelSnapshot & original, const HDLModelSnapshot & optimized )
+{
+	HDLTruthTable before, after;
+	if( !before.load( original ) || !after.load( optimized ) )
+		return Unchecked;
+
+	if( before.inputNames() != after.inputNames() || before.outputNames() != after.outputNames() )
+		return Different;
+
+	if( !before.evaluate() || !after.evaluate() )
+		return Unchecked;
+
+	for( uint o=0; o < before.outputNames().count(); o++ )
+		for( uint v=0; v < before.vectorCount(); v++ )
+			if( before.value( o, v ) != after.value( o, v ) )
+				return Different;
+
+	return Equivalent;
+}
+
+bool HDLNetlistOptimizer::optimizeVerified( HDLModelSnapshot & snapshot, Report * report )
+{
+	HDLModelSnapshot optimized = snapshot;
+	HDLNetlistOptimizer optimizer;
+	optimizer.optimize( optimized );
+
+	Check check = verify( snapshot, optimized );
+	if( report ){
+		report->check = check;
+		report->instancesBefore = optimizer.instancesBefore();
+		report->instancesAfter = optimizer.instancesAfter();
+		report->netsBefore = optimizer.netsBefore();
+		report->netsAfter = optimizer.netsAfter();
+	}
+
+	if( check != Equivalent )
+		return false;
+
+	snapshot = optimized;
+	return true;
+}
+
+QString HDLNetlistOptimizer::Report::summary() const
+{
+	return QObject::tr(" Netlist optimizada: %1 -> %2 instancias, %3 -> %4 redes")
+		.arg( instancesBefore ).arg( instancesAfter ).arg( netsBefore ).arg( netsAfter );
+}
+
+QString HDLNetlistOptimizer::Report::rejection() const
+{
+	switch( check ){
+	case Different:
+		return QObject::tr("    La netlist optimizada no es equivalente a la original: se utilizar la original.");
+	case Unchecked:
+		return QObject::tr("    Equivalencia no comprobada (modelo secuencial o con demasiadas entradas): se utilizar la netlist original.");
+	default:
+		return QString::null;
+	}
+}
@@ -0,0 +1,144 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLNetlistOptimizer.h: interface for the HDLNetlistOptimizer class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLNETLISTOPTIMIZER_H_)
+#define _HDLNETLISTOPTIMIZER_H_
+
+#include <qstring.h>
+#include <qmap.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+
+#include "HDLModelSnapshot.h"
+#include "HDLGateKind.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLNetlistOptimizer
+//
+//	Optimizacin de la netlist capturada (HDLModelSnapshot) antes de su
+//	volcado en VHDL. Elimina las instancias redundantes de los documentos
+//	generados (rboles INV-NAND-OR de los selectores, dispositivos
+//	duplicados, cadenas de buffers...):
+//
+//	  - Propagacin de constantes desde las instancias VCC y GND.
+//	  - Eliminacin de dobles inversores y de buffers.
+//	  - Fusin de puertas idnticas (mismo componente y mismas entradas).
+//	  - Eliminacin de puertas sin camino hasta un puerto de la entidad.
+//
+//	Slo se transforman las puertas lgicas de un bit que reconoce
+//	HDLGateKind; el resto de instancias (registros, buses,
+//	componentes de usuario...) se conservan tal cual. El puerto de la
+//	entidad no cambia, de forma que el fichero .sig sigue siendo vlido.
+//
+//	La etapa es opcional (ver setEnabled, opcin -O de hdlbuild): la
+//	utilizan HDLGenerator y HDLBuildScheduler a travs de
+//	optimizeVerified(), que slo sustituye la netlist por la optimizada si
+//	verify() comprueba que es equivalente.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLNetlistOptimizer
+{
+public:
+	// Resultado de la comprobacin de equivalencia
+	enum Check { Equivalent, Different, Unchecked };
+
+	// Resultado de optimizeVerified
+	struct Report{
+		Report() : check( Unchecked ), instancesBefore( 0 ), instancesAfter( 0 ), netsBefore( 0 ), netsAfter( 0 ) {}
+
+		// Recuento de instancias y redes
+		QString summary() const;
+		// Motivo por el que se conserva la netlist original (null si se
+		// utiliza la optimizada)
+		QString rejection() const;
+
+		Check check;
+		int instancesBefore, instancesAfter;
+		int netsBefore, netsAfter;
+	};
+
+	HDLNetlistOptimizer();
+
+	// Optimiza el snapshot. Devuelve el nmero de transformaciones aplicadas
+	int optimize( HDLModelSnapshot & snapshot );
+
+	// Recuento de la ltima optimizacin (las redes incluyen los puertos)
+	int instancesBefore() const;
+	int instancesAfter() const;
+	int netsBefore() const;
+	int netsAfter() const;
+
+	// Compara las tablas de verdad completas de ambos modelos (ver
+	// HDLTruthTable). Los modelos secuenciales o con demasiadas entradas
+	// no pueden comprobarse
+	static Check verify( const HDLModelSnapshot & original, const HDLModelSnapshot & optimized );
+
+	// Optimiza una copia de snapshot y la sustituye slo si es equivalente
+	// (si la equivalencia no puede comprobarse se conserva la original).
+	// Devuelve true si snapshot ha sido sustituido
+	static bool optimizeVerified( HDLModelSnapshot & snapshot, Report * report=0 );
+
+	// Activacin global de la etapa (desactivada por defecto)
+	static void setEnabled( bool enabled );
+	static bool isEnabled();
+
+private:
+	// Instancia en optimizacin
+	struct Cell{
+		HDLModelSnapshot::Instance inst;
+		HDLGateKind::Kind type;
+		QValueList<int> inputs;		// Posiciones de inst.portMap ledas
+		QValueList<int> outputs;	// Posiciones de inst.portMap excitadas
+		bool removed;
+	};
+
+	void load( const HDLModelSnapshot & snapshot );
+	void store( HDLModelSnapshot & snapshot );
+
+	void index();
+	bool isBit( const QString & net ) const;
+	bool isPort( const QString & net ) const;
+	QString output( const Cell & cell ) const;
+	int fold( const Cell & cell, const QMap<QString, int> & consts, QString & alias ) const;
+	bool substitute( int cell, const QString & equiv );
+	void rename( const QString & from, const QString & to );
+
+	int propagateConstants();
+	int removeInverterPairs();
+	int mergeGates();
+	int removeDeadGates();
+
+	QValueVector<Cell> cells;
+	QMap<QString, HDLModelSnapshot::PortMode> ports;
+	QMap<QString, int> widths;		// Puertos y seales de ms de un bit
+
+	// ndices de la netlist en curso (ver index())
+	QMap<QString, QValueList<int> > drivers;
+	QMap<QString, int> readers;
+
+	int instsBefore, instsAfter;
+	int nNetsBefore, nNetsAfter;
+
+	static bool enabled;
+};
+
+#endif
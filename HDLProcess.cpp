@@ -17,6 +17,41 @@
 
 
 #include "HDLProcess.h"
+#include "HDLBuildState.h"
+
+#include <qmap.h>
+
+// Un binario est al da si su fuente HDL conserva el contenido con el que
+// se compil (ver HDLBuildState::isCompiled)
+static bool componentUpToDate( const QString & HDLFile, const HDLBuildState & state )
+{
+	QString binary = HDLFile;
+	if( HDLFile.length() > 4 )
+		binary.truncate( HDLFile.length()-4 );
+
+	return state.isCompiled( HDLFile, binary );
+}
+
+// Hash de los fuentes que compila cada HDLProcCompiler en curso, tomado
+// al lanzar vcom: slo se registra si la compilacin termina con xito
+typedef QMap<QString, QString> SourceHashes;
+static QMap<const HDLProcess*, SourceHashes> compilingSources;
+
+static void recordCompiled( const SourceHashes & sources )
+{
+	// Un estado por directorio de los fuentes
+	QMap<QString, HDLBuildState> states;
+	SourceHashes::const_iterator it;
+	for( it = sources.begin(); it != sources.end(); ++it ){
+		QString dir = QFileInfo( it.key() ).dirPath( true );
+		if( !states.contains( dir ) )
+			states[dir].load( dir );
+		states[dir].setCompiled( it.key(), it.data() );
+	}
+
+	for( QMap<QString, HDLBuildState>::iterator itState = states.begin(); itState != states.end(); ++itState )
+		itState.data().save();
+}
 
 HDLProcess::HDLProcess( QObject * parent , const char * name )
 : QProcess( parent, name )
@@ -26,11 +61,20 @@ HDLProcess::HDLProcess( QObject * parent , const char * name )
 
 void HDLProcess::afterExit()
 {
+	// Fuentes compilados por este proceso (si es un HDLProcCompiler)
+	SourceHashes sources;
+	QMap<const HDLProcess*, SourceHashes>::iterator itSources = compilingSources.find( this );
+	if( itSources != compilingSources.end() ){
+		sources = itSources.data();
+		compilingSources.remove( itSources );
+	}
+
 	if( normalExit() )
 	{
-		if( !exitStatus() )
+		if( !exitStatus() ){
+			recordCompiled( sources );
 			emit success();
-		else
+		}else
 			emit failure();
 	}else
 		emit failure();
@@ -198,8 +242,9 @@ bool HDLProcCompiler::start( QStringList * env )
 
 		targets = libDir.entryList();
 		
+		HDLBuildState state( workLibrary() );
 		for( QStringList::iterator it = targets.begin(); it != targets.end(); ++it )
-			if( !checkComponentuptoDate( workLibrary()+QDir::separator()+*it ) )
+			if( !componentUpToDate( workLibrary()+QDir::separator()+*it, state ) )
 				finalTargets.append( workLibrary()+QDir::separator()+*it );
 	}
 
@@ -213,30 +258,32 @@ bool HDLProcCompiler::start( QStringList * env )
 	addArgument("vcom");
 	addArgument("-work");
 	addArgument( workLibrary() );
-	for( QStringList::iterator it = finalTargets.begin(); it != finalTargets.end(); ++it )
+	// Contenido que va a compilarse (se registra al terminar con xito)
+	SourceHashes & sources = compilingSources[this];
+	sources.clear();
+	for( QStringList::iterator it = finalTargets.begin(); it != finalTargets.end(); ++it ){
 		addArgument( *it );
 
-	return HDLProcess::start( env );
+		QString hash = HDLBuildState::hashFile( *it );
+		if( !hash.isNull() )
+			sources.insert( QFileInfo( *it ).absFilePath(), hash );
+	}
+
+	if( !HDLProcess::start( env ) ){
+		compilingSources.remove( this );
+		return false;
+	}
+
+	return true;
 
 }
 	
 // Comprueba si el documento est al da
 bool HDLProcCompiler::checkComponentuptoDate(const QString & HDLFile )
 {
-	QString binary = HDLFile;
-	if( HDLFile.length() > 4 )
-		binary.truncate( HDLFile.length()-4 );
+	HDLBuildState state( QFileInfo( HDLFile ).dirPath( true ) );
 
-	// El fichero binario asociado a HDLFile todava no existe
-	QFileInfo binFile( binary );
-	if( !binFile.exists() )
-		return false;
-
-	// El fichero binario no est al da respecto al fuente HDL
-	QFileInfo srcFile( HDLFile );
-
-	return (binFile.lastModified() >= srcFile.lastModified());
-	
+	return componentUpToDate( HDLFile, state );
 }
 
 //////////////////////////////////////////////////////////////////////
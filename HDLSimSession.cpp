@@ -0,0 +1,387 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLSimSession.cpp: implementation of the HDLSimSession class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLSimSession.h"
+
+#include <qtextstream.h>
+
+#include "HDLVectorTable.h"
+
+// Marcadores que el simulador devuelve con echo: valor de una seal y
+// fin de una simulacin
+#define VALUE_MARKER "@@VAL "
+#define DONE_MARKER "@@DONE "
+#define ROW_MARKER "@@ROW "
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLSimSession::HDLSimSession( const QString & model, const QStringList & libDependences, QObject * parent, const char * name )
+: HDLProcSimulator( model, libDependences, parent, name ),
+  prog( "vsim" ), failed( false ), fresh( true ), closing( false ), reopening( false ), restarts( 0 ), nextId( 1 )
+{
+	setCommunication( Stdin|Stdout|Stderr );
+
+	connect( &killTimer, SIGNAL(timeout()), this, SLOT(kill()) );
+
+	connect( this, SIGNAL(readyReadStdout()), this, SLOT(readSession()) );
+	connect( this, SIGNAL(readyReadStderr()), this, SLOT(readSessionErrors()) );
+	connect( this, SIGNAL(processExited()), this, SLOT(sessionExited()) );
+}
+
+HDLSimSession::~HDLSimSession()
+{
+	// QProcess no termina el proceso al destruirse
+	if( isRunning() ){
+		closing = true;
+		kill();
+	}
+}
+
+void HDLSimSession::setProgram( const QString & program )
+{
+	prog = program;
+}
+
+QString HDLSimSession::program() const
+{
+	return prog;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sesin
+//////////////////////////////////////////////////////////////////////
+
+// Si el proceso anterior an no ha terminado tras close(), la sesin se
+// relanza al terminar (sessionExited) y las peticiones se reenvan
+bool HDLSimSession::open()
+{
+	restarts = 0;
+
+	if( isRunning() ){
+		if( closing )
+			reopening = true;
+		closing = false;
+		return true;
+	}
+
+	closing = false;
+	return launch();
+}
+
+void HDLSimSession::close()
+{
+	closing = true;
+	reopening = false;
+
+	if( isRunning() ){
+		writeToStdin( "quit -f\n" );
+		closeStdin();
+
+		// Si no atiende la orden se termina por la fuerza. El temporizador
+		// se detiene al lanzar otro proceso, que no debe verse afectado
+		killTimer.start( 5000, TRUE );
+	}
+
+	while( !pending.isEmpty() )
+		finish( false );
+}
+
+bool HDLSimSession::isOpen() const
+{
+	return isRunning();
+}
+
+// Lanza "vsim -c -lib ... modelo": el modelo se elabora al arrancar
+bool HDLSimSession::launch()
+{
+	killTimer.stop();
+
+	clearArguments();
+	addArgument( prog );
+	addArgument( "-c" );
+
+	QStringList deps = libraryDependences();
+	for( QStringList::iterator itd = deps.begin(); itd != deps.end(); ++itd ){
+		addArgument( "-lib" );
+		addArgument( *itd );
+	}
+
+	addArgument( model() );
+
+	fresh = true;
+	failed = false;
+	results.clear();
+
+	emit outputMessage( "$ " + arguments().join(" ") );
+	return QProcess::start();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Simulacin
+//////////////////////////////////////////////////////////////////////
+
+bool HDLSimSession::simulate( const SignalValues & inputs, const SignalValues & outputs )
+{
+	if( !isRunning() && !open() )
+		return false;
+
+	Request req;
+	req.id = nextId++;
+	req.inputs = inputs;
+	req.outputs = outputs;
+	req.table = NULL;
+
+	pending.append( req );
+	send( req );
+
+	return true;
+}
+
+bool HDLSimSession::simulate( HDLVectorTable * table )
+{
+	if( !table || ( !isRunning() && !open() ) )
+		return false;
+
+	Request req;
+	req.id = nextId++;
+	req.table = table;
+
+	table->clearResults();
+
+	pending.append( req );
+	send( req );
+
+	return true;
+}
+
+uint HDLSimSession::pendingCount() const
+{
+	return pending.count();
+}
+
+// rdenes de una simulacin. Los valores se devuelven con echo para
+// distinguirlos del resto de la salida del simulador
+void HDLSimSession::send( const Request & req )
+{
+	// El proceso anterior est terminando: se enviar al relanzar
+	if( reopening )
+		return;
+
+	QString orders;
+
+	if( !fresh )
+		orders += "restart -f\n";
+	fresh = false;
+
+	if( req.table ){
+		// Todos los vectores en una nica simulacin
+		QTextStream out( &orders, IO_WriteOnly|IO_Append );
+		req.table->writeDoFile( out );
+
+		orders += QString( "echo \"" DONE_MARKER "%1\"\n" ).arg( req.id );
+		writeToStdin( orders );
+		return;
+	}
+
+	SignalValues::const_iterator it;
+	for( it = req.inputs.begin(); it != req.inputs.end(); ++it )
+		orders += QString( "force %1 %2\n" ).arg( it.key() ).arg( QChar( (char)it.data() ) );
+
+	orders += "run\n";
+
+	if( req.outputs.isEmpty() )
+		orders += "foreach s [find signals /*] { echo \"" VALUE_MARKER "[file tail $s] [examine $s]\" }\n";
+	else
+		for( it = req.outputs.begin(); it != req.outputs.end(); ++it )
+			orders += QString( "echo \"" VALUE_MARKER "%1 [examine %2]\"\n" ).arg( it.key() ).arg( it.key() );
+
+	orders += QString( "echo \"" DONE_MARKER "%1\"\n" ).arg( req.id );
+
+	writeToStdin( orders );
+}
+
+void HDLSimSession::parseLine( const QString & line )
+{
+	// Eco de las propias rdenes (si el simulador las repite)
+	if( line.find( "echo \"@@" ) != -1 )
+		return;
+
+	int pos = line.find( VALUE_MARKER );
+	if( pos != -1 ){
+		QStringList fields = QStringList::split( ' ', line.mid( pos + sizeof( VALUE_MARKER ) - 1 ) );
+		if( !pending.isEmpty() && fields.count() >= 2 ){
+			// Un valor por seal: los buses se examinan como {b b ...}
+			QString value = fields[1];
+			value.remove( '{' );
+			results.insert( fields[0], value.isEmpty() ? 'U' : value[0].latin1() );
+		}
+		return;
+	}
+
+	// Fila de resultados de una tabla de vectores: "@@ROW n salidas..."
+	pos = line.find( ROW_MARKER );
+	if( pos != -1 ){
+		if( !pending.isEmpty() && pending.first().table ){
+			QStringList fields = QStringList::split( ' ', line.mid( pos + sizeof( ROW_MARKER ) - 1 ) );
+			if( !fields.isEmpty() ){
+				int vector = fields[0].toInt();
+				fields.remove( fields.begin() );
+
+				QString outputs = fields.join( "" );
+				outputs.remove( '{' );
+				outputs.remove( '}' );
+				pending.first().table->setResult( vector, outputs );
+			}
+		}
+		return;
+	}
+
+	pos = line.find( DONE_MARKER );
+	if( pos != -1 ){
+		int id = line.mid( pos + sizeof( DONE_MARKER ) - 1 ).stripWhiteSpace().toInt();
+		if( !pending.isEmpty() && pending.first().id == id ){
+			// Todas las salidas pedidas deben haberse examinado
+			const SignalValues & outputs = pending.first().outputs;
+			bool ok = !failed && ( outputs.isEmpty() || results.count() >= outputs.count() );
+			finish( ok );
+		}
+		return;
+	}
+
+	if( line.find( "** Error" ) != -1 || line.find( "** Fatal" ) != -1 ){
+		if( !pending.isEmpty() )
+			failed = true;
+		emit errorMessage( line );
+		return;
+	}
+
+	emit outputMessage( line );
+}
+
+// Termina la simulacin en curso (la primera pendiente)
+void HDLSimSession::finish( bool ok )
+{
+	Request req = pending.first();
+	pending.remove( pending.begin() );
+
+	setInputSignals( req.inputs );
+	setOutputSignals( results );
+
+	results.clear();
+	failed = false;
+
+	if( req.table ){
+		// La tabla debe tener resultado para todos sus vectores
+		ok = ok && req.table->resultCount() == req.table->count();
+		if( ok )
+			restarts = 0;
+
+		emit vectorsDone( req.table, ok );
+		return;
+	}
+
+	if( ok ){
+		restarts = 0;
+		emit success();
+	}else
+		emit failure();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Manejadores internos
+//////////////////////////////////////////////////////////////////////
+
+// La salida se procesa segn llega, lnea a lnea
+void HDLSimSession::readSession()
+{
+	while( canReadLineStdout() ){
+		QString line = readLineStdout();
+
+		// Salida del proceso anterior, que est terminando
+		if( !reopening )
+			parseLine( line );
+	}
+}
+
+void HDLSimSession::readSessionErrors()
+{
+	while( canReadLineStderr() )
+		emit errorMessage( readLineStderr() );
+}
+
+void HDLSimSession::sessionExited()
+{
+	if( closing )
+		return;
+
+	// Terminacin del proceso cerrado antes de volver a abrir la sesin:
+	// se lanza el nuevo con todas las peticiones encoladas mientras tanto
+	if( reopening ){
+		reopening = false;
+
+		if( !launch() ){
+			while( !pending.isEmpty() )
+				finish( false );
+			return;
+		}
+
+		QValueList<Request>::iterator it;
+		for( it = pending.begin(); it != pending.end(); ++it )
+			send( *it );
+		return;
+	}
+
+	// Restos de salida anteriores a la terminacin
+	readSession();
+
+	emit errorMessage( tr("> El simulador del modelo %1 ha terminado inesperadamente.").arg( model() ) );
+
+	// La simulacin en curso es la causante: falla (se notifica tras
+	// relanzar, por si el receptor encola otra simulacin)
+	bool crashed = !pending.isEmpty();
+
+	if( restarts >= MaxRestarts ){
+		emit errorMessage( tr("> Se abandona la sesin del simulador tras %1 reinicios.").arg( restarts ) );
+		while( !pending.isEmpty() )
+			finish( false );
+		return;
+	}
+
+	restarts++;
+	if( !launch() ){
+		while( !pending.isEmpty() )
+			finish( false );
+		return;
+	}
+
+	// Reenvo de las peticiones pendientes
+	QValueList<Request>::iterator it = pending.begin();
+	if( crashed )
+		++it;
+	for( ; it != pending.end(); ++it )
+		send( *it );
+
+	if( crashed )
+		finish( false );
+}
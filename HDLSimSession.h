@@ -0,0 +1,131 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLSimSession.h: interface for the HDLSimSession class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLSIMSESSION_H_)
+#define _HDLSIMSESSION_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluelist.h>
+#include <qtimer.h>
+
+#include "HDLProcess.h"
+
+class HDLVectorTable;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLSimSession
+//
+//	Sesin persistente del simulador: a diferencia de HDLProcSimulator, que
+//	lanza un "vsim -c -do ordersN.in" por simulacin (cargando de nuevo las
+//	libreras y elaborando el modelo cada vez), mantiene vivo un nico
+//	proceso "vsim -c" y le enva las rdenes por la entrada estndar.
+//
+//	Cada simulacin es una secuencia restart/force/run/examine terminada
+//	con un echo de un marcador propio; la salida se analiza lnea a lnea
+//	segn llega, asociando cada resultado a la peticin ms antigua en
+//	curso (vsim procesa las rdenes en orden). "restart -f" devuelve el
+//	modelo al instante 0 y recarga las unidades recompiladas.
+//
+//	Si el proceso termina inesperadamente la simulacin en curso falla y
+//	la sesin se relanza (hasta MaxRestarts veces seguidas), reenviando
+//	las peticiones pendientes.
+//
+//	Al terminar cada simulacin se establecen inputSignals() y
+//	outputSignals() con la peticin y sus resultados y se emite success()
+//	o failure(), como al terminar un HDLProcSimulator.
+//
+//	Una tabla de vectores (HDLVectorTable) se simula completa con una
+//	nica peticin: sus filas de resultados ("@@ROW n ...") se guardan en
+//	la tabla segn llegan y al terminar se emite vectorsDone().
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLSimSession : public HDLProcSimulator
+{
+	Q_OBJECT
+
+public:
+	enum { MaxRestarts = 3 };
+
+	HDLSimSession( const QString & model, const QStringList & libDependences, QObject * parent=0, const char * name=0 );
+	virtual ~HDLSimSession();
+
+	// Programa del simulador ("vsim" por defecto). Sirve cualquier programa
+	// que acepte el mismo protocolo por la entrada estndar (un script que
+	// imite a vsim, por ejemplo)
+	void setProgram( const QString & program );
+	QString program() const;
+
+	// Lanza el simulador, que elabora el modelo una nica vez
+	bool open();
+	// Termina la sesin: las simulaciones pendientes fallan
+	void close();
+	bool isOpen() const;
+
+	// Encola una simulacin: fuerza inputs, ejecuta y examina outputs
+	// (todas las seales del modelo si est vaco)
+	bool simulate( const SignalValues & inputs, const SignalValues & outputs );
+
+	// Encola la simulacin de todos los vectores de table, que se aplican
+	// con force sobre el modelo de la sesin (HDLVectorTable::writeDoFile)
+	bool simulate( HDLVectorTable * table );
+
+	// Simulaciones enviadas pendientes de respuesta
+	uint pendingCount() const;
+
+signals:
+	void vectorsDone( HDLVectorTable * table, bool ok );
+
+private slots:
+	void readSession();
+	void readSessionErrors();
+	void sessionExited();
+
+private:
+	struct Request{
+		int id;
+		SignalValues inputs;
+		SignalValues outputs;
+		HDLVectorTable * table;
+	};
+
+	bool launch();
+	void send( const Request & req );
+	void parseLine( const QString & line );
+	void finish( bool ok );
+
+	QString prog;
+	QValueList<Request> pending;
+
+	// Resultado de la simulacin en curso (la primera de pending)
+	SignalValues results;
+	bool failed;
+
+	bool fresh;			// Modelo recin elaborado: no necesita restart
+	bool closing;
+	bool reopening;		// Abierta de nuevo antes de terminar el proceso anterior
+	QTimer killTimer;	// Terminacin forzada del proceso que se cierra
+	int restarts;
+	int nextId;
+};
+
+#endif
@@ -0,0 +1,484 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLTruthTable.cpp: implementation of the HDLTruthTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLTruthTable.h"
+
+#include <qobject.h>
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qdatetime.h>
+
+#include "HDLModelSnapshot.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLTruthTable::HDLTruthTable()
+	: levels( 0 ), nVectors( 0 ), nWords( 0 ), rate( 0 )
+{
+}
+
+QString HDLTruthTable::errorString() const
+{
+	return errStr;
+}
+
+const QStringList & HDLTruthTable::inputNames() const
+{
+	return inNames;
+}
+
+const QStringList & HDLTruthTable::outputNames() const
+{
+	return outNames;
+}
+
+int HDLTruthTable::depth() const
+{
+	return levels;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construccin del circuito
+//////////////////////////////////////////////////////////////////////
+
+bool HDLTruthTable::load( const HDLModelSnapshot & snapshot )
+{
+	netIds.clear();
+	netNames.clear();
+	inNames.clear();
+	outNames.clear();
+	inNets.clear();
+	outNets.clear();
+	gates.clear();
+	order.clear();
+	table.resize( 0 );
+	nVectors = 0;
+	nWords = 0;
+	errStr = QString::null;
+
+	// Red constante a 0 para las entradas sin conectar
+	netNames.push_back( QString::null );
+
+	// Puertos de la entidad: IN son las entradas de la tabla
+	QValueList<HDLModelSnapshot::Port>::const_iterator itPort;
+	for( itPort = snapshot.portList().begin(); itPort != snapshot.portList().end(); ++itPort ){
+		if( (*itPort).width > 1 ){
+			errStr = QObject::tr("El puerto %1 es un bus: no puede evaluarse a nivel de bit.").arg( (*itPort).name );
+			return false;
+		}
+
+		if( (*itPort).mode == HDLModelSnapshot::In ){
+			inNames.append( (*itPort).name );
+			inNets.push_back( net( (*itPort).name ) );
+		}else{
+			outNames.append( (*itPort).name );
+			outNets.push_back( net( (*itPort).name ) );
+		}
+	}
+
+	if( inNets.count() > MaxInputs ){
+		errStr = QObject::tr("El modelo tiene %1 entradas (mximo %2).").arg( inNets.count() ).arg( MaxInputs );
+		return false;
+	}
+
+	QStringList::const_iterator itSig;
+	for( itSig = snapshot.signalList().begin(); itSig != snapshot.signalList().end(); ++itSig ){
+		if( snapshot.signalWidth( *itSig ) > 1 ){
+			errStr = QObject::tr("La seal %1 es un bus: no puede evaluarse a nivel de bit.").arg( *itSig );
+			return false;
+		}
+		net( *itSig );
+	}
+
+	// Componentes por nombre
+	QMap<QString, const HDLModelSnapshot::Component *> comps;
+	QValueList<HDLModelSnapshot::Component>::const_iterator itCmp;
+	for( itCmp = snapshot.componentList().begin(); itCmp != snapshot.componentList().end(); ++itCmp )
+		comps.insert( (*itCmp).name, &(*itCmp) );
+
+	// Una puerta por instancia
+	QValueList<HDLModelSnapshot::Instance>::const_iterator itInst;
+	for( itInst = snapshot.instanceList().begin(); itInst != snapshot.instanceList().end(); ++itInst ){
+		const HDLModelSnapshot::Component * cmp = comps[ (*itInst).component ];
+		if( !cmp ){
+			errStr = QObject::tr("El componente %1 no est declarado.").arg( (*itInst).component );
+			return false;
+		}
+
+		// Red de cada pin (mismo orden en el componente y en el mapeado)
+		const QValueList<HDLModelSnapshot::Port> & pins = cmp->pins;
+		QMap<QString, int> pinNets;
+		QStringList inPins, outPins;
+		uint i = 0;
+		for( itPort = pins.begin(); itPort != pins.end(); ++itPort, ++i ){
+			QString sigName = ( i < (*itInst).portMap.count() ) ? (*itInst).portMap[i] : QString::null;
+			QString pinName = (*itPort).name.upper();
+
+			pinNets.insert( pinName, sigName.isNull() ? (int)ZeroNet : net( sigName ) );
+			if( (*itPort).mode == HDLModelSnapshot::Out )
+				outPins.append( pinName );
+			else
+				inPins.append( pinName );
+		}
+
+		Gate gate;
+		gate.control = ZeroNet;
+
+		gate.type = HDLGateKind::classify( *cmp );
+		if( !HDLGateKind::isCombinational( gate.type ) ){
+			errStr = QObject::tr("La instancia %1 (%2) no es combinacional.").arg( (*itInst).name ).arg( cmp->name );
+			return false;
+		}
+		if( gate.type == HDLGateKind::Opaque ){
+			errStr = QObject::tr("No existe modelo de evaluacin para el componente %1 (instancia %2).").arg( cmp->name ).arg( (*itInst).name );
+			return false;
+		}
+
+		QStringList::iterator itPin;
+		if( gate.type == HDLGateKind::Decoder ){
+			// Entradas de seleccin I<k> y salidas O<k> por ndice
+			gate.control = pinNets[ "E*" ];
+			gate.inputs.resize( inPins.count() - 1, ZeroNet );
+			gate.outputs.resize( outPins.count(), ZeroNet );
+			for( itPin = inPins.begin(); itPin != inPins.end(); ++itPin ){
+				int k = HDLGateKind::pinIndex( *itPin, "I" );
+				if( k >= 0 && k < (int)gate.inputs.count() )
+					gate.inputs[k] = pinNets[*itPin];
+			}
+			for( itPin = outPins.begin(); itPin != outPins.end(); ++itPin ){
+				int k = HDLGateKind::pinIndex( *itPin, "O" );
+				if( k >= 0 && k < (int)gate.outputs.count() )
+					gate.outputs[k] = pinNets[*itPin];
+			}
+		}else{
+			for( itPin = inPins.begin(); itPin != inPins.end(); ++itPin )
+				gate.inputs.push_back( pinNets[*itPin] );
+			for( itPin = outPins.begin(); itPin != outPins.end(); ++itPin )
+				gate.outputs.push_back( pinNets[*itPin] );
+		}
+
+		gates.push_back( gate );
+	}
+
+	return levelize();
+}
+
+int HDLTruthTable::net( const QString & name )
+{
+	QMap<QString, int>::iterator it = netIds.find( name );
+	if( it != netIds.end() )
+		return it.data();
+
+	int id = netNames.count();
+	netIds.insert( name, id );
+	netNames.push_back( name );
+
+	return id;
+}
+
+// Ordena las puertas por niveles: una puerta se evala despus de las que
+// excitan sus entradas. Falla si una red tiene varios excitadores o si
+// hay lazos (el modelo no es combinacional)
+bool HDLTruthTable::levelize()
+{
+	uint g, i;
+
+	QValueVector<int> drivers( netNames.count(), -1 );
+	for( i=0; i < inNets.count(); i++ )
+		drivers[ inNets[i] ] = -2;
+
+	for( g=0; g < gates.count(); g++ )
+		for( i=0; i < gates[g].outputs.count(); i++ ){
+			int n = gates[g].outputs[i];
+			if( n == ZeroNet )
+				continue;
+
+			if( drivers[n] != -1 ){
+				errStr = QObject::tr("La red %1 tiene varios excitadores.").arg( netNames[n] );
+				return false;
+			}
+			drivers[n] = g;
+		}
+
+	// Abanico de salida entre puertas y nmero de puertas previas de cada una
+	QValueVector< QValueList<int> > fanout( gates.count() );
+	QValueVector<int> pending( gates.count(), 0 );
+	for( g=0; g < gates.count(); g++ ){
+		QValueVector<int> reads = gates[g].inputs;
+		reads.push_back( gates[g].control );
+
+		for( i=0; i < reads.count(); i++ ){
+			int d = drivers[ reads[i] ];
+			if( d >= 0 ){
+				fanout[d].append( g );
+				pending[g]++;
+			}
+		}
+	}
+
+	// Recorrido por niveles
+	QValueList<int> level;
+	for( g=0; g < gates.count(); g++ )
+		if( pending[g] == 0 )
+			level.append( g );
+
+	levels = 0;
+	while( !level.isEmpty() ){
+		QValueList<int> next;
+		for( QValueList<int>::iterator it = level.begin(); it != level.end(); ++it ){
+			order.push_back( *it );
+			for( QValueList<int>::iterator itF = fanout[*it].begin(); itF != fanout[*it].end(); ++itF )
+				if( --pending[*itF] == 0 )
+					next.append( *itF );
+		}
+
+		level = next;
+		levels++;
+	}
+
+	if( order.count() != gates.count() ){
+		errStr = QObject::tr("El modelo tiene lazos combinacionales.");
+		order.clear();
+		return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Evaluacin
+//////////////////////////////////////////////////////////////////////
+
+void HDLTruthTable::evaluateGate( const Gate & gate, Word * values ) const
+{
+	Word r[Lanes];
+	const Word * in;
+	uint i;
+	int l;
+
+	switch( gate.type ){
+	case HDLGateKind::Vcc:
+		for( l=0; l < Lanes; l++ )
+			r[l] = ~(Word)0;
+		break;
+
+	case HDLGateKind::Gnd:
+		for( l=0; l < Lanes; l++ )
+			r[l] = 0;
+		break;
+
+	case HDLGateKind::Inv:
+	case HDLGateKind::Buf:
+		in = values + ( gate.inputs.isEmpty() ? (int)ZeroNet : gate.inputs[0] ) * Lanes;
+		for( l=0; l < Lanes; l++ )
+			r[l] = ( gate.type == HDLGateKind::Inv ) ? ~in[l] : in[l];
+		break;
+
+	case HDLGateKind::And:
+	case HDLGateKind::Nand:
+		for( l=0; l < Lanes; l++ )
+			r[l] = ~(Word)0;
+		for( i=0; i < gate.inputs.count(); i++ ){
+			in = values + gate.inputs[i] * Lanes;
+			for( l=0; l < Lanes; l++ )
+				r[l] &= in[l];
+		}
+		if( gate.type == HDLGateKind::Nand )
+			for( l=0; l < Lanes; l++ )
+				r[l] = ~r[l];
+		break;
+
+	case HDLGateKind::Or:
+	case HDLGateKind::Nor:
+		for( l=0; l < Lanes; l++ )
+			r[l] = 0;
+		for( i=0; i < gate.inputs.count(); i++ ){
+			in = values + gate.inputs[i] * Lanes;
+			for( l=0; l < Lanes; l++ )
+				r[l] |= in[l];
+		}
+		if( gate.type == HDLGateKind::Nor )
+			for( l=0; l < Lanes; l++ )
+				r[l] = ~r[l];
+		break;
+
+	case HDLGateKind::Xor:
+	case HDLGateKind::Xnor:
+		for( l=0; l < Lanes; l++ )
+			r[l] = 0;
+		for( i=0; i < gate.inputs.count(); i++ ){
+			in = values + gate.inputs[i] * Lanes;
+			for( l=0; l < Lanes; l++ )
+				r[l] ^= in[l];
+		}
+		if( gate.type == HDLGateKind::Xnor )
+			for( l=0; l < Lanes; l++ )
+				r[l] = ~r[l];
+		break;
+
+	case HDLGateKind::Decoder:{
+		// E* activo a nivel bajo: la salida k se activa si la seleccin vale k
+		const Word * enable = values + gate.control * Lanes;
+		for( uint k=0; k < gate.outputs.count(); k++ ){
+			for( l=0; l < Lanes; l++ )
+				r[l] = ~enable[l];
+
+			for( i=0; i < gate.inputs.count(); i++ ){
+				in = values + gate.inputs[i] * Lanes;
+				if( ( k >> i ) & 1 )
+					for( l=0; l < Lanes; l++ )
+						r[l] &= in[l];
+				else
+					for( l=0; l < Lanes; l++ )
+						r[l] &= ~in[l];
+			}
+
+			if( gate.outputs[k] != ZeroNet ){
+				Word * out = values + gate.outputs[k] * Lanes;
+				for( l=0; l < Lanes; l++ )
+					out[l] = r[l];
+			}
+		}
+		return;
+	}
+	}
+
+	for( i=0; i < gate.outputs.count(); i++ )
+		if( gate.outputs[i] != ZeroNet ){
+			Word * out = values + gate.outputs[i] * Lanes;
+			for( l=0; l < Lanes; l++ )
+				out[l] = r[l];
+		}
+}
+
+// Cada pasada evala Lanes palabras consecutivas de la tabla. En la
+// palabra w, la entrada i < 6 sigue un patrn fijo dentro de la palabra
+// (bit i del ndice del bit) y las dems valen el bit i-6 de w
+bool HDLTruthTable::evaluate()
+{
+	if( order.count() != gates.count() )
+		return false;
+
+	uint nIn = inNets.count(), nOut = outNets.count();
+	nVectors = 1 << nIn;
+	nWords = ( nVectors + 63 ) / 64;
+
+	table.resize( nOut * nWords );
+	table.fill( 0 );
+
+	Word patterns[6];
+	for( uint p=0; p < 6; p++ ){
+		patterns[p] = 0;
+		for( uint b=0; b < 64; b++ )
+			if( ( b >> p ) & 1 )
+				patterns[p] |= (Word)1 << b;
+	}
+
+	QMemArray<Word> netValues( netNames.count() * Lanes );
+	netValues.fill( 0 );
+	Word * values = netValues.data();
+
+	QTime timer;
+	timer.start();
+
+	for( uint base = 0; base < nWords; base += Lanes ){
+		uint i;
+		int l;
+
+		for( i=0; i < nIn; i++ ){
+			Word * in = values + inNets[i] * Lanes;
+			for( l=0; l < Lanes; l++ )
+				in[l] = ( i < 6 ) ? patterns[i] : ( ( ( ( base + l ) >> ( i - 6 ) ) & 1 ) ? ~(Word)0 : 0 );
+		}
+
+		for( i=0; i < order.count(); i++ )
+			evaluateGate( gates[ order[i] ], values );
+
+		for( i=0; i < nOut; i++ ){
+			const Word * out = values + outNets[i] * Lanes;
+			for( l=0; l < Lanes && base + l < nWords; l++ )
+				table[ i*nWords + base + l ] = out[l];
+		}
+	}
+
+	int ms = timer.elapsed();
+	rate = nVectors * 1000.0 / ( ms > 0 ? ms : 1 );
+
+	return true;
+}
+
+uint HDLTruthTable::vectorCount() const
+{
+	return nVectors;
+}
+
+bool HDLTruthTable::value( int output, uint vector ) const
+{
+	if( output < 0 || output >= (int)outNets.count() || vector >= nVectors )
+		return false;
+
+	return ( table[ output*nWords + vector/64 ] >> ( vector % 64 ) ) & 1;
+}
+
+double HDLTruthTable::vectorsPerSecond() const
+{
+	return rate;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Exportacin
+//////////////////////////////////////////////////////////////////////
+
+bool HDLTruthTable::save( const QString & fileName, int period ) const
+{
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly ) )
+		return false;
+
+	QTextStream out( &file );
+	QStringList::const_iterator it;
+
+	out << "inputs";
+	for( it = inNames.begin(); it != inNames.end(); ++it )
+		out << " " << *it;
+	out << "\noutputs";
+	for( it = outNames.begin(); it != outNames.end(); ++it )
+		out << " " << *it;
+	out << "\n";
+
+	for( uint v=0; v < nVectors; v++ ){
+		out << v * period;
+
+		for( uint i=0; i < inNames.count(); i++ )
+			out << ( ( ( v >> i ) & 1 ) ? " 1" : " 0" );
+
+		out << " |";
+		for( uint o=0; o < outNames.count(); o++ )
+			out << ( value( o, v ) ? " 1" : " 0" );
+
+		out << "\n";
+	}
+
+	return true;
+}
@@ -0,0 +1,120 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLTruthTable.h: interface for the HDLTruthTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLTRUTHTABLE_H_)
+#define _HDLTRUTHTABLE_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluevector.h>
+#include <qmemarray.h>
+#include <qmap.h>
+
+#include "HDLGateKind.h"
+
+class HDLModelSnapshot;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLTruthTable
+//
+//	Tabla de verdad completa de un modelo combinacional, sin simulador:
+//	evala las 2^n combinaciones de sus entradas en paralelo de bits.
+//
+//	Parte de la netlist capturada en un HDLModelSnapshot (las mismas
+//	primitivas que HDLGateSimulator salvo registros y buffers triestado).
+//	Las puertas se ordenan por niveles (cada una tras las que excitan sus
+//	entradas) y cada red guarda Lanes palabras de 64 bits: un vector de
+//	entrada por bit, de forma que cada puerta evala Lanes*64 vectores con
+//	unas pocas operaciones AND/OR/XOR/NOT por palabra (bucles de longitud
+//	fija que el compilador puede vectorizar).
+//
+//	El vector v asigna a la entrada i el bit i de v. Las entradas son los
+//	puertos IN de la entidad y las salidas el resto, con los nombres de su
+//	fichero .sig.
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLTruthTable
+{
+public:
+	enum { Lanes = 4, MaxInputs = 24 };
+	typedef Q_ULLONG Word;
+
+	HDLTruthTable();
+
+	// Construye el circuito. Devuelve false si el modelo no es
+	// combinacional o instancia componentes sin modelo (ver errorString)
+	bool load( const HDLModelSnapshot & snapshot );
+	QString errorString() const;
+
+	const QStringList & inputNames() const;
+	const QStringList & outputNames() const;
+
+	// Nmero de niveles del circuito
+	int depth() const;
+
+	// Evala todos los vectores de entrada
+	bool evaluate();
+
+	uint vectorCount() const;
+	bool value( int output, uint vector ) const;
+
+	// Vectores evaluados por segundo en la ltima evaluacin
+	double vectorsPerSecond() const;
+
+	// Exporta la tabla en el formato de HDLVectorTable (un vector cada
+	// period ns, con sus salidas como resultados)
+	bool save( const QString & fileName, int period=10 ) const;
+
+private:
+	struct Gate{
+		HDLGateKind::Kind type;
+		QValueVector<int> inputs;	// Redes de entrada (ZeroNet si no estn conectadas)
+		QValueVector<int> outputs;	// Redes excitadas
+		int control;				// Red de E* (decodificadores)
+	};
+
+	enum { ZeroNet = 0 };
+
+	int net( const QString & name );
+	bool levelize();
+	void evaluateGate( const Gate & gate, Word * values ) const;
+
+	QString errStr;
+
+	QMap<QString, int> netIds;
+	QValueVector<QString> netNames;
+
+	QStringList inNames, outNames;
+	QValueVector<int> inNets, outNets;
+
+	QValueVector<Gate> gates;
+	QValueVector<int> order;	// Puertas por niveles
+	int levels;
+
+	// Resultados: una fila de palabras por salida
+	QMemArray<Word> table;
+	uint nVectors;
+	uint nWords;
+	double rate;
+};
+
+#endif
@@ -18,6 +18,7 @@
 
 #include "HDLVComAssembler.h"
 #include "HDLProcess.h"
+#include "HDLSimSession.h"
 
 #include <qprocess.h>
 #include <qregexp.h>
@@ -124,18 +125,41 @@ bool HDLVComAssembler::buildProject( const QString& entity, const QString& proje
 // Simulacin
 //////////////////////////////////////////////////////////////////////
 // Simula el modelo 'model', variando las seales 'inputs' usando las libreras 'dependences' [seleccionando las salidas 'outputs']
+//
+// Cada modelo tiene su propia sesin del simulador (un hijo llamado
+// "vsim:modelo"), que se mantiene abierta entre simulaciones: el modelo
+// slo se elabora la primera vez o si cambian sus dependencias
 bool HDLVComAssembler::forceSignals( const QString& model, const SignalValues & inputs , const QStringList& dependences, const SignalValues & outputs )
 {
-	HDLProcSimulator * vsim = new HDLProcSimulator( model, dependences, inputs, outputs, this, "vsim" );
-	
-	// Manejadores de mensajes
-	connect( vsim, SIGNAL(errorMessage(const QString&)), this, SIGNAL(errorMessage(const QString&)) );
-	connect( vsim, SIGNAL(outputMessage(const QString&)), this, SIGNAL(outputMessage(const QString&)) );
-
-	connect( vsim, SIGNAL(success()), this, SLOT(vsimSuccess()) );
-	connect( vsim, SIGNAL(failure()), this, SLOT(vsimFailure()) );
-
-	return vsim->start();
+	QString sessionName = "vsim:" + model;
+	HDLSimSession * vsim = (HDLSimSession*) child( sessionName.latin1(), "HDLSimSession", FALSE );
+
+	if( vsim && vsim->libraryDependences() != dependences ){
+		// Puede estar notificando una simulacin: se destruye ms tarde
+		vsim->close();
+		vsim->setName( "vsim:closed" );
+		vsim->deleteLater();
+		vsim = NULL;
+	}
+
+	if( !vsim ){
+		vsim = new HDLSimSession( model, dependences, this, sessionName.latin1() );
+
+		// Manejadores de mensajes
+		connect( vsim, SIGNAL(errorMessage(const QString&)), this, SIGNAL(errorMessage(const QString&)) );
+		connect( vsim, SIGNAL(outputMessage(const QString&)), this, SIGNAL(outputMessage(const QString&)) );
+
+		connect( vsim, SIGNAL(success()), this, SLOT(vsimSuccess()) );
+		connect( vsim, SIGNAL(failure()), this, SLOT(vsimFailure()) );
+
+		if( !vsim->open() ){
+			emit errorMessage( tr("> No se pudo lanzar el simulador para el modelo %1.").arg( model ) );
+			delete vsim;
+			return false;
+		}
+	}
+
+	return vsim->simulate( inputs, outputs );
 }
 
 bool HDLVComAssembler::forceSignals( const QString& model, const SignalValues & inputs , const QStringList& dependences )
@@ -228,6 +252,13 @@ void HDLVComAssembler::vsimSuccess()
 	HDLProcSimulator * procSim = (HDLProcSimulator*)sender();
 
 	emit simulationSuccess( procSim->model(), procSim->inputSignals(), procSim->outputSignals() );
+
+	// Las sesiones persistentes siguen abiertas para la siguiente simulacin
+	if( procSim->inherits( "HDLSimSession" ) ){
+		emit outputMessage( tr("> Simulacin de %1 finalizada con xito.").arg( procSim->model() ) );
+		return;
+	}
+
 	emit outputMessage( tr("> %1 ha finalizado con xito.").arg( procSim->arguments().join(" ") ) );
 
 	delete procSim;
@@ -244,6 +275,12 @@ void HDLVComAssembler::vsimFailure()
 	HDLProcSimulator * procSim = (HDLProcSimulator*)sender();
 	
 	emit simulationFailure( procSim->model(), procSim->inputSignals() );
+
+	if( procSim->inherits( "HDLSimSession" ) ){
+		emit errorMessage( tr("> Simulacin de %1 finalizada con errores.").arg( procSim->model() ) );
+		return;
+	}
+
 	emit errorMessage( tr("> %1 ha finalizado con errores.").arg( procSim->arguments().join(" ") ) );
 	
 	delete procSim;
@@ -0,0 +1,460 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLVectorTable.cpp: implementation of the HDLVectorTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLVectorTable.h"
+
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qstringlist.h>
+#include <qdom.h>
+#include <qobject.h>
+
+#include "LEPin.h"
+#include "LMComponent.h"
+
+// Tipo VHDL de un puerto de width bits
+static QString typeName( int width )
+{
+	if( width <= 1 )
+		return "BIT";
+
+	return QString( "BIT_VECTOR(%1 DOWNTO 0)" ).arg( width - 1 );
+}
+
+// Literal VHDL de un valor
+static QString literal( const QString & value )
+{
+	if( value.length() == 1 )
+		return "'" + value + "'";
+
+	return "\"" + value + "\"";
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLVectorTable::HDLVectorTable()
+{
+	clear();
+}
+
+void HDLVectorTable::clear()
+{
+	ent = QString::null;
+	ins.clear();
+	outs.clear();
+	inWidth = 0;
+	outWidth = 0;
+
+	times.clear();
+	vals.clear();
+	results.clear();
+	nResults = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Columnas
+//////////////////////////////////////////////////////////////////////
+
+void HDLVectorTable::addInput( const QString & name, int width )
+{
+	Column col;
+	col.name = name;
+	col.mode = "IN";
+	col.width = width;
+
+	ins.append( col );
+	inWidth += width;
+}
+
+void HDLVectorTable::addOutput( const QString & name, int width, const QString & mode )
+{
+	Column col;
+	col.name = name;
+	col.mode = mode;
+	col.width = width;
+
+	outs.append( col );
+	outWidth += width;
+}
+
+bool HDLVectorTable::setPorts( const QString & sigFile )
+{
+	QFile file( sigFile );
+	if( !file.open( IO_ReadOnly ) ){
+		errStr = QObject::tr("No se pudo abrir el fichero de seales '%1'.").arg( sigFile );
+		return false;
+	}
+
+	QDomDocument dom;
+	if( !dom.setContent( &file ) || dom.documentElement().tagName() != "signals" ){
+		errStr = QObject::tr("'%1' no es un fichero de seales vlido.").arg( sigFile );
+		return false;
+	}
+
+	LMComponent cmp;
+	if( !cmp.parseSignals( dom.documentElement() ) ){
+		errStr = QObject::tr("'%1' no es un fichero de seales vlido.").arg( sigFile );
+		return false;
+	}
+
+	// Las columnas cambian: los vectores dejan de ser vlidos
+	clear();
+	ent = cmp.name();
+
+	for( PinList::iterator it = cmp.pinList().begin(); it != cmp.pinList().end(); ++it )
+		if( (*it).accessMode() == LEPin::Input )
+			addInput( (*it).name(), (*it).busWidth() );
+		else
+			addOutput( (*it).name(), (*it).busWidth(), (*it).accessMode() == LEPin::Output ? "OUT" : "INOUT" );
+
+	return true;
+}
+
+QString HDLVectorTable::entity() const
+{
+	return ent;
+}
+
+const QValueList<HDLVectorTable::Column> & HDLVectorTable::inputs() const
+{
+	return ins;
+}
+
+const QValueList<HDLVectorTable::Column> & HDLVectorTable::outputs() const
+{
+	return outs;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Vectores
+//////////////////////////////////////////////////////////////////////
+
+int HDLVectorTable::addVector( int time, const QString & values )
+{
+	if( (int)values.length() != inWidth )
+		return -1;
+
+	if( !times.isEmpty() && time <= times.back() )
+		return -1;
+
+	times.push_back( time );
+	vals.push_back( values );
+	results.push_back( QString::null );
+
+	return times.size() - 1;
+}
+
+uint HDLVectorTable::count() const
+{
+	return times.size();
+}
+
+int HDLVectorTable::time( int vector ) const
+{
+	return times[vector];
+}
+
+const QString & HDLVectorTable::values( int vector ) const
+{
+	return vals[vector];
+}
+
+void HDLVectorTable::setResult( int vector, const QString & outputs )
+{
+	if( vector < 0 || vector >= (int)results.size() )
+		return;
+
+	if( results[vector].isNull() )
+		nResults++;
+
+	// Una tabla sin salidas tambin registra los vectores simulados
+	results[vector] = outputs.isNull() ? QString( "" ) : outputs;
+}
+
+const QString & HDLVectorTable::result( int vector ) const
+{
+	return results[vector];
+}
+
+uint HDLVectorTable::resultCount() const
+{
+	return nResults;
+}
+
+void HDLVectorTable::clearResults()
+{
+	for( uint i=0; i < results.size(); i++ )
+		results[i] = QString::null;
+	nResults = 0;
+}
+
+int HDLVectorTable::sampleTime( int vector ) const
+{
+	if( vector + 1 < (int)times.size() )
+		return times[vector + 1];
+
+	return times[vector] + SettleTime;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Ficheros
+//////////////////////////////////////////////////////////////////////
+
+QString HDLVectorTable::errorString() const
+{
+	return errStr;
+}
+
+// Las lneas de un fichero guardado con resultados ("... | salidas")
+// recuperan tambin los resultados
+bool HDLVectorTable::load( const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) ){
+		errStr = QObject::tr("No se pudo abrir el fichero de estmulos '%1'.").arg( fileName );
+		return false;
+	}
+
+	clear();
+
+	QTextStream in( &file );
+	for( int nLine = 1; !in.atEnd(); nLine++ ){
+		QString line = in.readLine().stripWhiteSpace();
+		if( line.isEmpty() || line[0] == '#' )
+			continue;
+
+		QStringList fields = QStringList::split( ' ', line.simplifyWhiteSpace() );
+
+		// Columnas: nombre[:ancho]
+		if( fields[0] == "inputs" || fields[0] == "outputs" ){
+			for( QStringList::iterator it = fields.at( 1 ); it != fields.end(); ++it ){
+				int width = 1;
+				QString name = (*it).section( ':', 0, 0 );
+				if( (*it).contains( ':' ) )
+					width = (*it).section( ':', 1, 1 ).toInt();
+
+				if( name.isEmpty() || width < 1 ){
+					errStr = QObject::tr("%1:%2: columna '%3' no vlida.").arg( fileName ).arg( nLine ).arg( *it );
+					return false;
+				}
+
+				if( fields[0] == "inputs" )
+					addInput( name, width );
+				else
+					addOutput( name, width );
+			}
+			continue;
+		}
+
+		// Vector: instante, un valor por entrada y, opcionalmente, "|" y
+		// un valor por salida
+		bool ok;
+		int t = fields[0].toInt( &ok );
+		if( !ok || fields.count() < ins.count() + 1 ){
+			errStr = QObject::tr("%1:%2: vector no vlido.").arg( fileName ).arg( nLine );
+			return false;
+		}
+
+		QString values;
+		for( uint i=1; i <= ins.count(); i++ )
+			values += fields[i];
+
+		int vector = addVector( t, values );
+		if( vector == -1 ){
+			errStr = QObject::tr("%1:%2: el vector no cubre las entradas o su instante no es creciente.").arg( fileName ).arg( nLine );
+			return false;
+		}
+
+		if( fields.count() > ins.count() + 1 && fields[ ins.count() + 1 ] == "|" ){
+			QString outputs;
+			for( uint i = ins.count() + 2; i < fields.count(); i++ )
+				outputs += fields[i];
+			setResult( vector, outputs );
+		}
+	}
+
+	return true;
+}
+
+bool HDLVectorTable::save( const QString & fileName ) const
+{
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly ) )
+		return false;
+
+	QTextStream out( &file );
+	QValueList<Column>::const_iterator itCol;
+
+	out << "inputs";
+	for( itCol = ins.begin(); itCol != ins.end(); ++itCol ){
+		out << " " << (*itCol).name;
+		if( (*itCol).width > 1 )
+			out << ":" << (*itCol).width;
+	}
+	out << "\noutputs";
+	for( itCol = outs.begin(); itCol != outs.end(); ++itCol ){
+		out << " " << (*itCol).name;
+		if( (*itCol).width > 1 )
+			out << ":" << (*itCol).width;
+	}
+	out << "\n";
+
+	for( uint i=0; i < times.size(); i++ ){
+		out << times[i];
+
+		int offset = 0;
+		for( itCol = ins.begin(); itCol != ins.end(); ++itCol ){
+			out << " " << vals[i].mid( offset, (*itCol).width );
+			offset += (*itCol).width;
+		}
+
+		if( !results[i].isNull() ){
+			out << " |";
+			offset = 0;
+			for( itCol = outs.begin(); itCol != outs.end(); ++itCol ){
+				out << " " << results[i].mid( offset, (*itCol).width );
+				offset += (*itCol).width;
+			}
+		}
+
+		out << "\n";
+	}
+
+	return true;
+}
+
+// Slo se fuerzan las entradas que cambian respecto al vector anterior
+void HDLVectorTable::writeDoFile( QTextStream & out ) const
+{
+	QValueList<Column>::const_iterator itCol;
+
+	if( !times.isEmpty() && times[0] > 0 )
+		out << "run " << times[0] << " ns\n";
+
+	for( uint i=0; i < times.size(); i++ ){
+		int offset = 0;
+		for( itCol = ins.begin(); itCol != ins.end(); ++itCol ){
+			QString value = vals[i].mid( offset, (*itCol).width );
+			if( i == 0 || value != vals[i-1].mid( offset, (*itCol).width ) )
+				out << "force " << (*itCol).name << " " << value << "\n";
+			offset += (*itCol).width;
+		}
+
+		out << "run " << sampleTime( i ) - times[i] << " ns\n";
+
+		out << "echo \"@@ROW " << i;
+		for( itCol = outs.begin(); itCol != outs.end(); ++itCol )
+			out << " [examine -radix binary " << (*itCol).name << "]";
+		out << "\"\n";
+	}
+}
+
+bool HDLVectorTable::writeTestbench( QTextStream & out ) const
+{
+	if( ent.isEmpty() ){
+		errStr = QObject::tr("La tabla de vectores no tiene entidad (ver setPorts).");
+		return false;
+	}
+
+	// Los puertos del modelo son de tipo BIT
+	for( uint i=0; i < vals.size(); i++ )
+		for( uint j=0; j < vals[i].length(); j++ )
+			if( vals[i][j] != '0' && vals[i][j] != '1' ){
+				errStr = QObject::tr("El vector %1 tiene valores distintos de '0' y '1'.").arg( i );
+				return false;
+			}
+
+	QValueList<Column> ports = ins + outs;
+	QValueList<Column>::const_iterator itCol;
+
+	// ENTITY
+	out << "ENTITY tb_" << ent << " IS\nEND tb_" << ent << ";\n\n";
+
+	// ARCHITECTURE
+	out << "ARCHITECTURE estimulos OF tb_" << ent << " IS\n";
+
+	out << "\tCOMPONENT " << ent << "\n\t\tPORT( ";
+	for( itCol = ports.begin(); itCol != ports.end(); ++itCol ){
+		if( itCol != ports.begin() )
+			out << "; ";
+		out << (*itCol).name << " : " << (*itCol).mode << " " << typeName( (*itCol).width );
+	}
+	out << ");\n\tEND COMPONENT;\n\n";
+
+	for( itCol = ports.begin(); itCol != ports.end(); ++itCol )
+		out << "\tSIGNAL " << (*itCol).name << ": " << typeName( (*itCol).width ) << ";\n";
+	out << "\n";
+
+	// Valor de una seal como cadena de bits
+	out << "\tFUNCTION tb_image( v : BIT_VECTOR ) RETURN STRING IS\n"
+		<< "\t\tVARIABLE s : STRING( 1 TO v'LENGTH );\n"
+		<< "\t\tVARIABLE i : INTEGER := 1;\n"
+		<< "\tBEGIN\n"
+		<< "\t\tFOR k IN v'RANGE LOOP\n"
+		<< "\t\t\tIF v(k) = '1' THEN s(i) := '1'; ELSE s(i) := '0'; END IF;\n"
+		<< "\t\t\ti := i + 1;\n"
+		<< "\t\tEND LOOP;\n"
+		<< "\t\tRETURN s;\n"
+		<< "\tEND tb_image;\n\n";
+
+	// BEGIN
+	out << "\tBEGIN\n";
+
+	out << "\t\tuut : " << ent << " PORT MAP( ";
+	for( itCol = ports.begin(); itCol != ports.end(); ++itCol ){
+		if( itCol != ports.begin() )
+			out << ", ";
+		out << (*itCol).name << " => " << (*itCol).name;
+	}
+	out << ");\n\n";
+
+	out << "\t\tPROCESS\n\t\tBEGIN\n";
+	if( !times.isEmpty() && times[0] > 0 )
+		out << "\t\t\tWAIT FOR " << times[0] << " ns;\n";
+	for( uint i=0; i < times.size(); i++ ){
+		int offset = 0;
+		for( itCol = ins.begin(); itCol != ins.end(); ++itCol ){
+			QString value = vals[i].mid( offset, (*itCol).width );
+			if( i == 0 || value != vals[i-1].mid( offset, (*itCol).width ) )
+				out << "\t\t\t" << (*itCol).name << " <= " << literal( value ) << ";\n";
+			offset += (*itCol).width;
+		}
+
+		out << "\t\t\tWAIT FOR " << sampleTime( i ) - times[i] << " ns;\n";
+
+		out << "\t\t\tREPORT \"@@ROW " << i << "\"";
+		for( itCol = outs.begin(); itCol != outs.end(); ++itCol )
+			if( (*itCol).width > 1 )
+				out << " & \" \" & tb_image( " << (*itCol).name << " )";
+			else
+				out << " & \" \" & tb_image( BIT_VECTOR'( 0 => " << (*itCol).name << " ) )";
+		out << ";\n";
+	}
+	out << "\t\t\tWAIT;\n\t\tEND PROCESS;\n\n";
+
+	// END
+	out << "END estimulos;\n";
+
+	return true;
+}
@@ -0,0 +1,141 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLVectorTable.h: interface for the HDLVectorTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLVECTORTABLE_H_)
+#define _HDLVECTORTABLE_H_
+
+#include <qstring.h>
+#include <qvaluelist.h>
+#include <qvaluevector.h>
+
+class QTextStream;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLVectorTable
+//
+//	Tabla de vectores de estmulo de un modelo, para simular una tabla de
+//	verdad completa en una nica simulacin en lugar de una por vector.
+//
+//	Las columnas son las entradas y salidas del modelo (pueden tomarse de
+//	su fichero .sig). Cada vector tiene un instante de aplicacin (ns) y
+//	los valores de todas las entradas concatenados ('0', '1', 'Z'...; un
+//	carcter por bit, del ms significativo al menos); la simulacin
+//	empieza en el instante 0 y llega al primer vector. Las salidas se
+//	muestrean justo antes del vector siguiente (SettleTime ns despus del
+//	ltimo) y se guardan con el mismo formato, una fila por vector.
+//
+//	La tabla se expande a un fichero de rdenes (force/run/echo) o a un
+//	banco de pruebas VHDL; en ambos casos cada fila de resultados se
+//	devuelve en una lnea "@@ROW n salidas" de la salida del simulador.
+//
+//	Formato del fichero de estmulos:
+//
+//		# comentario
+//		inputs A B:4		(nombre[:ancho])
+//		outputs S
+//		0 0 0101			(instante y un valor por entrada)
+//		10 1 0101
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLVectorTable
+{
+public:
+	enum { SettleTime = 10 };
+
+	struct Column{
+		QString name;
+		QString mode;	// IN, OUT o INOUT
+		int width;
+	};
+
+	HDLVectorTable();
+
+	void clear();
+
+	//////////////////////////////////////////////////////////////////////
+	// Columnas
+	//////////////////////////////////////////////////////////////////////
+
+	void addInput( const QString & name, int width=1 );
+	void addOutput( const QString & name, int width=1, const QString & mode="OUT" );
+
+	// Columnas a partir del fichero .sig del modelo: los puertos IN son
+	// entradas y el resto salidas
+	bool setPorts( const QString & sigFile );
+
+	QString entity() const;
+	const QValueList<Column> & inputs() const;
+	const QValueList<Column> & outputs() const;
+
+	//////////////////////////////////////////////////////////////////////
+	// Vectores
+	//////////////////////////////////////////////////////////////////////
+
+	// Aade un vector (los instantes deben ser crecientes). Devuelve su
+	// ndice o -1 si los valores no cubren las entradas
+	int addVector( int time, const QString & values );
+
+	uint count() const;
+	int time( int vector ) const;
+	const QString & values( int vector ) const;
+
+	// Resultados: valores concatenados de las salidas (null si el vector
+	// no se ha simulado)
+	void setResult( int vector, const QString & outputs );
+	const QString & result( int vector ) const;
+	uint resultCount() const;
+	void clearResults();
+
+	//////////////////////////////////////////////////////////////////////
+	// Ficheros
+	//////////////////////////////////////////////////////////////////////
+
+	// Carga los estmulos / guarda estmulos y resultados
+	bool load( const QString & fileName );
+	bool save( const QString & fileName ) const;
+	QString errorString() const;
+
+	// rdenes para el simulador con el modelo ya elaborado
+	void writeDoFile( QTextStream & out ) const;
+
+	// Banco de pruebas "tb_entidad" que instancia el modelo, aplica los
+	// vectores e informa de las salidas con REPORT. Se compila junto al
+	// modelo y se simula por separado (vsim -c tb_entidad -do "run -all")
+	bool writeTestbench( QTextStream & out ) const;
+
+private:
+	// Instante de muestreo de las salidas del vector
+	int sampleTime( int vector ) const;
+
+	QString ent;
+	QValueList<Column> ins, outs;
+	int inWidth, outWidth;
+
+	QValueVector<int> times;
+	QValueVector<QString> vals;
+	QValueVector<QString> results;
+	uint nResults;
+
+	mutable QString errStr;
+};
+
+#endif
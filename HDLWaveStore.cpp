@@ -0,0 +1,670 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLWaveStore.cpp: implementation of the HDLWaveStore class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "HDLWaveStore.h"
+
+#include <qtextstream.h>
+#include <qdatastream.h>
+#include <qobject.h>
+
+#include <string.h>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#endif
+
+#define WAVESTORE_MAGIC 0x49455756		// "IEWV"
+#define WAVESTORE_VERSION 1
+
+// Cabecera (magia y versin) y cola (posicin del ndice y magia)
+#define WAVESTORE_HEADER_SIZE 8
+#define WAVESTORE_TRAILER_SIZE 12
+
+// Valores de un bit: su posicin en la tabla es su cdigo de 4 bits
+static const char symbols[] = "01XZUWLH-";
+
+static uchar symbolCode( QChar c )
+{
+	const char * p = c.latin1() ? strchr( symbols, c.latin1() ) : NULL;
+	return p ? (uchar)( p - symbols ) : 2;
+}
+
+// Ajusta un valor al ancho de la seal: los valores ms estrechos se
+// extienden con '0' o, si empiezan por 'X' o 'Z', con ese valor (VCD)
+static QString extend( const QString & value, int width )
+{
+	QString v = value.upper();
+
+	if( (int)v.length() > width )
+		return v.right( width );
+
+	if( (int)v.length() < width ){
+		QChar fill = ( !v.isEmpty() && ( v[0] == 'X' || v[0] == 'Z' ) ) ? v[0] : QChar( '0' );
+		v = QString().fill( fill, width - v.length() ) + v;
+	}
+
+	return v;
+}
+
+// QDataStream de Qt 3 no serializa enteros de 64 bits
+static void writeUInt64( QDataStream & out, Q_ULLONG value )
+{
+	out << (Q_UINT32)( value >> 32 ) << (Q_UINT32)( value & 0xffffffff );
+}
+
+static Q_ULLONG readUInt64( QDataStream & in )
+{
+	Q_UINT32 hi, lo;
+	in >> hi >> lo;
+	return ( (Q_ULLONG)hi << 32 ) | lo;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+HDLWaveStore::HDLWaveStore()
+	: tEnd( 0 ), writing( false ), writeOffset( 0 ), mapped( NULL ), mappedSize( 0 )
+{
+}
+
+HDLWaveStore::~HDLWaveStore()
+{
+	close();
+}
+
+void HDLWaveStore::reset()
+{
+	for( uint i=0; i < sigs.size(); i++ )
+		delete sigs[i];
+	sigs.clear();
+	sigIds.clear();
+	tEnd = 0;
+}
+
+QString HDLWaveStore::errorString() const
+{
+	return errStr;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Escritura
+//////////////////////////////////////////////////////////////////////
+
+bool HDLWaveStore::create( const QString & fileName )
+{
+	close();
+
+	file.setName( fileName );
+	if( !file.open( IO_WriteOnly | IO_Truncate ) ){
+		errStr = QObject::tr("No se pudo crear el fichero de formas de onda '%1'.").arg( fileName );
+		return false;
+	}
+
+	QDataStream out( &file );
+	out << (Q_UINT32)WAVESTORE_MAGIC << (Q_UINT32)WAVESTORE_VERSION;
+
+	writing = true;
+	writeOffset = WAVESTORE_HEADER_SIZE;
+
+	return true;
+}
+
+int HDLWaveStore::addSignal( const QString & name, int width )
+{
+	QMap<QString, int>::const_iterator it = sigIds.find( name );
+	if( it != sigIds.end() )
+		return it.data();
+
+	Signal * sig = new Signal;
+	sig->name = name;
+	sig->width = ( width > 0 ) ? width : 1;
+	sig->pendingSize = 0;
+	sig->pendingCount = 0;
+	sig->pendingStart = 0;
+	sig->lastTime = 0;
+
+	sigs.push_back( sig );
+	sigIds.insert( name, sigs.size() - 1 );
+
+	return sigs.size() - 1;
+}
+
+void HDLWaveStore::addChange( int signal, Time time, const QString & value )
+{
+	if( !writing || signal < 0 || signal >= (int)sigs.size() )
+		return;
+
+	Signal & sig = *sigs[signal];
+	QString v = extend( value, sig.width );
+
+	// Slo se guardan los cambios, en orden
+	if( !sig.lastValue.isNull() && ( v == sig.lastValue || time < sig.lastTime ) )
+		return;
+
+	Time delta = 0;
+	if( sig.pendingCount == 0 )
+		sig.pendingStart = time;
+	else
+		delta = time - sig.lastTime;
+
+	// Instante: diferencia con el cambio anterior del bloque (7 bits por byte)
+	while( delta >= 0x80 ){
+		append( sig, (uchar)( delta | 0x80 ) );
+		delta >>= 7;
+	}
+	append( sig, (uchar)delta );
+
+	// Valor: un nibble por bit (symbolCode), dos bits de la seal por byte
+	for( int k=0; k < sig.width; k += 2 ){
+		uchar b = symbolCode( v[k] ) << 4;
+		if( k + 1 < sig.width )
+			b |= symbolCode( v[k+1] );
+		append( sig, b );
+	}
+
+	sig.pendingCount++;
+	sig.lastTime = time;
+	sig.lastValue = v;
+
+	if( time > tEnd )
+		tEnd = time;
+
+	if( sig.pendingCount == ChunkSize )
+		flushChunk( sig );
+}
+
+void HDLWaveStore::append( Signal & sig, uchar byte )
+{
+	if( sig.pendingSize == sig.pending.size() )
+		sig.pending.resize( sig.pending.size() ? 2*sig.pending.size() : 256 );
+
+	sig.pending[ sig.pendingSize++ ] = byte;
+}
+
+void HDLWaveStore::flushChunk( Signal & sig )
+{
+	if( sig.pendingCount == 0 )
+		return;
+
+	Chunk chunk;
+	chunk.start = sig.pendingStart;
+	chunk.offset = writeOffset;
+	chunk.count = sig.pendingCount;
+	chunk.size = sig.pendingSize;
+
+	file.writeBlock( (const char*)sig.pending.data(), sig.pendingSize );
+	writeOffset += sig.pendingSize;
+
+	sig.chunks.push_back( chunk );
+	sig.pendingSize = 0;
+	sig.pendingCount = 0;
+}
+
+// ndice: seales con sus bloques, instante final y, en la cola, la
+// posicin del ndice
+bool HDLWaveStore::writeIndex()
+{
+	QDataStream out( &file );
+
+	out << (Q_UINT32)sigs.size();
+	for( uint i=0; i < sigs.size(); i++ ){
+		const Signal & sig = *sigs[i];
+		out << sig.name << (Q_INT32)sig.width << (Q_UINT32)sig.chunks.size();
+
+		for( uint c=0; c < sig.chunks.size(); c++ ){
+			writeUInt64( out, sig.chunks[c].start );
+			writeUInt64( out, sig.chunks[c].offset );
+			out << (Q_UINT32)sig.chunks[c].count << (Q_UINT32)sig.chunks[c].size;
+		}
+	}
+	writeUInt64( out, tEnd );
+
+	writeUInt64( out, writeOffset );
+	out << (Q_UINT32)WAVESTORE_MAGIC;
+
+	return file.status() == IO_Ok;
+}
+
+bool HDLWaveStore::close()
+{
+	bool ok = true;
+
+	if( writing ){
+		for( uint i=0; i < sigs.size(); i++ )
+			flushChunk( *sigs[i] );
+
+		ok = writeIndex();
+		if( !ok )
+			errStr = QObject::tr("Error escribiendo el fichero de formas de onda '%1'.").arg( file.name() );
+
+		writing = false;
+	}
+	reset();
+
+#if defined(Q_OS_UNIX)
+	if( mapped )
+		munmap( mapped, mappedSize );
+#endif
+	mapped = NULL;
+	mappedSize = 0;
+
+	if( file.isOpen() )
+		file.close();
+
+	return ok;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Volcados del simulador
+//////////////////////////////////////////////////////////////////////
+
+// Declaraciones $scope/$var hasta $enddefinitions (una por lnea) y
+// despus instantes (#t) y cambios ("0!", "b0101 #"). Las seales se
+// nombran con su mbito: ambito/subambito/seal
+bool HDLWaveStore::ingestVCD( QTextStream & in )
+{
+	if( !writing )
+		return false;
+
+	QMap<QString, int> ids;
+	QStringList scopes;
+	bool header = true;
+	Time now = 0;
+
+	while( !in.atEnd() ){
+		QStringList fields = QStringList::split( ' ', in.readLine().simplifyWhiteSpace() );
+		if( fields.isEmpty() )
+			continue;
+
+		if( header ){
+			if( fields[0] == "$scope" && fields.count() >= 3 )
+				scopes.append( fields[2] );
+			else if( fields[0] == "$upscope" && !scopes.isEmpty() )
+				scopes.remove( scopes.fromLast() );
+			else if( fields[0] == "$var" && fields.count() >= 5 ){
+				// $var tipo ancho identificador nombre [rango] $end
+				// (los identificadores repetidos son alias de la misma seal)
+				if( !ids.contains( fields[3] ) ){
+					QString name = scopes.isEmpty() ? fields[4] : scopes.join( "/" ) + "/" + fields[4];
+					ids.insert( fields[3], addSignal( name, fields[2].toInt() ) );
+				}
+			}else if( fields[0] == "$enddefinitions" )
+				header = false;
+			continue;
+		}
+
+		for( QStringList::iterator it = fields.begin(); it != fields.end(); ++it ){
+			QChar c = (*it)[0];
+
+			if( c == '#' ){
+				now = (*it).mid( 1 ).toULongLong();
+			}else if( c == '$' ){
+				// $dumpvars, $end...
+				continue;
+			}else if( c == 'b' || c == 'B' || c == 'r' || c == 'R' ){
+				// Vector: valor e identificador separados (los reales se ignoran)
+				QString value = (*it).mid( 1 );
+				if( ++it == fields.end() )
+					break;
+
+				QMap<QString, int>::iterator itId = ids.find( *it );
+				if( itId != ids.end() && c.lower() == 'b' )
+					addChange( itId.data(), now, value );
+			}else{
+				QMap<QString, int>::iterator itId = ids.find( (*it).mid( 1 ) );
+				if( itId != ids.end() )
+					addChange( itId.data(), now, QString( c ) );
+			}
+		}
+	}
+
+	return true;
+}
+
+// Listado de vsim (write list): una cabecera con los nombres de las
+// seales y una fila por instante: tiempo, ciclo delta (+n) y un valor por
+// seal
+bool HDLWaveStore::ingestList( QTextStream & in )
+{
+	if( !writing )
+		return false;
+
+	QStringList names;
+	QValueVector<int> ids;
+
+	while( !in.atEnd() ){
+		QStringList fields = QStringList::split( ' ', in.readLine().simplifyWhiteSpace() );
+		if( fields.isEmpty() )
+			continue;
+
+		bool isRow;
+		Time t = fields[0].toULongLong( &isRow );
+
+		// Cabecera: nombres de las seales (sin unidades ni "delta")
+		if( !isRow ){
+			if( ids.isEmpty() )
+				for( QStringList::iterator it = fields.begin(); it != fields.end(); ++it )
+					if( *it != "ns" && *it != "ps" && *it != "fs" && *it != "us" && *it != "ms" && *it != "delta" )
+						names.append( (*it)[0] == '/' ? (*it).mid( 1 ) : *it );
+			continue;
+		}
+
+		uint first = ( fields.count() > 1 && fields[1][0] == '+' ) ? 2 : 1;
+
+		// El ancho de cada seal es el de su primer valor
+		if( ids.isEmpty() )
+			for( uint i=0; i < names.count(); i++ ){
+				int width = ( first + i < fields.count() ) ? fields[ first + i ].length() : 1;
+				ids.push_back( addSignal( names[i], width ) );
+			}
+
+		for( uint i=0; i < ids.size() && first + i < fields.count(); i++ )
+			addChange( ids[i], t, fields[ first + i ] );
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Lectura
+//////////////////////////////////////////////////////////////////////
+
+bool HDLWaveStore::open( const QString & fileName )
+{
+	close();
+
+	file.setName( fileName );
+	if( !file.open( IO_ReadOnly ) ){
+		errStr = QObject::tr("No se pudo abrir el fichero de formas de onda '%1'.").arg( fileName );
+		return false;
+	}
+
+	Q_ULLONG size = file.size();
+	if( size < WAVESTORE_HEADER_SIZE + WAVESTORE_TRAILER_SIZE ){
+		errStr = QObject::tr("'%1' no es un fichero de formas de onda vlido.").arg( fileName );
+		file.close();
+		return false;
+	}
+
+	QDataStream in( &file );
+	Q_UINT32 magic, version;
+	in >> magic >> version;
+
+	file.at( size - WAVESTORE_TRAILER_SIZE );
+	Q_ULLONG indexOffset = readUInt64( in );
+	Q_UINT32 endMagic;
+	in >> endMagic;
+
+	if( magic != WAVESTORE_MAGIC || endMagic != WAVESTORE_MAGIC || version != WAVESTORE_VERSION || indexOffset >= size ){
+		errStr = QObject::tr("'%1' no es un fichero de formas de onda vlido.").arg( fileName );
+		file.close();
+		return false;
+	}
+
+	// ndice
+	file.at( indexOffset );
+
+	Q_UINT32 nSigs;
+	in >> nSigs;
+	for( uint i=0; i < nSigs && !in.atEnd(); i++ ){
+		QString name;
+		Q_INT32 width;
+		Q_UINT32 nChunks;
+		in >> name >> width >> nChunks;
+
+		Signal & sig = *sigs[ addSignal( name, width ) ];
+		sig.chunks.reserve( nChunks );
+		for( uint c=0; c < nChunks; c++ ){
+			Chunk chunk;
+			chunk.start = readUInt64( in );
+			chunk.offset = readUInt64( in );
+
+			Q_UINT32 count, chunkSize;
+			in >> count >> chunkSize;
+			chunk.count = count;
+			chunk.size = chunkSize;
+
+			sig.chunks.push_back( chunk );
+		}
+	}
+	tEnd = readUInt64( in );
+
+	// Los bloques se leen de la proyeccin del fichero
+#if defined(Q_OS_UNIX)
+	void * p = mmap( 0, size, PROT_READ, MAP_SHARED, file.handle(), 0 );
+	if( p != MAP_FAILED ){
+		mapped = (uchar*)p;
+		mappedSize = size;
+	}
+#endif
+
+	return true;
+}
+
+int HDLWaveStore::signalCount() const
+{
+	return sigs.size();
+}
+
+int HDLWaveStore::findSignal( const QString & name ) const
+{
+	QMap<QString, int>::const_iterator it = sigIds.find( name );
+	return ( it != sigIds.end() ) ? it.data() : -1;
+}
+
+QString HDLWaveStore::signalName( int signal ) const
+{
+	return sigs[signal]->name;
+}
+
+int HDLWaveStore::signalWidth( int signal ) const
+{
+	return sigs[signal]->width;
+}
+
+HDLWaveStore::Time HDLWaveStore::endTime() const
+{
+	return tEnd;
+}
+
+// ltimo bloque que empieza antes o en el instante time (-1 si no hay)
+int HDLWaveStore::findChunk( const Signal & sig, Time time ) const
+{
+	int lo = 0, hi = (int)sig.chunks.size() - 1, found = -1;
+
+	while( lo <= hi ){
+		int mid = ( lo + hi ) / 2;
+		if( sig.chunks[mid].start <= time ){
+			found = mid;
+			lo = mid + 1;
+		}else
+			hi = mid - 1;
+	}
+
+	return found;
+}
+
+void HDLWaveStore::decode( const Signal & sig, int chunk, QValueVector<Time> & times, QValueVector<QString> & values ) const
+{
+	const Chunk & c = sig.chunks[chunk];
+
+	QMemArray<uchar> buffer;
+	const uchar * data;
+	if( mapped )
+		data = mapped + c.offset;
+	else{
+		buffer.resize( c.size );
+		file.at( c.offset );
+		file.readBlock( (char*)buffer.data(), c.size );
+		data = buffer.data();
+	}
+
+	times.resize( c.count );
+	values.resize( c.count );
+
+	uint pos = 0;
+	Time t = c.start;
+	for( uint i=0; i < c.count && pos < c.size; i++ ){
+		Time delta = 0;
+		int shift = 0;
+		uchar b;
+		do{
+			b = data[pos++];
+			delta |= (Time)( b & 0x7f ) << shift;
+			shift += 7;
+		}while( ( b & 0x80 ) && pos < c.size );
+
+		t += delta;
+		times[i] = t;
+
+		QString v;
+		v.setLength( sig.width );
+		for( int k=0; k < sig.width; k += 2 ){
+			b = data[pos++];
+			v[k] = symbols[ ( b >> 4 ) < sizeof( symbols ) - 1 ? ( b >> 4 ) : 2 ];
+			if( k + 1 < sig.width )
+				v[k+1] = symbols[ ( b & 0x0f ) < sizeof( symbols ) - 1 ? ( b & 0x0f ) : 2 ];
+		}
+		values[i] = v;
+	}
+}
+
+QString HDLWaveStore::valueAt( int signal, Time time ) const
+{
+	if( signal < 0 || signal >= (int)sigs.size() )
+		return QString::null;
+
+	const Signal & sig = *sigs[signal];
+	int chunk = findChunk( sig, time );
+	if( chunk == -1 )
+		return QString::null;
+
+	QValueVector<Time> times;
+	QValueVector<QString> values;
+	decode( sig, chunk, times, values );
+
+	// ltimo cambio del bloque anterior o en el instante time
+	int lo = 0, hi = (int)times.size() - 1, found = 0;
+	while( lo <= hi ){
+		int mid = ( lo + hi ) / 2;
+		if( times[mid] <= time ){
+			found = mid;
+			lo = mid + 1;
+		}else
+			hi = mid - 1;
+	}
+
+	return values[found];
+}
+
+uint HDLWaveStore::changes( int signal, Time from, Time to, QValueList<Time> & times, QStringList & values ) const
+{
+	if( signal < 0 || signal >= (int)sigs.size() )
+		return 0;
+
+	const Signal & sig = *sigs[signal];
+	int chunk = findChunk( sig, from );
+	if( chunk == -1 )
+		chunk = 0;
+
+	uint n = 0;
+	QValueVector<Time> chunkTimes;
+	QValueVector<QString> chunkValues;
+	for( ; chunk < (int)sig.chunks.size() && sig.chunks[chunk].start <= to; chunk++ ){
+		decode( sig, chunk, chunkTimes, chunkValues );
+
+		for( uint i=0; i < chunkTimes.size(); i++ )
+			if( chunkTimes[i] >= from && chunkTimes[i] <= to ){
+				times.append( chunkTimes[i] );
+				values.append( chunkValues[i] );
+				n++;
+			}
+	}
+
+	return n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Comparacin
+//////////////////////////////////////////////////////////////////////
+
+// Siguiente cambio del cursor, sin consumirlo
+bool HDLWaveStore::peek( Cursor & cursor, Time & time ) const
+{
+	const Signal & sig = *sigs[ cursor.signal ];
+
+	while( cursor.index >= cursor.times.size() ){
+		if( cursor.chunk + 1 >= (int)sig.chunks.size() )
+			return false;
+
+		decode( sig, ++cursor.chunk, cursor.times, cursor.values );
+		cursor.index = 0;
+	}
+
+	time = cursor.times[ cursor.index ];
+	return true;
+}
+
+QString HDLWaveStore::take( Cursor & cursor ) const
+{
+	return cursor.values[ cursor.index++ ];
+}
+
+// Recorre ambas seales a la vez, bloque a bloque
+bool HDLWaveStore::firstDifference( int signal, const HDLWaveStore & other, int otherSignal, Time & time ) const
+{
+	if( signal < 0 || signal >= (int)sigs.size() || otherSignal < 0 || otherSignal >= (int)other.sigs.size() )
+		return false;
+
+	Cursor a, b;
+	a.signal = signal;
+	a.chunk = -1;
+	a.index = 0;
+	b.signal = otherSignal;
+	b.chunk = -1;
+	b.index = 0;
+
+	QString va, vb;
+	Time ta, tb;
+	bool hasA = peek( a, ta ), hasB = other.peek( b, tb );
+
+	while( hasA || hasB ){
+		Time t = ( !hasB || ( hasA && ta <= tb ) ) ? ta : tb;
+
+		while( hasA && ta == t ){
+			va = take( a );
+			hasA = peek( a, ta );
+		}
+		while( hasB && tb == t ){
+			vb = other.take( b );
+			hasB = other.peek( b, tb );
+		}
+
+		if( va != vb ){
+			time = t;
+			return true;
+		}
+	}
+
+	return false;
+}
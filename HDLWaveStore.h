@@ -0,0 +1,167 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// HDLWaveStore.h: interface for the HDLWaveStore class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_HDLWAVESTORE_H_)
+#define _HDLWAVESTORE_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+#include <qmemarray.h>
+#include <qmap.h>
+#include <qfile.h>
+
+class QTextStream;
+
+////////////////////////////////////////////////////////////////////////////////
+//	HDLWaveStore
+//
+//	Base de datos de formas de onda de una simulacin, alternativa a los
+//	ficheros de texto "signalsN.out" (write list), que hay que volver a
+//	leer desde el principio para cualquier consulta.
+//
+//	Se alimenta como un flujo (volcados VCD o listados de vsim) y guarda,
+//	por seal, slo sus cambios de valor en bloques de ChunkSize cambios:
+//	los instantes como diferencias codificadas en longitud variable y los
+//	valores con un nibble por bit ('0', '1', 'X', 'Z', 'U', 'W', 'L', 'H',
+//	'-'). Cada bloque se escribe en el fichero en cuanto se llena, as que
+//	la escritura usa memoria constante por seal.
+//
+//	Al cerrar se escribe el ndice: nombre y ancho de cada seal y, de
+//	cada bloque, su instante inicial y su posicin en el fichero. La
+//	lectura slo carga el ndice; los bloques se leen de la proyeccin en
+//	memoria del fichero (mmap, si el sistema la ofrece) segn se consultan,
+//	de forma que un valor en un instante se obtiene con dos bsquedas
+//	binarias (bloque y cambio dentro del bloque).
+//
+////////////////////////////////////////////////////////////////////////////////
+class HDLWaveStore
+{
+public:
+	enum { ChunkSize = 256 };
+	typedef Q_ULLONG Time;
+
+	HDLWaveStore();
+	~HDLWaveStore();
+
+	//////////////////////////////////////////////////////////////////////
+	// Escritura
+	//////////////////////////////////////////////////////////////////////
+
+	bool create( const QString & fileName );
+
+	// Seales y cambios de valor (en instantes no decrecientes por seal).
+	// Los valores ms estrechos que la seal se extienden como en VCD
+	int addSignal( const QString & name, int width=1 );
+	void addChange( int signal, Time time, const QString & value );
+
+	// Volcados completos del simulador
+	bool ingestVCD( QTextStream & in );
+	bool ingestList( QTextStream & in );
+
+	// Escribe los bloques pendientes y el ndice (si se est escribiendo)
+	// y cierra el fichero. Se consulta despus con open()
+	bool close();
+
+	//////////////////////////////////////////////////////////////////////
+	// Lectura
+	//////////////////////////////////////////////////////////////////////
+
+	bool open( const QString & fileName );
+
+	int signalCount() const;
+	int findSignal( const QString & name ) const;
+	QString signalName( int signal ) const;
+	int signalWidth( int signal ) const;
+	Time endTime() const;
+
+	// Valor de la seal en el instante time (null si an no tiene valor)
+	QString valueAt( int signal, Time time ) const;
+
+	// Cambios de la seal en [from, to], en orden. Devuelve su nmero
+	uint changes( int signal, Time from, Time to, QValueList<Time> & times, QStringList & values ) const;
+
+	// Primer instante en que la seal difiere de otherSignal de other.
+	// Devuelve false si no difieren nunca
+	bool firstDifference( int signal, const HDLWaveStore & other, int otherSignal, Time & time ) const;
+
+	QString errorString() const;
+
+private:
+	struct Chunk{
+		Time start;
+		Q_ULLONG offset;
+		uint count;
+		uint size;
+	};
+
+	struct Signal{
+		QString name;
+		int width;
+		QValueVector<Chunk> chunks;
+
+		// Escritura: bloque en construccin y ltimo cambio
+		QMemArray<uchar> pending;
+		uint pendingSize;
+		uint pendingCount;
+		Time pendingStart;
+		Time lastTime;
+		QString lastValue;
+	};
+
+	// Recorrido secuencial de los cambios de una seal
+	struct Cursor{
+		int signal;
+		int chunk;
+		uint index;
+		QValueVector<Time> times;
+		QValueVector<QString> values;
+	};
+
+	void reset();
+
+	void append( Signal & sig, uchar byte );
+	void flushChunk( Signal & sig );
+	bool writeIndex();
+
+	int findChunk( const Signal & sig, Time time ) const;
+	void decode( const Signal & sig, int chunk, QValueVector<Time> & times, QValueVector<QString> & values ) const;
+	bool peek( Cursor & cursor, Time & time ) const;
+	QString take( Cursor & cursor ) const;
+
+	QValueVector<Signal*> sigs;
+	QMap<QString, int> sigIds;
+	Time tEnd;
+
+	mutable QFile file;
+	bool writing;
+	Q_ULLONG writeOffset;
+
+	// Proyeccin del fichero en memoria (NULL si se lee con QFile)
+	uchar * mapped;
+	Q_ULLONG mappedSize;
+
+	QString errStr;
+};
+
+#endif
@@ -0,0 +1,581 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// IAAddressMap.cpp: implementation of the IAAddressMap class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "IAAddressMap.h"
+
+#include <qobject.h>
+#include <qmap.h>
+
+// Espacio de direcciones de la interfaz (32 bits)
+static const Q_ULLONG AddressSpace = (Q_ULLONG)1 << 32;
+
+// Primera direccin mltiplo de align a partir de addr
+static Q_ULLONG alignUp( Q_ULLONG addr, Q_ULLONG align )
+{
+	return ( ( addr + align - 1 ) / align ) * align;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+IAAddressMap::IAAddressMap()
+{
+	root = 0;
+	dataBytes = 0;
+}
+
+IAAddressMap::IAAddressMap( const IAAddressMap & map )
+{
+	root = 0;
+	dataBytes = 0;
+	copy( map );
+}
+
+IAAddressMap::~IAAddressMap()
+{
+	destroy( root );
+}
+
+IAAddressMap & IAAddressMap::operator=( const IAAddressMap & map )
+{
+	if( &map != this ){
+		clear();
+		copy( map );
+	}
+	return *this;
+}
+
+void IAAddressMap::clear()
+{
+	destroy( root );
+	root = 0;
+	names.clear();
+	dataBytes = 0;
+}
+
+uint IAAddressMap::count() const
+{
+	return names.count();
+}
+
+bool IAAddressMap::contains( const QString & name ) const
+{
+	return names.find( name ) != 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Manipulacin de puertos
+//////////////////////////////////////////////////////////////////////
+
+bool IAAddressMap::insert( const QString & name, Q_UINT32 addr, Q_UINT32 size, bool readable, bool writable )
+{
+	if( name.isEmpty() || size == 0 || contains( name ) )
+		return false;
+
+	if( (Q_ULLONG)addr + size > AddressSpace || overlaps( addr, size, 0 ) )
+		return false;
+
+	Node * n = new Node;
+	n->name = name;
+	n->base = addr;
+	n->size = size;
+	n->readable = readable;
+	n->writable = writable;
+	n->left = n->right = 0;
+	update( n );
+
+	root = insertNode( root, n );
+	link( n );
+
+	return true;
+}
+
+bool IAAddressMap::allocate( const QString & name, Q_UINT32 size, Q_UINT32 align, Q_UINT32 * addr )
+{
+	if( name.isEmpty() || size == 0 || contains( name ) )
+		return false;
+
+	if( align == 0 )
+		align = 1;
+
+	// Primer hueco entre puertos o, si no hay ninguno, tras el ltimo
+	Q_ULLONG a;
+	if( !firstFit( root, 0, size, align, a ) ){
+		a = alignUp( root ? root->maxEnd : 0, align );
+		if( a + size > AddressSpace )
+			return false;
+	}
+
+	if( addr )
+		*addr = (Q_UINT32)a;
+
+	return insert( name, (Q_UINT32)a, size );
+}
+
+bool IAAddressMap::remove( const QString & name )
+{
+	Node * n = names.find( name );
+	if( !n )
+		return false;
+
+	root = removeNode( root, n->base );
+	unlink( n );
+	delete n;
+
+	return true;
+}
+
+bool IAAddressMap::move( const QString & name, Q_UINT32 addr )
+{
+	Node * n = names.find( name );
+	if( !n )
+		return false;
+
+	if( addr == n->base )
+		return true;
+
+	if( (Q_ULLONG)addr + n->size > AddressSpace || overlaps( addr, n->size, n ) )
+		return false;
+
+	root = removeNode( root, n->base );
+	n->base = addr;
+	n->left = n->right = 0;
+	update( n );
+	root = insertNode( root, n );
+
+	return true;
+}
+
+bool IAAddressMap::resize( const QString & name, Q_UINT32 size )
+{
+	Node * n = names.find( name );
+	if( !n || size == 0 )
+		return false;
+
+	if( (Q_ULLONG)n->base + size > AddressSpace || overlaps( n->base, size, n ) )
+		return false;
+
+	// La posicin en el rbol no cambia, pero s los datos agregados de
+	// sus antecesores: se reinserta
+	root = removeNode( root, n->base );
+	unlink( n );
+	n->size = size;
+	n->left = n->right = 0;
+	update( n );
+	root = insertNode( root, n );
+	link( n );
+
+	return true;
+}
+
+bool IAAddressMap::setAccess( const QString & name, bool readable, bool writable )
+{
+	Node * n = names.find( name );
+	if( !n )
+		return false;
+
+	unlink( n );
+	n->readable = readable;
+	n->writable = writable;
+	link( n );
+
+	return true;
+}
+
+Q_UINT32 IAAddressMap::address( const QString & name ) const
+{
+	Node * n = names.find( name );
+	return n ? n->base : 0;
+}
+
+Q_UINT32 IAAddressMap::portSize( const QString & name ) const
+{
+	Node * n = names.find( name );
+	return n ? n->size : 0;
+}
+
+bool IAAddressMap::isReadable( const QString & name ) const
+{
+	Node * n = names.find( name );
+	return n && n->readable;
+}
+
+bool IAAddressMap::isWritable( const QString & name ) const
+{
+	Node * n = names.find( name );
+	return n && n->writable;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consultas
+//////////////////////////////////////////////////////////////////////
+
+bool IAAddressMap::isFree( Q_UINT32 addr, Q_UINT32 size, const QString & except ) const
+{
+	// Un tamao nulo comprueba slo la direccin addr
+	if( size == 0 )
+		size = 1;
+
+	if( (Q_ULLONG)addr + size > AddressSpace )
+		return false;
+
+	return !overlaps( addr, size, except.isNull() ? 0 : names.find( except ) );
+}
+
+QString IAAddressMap::portAt( Q_UINT32 addr ) const
+{
+	const Node * n = lastBefore( (Q_ULLONG)addr + 1 );
+	return ( n && end( n ) > addr ) ? n->name : QString::null;
+}
+
+Q_UINT32 IAAddressMap::size() const
+{
+	// Techo del tamao en palabras (4bytes)
+	return root ? (Q_UINT32)alignUp( root->maxEnd, 4 ) : 0;
+}
+
+Q_UINT32 IAAddressMap::dataSize() const
+{
+	return dataBytes;
+}
+
+QStringList IAAddressMap::portNames() const
+{
+	QValueVector<Node*> nodes;
+	collect( root, nodes );
+
+	QStringList list;
+	for( uint i=0; i < nodes.size(); i++ )
+		list.append( nodes[i]->name );
+
+	return list;
+}
+
+// ltimo puerto (por direccin) que empieza antes de limit
+const IAAddressMap::Node * IAAddressMap::lastBefore( Q_ULLONG limit ) const
+{
+	const Node * best = 0;
+	const Node * n = root;
+	while( n )
+		if( n->base < limit ){
+			best = n;
+			n = n->right;
+		}else
+			n = n->left;
+
+	return best;
+}
+
+// Los puertos no se solapan entre s, as que slo puede solaparse con
+// [addr, addr+size) el ltimo que empieza antes de addr+size (o, si es
+// except, el anterior a l)
+bool IAAddressMap::overlaps( Q_ULLONG addr, Q_ULLONG size, const Node * except ) const
+{
+	const Node * n = lastBefore( addr + size );
+	if( n && n == except )
+		n = lastBefore( n->base );
+
+	return n && end( n ) > addr;
+}
+
+// Primer hueco alineado de size bytes entre los puertos del subrbol n,
+// que ocupa la regin que empieza en lo. Se descartan los subrboles
+// cuyo mayor hueco es menor que size
+bool IAAddressMap::firstFit( const Node * n, Q_ULLONG lo, Q_ULLONG size, Q_ULLONG align, Q_ULLONG & addr ) const
+{
+	if( !n || ( n->minBase - lo < size && n->maxGap < size ) )
+		return false;
+
+	if( firstFit( n->left, lo, size, align, addr ) )
+		return true;
+
+	// Hueco inmediatamente anterior a n
+	Q_ULLONG a = alignUp( n->left ? n->left->maxEnd : lo, align );
+	if( a + size <= n->base ){
+		addr = a;
+		return true;
+	}
+
+	return firstFit( n->right, end( n ), size, align, addr );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Importacin
+//////////////////////////////////////////////////////////////////////
+
+bool IAAddressMap::import( const QValueList<Entry> & entries, QString * error )
+{
+	QValueVector<Node*> created;
+	QMap<Q_UINT32, Node*> sorted;
+	QMap<QString, bool> seen;
+	QString errStr;
+
+	// Puertos actuales
+	QValueVector<Node*> current;
+	collect( root, current );
+	uint i;
+	for( i=0; i < current.size(); i++ )
+		sorted.insert( current[i]->base, current[i] );
+
+	QValueList<Entry>::const_iterator it;
+	for( it = entries.begin(); it != entries.end() && errStr.isNull(); ++it ){
+		if( (*it).name.isEmpty() || (*it).size == 0 )
+			errStr = QObject::tr("El puerto '%1' no tiene nombre o tamao.").arg( (*it).name );
+		else if( contains( (*it).name ) || seen.contains( (*it).name ) )
+			errStr = QObject::tr("El puerto '%1' est repetido.").arg( (*it).name );
+		else if( (Q_ULLONG)(*it).address + (*it).size > AddressSpace )
+			errStr = QObject::tr("El puerto '%1' excede el espacio de direcciones.").arg( (*it).name );
+		else if( sorted.contains( (*it).address ) )
+			errStr = QObject::tr("Los puertos '%1' y '%2' se solapan.").arg( sorted[ (*it).address ]->name ).arg( (*it).name );
+		else{
+			Node * n = new Node;
+			n->name = (*it).name;
+			n->base = (*it).address;
+			n->size = (*it).size;
+			n->readable = (*it).readable;
+			n->writable = (*it).writable;
+			n->left = n->right = 0;
+
+			created.push_back( n );
+			sorted.insert( n->base, n );
+			seen.insert( n->name, true );
+		}
+	}
+
+	// Orden de direcciones y comprobacin de solapes entre vecinos
+	QValueVector<Node*> nodes;
+	nodes.reserve( sorted.count() );
+	for( QMap<Q_UINT32, Node*>::iterator itNode = sorted.begin(); itNode != sorted.end() && errStr.isNull(); ++itNode ){
+		if( !nodes.isEmpty() && end( nodes.back() ) > itNode.data()->base )
+			errStr = QObject::tr("Los puertos '%1' y '%2' se solapan.").arg( nodes.back()->name ).arg( itNode.data()->name );
+		nodes.push_back( itNode.data() );
+	}
+
+	if( !errStr.isNull() ){
+		for( i=0; i < created.size(); i++ )
+			delete created[i];
+		if( error )
+			*error = errStr;
+		return false;
+	}
+
+	// rbol equilibrado a partir de la lista ordenada
+	root = build( nodes, 0, (int)nodes.size() - 1 );
+	for( i=0; i < created.size(); i++ )
+		link( created[i] );
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// rbol AVL
+//////////////////////////////////////////////////////////////////////
+
+Q_ULLONG IAAddressMap::end( const Node * n )
+{
+	return (Q_ULLONG)n->base + n->size;
+}
+
+int IAAddressMap::height( const Node * n )
+{
+	return n ? n->height : 0;
+}
+
+// Recalcula la altura y los datos agregados de n a partir de sus hijos
+void IAAddressMap::update( Node * n )
+{
+	n->height = 1 + QMAX( height( n->left ), height( n->right ) );
+	n->minBase = n->left ? n->left->minBase : n->base;
+	n->maxEnd = n->right ? n->right->maxEnd : end( n );
+
+	n->maxGap = 0;
+	if( n->left )
+		n->maxGap = QMAX( n->left->maxGap, n->base - n->left->maxEnd );
+	if( n->right )
+		n->maxGap = QMAX( n->maxGap, QMAX( n->right->maxGap, n->right->minBase - end( n ) ) );
+}
+
+IAAddressMap::Node * IAAddressMap::rotateLeft( Node * n )
+{
+	Node * r = n->right;
+	n->right = r->left;
+	r->left = n;
+	update( n );
+	update( r );
+	return r;
+}
+
+IAAddressMap::Node * IAAddressMap::rotateRight( Node * n )
+{
+	Node * l = n->left;
+	n->left = l->right;
+	l->right = n;
+	update( n );
+	update( l );
+	return l;
+}
+
+IAAddressMap::Node * IAAddressMap::balance( Node * n )
+{
+	update( n );
+
+	int factor = height( n->left ) - height( n->right );
+	if( factor > 1 ){
+		if( height( n->left->left ) < height( n->left->right ) )
+			n->left = rotateLeft( n->left );
+		return rotateRight( n );
+	}
+	if( factor < -1 ){
+		if( height( n->right->right ) < height( n->right->left ) )
+			n->right = rotateRight( n->right );
+		return rotateLeft( n );
+	}
+
+	return n;
+}
+
+IAAddressMap::Node * IAAddressMap::insertNode( Node * root, Node * n )
+{
+	if( !root )
+		return n;
+
+	if( n->base < root->base )
+		root->left = insertNode( root->left, n );
+	else
+		root->right = insertNode( root->right, n );
+
+	return balance( root );
+}
+
+// Desengancha (sin destruirlo) el puerto que empieza en base
+IAAddressMap::Node * IAAddressMap::removeNode( Node * root, Q_UINT32 base )
+{
+	if( !root )
+		return 0;
+
+	if( base < root->base )
+		root->left = removeNode( root->left, base );
+	else if( base > root->base )
+		root->right = removeNode( root->right, base );
+	else{
+		Node * l = root->left, * r = root->right;
+		if( !r )
+			return l;
+
+		Node * min;
+		r = removeMin( r, &min );
+		min->left = l;
+		min->right = r;
+		return balance( min );
+	}
+
+	return balance( root );
+}
+
+IAAddressMap::Node * IAAddressMap::removeMin( Node * root, Node ** min )
+{
+	if( !root->left ){
+		*min = root;
+		return root->right;
+	}
+
+	root->left = removeMin( root->left, min );
+	return balance( root );
+}
+
+IAAddressMap::Node * IAAddressMap::build( QValueVector<Node*> & nodes, int first, int last )
+{
+	if( first > last )
+		return 0;
+
+	int mid = ( first + last ) / 2;
+	Node * n = nodes[mid];
+	n->left = build( nodes, first, mid - 1 );
+	n->right = build( nodes, mid + 1, last );
+	update( n );
+
+	return n;
+}
+
+// Puertos del subrbol en orden de direcciones
+void IAAddressMap::collect( Node * root, QValueVector<Node*> & nodes )
+{
+	if( !root )
+		return;
+
+	collect( root->left, nodes );
+	nodes.push_back( root );
+	collect( root->right, nodes );
+}
+
+void IAAddressMap::destroy( Node * root )
+{
+	if( !root )
+		return;
+
+	destroy( root->left );
+	destroy( root->right );
+	delete root;
+}
+
+//////////////////////////////////////////////////////////////////////
+// ndice de nombres y tamao de datos
+//////////////////////////////////////////////////////////////////////
+
+void IAAddressMap::link( Node * n )
+{
+	names.insert( n->name, n );
+
+	// QDict no crece por s mismo
+	if( names.count() > names.size() )
+		names.resize( 2*names.size() + 1 );
+
+	if( n->readable )
+		dataBytes += n->size;
+	if( n->writable )
+		dataBytes += n->size;
+}
+
+void IAAddressMap::unlink( Node * n )
+{
+	names.remove( n->name );
+
+	if( n->readable )
+		dataBytes -= n->size;
+	if( n->writable )
+		dataBytes -= n->size;
+}
+
+void IAAddressMap::copy( const IAAddressMap & map )
+{
+	QValueVector<Node*> source, nodes;
+	collect( map.root, source );
+
+	for( uint i=0; i < source.size(); i++ ){
+		Node * n = new Node( *source[i] );
+		nodes.push_back( n );
+		link( n );
+	}
+
+	root = build( nodes, 0, (int)nodes.size() - 1 );
+}
@@ -0,0 +1,152 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// IAAddressMap.h: interface for the IAAddressMap class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_IAADDRESSMAP_H_)
+#define _IAADDRESSMAP_H_
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvaluelist.h>
+#include <qvaluevector.h>
+#include <qdict.h>
+
+////////////////////////////////////////////////////////////////////////////////
+//	IAAddressMap
+//
+//	Mapa de direcciones de los puertos de una interfaz: cada puerto ocupa
+//	el rango [direccin, direccin+tamao) y los rangos no se solapan.
+//
+//	Los puertos se guardan en un rbol AVL ordenado por direccin y
+//	aumentado con, para cada subrbol, su primera direccin, su ltima
+//	direccin ocupada y el mayor hueco entre dos de sus puertos. As la
+//	comprobacin de solapes, la reserva, el desplazamiento y el cambio de
+//	tamao cuestan O(log n) y la bsqueda del primer hueco descarta los
+//	subrboles en los que no cabe el puerto. El nombre de cada puerto se
+//	indexa en una tabla hash.
+//
+//	size() y dataSize() se mantienen al da con cada cambio, y import()
+//	inserta miles de puertos ordenndolos una sola vez y construyendo el
+//	rbol equilibrado directamente.
+//
+////////////////////////////////////////////////////////////////////////////////
+class IAAddressMap
+{
+public:
+	// Puerto de una importacin masiva
+	struct Entry{
+		QString name;
+		Q_UINT32 address;
+		Q_UINT32 size;
+		bool readable;
+		bool writable;
+	};
+
+	IAAddressMap();
+	IAAddressMap( const IAAddressMap & map );
+	~IAAddressMap();
+
+	IAAddressMap & operator=( const IAAddressMap & map );
+
+	void clear();
+	uint count() const;
+	bool contains( const QString & name ) const;
+
+	// Inserta el puerto en [addr, addr+size). Falla si el nombre ya existe,
+	// el tamao es 0 o el rango no est libre
+	bool insert( const QString & name, Q_UINT32 addr, Q_UINT32 size, bool readable=true, bool writable=true );
+
+	// Inserta el puerto en el primer hueco de size bytes cuya direccin es
+	// mltiplo de align (potencia de 2). Devuelve la direccin en addr
+	bool allocate( const QString & name, Q_UINT32 size, Q_UINT32 align=1, Q_UINT32 * addr=0 );
+
+	bool remove( const QString & name );
+	bool move( const QString & name, Q_UINT32 addr );
+	bool resize( const QString & name, Q_UINT32 size );
+	bool setAccess( const QString & name, bool readable, bool writable );
+
+	// Atributos de un puerto (0 si no existe)
+	Q_UINT32 address( const QString & name ) const;
+	Q_UINT32 portSize( const QString & name ) const;
+	bool isReadable( const QString & name ) const;
+	bool isWritable( const QString & name ) const;
+
+	// Determina si [addr, addr+size) no se solapa con ningn puerto (salvo
+	// except): un rango que contiene por completo a un puerto no est libre
+	bool isFree( Q_UINT32 addr, Q_UINT32 size, const QString & except=QString::null ) const;
+
+	// Puerto que ocupa la direccin addr (QString::null si ninguno)
+	QString portAt( Q_UINT32 addr ) const;
+
+	// Final del ltimo puerto redondeado a palabras de 4 bytes
+	Q_UINT32 size() const;
+	// Bytes de datos: el tamao de cada puerto por cada sentido de acceso
+	Q_UINT32 dataSize() const;
+
+	// Puertos en orden de direcciones
+	QStringList portNames() const;
+
+	// Inserta todos los puertos de entries. Si alguno se solapa, repite
+	// nombre o tiene tamao 0 no se inserta ninguno y se describe el
+	// problema en error
+	bool import( const QValueList<Entry> & entries, QString * error=0 );
+
+private:
+	struct Node{
+		QString name;
+		Q_UINT32 base;
+		Q_UINT32 size;
+		bool readable, writable;
+
+		Node *left, *right;
+		int height;
+		Q_ULLONG minBase;	// Primera direccin del subrbol
+		Q_ULLONG maxEnd;	// Final del ltimo puerto del subrbol
+		Q_ULLONG maxGap;	// Mayor hueco entre dos puertos del subrbol
+	};
+
+	static Q_ULLONG end( const Node * n );
+	static int height( const Node * n );
+	static void update( Node * n );
+	static Node * rotateLeft( Node * n );
+	static Node * rotateRight( Node * n );
+	static Node * balance( Node * n );
+	static Node * insertNode( Node * root, Node * n );
+	static Node * removeNode( Node * root, Q_UINT32 base );
+	static Node * removeMin( Node * root, Node ** min );
+	static Node * build( QValueVector<Node*> & nodes, int first, int last );
+	static void collect( Node * root, QValueVector<Node*> & nodes );
+	static void destroy( Node * root );
+
+	const Node * lastBefore( Q_ULLONG limit ) const;
+	bool overlaps( Q_ULLONG addr, Q_ULLONG size, const Node * except ) const;
+	bool firstFit( const Node * n, Q_ULLONG lo, Q_ULLONG size, Q_ULLONG align, Q_ULLONG & addr ) const;
+
+	void link( Node * n );
+	void unlink( Node * n );
+	void copy( const IAAddressMap & map );
+
+	Node * root;
+	QDict<Node> names;
+	Q_UINT32 dataBytes;
+};
+
+#endif
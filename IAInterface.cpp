@@ -164,13 +164,16 @@ IAPort & IAInterface::findPort( const QString& portName )
 // private members
 //////////////////////////////////////////////////////////////////////
 
-// Comprueba si el rango con inicio en 'addr' y tamao 'size' bytes est libre
+// Comprueba si el rango con inicio en 'addr' y tamao 'size' bytes est libre.
+// Dos rangos se solapan si cada uno empieza antes de que acabe el otro (lo
+// que incluye a un rango que contiene por completo a un puerto)
 bool IAInterface::checkFreeRange( Q_UINT32 addr, Q_UINT32 size, IAPort * butThisPort )
 {
+	Q_ULLONG end = (Q_ULLONG)addr + ( size ? size : 1 );
+
 	for( IAPortList::iterator it = ports.begin(); it != ports.end(); it++ )
 		if( (*it).isInitialized() && (*it)!=(*butThisPort))
-			if( (addr >= (*it).baseAddress() && addr < (*it).baseAddress()+(*it).size()) ||
-				(addr+size > (*it).baseAddress() && addr+size <= (*it).baseAddress()+(*it).size()) )
+			if( addr < (Q_ULLONG)(*it).baseAddress()+(*it).size() && end > (*it).baseAddress() )
 				return false;
 		
 	return true;
@@ -0,0 +1,306 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// IAPortMap.cpp: implementation of the IAPortMap class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "IAPortMap.h"
+
+#include <qobject.h>
+
+// Primera direccin mltiplo de align a partir de addr
+static Q_ULLONG alignUp( Q_ULLONG addr, Q_ULLONG align )
+{
+	return ( ( addr + align - 1 ) / align ) * align;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+IAPortMap::IAPortMap()
+{
+}
+
+void IAPortMap::clear()
+{
+	map.clear();
+	loose.clear();
+}
+
+// Los puertos inicializados de tamao no nulo se importan de una vez
+bool IAPortMap::load( const QValueList<IAPort> & ports, QString * error )
+{
+	clear();
+
+	QValueList<IAAddressMap::Entry> entries;
+	QString errStr;
+
+	QValueList<IAPort>::const_iterator it;
+	for( it = ports.begin(); it != ports.end() && errStr.isNull(); ++it ){
+		if( (*it).isInitialized() && (*it).size() ){
+			IAAddressMap::Entry e;
+			e.name = (*it).name();
+			e.address = (*it).baseAddress();
+			e.size = (*it).size();
+			e.readable = (*it).readable();
+			e.writable = (*it).writable();
+			entries.append( e );
+			continue;
+		}
+
+		if( loose.contains( (*it).name() ) ){
+			errStr = QObject::tr("El puerto '%1' est repetido.").arg( (*it).name() );
+			break;
+		}
+
+		Loose l;
+		l.hasBase = (*it).baseAddress() != NOT_INITIALIZED;
+		l.hasSize = (*it).size() != NOT_INITIALIZED;
+		l.base = l.hasBase ? (*it).baseAddress() : 0;
+		l.size = l.hasSize ? (*it).size() : 0;
+		l.readable = (*it).readable();
+		l.writable = (*it).writable();
+		loose.insert( (*it).name(), l );
+	}
+
+	if( errStr.isNull() && map.import( entries, &errStr ) ){
+		QMap<QString, Loose>::const_iterator itLoose;
+		for( itLoose = loose.begin(); itLoose != loose.end() && errStr.isNull(); ++itLoose )
+			if( map.contains( itLoose.key() ) )
+				errStr = QObject::tr("El puerto '%1' est repetido.").arg( itLoose.key() );
+	}
+
+	if( !errStr.isNull() ){
+		clear();
+		if( error )
+			*error = errStr;
+		return false;
+	}
+
+	return true;
+}
+
+uint IAPortMap::count() const
+{
+	return map.count() + loose.count();
+}
+
+bool IAPortMap::contains( const QString & name ) const
+{
+	return map.contains( name ) || loose.contains( name );
+}
+
+bool IAPortMap::isInitialized( const QString & name ) const
+{
+	if( map.contains( name ) )
+		return true;
+
+	QMap<QString, Loose>::const_iterator it = loose.find( name );
+	return it != loose.end() && it.data().hasBase && it.data().hasSize;
+}
+
+Q_UINT32 IAPortMap::portAddress( const QString & name ) const
+{
+	if( map.contains( name ) )
+		return map.address( name );
+
+	QMap<QString, Loose>::const_iterator it = loose.find( name );
+	return it != loose.end() ? it.data().base : 0;
+}
+
+Q_UINT32 IAPortMap::portSize( const QString & name ) const
+{
+	if( map.contains( name ) )
+		return map.portSize( name );
+
+	QMap<QString, Loose>::const_iterator it = loose.find( name );
+	return it != loose.end() ? it.data().size : 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Manipulacin de puertos
+//////////////////////////////////////////////////////////////////////
+
+// Al final del perifrico, con 1 byte de tamao
+void IAPortMap::insertPort( const QString & name )
+{
+	if( name.isEmpty() || contains( name ) )
+		return;
+
+	map.insert( name, size(), 1 );
+}
+
+void IAPortMap::insertUninitialized( const QString & name, bool readable, bool writable )
+{
+	if( name.isEmpty() || contains( name ) )
+		return;
+
+	Loose l;
+	l.base = l.size = 0;
+	l.hasBase = l.hasSize = false;
+	l.readable = readable;
+	l.writable = writable;
+	loose.insert( name, l );
+}
+
+void IAPortMap::removePort( const QString & name )
+{
+	if( !map.remove( name ) )
+		loose.remove( name );
+}
+
+void IAPortMap::setPortAddress( const QString & name, Q_UINT32 addr )
+{
+	if( map.contains( name ) ){
+		if( checkFreeRange( addr, map.portSize( name ), name ) )
+			map.move( name, addr );
+		return;
+	}
+
+	QMap<QString, Loose>::iterator it = loose.find( name );
+	if( it == loose.end() )
+		return;
+
+	Loose l = it.data();
+	if( !checkFreeRange( addr, l.hasSize ? l.size : 1, name ) )
+		return;
+
+	l.base = addr;
+	l.hasBase = true;
+	place( name, l );
+}
+
+void IAPortMap::setPortSize( const QString & name, Q_UINT32 sz )
+{
+	if( map.contains( name ) ){
+		Q_UINT32 addr = map.address( name );
+		if( !checkFreeRange( addr, sz, name ) )
+			return;
+
+		if( sz ){
+			map.resize( name, sz );
+			return;
+		}
+
+		// Pasa a ocupar slo su direccin
+		Loose l;
+		l.base = addr;
+		l.size = 0;
+		l.hasBase = l.hasSize = true;
+		l.readable = map.isReadable( name );
+		l.writable = map.isWritable( name );
+		map.remove( name );
+		loose.insert( name, l );
+		return;
+	}
+
+	QMap<QString, Loose>::iterator it = loose.find( name );
+	if( it == loose.end() )
+		return;
+
+	Loose l = it.data();
+	if( !checkFreeRange( l.hasBase ? l.base : size(), sz, name ) )
+		return;
+
+	l.size = sz;
+	l.hasSize = true;
+	place( name, l );
+}
+
+void IAPortMap::setPortAccess( const QString & name, bool readable, bool writable )
+{
+	if( map.setAccess( name, readable, writable ) )
+		return;
+
+	QMap<QString, Loose>::iterator it = loose.find( name );
+	if( it != loose.end() ){
+		it.data().readable = readable;
+		it.data().writable = writable;
+	}
+}
+
+// Los puertos de tamao 0 no forman parte del rbol: si el hueco elegido
+// contiene alguno, el puerto se coloca al final del perifrico
+bool IAPortMap::allocatePort( const QString & name, Q_UINT32 size, Q_UINT32 align )
+{
+	if( contains( name ) )
+		return false;
+
+	Q_UINT32 addr;
+	if( !map.allocate( name, size, align, &addr ) )
+		return false;
+
+	if( checkFreeRange( addr, size, name ) )
+		return true;
+
+	map.remove( name );
+	return map.insert( name, (Q_UINT32)alignUp( this->size(), align ? align : 1 ), size );
+}
+
+// Un puerto completo pasa al rbol si tiene tamao; si no, sigue aparte
+void IAPortMap::place( const QString & name, const Loose & port )
+{
+	if( port.hasBase && port.hasSize && port.size &&
+		map.insert( name, port.base, port.size, port.readable, port.writable ) ){
+		loose.remove( name );
+		return;
+	}
+
+	loose.replace( name, port );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consultas
+//////////////////////////////////////////////////////////////////////
+
+bool IAPortMap::checkFreeRange( Q_UINT32 addr, Q_UINT32 size, const QString & except ) const
+{
+	if( !map.isFree( addr, size, except ) )
+		return false;
+
+	// Puertos de tamao 0 dentro del rango
+	Q_ULLONG end = (Q_ULLONG)addr + ( size ? size : 1 );
+	QMap<QString, Loose>::const_iterator it;
+	for( it = loose.begin(); it != loose.end(); ++it ){
+		const Loose & l = it.data();
+		if( l.hasBase && l.hasSize && l.size == 0 && it.key() != except )
+			if( addr < l.base && end > l.base )
+				return false;
+	}
+
+	return true;
+}
+
+Q_UINT32 IAPortMap::size() const
+{
+	Q_ULLONG max = 0;
+	QMap<QString, Loose>::const_iterator it;
+	for( it = loose.begin(); it != loose.end(); ++it )
+		if( it.data().hasBase && it.data().hasSize && it.data().base > max )
+			max = it.data().base;
+
+	// Techo del tamao en palabras (4bytes)
+	max = alignUp( max, 4 );
+	return ( max > map.size() ) ? (Q_UINT32)max : map.size();
+}
+
+Q_UINT32 IAPortMap::dataSize() const
+{
+	return map.dataSize();
+}
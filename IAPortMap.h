@@ -0,0 +1,104 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// IAPortMap.h: interface for the IAPortMap class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_IAPORTMAP_H_)
+#define _IAPORTMAP_H_
+
+#include <qstring.h>
+#include <qvaluelist.h>
+#include <qmap.h>
+
+#include "IAAddressMap.h"
+#include "IAPort.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//	IAPortMap
+//
+//	Puertos de una interfaz con la semntica de IAInterface (insertPort,
+//	setPortAddress, setPortSize, checkFreeRange, size y dataSize) sobre
+//	un IAAddressMap, que slo admite puertos con direccin y tamao no
+//	nulo. El resto se guardan aparte:
+//
+//	  - Los puertos sin inicializar (sin direccin, sin tamao o sin
+//	    ninguno de los dos) no ocupan ningn rango.
+//	  - Los puertos de tamao 0 ocupan slo su direccin base b, como en
+//	    IAInterface::checkFreeRange: impiden los rangos que empiezan antes
+//	    de b y terminan despus. Son pocos (un puerto en edicin), as que
+//	    se recorren linealmente.
+//
+//	Un puerto sin inicializar que recibe su direccin o su tamao se
+//	comprueba con el rango que ocupar (IAInterface supone tamao 1 o la
+//	direccin final del perifrico).
+//
+////////////////////////////////////////////////////////////////////////////////
+class IAPortMap
+{
+public:
+	IAPortMap();
+
+	void clear();
+
+	// Carga los puertos de una interfaz. Falla (sin cargar ninguno) si
+	// dos puertos inicializados se solapan o repiten nombre
+	bool load( const QValueList<IAPort> & ports, QString * error=0 );
+
+	uint count() const;
+	bool contains( const QString & name ) const;
+	bool isInitialized( const QString & name ) const;
+	Q_UINT32 portAddress( const QString & name ) const;
+	Q_UINT32 portSize( const QString & name ) const;
+
+	// Manipulacin de puertos (como en IAInterface: las operaciones que
+	// ocuparan un rango no libre no tienen efecto)
+	void insertPort( const QString & name );
+	void insertUninitialized( const QString & name, bool readable=true, bool writable=true );
+	void removePort( const QString & name );
+	void setPortAddress( const QString & name, Q_UINT32 addr );
+	void setPortSize( const QString & name, Q_UINT32 sz );
+	void setPortAccess( const QString & name, bool readable, bool writable );
+
+	// Inserta el puerto de size bytes en el primer hueco alineado
+	bool allocatePort( const QString & name, Q_UINT32 size, Q_UINT32 align=1 );
+
+	// Determina si el rango [addr, addr+size) est libre (salvo el puerto
+	// except). Un tamao 0 comprueba slo la direccin addr
+	bool checkFreeRange( Q_UINT32 addr, Q_UINT32 size, const QString & except=QString::null ) const;
+
+	// Final del ltimo puerto redondeado a palabras de 4 bytes
+	Q_UINT32 size() const;
+	// Bytes de datos: el tamao de cada puerto por cada sentido de acceso
+	Q_UINT32 dataSize() const;
+
+private:
+	// Puerto sin inicializar o de tamao 0
+	struct Loose{
+		Q_UINT32 base, size;
+		bool hasBase, hasSize;
+		bool readable, writable;
+	};
+
+	void place( const QString & name, const Loose & port );
+
+	IAAddressMap map;
+	QMap<QString, Loose> loose;
+};
+
+#endif
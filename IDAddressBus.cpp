@@ -44,7 +44,10 @@ LEConnectionPoint * IDAddressBus::out( int i )
 	return busAddr[i]->pinList().at(0)->connectionPoint();
 }
 
-// Instanciacin
+// Instanciacin: una entrada escalar por bit de direccin. Un nico puerto
+// BIT_VECTOR requerira que cada consumidor conectase su pin con un cable
+// de derivacin (LEWireLine::setSliceOffset) en lugar de con out(i), as
+// que el bus como red nica queda aplazado
 bool IDAddressBus::create( LogicEditor * editor, int left, int top )
 {
 	// Obtencin de componentes requeridos
@@ -55,12 +58,11 @@ bool IDAddressBus::create( LogicEditor * editor, int left, int top )
 	// Creacin del Bus
 	busAddr = new LEDevice*[size()];
 
-	for( int i=0; i<size(); i++ ){
-		busAddr[i] = editor->createDevice( inputComponent, false );
-		busAddr[i]->setName( "A"+QString::number(i) );
-		busAddr[i]->move( left+20, top+45*i );
-		busAddr[i]->show();
-	}
+	// Se crean en un nico lote, cada uno con su nombre definitivo
+	editor->beginBatch();
+	for( int i=0; i<size(); i++ )
+		busAddr[i] = editor->placeDevice( inputComponent, "A"+QString::number(i), QPoint( left+20, top+45*i ) );
+	editor->endBatch();
 
 	return true;	
 }
@@ -21,6 +21,7 @@
 #include "LogicEditor.h"
 #include "LEWireLine.h"
 #include "LEDevice.h"
+#include "IDNetlist.h"
 
 #include "Application.h"
 extern Application * app;
@@ -33,8 +34,19 @@ extern Application * app;
 IDInterfaceSelectorFunction::IDInterfaceSelectorFunction( unsigned int pattern, unsigned int length )
 	: IDInterfaceSelector( pattern, length )
 {
+	this->cpInput = 0;
 	this->devInv = 0;
 	this->devNand = 0;
+	this->devOr = 0;
+
+	this->inDevs = 0;
+	this->inPins = 0;
+	this->idxInv = 0;
+	this->idxOr = -1;
+	for( int i=0; i<4; i++ )
+		this->idxNand[i] = -1;
+
+	this->l = this->t = this->w = this->h = 0;
 }
 
 IDInterfaceSelectorFunction::~IDInterfaceSelectorFunction()
@@ -45,6 +57,13 @@ IDInterfaceSelectorFunction::~IDInterfaceSelectorFunction()
 		delete [] devNand;
 	if( this->cpInput )
 		delete [] cpInput;
+
+	if( this->inDevs )
+		delete [] inDevs;
+	if( this->inPins )
+		delete [] inPins;
+	if( this->idxInv )
+		delete [] idxInv;
 }
 
 LEConnectionPoint * IDInterfaceSelectorFunction::in( unsigned int i )
@@ -57,9 +76,22 @@ LEConnectionPoint * IDInterfaceSelectorFunction::out( unsigned int i )
 	return this->devOr->pinList().at(0)->connectionPoint();
 }
 
+// Instanciacin: la funcin se construye en memoria y sus items se crean
+// en el editor en un nico lote
 bool IDInterfaceSelectorFunction::create( LogicEditor * editor, int left, int top )
 {
-	int i, j, k, sz, selSize = length();
+	IDNetlist netlist;
+	if( !build( netlist, left, top ) || !netlist.materialize( editor ) )
+		return false;
+
+	bind( netlist );
+	return true;
+}
+
+// Construccin de la funcin de seleccin en netlist (sin crear items)
+bool IDInterfaceSelectorFunction::build( IDNetlist & netlist, int left, int top )
+{
+	int i, j, k=0, sz, selSize = length();
 	int nandTop = top;
 	unsigned int addr = pattern();
 	LMComponent * component;
@@ -72,11 +104,14 @@ bool IDInterfaceSelectorFunction::create( LogicEditor * editor, int left, int to
 	LMComponent * invComponent = app->libraryManager().findComponent( "Seleccion:INV" );
 	if( !invComponent )
 		return false;
+	int invHeight = invComponent->shapeList().first().boundingRect().height();
 
 	// Asignacin de recursos
-	cpInput = new LEConnectionPoint*[length()];
-	devInv = new LEDevice*[length()];
-	devNand = new LEDevice*[4];
+	inDevs = new int[length()];
+	inPins = new int[length()];
+	idxInv = new int[length()];
+	for( i=0; i<(int)length(); i++ )
+		idxInv[i] = -1;
 
 	// Creacin de las puertas para la funcin seleccin
 	i=0, j=0;
@@ -113,41 +148,31 @@ bool IDInterfaceSelectorFunction::create( LogicEditor * editor, int left, int to
 		if( component ){
 
 			// Instanciacin
-			devNand[i] = editor->createDevice( component, false );
-			devNand[i]->setName( "SEL"+QString::number(i) );
-			devNand[i]->setSize( devNand[i]->width(), 45*(sz+1)+2 );
-			devNand[i]->move( left+100, nandTop );
-			devNand[i]->show();
+			idxNand[i] = netlist.addDevice( component, "SEL"+QString::number(i), left+100, nandTop, 45*(sz+1)+2 );
 
-			nandTop += 20 + devNand[i]->height();
+			nandTop += 20 + netlist.deviceHeight( idxNand[i] );
 			
 			// Seleccin e interconexin interna (inversores con pins de las puertas OR)
 			// a nivel de bit
 			for( k=0; k<sz; k++ ){
-				LEWireLine * wl;
-				
 				if( !(addr & 0x80000000) ){
 				
 					// El aparece a nivel bajo, hay que invertirlo
-					devInv[j] = editor->createDevice( invComponent, false );
-					devInv[j]->setName( "INV_A"+QString::number(j) );
-					devInv[j]->move( left, top+((10+devInv[j]->height())*k) );
-					devInv[j]->show();
+					idxInv[j] = netlist.addDevice( invComponent, "INV_A"+QString::number(j), left, top+((10+invHeight)*k) );
 
 					// Conexin entre el inversor y la puerta OR
-					wl = editor->createWireLine( devInv[j]->pinList().at(0)->connectionPoint(),
-										 devNand[i]->pinList().at(k+1)->connectionPoint() );
-					wl->show();
+					netlist.addWire( idxInv[j], 0, idxNand[i], k+1 );
 
 					// La entrada del inversor para este bit forma parte de la interfaz del componente 
 					// (NOTA: En esta aplicacin, en una lista de pins, primero se encuentran las salidas
 					//		  y despus las entradas)
-					cpInput[j] = devInv[j]->pinList().at(1)->connectionPoint();
+					inDevs[j] = idxInv[j];
+					inPins[j] = 1;
 
 				}else{
 
-					devInv[j] = 0;
-					cpInput[j] = devNand[i]->pinList().at(k+1)->connectionPoint();
+					inDevs[j] = idxNand[i];
+					inPins[j] = k+1;
 
 				}				
 				addr <<= 1;
@@ -162,42 +187,29 @@ bool IDInterfaceSelectorFunction::create( LogicEditor * editor, int left, int to
 		int orSize;
 		if( selSize>0 )orSize=i+1;else orSize=i;
 		component = app->libraryManager().findComponent( "Seleccion:OR"+QString::number(orSize) );
-		devOr = editor->createDevice( component, false );
-		devOr->setName( "SEL" );
-		devOr->move( left+200, top/2 );
-		devOr->show();
+		if( !component )
+			return false;
+		idxOr = netlist.addDevice( component, "SEL", left+200, top/2 );
 
 		// Conexin NAND-OR
-		for( k=0; k < i; k++ ){
-			LEConnectionPoint *cpNAND, *cpOR;
-			cpOR = devOr->pinList().at(k+1)->connectionPoint();
-			cpNAND = devNand[k]->pinList().at(0)->connectionPoint();
-	
-			LEWireLine * wl = editor->createWireLine( cpNAND, cpOR, 0.35+0.5*((float)k)/((float)i) );
-			wl->show();
-		}
+		for( k=0; k < i; k++ )
+			netlist.addWire( idxNand[k], 0, idxOr, k+1, 0.35+0.5*((float)k)/((float)i) );
 
 		// Conexin del bit de seleccin excedente (si lo hay)
 		if( selSize > 0 ){
 
 			if( !(addr & 0x80000000) ){	
 				// El aparece a nivel bajo, hay que invertirlo
-				devInv[j] = editor->createDevice( invComponent, false );
-				devInv[j]->setName( "INV_A"+QString::number(j) );
-				devInv[j]->move( left, top+((10+devInv[j]->height())*k) );
-				devInv[j]->show();
-
-
-				LEWireLine * wl = editor->createWireLine( devInv[j]->pinList().at(0)->connectionPoint(),
-												  devOr->pinList().at(k+1)->connectionPoint() );
-				wl->show();
+				idxInv[j] = netlist.addDevice( invComponent, "INV_A"+QString::number(j), left, top+((10+invHeight)*k) );
+				netlist.addWire( idxInv[j], 0, idxOr, k+1 );
 
 				// Guardamos la referencia a la entrada
-				cpInput[j] = devInv[j]->pinList().at(1)->connectionPoint();
+				inDevs[j] = idxInv[j];
+				inPins[j] = 1;
 												  
 			}else{
-				devInv[j] = 0;
-				cpInput[j] = devOr->pinList().at(k+1)->connectionPoint();
+				inDevs[j] = idxOr;
+				inPins[j] = k+1;
 			}
 		}
 	}
@@ -205,10 +217,36 @@ bool IDInterfaceSelectorFunction::create( LogicEditor * editor, int left, int to
   // Actualizacin de geometra
 
 	// El alto lo determinan las puertas NAND o el ltimo inversor de entrada
-	this->h = max( nandTop, (devInv[j]?(top+((10+devInv[j]->height())*k)):0) ) - this->t;
+	bool lastInv = ( j < (int)length() && idxInv[j] != -1 );
+	this->h = max( nandTop, (lastInv?(top+((10+invHeight)*k)):0) ) - this->t;
 	
 	// El ancho lo determina la puerta Or final (si existe) o cualquier puerta NAND
-	this->w = (devOr?(devOr->x()+devOr->width()):(devNand[0]?(devNand[0]->x()+devNand[0]->width()):0) ) - this->l;
+	if( idxOr != -1 )
+		this->w = netlist.deviceX( idxOr ) + netlist.deviceWidth( idxOr ) - this->l;
+	else if( idxNand[0] != -1 )
+		this->w = netlist.deviceX( idxNand[0] ) + netlist.deviceWidth( idxNand[0] ) - this->l;
+	else
+		this->w = -this->l;
 
 	return true;
-}
\ No newline at end of file
+}
+
+// Enlaza el mdulo con los items creados al materializar la netlist
+void IDInterfaceSelectorFunction::bind( const IDNetlist & netlist )
+{
+	int i;
+
+	cpInput = new LEConnectionPoint*[length()];
+	devInv = new LEDevice*[length()];
+	devNand = new LEDevice*[4];
+
+	for( i=0; i<(int)length(); i++ ){
+		devInv[i] = netlist.device( idxInv[i] );
+		cpInput[i] = netlist.connectionPoint( inDevs[i], inPins[i] );
+	}
+
+	for( i=0; i<4; i++ )
+		devNand[i] = netlist.device( idxNand[i] );
+
+	devOr = netlist.device( idxOr );
+}
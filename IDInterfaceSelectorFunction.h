@@ -22,6 +22,7 @@
 class LogicEditor;
 class LEConnectionPoint;
 class LEDevice;
+class IDNetlist;
 
 #include "IDInterfaceSelector.h"
 
@@ -40,6 +41,11 @@ public:
 	// Instanciacin
 	virtual bool create( LogicEditor * editor, int left, int top );
 
+	// Construccin en memoria (sin crear items) y enlace con los items
+	// creados al materializar la netlist (ver IDNetlist)
+	bool build( IDNetlist & netlist, int left, int top );
+	void bind( const IDNetlist & netlist );
+
 	// Geometra
 	virtual int width() const{ return w; }
 	virtual int height() const{ return h; }
@@ -52,6 +58,12 @@ private:
 	LEDevice **devNand;
 	LEDevice *devOr;
 
+	// ndices en la netlist (dispositivo y pin de cada entrada)
+	int *inDevs, *inPins;
+	int *idxInv;
+	int idxNand[4];
+	int idxOr;
+
 	// Geometra
 	int l, t, w, h;
 };
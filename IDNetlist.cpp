@@ -0,0 +1,188 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// IDNetlist.cpp: implementation of the IDNetlist class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "IDNetlist.h"
+
+#include "LogicEditor.h"
+#include "LEDevice.h"
+#include "LEPin.h"
+#include "LEWireLine.h"
+#include "LMComponent.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+IDNetlist::IDNetlist()
+{
+}
+
+void IDNetlist::clear()
+{
+	devComponents.clear();
+	devNames.clear();
+	devXs.clear();
+	devYs.clear();
+	devWidths.clear();
+	devHeights.clear();
+	devResized.clear();
+	names.clear();
+
+	wlDevs1.clear();
+	wlPins1.clear();
+	wlDevs2.clear();
+	wlPins2.clear();
+	wlBreaks.clear();
+
+	items.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Dispositivos
+//////////////////////////////////////////////////////////////////////
+
+int IDNetlist::addDevice( LMComponent * component, const QString & name, int x, int y, int height )
+{
+	int dev = devNames.size();
+
+	// Unicidad de nombres (como LEItem::setName en el editor)
+	QString finalName = name;
+	QMap<QString, int>::iterator it = names.find( name );
+	if( it != names.end() ){
+		do
+			finalName = name + QString::number( ++it.data() );
+		while( names.contains( finalName ) );
+	}
+	names.insert( finalName, 0 );
+
+	// Tamao de la figura del componente (el que toma LEDevice::setShape)
+	QRect shape = component->shapeList().first().boundingRect();
+
+	devComponents.push_back( component );
+	devNames.push_back( finalName );
+	devXs.push_back( x );
+	devYs.push_back( y );
+	devWidths.push_back( shape.width() );
+	devHeights.push_back( height >= 0 ? height : shape.height() );
+	devResized.push_back( height >= 0 );
+
+	return dev;
+}
+
+int IDNetlist::deviceCount() const
+{
+	return devNames.size();
+}
+
+const QString & IDNetlist::deviceName( int dev ) const
+{
+	return devNames[dev];
+}
+
+int IDNetlist::deviceX( int dev ) const
+{
+	return devXs[dev];
+}
+
+int IDNetlist::deviceY( int dev ) const
+{
+	return devYs[dev];
+}
+
+int IDNetlist::deviceWidth( int dev ) const
+{
+	return devWidths[dev];
+}
+
+int IDNetlist::deviceHeight( int dev ) const
+{
+	return devHeights[dev];
+}
+
+//////////////////////////////////////////////////////////////////////
+// Cables
+//////////////////////////////////////////////////////////////////////
+
+int IDNetlist::addWire( int dev1, int pin1, int dev2, int pin2, float breakPoint )
+{
+	int wire = wlDevs1.size();
+
+	wlDevs1.push_back( dev1 );
+	wlPins1.push_back( pin1 );
+	wlDevs2.push_back( dev2 );
+	wlPins2.push_back( pin2 );
+	wlBreaks.push_back( breakPoint );
+
+	return wire;
+}
+
+int IDNetlist::wireCount() const
+{
+	return wlDevs1.size();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Materializacin
+//////////////////////////////////////////////////////////////////////
+
+bool IDNetlist::materialize( LogicEditor * editor )
+{
+	if( !editor )
+		return false;
+
+	uint i;
+	items.resize( devNames.size() );
+
+	editor->beginBatch();
+
+	// Los nombres slo son nicos dentro de la netlist: se toma el que
+	// asigna el editor
+	for( i=0; i < devNames.size(); i++ ){
+		items[i] = editor->placeDevice( devComponents[i], devNames[i], QPoint( devXs[i], devYs[i] ),
+										devResized[i] ? devHeights[i] : -1 );
+		devNames[i] = items[i]->name();
+	}
+
+	for( i=0; i < wlDevs1.size(); i++ ){
+		LEWireLine * wl = editor->createWireLine( connectionPoint( wlDevs1[i], wlPins1[i] ),
+												  connectionPoint( wlDevs2[i], wlPins2[i] ), wlBreaks[i] );
+		wl->show();
+	}
+
+	editor->endBatch();
+
+	return true;
+}
+
+LEDevice * IDNetlist::device( int dev ) const
+{
+	return ( dev >= 0 && dev < (int)items.size() ) ? items[dev] : 0;
+}
+
+LEConnectionPoint * IDNetlist::connectionPoint( int dev, int pin ) const
+{
+	LEDevice * lpDev = device( dev );
+	if( !lpDev || !lpDev->pinList().at( pin ) )
+		return 0;
+
+	return lpDev->pinList().at( pin )->connectionPoint();
+}
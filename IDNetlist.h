@@ -0,0 +1,97 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// IDNetlist.h: interface for the IDNetlist class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_IDNETLIST_H_)
+#define _IDNETLIST_H_
+
+#include <qstring.h>
+#include <qpoint.h>
+#include <qmap.h>
+#include <qvaluevector.h>
+
+class LMComponent;
+class LogicEditor;
+class LEDevice;
+class LEConnectionPoint;
+
+////////////////////////////////////////////////////////////////////////////////
+//	IDNetlist
+//
+//	Interfaz generada en memoria: dispositivos (componente, nombre y
+//	geometra) y cables entre pins, identificados por ndice. Los mdulos
+//	ID* la construyen sin tocar el lienzo y despus:
+//
+//	  - materialize() crea todos los items en el editor en un nico lote
+//	    (ver LogicEditor::beginBatch). El editor puede renombrar los
+//	    dispositivos que coincidan con otros ya existentes: tras
+//	    materializarse, deviceName() devuelve el nombre definitivo.
+//
+//	Los pins se identifican por su posicin en la descripcin del
+//	componente (el mismo orden que LEDevice::pinList).
+//
+////////////////////////////////////////////////////////////////////////////////
+class IDNetlist
+{
+public:
+	IDNetlist();
+
+	void clear();
+
+	// Inserta un dispositivo en (x, y). Si height es -1 conserva el alto de
+	// la figura del componente. Un nombre repetido recibe un sufijo numrico.
+	// Devuelve su ndice
+	int addDevice( LMComponent * component, const QString & name, int x, int y, int height=-1 );
+
+	int deviceCount() const;
+	const QString & deviceName( int dev ) const;
+	int deviceX( int dev ) const;
+	int deviceY( int dev ) const;
+	int deviceWidth( int dev ) const;
+	int deviceHeight( int dev ) const;
+
+	// Cable entre dos pins (ver LogicEditor::createWireLine). Devuelve su ndice
+	int addWire( int dev1, int pin1, int dev2, int pin2, float breakPoint=0.5 );
+	int wireCount() const;
+
+	// Crea los items en el editor. Tras materializarse, device() y
+	// connectionPoint() devuelven los items creados
+	bool materialize( LogicEditor * editor );
+	LEDevice * device( int dev ) const;
+	LEConnectionPoint * connectionPoint( int dev, int pin ) const;
+
+private:
+	// Dispositivos
+	QValueVector<LMComponent*> devComponents;
+	QValueVector<QString> devNames;
+	QValueVector<int> devXs, devYs, devWidths, devHeights;
+	QValueVector<bool> devResized;
+	QMap<QString, int> names;
+
+	// Cables
+	QValueVector<int> wlDevs1, wlPins1, wlDevs2, wlPins2;
+	QValueVector<float> wlBreaks;
+
+	// Items creados por materialize()
+	QValueVector<LEDevice*> items;
+};
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "LogicEditor.h"
 #include "LEDevice.h"
+#include "IDNetlist.h"
 #include "Application.h"
 
 extern Application * app;
@@ -28,6 +29,7 @@ IDPortSelectorMux::IDPortSelectorMux( int size )
 	: IDPortSelector( size )
 {
 	mux=0;
+	idxMux=-1;
 }
 
 IDPortSelectorMux::~IDPortSelectorMux()
@@ -52,8 +54,20 @@ LEConnectionPoint * IDPortSelectorMux::out( unsigned int i )
 	return mux?mux->pinList().at( 1+i )->connectionPoint():0;
 }
 
-// Instanciacin
+// Instanciacin: el multiplexor se construye en memoria y se crea en el
+// editor en un nico lote
 bool IDPortSelectorMux::create( LogicEditor * editor, int left, int top )
+{
+	IDNetlist netlist;
+	if( !build( netlist, left, top ) || !netlist.materialize( editor ) )
+		return false;
+
+	bind( netlist );
+	return true;
+}
+
+// Construccin en netlist (sin crear items)
+bool IDPortSelectorMux::build( IDNetlist & netlist, int left, int top )
 {
 	// Cargamos el componente
 	LMComponent * compMux = app->libraryManager().findComponent( "Seleccion:MUX"+QString::number(size()) );
@@ -61,16 +75,19 @@ bool IDPortSelectorMux::create( LogicEditor * editor, int left, int top )
 		return false;
 
 	// Instanciacin del componente
-	mux = editor->createDevice( compMux, false );
-	mux->setName( "PORT_MUXER" );
-	mux->move( left, top );
-	mux->show();
+	idxMux = netlist.addDevice( compMux, "PORT_MUXER", left, top );
 
 	// Actualizacin de Geometra
 	this->l = left;
 	this->t = top;
-	this->w = mux->width();
-	this->h = mux->height();
+	this->w = netlist.deviceWidth( idxMux );
+	this->h = netlist.deviceHeight( idxMux );
 
 	return true;
 }
+
+// Enlaza el mdulo con el multiplexor creado al materializar la netlist
+void IDPortSelectorMux::bind( const IDNetlist & netlist )
+{
+	mux = netlist.device( idxMux );
+}
@@ -25,6 +25,7 @@
 #include "IDPortSelector.h"
 
 class LEDevice;
+class IDNetlist;
 
 class IDPortSelectorMux : public IDPortSelector
 {
@@ -43,6 +44,10 @@ public:
 	// Instanciacin
 	virtual bool create( LogicEditor * canvas, int left, int top );
 
+	// Construccin en memoria y enlace con los items creados (ver IDNetlist)
+	bool build( IDNetlist & netlist, int left, int top );
+	void bind( const IDNetlist & netlist );
+
 	// Geometra
 	virtual int width() const{ return w; }
 	virtual int height() const{ return h; }
@@ -51,6 +56,7 @@ public:
 
 private:
 	LEDevice * mux;	
+	int idxMux;		// ndice en la netlist
 	
 	// Geometra
 	int l, t, w, h;
@@ -0,0 +1,366 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LEBinaryModel.cpp: implementation of the LEBinaryModel class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "LEBinaryModel.h"
+
+#include <qiodevice.h>
+#include <qfile.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Marca del formato (comn a todas las versiones, ver Header::version)
+static const char lmbMagic[4] = { 'L', 'M', 'B', '1' };
+static const Q_UINT32 lmbByteOrder = 0x01020304;
+
+// Escritura de un bloque completo
+static bool writeData( QIODevice * out, const void * data, unsigned long size )
+{
+	if( size == 0 )
+		return true;
+
+	return out->writeBlock( (const char*) data, size ) == (Q_LONG) size;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+LEBinaryModel::LEBinaryModel()
+{
+	mdlName = -1;
+	stringBytes = 0;
+
+	mapData = NULL;
+	mapSize = 0;
+	header = NULL;
+	mapStringIndex = NULL;
+	mapDevices = NULL;
+	mapWireLines = NULL;
+	mapVertexs = NULL;
+	mapStrings = NULL;
+}
+
+LEBinaryModel::~LEBinaryModel()
+{
+	unmap();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Escritura
+//////////////////////////////////////////////////////////////////////
+
+void LEBinaryModel::setModelName( const QString & name )
+{
+	mdlName = addString( name );
+}
+
+void LEBinaryModel::addDevice( const QString & name, const QString & component, const QString & library, const QRect & geometry )
+{
+	DeviceRecord rec;
+
+	rec.name = addString( name );
+	rec.component = addString( component );
+	rec.library = addString( library );
+	rec.x = geometry.x();
+	rec.y = geometry.y();
+	rec.width = geometry.width();
+	rec.height = geometry.height();
+
+	devs.push_back( rec );
+}
+
+void LEBinaryModel::addWireLine( const QString & name, const QString & left, const QString & right, const QPointArray & points, int busWidth, int sliceOffset )
+{
+	WireLineRecord rec;
+
+	rec.name = addString( name );
+	rec.leftConnection = addString( left );
+	rec.rightConnection = addString( right );
+	rec.firstVertex = vtxs.size() / 2;
+	rec.vertexCount = points.count();
+	rec.busWidth = busWidth;
+	rec.sliceOffset = sliceOffset;
+
+	for( int i=0; i < (int)points.count(); i++ ){
+		vtxs.push_back( points.point( i ).x() );
+		vtxs.push_back( points.point( i ).y() );
+	}
+
+	wls.push_back( rec );
+}
+
+bool LEBinaryModel::write( QIODevice * out ) const
+{
+	Header h;
+
+	memcpy( h.magic, lmbMagic, sizeof(h.magic) );
+	h.byteOrder = lmbByteOrder;
+	h.version = Version;
+	h.modelName = mdlName;
+	h.strings = stringIndex.size() / 2;
+	h.devices = devs.size();
+	h.wireLines = wls.size();
+	h.vertexs = vtxs.size() / 2;
+	h.stringBytes = stringBytes;
+
+	if( !writeData( out, &h, sizeof(h) ) )
+		return false;
+
+	if( !stringIndex.isEmpty() && !writeData( out, &stringIndex[0], stringIndex.size()*sizeof(Q_INT32) ) )
+		return false;
+	if( !devs.isEmpty() && !writeData( out, &devs[0], devs.size()*sizeof(DeviceRecord) ) )
+		return false;
+	if( !wls.isEmpty() && !writeData( out, &wls[0], wls.size()*sizeof(WireLineRecord) ) )
+		return false;
+	if( !vtxs.isEmpty() && !writeData( out, &vtxs[0], vtxs.size()*sizeof(Q_INT32) ) )
+		return false;
+
+	QValueList<QCString>::const_iterator it;
+	for( it = stringData.begin(); it != stringData.end(); ++it )
+		if( !writeData( out, (*it).data(), (*it).length() ) )
+			return false;
+
+	return true;
+}
+
+// Devuelve el ndice de la cadena en la tabla, insertndola si no existe
+Q_INT32 LEBinaryModel::addString( const QString & str )
+{
+	if( str.isNull() )
+		return -1;
+
+	QMap<QString, Q_INT32>::iterator it = stringIds.find( str );
+	if( it != stringIds.end() )
+		return it.data();
+
+	Q_INT32 id = stringIndex.size() / 2;
+	QCString utf8 = str.utf8();
+
+	stringIndex.push_back( stringBytes );
+	stringIndex.push_back( utf8.length() );
+	stringData.append( utf8 );
+	stringBytes += utf8.length();
+	stringIds.insert( str, id );
+
+	return id;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Lectura
+//////////////////////////////////////////////////////////////////////
+
+bool LEBinaryModel::map( const QString & fileName )
+{
+	unmap();
+
+#ifndef _WIN32
+	// Proyeccin del fichero en memoria
+	int fd = ::open( QFile::encodeName( fileName ), O_RDONLY );
+	if( fd == -1 )
+		return false;
+
+	struct stat st;
+	if( fstat( fd, &st ) == -1 || st.st_size == 0 ){
+		::close( fd );
+		return false;
+	}
+
+	void * addr = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	if( addr == MAP_FAILED )
+		return false;
+
+	mapData = (const char*) addr;
+	mapSize = st.st_size;
+#else
+	// Sin mmap: lectura completa del fichero
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) )
+		return false;
+
+	buffer = file.readAll();
+	mapData = buffer.data();
+	mapSize = buffer.size();
+#endif
+
+	// Validacin de la cabecera
+	if( mapSize < sizeof(Header) ){
+		unmap();
+		return false;
+	}
+
+	header = (const Header*) mapData;
+	if( memcmp( header->magic, lmbMagic, sizeof(header->magic) ) || header->byteOrder != lmbByteOrder ||
+		( header->version != Version && header->version != 1 ) || header->strings < 0 || header->devices < 0 ||
+		header->wireLines < 0 || header->vertexs < 0 || header->stringBytes < 0 ){
+		unmap();
+		return false;
+	}
+
+	// Ubicacin de las secciones (los tamaos se acumulan en 64 bits: con
+	// contadores de 32 bits arbitrarios la suma no puede desbordarse)
+	Q_ULLONG offset = sizeof(Header);
+	mapStringIndex = (const Q_INT32*)( mapData + offset );
+	offset += 2 * (Q_ULLONG)header->strings * sizeof(Q_INT32);
+	if( offset > mapSize ){
+		unmap();
+		return false;
+	}
+	mapDevices = (const DeviceRecord*)( mapData + offset );
+	offset += (Q_ULLONG)header->devices * sizeof(DeviceRecord);
+	if( offset > mapSize ){
+		unmap();
+		return false;
+	}
+	mapWireLines = (const WireLineRecord*)( mapData + offset );
+	if( header->version == 1 ){
+		// Registros de 5 enteros: se copian completando los datos de bus
+		const Q_INT32 * rec = (const Q_INT32*) mapWireLines;
+		offset += (Q_ULLONG)header->wireLines * 5 * sizeof(Q_INT32);
+		if( offset > mapSize ){
+			unmap();
+			return false;
+		}
+
+		oldWireLines.resize( header->wireLines );
+		for( int i=0; i < header->wireLines; i++, rec += 5 ){
+			WireLineRecord & wl = oldWireLines[i];
+			wl.name = rec[0];
+			wl.leftConnection = rec[1];
+			wl.rightConnection = rec[2];
+			wl.firstVertex = rec[3];
+			wl.vertexCount = rec[4];
+			wl.busWidth = 1;
+			wl.sliceOffset = -1;
+		}
+		mapWireLines = oldWireLines.isEmpty() ? NULL : &oldWireLines[0];
+	}else
+		offset += (Q_ULLONG)header->wireLines * sizeof(WireLineRecord);
+	if( offset > mapSize ){
+		unmap();
+		return false;
+	}
+	mapVertexs = (const Q_INT32*)( mapData + offset );
+	offset += 2 * (Q_ULLONG)header->vertexs * sizeof(Q_INT32);
+	if( offset > mapSize ){
+		unmap();
+		return false;
+	}
+	mapStrings = mapData + offset;
+	offset += (Q_ULLONG)header->stringBytes;
+
+	if( offset > mapSize ){
+		unmap();
+		return false;
+	}
+
+	// Validacin de las referencias entre secciones (comparando sin sumar:
+	// desplazamiento y longitud pueden rondar el mximo de 32 bits)
+	int i;
+	for( i=0; i < header->strings; i++ )
+		if( mapStringIndex[2*i] < 0 || mapStringIndex[2*i+1] < 0 ||
+			mapStringIndex[2*i] > header->stringBytes ||
+			mapStringIndex[2*i+1] > header->stringBytes - mapStringIndex[2*i] ){
+			unmap();
+			return false;
+		}
+
+	for( i=0; i < header->wireLines; i++ )
+		if( mapWireLines[i].firstVertex < 0 || mapWireLines[i].vertexCount < 0 ||
+			mapWireLines[i].firstVertex > header->vertexs ||
+			mapWireLines[i].vertexCount > header->vertexs - mapWireLines[i].firstVertex ){
+			unmap();
+			return false;
+		}
+
+	return true;
+}
+
+void LEBinaryModel::unmap()
+{
+#ifndef _WIN32
+	if( mapData )
+		munmap( (void*) mapData, mapSize );
+#else
+	buffer.resize( 0 );
+#endif
+
+	mapData = NULL;
+	mapSize = 0;
+	header = NULL;
+	mapStringIndex = NULL;
+	mapDevices = NULL;
+	mapWireLines = NULL;
+	mapVertexs = NULL;
+	mapStrings = NULL;
+	oldWireLines.clear();
+}
+
+QString LEBinaryModel::modelName() const
+{
+	return header ? string( header->modelName ) : QString::null;
+}
+
+int LEBinaryModel::deviceCount() const
+{
+	return header ? header->devices : 0;
+}
+
+const LEBinaryModel::DeviceRecord & LEBinaryModel::device( int i ) const
+{
+	return mapDevices[i];
+}
+
+int LEBinaryModel::wireLineCount() const
+{
+	return header ? header->wireLines : 0;
+}
+
+const LEBinaryModel::WireLineRecord & LEBinaryModel::wireLine( int i ) const
+{
+	return mapWireLines[i];
+}
+
+QString LEBinaryModel::string( int index ) const
+{
+	if( !header || index < 0 || index >= header->strings )
+		return QString::null;
+
+	return QString::fromUtf8( mapStrings + mapStringIndex[2*index], mapStringIndex[2*index+1] );
+}
+
+QPointArray LEBinaryModel::vertexs( const WireLineRecord & wl ) const
+{
+	QPointArray points( wl.vertexCount );
+	const Q_INT32 * v = mapVertexs + 2*wl.firstVertex;
+
+	for( int i=0; i < wl.vertexCount; i++ )
+		points.setPoint( i, v[2*i], v[2*i+1] );
+
+	return points;
+}
@@ -0,0 +1,143 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LEBinaryModel.h: interface for the LEBinaryModel class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_LEBINARYMODEL_H_)
+#define _LEBINARYMODEL_H_
+
+#include <qstring.h>
+#include <qcstring.h>
+#include <qmap.h>
+#include <qvaluevector.h>
+#include <qvaluelist.h>
+#include <qpointarray.h>
+#include <qrect.h>
+
+class QIODevice;
+
+////////////////////////////////////////////////////////////////////////////////
+//	LEBinaryModel
+//
+//	Formato binario de modelos (.lmb), equivalente sin prdidas al XML (.lem).
+//
+//	El fichero se compone de secciones de enteros de 32 bits en el orden de
+//	bytes de la mquina que lo escribe (marcado en la cabecera):
+//
+//		Header			cabecera y nmero de elementos de cada seccin
+//		ndice			(offset, longitud) de cada cadena en el bloque de cadenas
+//		DeviceRecord	un registro por dispositivo
+//		WireLineRecord	un registro por cable
+//		vrtices		(x, y) de todos los cables, consecutivos
+//		cadenas			bloque de cadenas UTF-8 (sin repeticiones)
+//
+//	La marca de la cabecera ('LMB1') identifica el formato, no su versin:
+//	se mantiene en todas las versiones y la versin es el campo version.
+//	La versin 1 no inclua el ancho de bus de los cables; sus registros se
+//	convierten al cargarlos (cables escalares).
+//
+//	Los nombres se guardan como ndices a la tabla de cadenas (-1 = ninguno).
+//	La lectura proyecta el fichero en memoria (mmap) y accede a los registros
+//	sin copiarlos; en Windows el fichero se lee completo en un buffer.
+//
+////////////////////////////////////////////////////////////////////////////////
+class LEBinaryModel
+{
+public:
+	enum { Version = 2 };
+
+	struct DeviceRecord
+	{
+		Q_INT32 name, component, library;
+		Q_INT32 x, y, width, height;
+	};
+
+	struct WireLineRecord
+	{
+		Q_INT32 name, leftConnection, rightConnection;
+		Q_INT32 firstVertex, vertexCount;
+		Q_INT32 busWidth, sliceOffset;
+	};
+
+	LEBinaryModel();
+	~LEBinaryModel();
+
+	//////////////////////////////////////////////////////////////////////
+	// Escritura
+	//////////////////////////////////////////////////////////////////////
+	void setModelName( const QString & name );
+	void addDevice( const QString & name, const QString & component, const QString & library, const QRect & geometry );
+	void addWireLine( const QString & name, const QString & left, const QString & right, const QPointArray & points, int busWidth=1, int sliceOffset=-1 );
+	bool write( QIODevice * out ) const;
+
+	//////////////////////////////////////////////////////////////////////
+	// Lectura
+	//////////////////////////////////////////////////////////////////////
+	bool map( const QString & fileName );
+	void unmap();
+
+	QString modelName() const;
+	int deviceCount() const;
+	const DeviceRecord & device( int i ) const;
+	int wireLineCount() const;
+	const WireLineRecord & wireLine( int i ) const;
+
+	// Cadena de ndice index (QString::null si index es -1)
+	QString string( int index ) const;
+	QPointArray vertexs( const WireLineRecord & wl ) const;
+
+private:
+	struct Header
+	{
+		char magic[4];
+		Q_UINT32 byteOrder;
+		Q_INT32 version;
+		Q_INT32 modelName;
+		Q_INT32 strings, devices, wireLines, vertexs;
+		Q_INT32 stringBytes;
+	};
+
+	Q_INT32 addString( const QString & str );
+
+	// Datos de escritura
+	Q_INT32 mdlName;
+	QMap<QString, Q_INT32> stringIds;
+	QValueList<QCString> stringData;
+	QValueVector<Q_INT32> stringIndex;
+	QValueVector<DeviceRecord> devs;
+	QValueVector<WireLineRecord> wls;
+	QValueVector<Q_INT32> vtxs;
+	Q_INT32 stringBytes;
+
+	// Datos de lectura (apuntan a la proyeccin del fichero)
+	const char * mapData;
+	unsigned long mapSize;
+	QByteArray buffer;
+	const Header * header;
+	const Q_INT32 * mapStringIndex;
+	const DeviceRecord * mapDevices;
+	const WireLineRecord * mapWireLines;
+	const Q_INT32 * mapVertexs;
+	const char * mapStrings;
+
+	// Cables de un fichero de la versin 1 (sin datos de bus), convertidos
+	QValueVector<WireLineRecord> oldWireLines;
+};
+
+#endif
@@ -19,6 +19,7 @@
 #include "LEDevice.h"
 
 #include "LELabel.h"
+#include "LEWireLine.h"
 
 #include <qpainter.h>
 #include <math.h>
@@ -137,9 +138,11 @@ void LEDevice::setSize ( int w, int h )
 	// Reubicamos los puntos de la figura
 	scaledShape.translate( this->x(), this->y() );
 
-	// Reubicamos los pins
+	// Reubicamos los pins (los cables conectados se recalculan en un nico lote)
+	LEWireLine::beginBatch();
 	for( LEPin * aux = lsPin.first(); aux != NULL; aux = lsPin.next() )
 		placePin( aux );
+	LEWireLine::endBatch();
 
 	// Reubicamos la etiqueta
 	if( label != NULL ){
@@ -164,10 +167,13 @@ void LEDevice::move( double x, double y )
 	invalidate();
 	scaledShape.translate( deltaX, deltaY );
 	update();
+	geometryChanged();
 
-	// Reubicamos los pins
+	// Reubicamos los pins (los cables conectados se recalculan en un nico lote)
+	LEWireLine::beginBatch();
 	for( LEPin * aux = lsPin.first(); aux != NULL; aux = lsPin.next() )
 		placePin( aux );
+	LEWireLine::endBatch();
 
 	// Reubicamos la etiqueta
 	if( label != NULL ){
@@ -187,10 +193,13 @@ void LEDevice::moveBy( double x, double y )
 	invalidate();
 	scaledShape.translate( x, y );
 	update();
+	geometryChanged();
 
-	// Reubicamos los pins
+	// Reubicamos los pins (los cables conectados se recalculan en un nico lote)
+	LEWireLine::beginBatch();
 	for( LEPin * aux = lsPin.first(); aux != NULL; aux = lsPin.next() )
 		aux->moveBy( x, y );
+	LEWireLine::endBatch();
 
 	// Reubicamos la etiqueta
 	if( label != NULL )
@@ -564,6 +573,7 @@ void LEDevice::setHDirection( const HDirection & direction )
 				aux->setPosition( 1.0 - aux->position() );
 
 		update();		
+		geometryChanged();
 	}
 
 	this->hDir = direction;
@@ -598,6 +608,7 @@ void LEDevice::setVDirection( const VDirection & direction )
 				aux->setPosition( 1.0 - aux->position() );
 		
 		update();
+		geometryChanged();
 	}
 
 	this->vDir = direction;
@@ -721,10 +732,28 @@ LEPin * LEDevice::insertPin( LEPin::Alignment align, LEPin::AccessMode access, Q
 
 void LEDevice::removePin( LEPin * pin )
 {
+	pinNames.clear();
+
 	if( lsPin.remove( pin ) )
 		pin->remove();
 }
 
+// El ndice se reconstruye cuando no refleja los nombres actuales de los
+// pins (pins insertados o renombrados tras la ltima reconstruccin)
+LEPin * LEDevice::findPin( const QString & name )
+{
+	LEPin * pin = pinNames.find( name );
+	if( pin && name == pin->name() )
+		return pin;
+
+	pinNames.clear();
+	for( QPtrListIterator<LEPin> it( lsPin ); it.current(); ++it )
+		if( !pinNames.find( it.current()->name() ) )
+			pinNames.insert( it.current()->name(), it.current() );
+
+	return pinNames.find( name );
+}
+
 void LEDevice::placePin(LEPin * pin )
 {
 	int offsetX, offsetY, desp;
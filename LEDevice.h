@@ -24,6 +24,7 @@
 
 #include <qpointarray.h>
 #include <qptrlist.h>
+#include <qdict.h>
 
 #include "LMComponent.h"
 #include "LErtti.h"
@@ -113,6 +114,9 @@ public:
 	LEPin * insertPin( LEPin::Alignment align, LEPin::AccessMode access, QString label=QString::null, double position=-1.0, LEPin::Level l = LEPin::HiLevel );
 	void removePin( LEPin * pin );
 
+	// Bsqueda de un pin por nombre (indexada)
+	LEPin * findPin( const QString & name );
+
 	////////////////////////////////////////////////////////////////
 	//	Etiqueta
 	////////////////////////////////////////////////////////////////	
@@ -148,6 +152,9 @@ protected:
 	// Pins de conexin
 	QPtrList<LEPin> lsPin;	
 
+	// ndice nombre->pin de findPin()
+	QDict<LEPin> pinNames;
+
 private:
 	// Forma principal
 	QPointArray mainShape;
@@ -24,7 +24,7 @@
 // Instanciacin
 //////////////////////////////////////////////////////////////////////
 LEItem::LEItem( QCanvas * canvas, LEItem * parentItem )
-	: QCanvasPolygonalItem( canvas )
+	: QCanvasPolygonalItem( canvas ), itemId( -1 ), graphIdx( -1 )
 {
 	setParent( parentItem );
 	setSize( 1, 1 );
@@ -75,10 +75,18 @@ void LEItem::setName( const char * name )
 		QObject::setName( name );
 	}
 
+	LogicEditor * lpLE = editor();
+	if( lpLE )
+		lpLE->itemRenamed( this );
 }
 void LEItem::remove()
 { 
 	LEItem *item, *lastItem;
+
+	// El item deja de ser localizable en el editor
+	LogicEditor * lpLE = editor();
+	if( lpLE )
+		lpLE->itemRemoved( this );
 	
 	// Borrado en cascada.
 	// Este borrado contempla la reentrancia de la lista: las clases hijas
@@ -128,6 +136,9 @@ bool LEItem::setProperty( const char * name, const QVariant & value )
 		//  (como la ubicacin de los handlers)
 		if( lpLE->activeItem() == this )
 			lpLE->setActiveItem( this );
+
+		// Los buses forman parte del modelo HDL
+		lpLE->itemPropertyChanged( this );
 	}
 
 	// Actualizacin del lienzo
@@ -149,6 +160,12 @@ void LEItem::hide()
 	QCanvasPolygonalItem::hide();
 }
 
+void LEItem::moveBy( double dx, double dy )
+{
+	QCanvasPolygonalItem::moveBy( dx, dy );
+	geometryChanged();
+}
+
 void LEItem::setResizable( bool rs )
 {
 	resizable = rs;
@@ -162,6 +179,7 @@ bool LEItem::isResizable() const
 void LEItem::setSize( int w, int h )
 {
 	this->w=w; this->h=h;
+	geometryChanged();
 }
 
 int LEItem::width() const
@@ -213,11 +231,19 @@ LEItemList& LEItem::childs()
 QString LEItem::resolvName( char separator ) const
 {
 	if( parent() )
-		return QString("%1%2%3").arg( parent()->resolvName() )
-								.arg( separator )
-								.arg( name() );
-	else
-		return name();
+		return parent()->resolvName() + separator + name();
+
+	return name();
+}
+
+int LEItem::id() const
+{
+	return itemId;
+}
+
+int LEItem::graphIndex() const
+{
+	return graphIdx;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -227,3 +253,21 @@ void LEItem::connectionMoved( LEConnectionPoint * connection )
 {}
 void LEItem::connectionRemoved( LEConnectionPoint * connection )
 {}
+
+//////////////////////////////////////////////////////////////////////
+// Editor
+//////////////////////////////////////////////////////////////////////
+LogicEditor * LEItem::editor() const
+{
+	if( canvas() && canvas()->parent() && canvas()->parent()->inherits( "LogicEditor" ) )
+		return (LogicEditor*) canvas()->parent();
+
+	return NULL;
+}
+
+void LEItem::geometryChanged()
+{
+	LogicEditor * lpLE = editor();
+	if( lpLE )
+		lpLE->itemGeometryChanged( this );
+}
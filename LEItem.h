@@ -30,6 +30,8 @@
 
 class LEConnectionPoint;
 class LEItem;
+class LESymbolTable;
+class LogicEditor;
 
 typedef QPtrList<LEItem> LEItemList;
 
@@ -75,6 +77,9 @@ public:
 //////////////////////////////////////////////////////////////////////
 	virtual void show();
 	virtual void hide();
+
+	// Desplazamiento: notifica el cambio de geometra al editor
+	virtual void moveBy( double dx, double dy );
 	
 	// Mtodos a implementar por todas las clases derivadas
 	virtual void setResizable( bool rs );
@@ -95,8 +100,20 @@ public:
 	virtual void removeChild( LEItem * item );
 	virtual LEItemList & childs();
 
+	// Nombre jerrquico (padre.hijo). No se guarda: la jerarqua tiene a lo
+	// sumo dos niveles (dispositivo.pin) y la ruta con ITEM_NAME_SEPARATOR
+	// de los items registrados ya est en la tabla de smbolos
 	virtual QString resolvName( char separator=ITEM_NAME_SEPARATOR ) const;
 
+	// Identificador estable asignado por la tabla de smbolos del editor
+	// (-1 si el item no ha sido registrado)
+	int id() const;
+
+	// ndice del dispositivo, pin o cable en el grafo del modelo del editor
+	// (ver HDLLiveGraph), -1 si no est en l. El estado de red del item
+	// (red, primer cable) se consulta en el grafo con este ndice
+	int graphIndex() const;
+
 //////////////////////////////////////////////////////////////////////
 // Conectividad
 //////////////////////////////////////////////////////////////////////
@@ -105,10 +122,24 @@ public:
 	virtual void connectionMoved( LEConnectionPoint * connection );
 	virtual void connectionRemoved( LEConnectionPoint * connection );
 
+protected:
+	// Editor propietario del lienzo (NULL si el lienzo no pertenece a un LogicEditor)
+	LogicEditor * editor() const;
+
+	// Notifica al editor que el area del item ha cambiado (ndice espacial).
+	// Las subclases que modifiquen su forma sin pasar por setSize() o
+	// moveBy() deben invocarlo
+	void geometryChanged();
+
 private:
+	friend class LESymbolTable;
+	friend class HDLLiveGraph;
+
 	LEItem * parentItem;
 	LEItemList childList;
 	bool resizable;
+	int itemId;
+	int graphIdx;
 	int w, h;
 };
 
@@ -0,0 +1,147 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LEModelReader.cpp: implementation of the LEModelReader class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "LEModelReader.h"
+
+#include "LogicEditor.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+LEModelReader::LEModelReader( LogicEditor * editor )
+{
+	this->editor = editor;
+	this->depth = 0;
+}
+
+bool LEModelReader::read( QIODevice * device )
+{
+	QXmlInputSource source( device );
+	QXmlSimpleReader reader;
+
+	reader.setContentHandler( this );
+	reader.setErrorHandler( this );
+
+	return reader.parse( &source );
+}
+
+//////////////////////////////////////////////////////////////////////
+// QXmlContentHandler
+//////////////////////////////////////////////////////////////////////
+
+bool LEModelReader::startDocument()
+{
+	depth = 0;
+	errStr = QString::null;
+	pendingWireLines.clear();
+
+	return true;
+}
+
+bool LEModelReader::startElement( const QString & namespaceURI, const QString & localName,
+								  const QString & qName, const QXmlAttributes & atts )
+{
+	QString tag = ( localName.isEmpty() ? qName : localName ).lower();
+
+	depth++;
+
+	if( depth == 1 ){
+		// Autentificacin de formato
+		if( tag != "model" ){
+			errStr = LogicEditor::tr("Error cargando librera: El fichero no es un modelo.");
+			qWarning( errStr );
+			return false;
+		}
+
+		// Carga de atributos del modelo
+		QString data;
+		if( atts.index( "name" ) != -1 )
+			data = atts.value( "name" );
+		else
+			data = editor->name();
+		editor->setName( data );
+
+	}else if( depth == 2 ){
+
+		// Elementos del modelo
+		if( tag == "device" )
+			editor->parseDevice( atts );
+		else if( tag == "wireline" ){
+			// Si algn extremo hace referencia a un dispositivo an no cargado
+			// el cable se aplaza hasta el final del documento
+			if( isResolvable( atts.value( "leftConnection" ) ) && isResolvable( atts.value( "rightConnection" ) ) )
+				editor->parseWireLine( atts );
+			else
+				pendingWireLines.append( atts );
+		}
+	}
+
+	return true;
+}
+
+bool LEModelReader::endElement( const QString & namespaceURI, const QString & localName, const QString & qName )
+{
+	depth--;
+	return true;
+}
+
+// Resolucin de los cables aplazados: los extremos que siguen sin
+// resolverse quedan desconectados
+bool LEModelReader::endDocument()
+{
+	QValueList<QXmlAttributes>::iterator it;
+	for( it = pendingWireLines.begin(); it != pendingWireLines.end(); ++it )
+		editor->parseWireLine( *it );
+
+	pendingWireLines.clear();
+
+	return true;
+}
+
+QString LEModelReader::errorString()
+{
+	return errStr;
+}
+
+bool LEModelReader::isResolvable( const QString & cnnctName )
+{
+	if( cnnctName.isEmpty() || cnnctName == "null" )
+		return true;
+
+	return editor->findItem( cnnctName, true ) != NULL;
+}
+
+//////////////////////////////////////////////////////////////////////
+// QXmlErrorHandler
+//////////////////////////////////////////////////////////////////////
+
+bool LEModelReader::fatalError( const QXmlParseException & exception )
+{
+	// Los errores de formato del modelo ya han sido notificados
+	if( errStr.isEmpty() ){
+		errStr = exception.message();
+		qWarning( LogicEditor::tr("Error cargando el modelo en la lnea %d, columna %d: %s"),
+				  exception.lineNumber(), exception.columnNumber(), errStr.latin1() );
+	}
+
+	return false;
+}
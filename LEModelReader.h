@@ -0,0 +1,72 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LEModelReader.h: interface for the LEModelReader class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_LEMODELREADER_H_)
+#define _LEMODELREADER_H_
+
+#include <qxml.h>
+#include <qvaluelist.h>
+
+class LogicEditor;
+class QIODevice;
+
+////////////////////////////////////////////////////////////////////////////////
+//	LEModelReader
+//
+//	Lector SAX de modelos (.lem) para un LogicEditor.
+//
+//	Crea los dispositivos y cables en un nico recorrido del fichero sin
+//	construir el rbol DOM. Un cable cuyos extremos hacen referencia a
+//	pins de dispositivos todava no cargados se aplaza a una tabla de
+//	pendientes que se resuelve al terminar el documento.
+//
+////////////////////////////////////////////////////////////////////////////////
+class LEModelReader : public QXmlDefaultHandler
+{
+public:
+	LEModelReader( LogicEditor * editor );
+
+	bool read( QIODevice * device );
+
+	// QXmlContentHandler
+	bool startDocument();
+	bool startElement( const QString & namespaceURI, const QString & localName,
+					   const QString & qName, const QXmlAttributes & atts );
+	bool endElement( const QString & namespaceURI, const QString & localName, const QString & qName );
+	bool endDocument();
+	QString errorString();
+
+	// QXmlErrorHandler
+	bool fatalError( const QXmlParseException & exception );
+
+private:
+	// Indica si los extremos del cable pueden resolverse con lo cargado hasta ahora
+	bool isResolvable( const QString & cnnctName );
+
+	LogicEditor * editor;
+	int depth;
+	QString errStr;
+
+	// Cables aplazados hasta el final del documento
+	QValueList<QXmlAttributes> pendingWireLines;
+};
+
+#endif
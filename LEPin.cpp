@@ -36,6 +36,7 @@ LEPin::LEPin( QCanvas * canvas, LEItem * parentItem )
 	this->access = Input;
 	this->label = new LELabel( canvas, this );
 	this->actLevel = HiLevel;
+	this->bw = 1;
 
 	// Punto de Conexin
 	lpCnnct = new LEConnectionPoint( canvas, this );
@@ -54,6 +55,7 @@ LEPin::LEPin( Alignment align, AccessMode access, const QString &label, double p
 	this->label = new LELabel( label, canvas, this );
 	this->actLevel = HiLevel;
 	this->actLevel = l;
+	this->bw = 1;
 
 	lpCnnct = new LEConnectionPoint( canvas, this );
 	
@@ -90,7 +92,7 @@ void LEPin::hide()
 
 QString LEPin::resolvName( char separator ) const
 {
-	return QString("%1%2%3").arg(parent()->name()).arg(separator).arg(name());
+	return QString( parent()->name() ) + separator + name();
 }
 
 
@@ -152,12 +154,12 @@ QString LEPin::text() const
 
 LEPin::AccessMode LEPin::accessMode() const
 {
-	return access;
+	return (AccessMode)access;
 }
 
 LEPin::Alignment LEPin::alignment() const
 {
-	return align;
+	return (Alignment)align;
 }
 
 double LEPin::position() const
@@ -167,7 +169,18 @@ double LEPin::position() const
 
 LEPin::Level LEPin::activeLevel() const
 {
-	return actLevel;
+	return (Level)actLevel;
+}
+
+void LEPin::setBusWidth( int w )
+{
+	this->bw = ( w < 1 ) ? 1 : w;
+	update();
+}
+
+int LEPin::busWidth() const
+{
+	return (int)bw;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -368,6 +381,10 @@ void LEPin::drawShape( QPainter& p )
 		}
 	}
 
+	// Los pins de bus se dibujan con trazo grueso
+	if( bw > 1 )
+		p.setPen( QPen( p.pen().color(), BusPenWidth ) );
+
 	p.drawLine( left, top, right, bottom );
 	if( activeLevel() == LowLevel )
 		p.drawArc( rx-CIRCLE_RADIO, ry-CIRCLE_RADIO, 2*CIRCLE_RADIO, 2*CIRCLE_RADIO, 0, 360*16 );
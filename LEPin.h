@@ -38,12 +38,13 @@ class LEPin : public LEItem
 	Q_PROPERTY( double position READ position WRITE setPosition )
 	Q_PROPERTY( QString text READ text WRITE setText )
 	Q_PROPERTY( Level activeLevel READ activeLevel WRITE setActiveLevel )
+	Q_PROPERTY( int busWidth READ busWidth )
 	Q_ENUMS( Alignment )
 	Q_ENUMS( AccessMode )
 	Q_ENUMS( Level )
 
 public:
-	enum { PinLenght = 20, hzMargin=1, vrMargin=1, FontSize=9, RTTI=LErttiPin };
+	enum { PinLenght = 20, hzMargin=1, vrMargin=1, FontSize=9, BusPenWidth=2, RTTI=LErttiPin };
 
 	enum Alignment { Left, Right, Top, Bottom };
 	enum AccessMode { Input, Output, InputOutput};
@@ -66,6 +67,10 @@ public:
 	void setPosition( double pos );
 	void setActiveLevel( Level l );
 	Level activeLevel() const;
+
+	// Nmero de bits del pin (fijado por la descripcin de librera)
+	void setBusWidth( int w );
+	int busWidth() const;
 	
 	QString text() const;
 	AccessMode accessMode() const;
@@ -88,9 +93,12 @@ protected:
 private:
 	LELabel * label;
 
-	AccessMode access;
-	Alignment align;
-	Level actLevel;
+	// Propiedades empaquetadas en una palabra (hay un LEPin por pin de cada
+	// dispositivo)
+	uint access : 2;
+	uint align : 2;
+	uint actLevel : 1;
+	uint bw : 27;
 	double pos;
 
 	LEConnectionPoint * lpCnnct;
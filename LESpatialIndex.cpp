@@ -0,0 +1,151 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LESpatialIndex.cpp: implementation of the LESpatialIndex class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "LESpatialIndex.h"
+
+#include "LEItem.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+LESpatialIndex::LESpatialIndex()
+{
+}
+
+void LESpatialIndex::clear()
+{
+	entries.clear();
+	cells.clear();
+	dirty.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mantenimiento
+//////////////////////////////////////////////////////////////////////
+
+void LESpatialIndex::invalidate( LEItem * item )
+{
+	dirty.replace( item, item );
+}
+
+void LESpatialIndex::remove( LEItem * item )
+{
+	dirty.remove( item );
+
+	QMap<LEItem*, Entry>::iterator it = entries.find( item );
+	if( it != entries.end() ){
+		unplace( item, it.data().rect );
+		entries.remove( it );
+	}
+}
+
+// Reubica en la rejilla los items pendientes
+void LESpatialIndex::flush()
+{
+	if( dirty.isEmpty() )
+		return;
+
+	for( QPtrDictIterator<LEItem> it( dirty ); it.current(); ++it )
+		place( it.current() );
+
+	dirty.clear();
+}
+
+void LESpatialIndex::place( LEItem * item )
+{
+	QMap<LEItem*, Entry>::iterator it = entries.find( item );
+	if( it != entries.end() )
+		unplace( item, it.data().rect );
+
+	// Geometra cacheada: el area puede exceder boundingRect() (LEWireLine)
+	Entry entry;
+	QPointArray area = item->areaPoints();
+	entry.rect = area.boundingRect() | item->boundingRect();
+	entry.region = QRegion( area );
+	entries.replace( item, entry );
+
+	for( int cy = cellOf( entry.rect.top() ); cy <= cellOf( entry.rect.bottom() ); cy++ )
+		for( int cx = cellOf( entry.rect.left() ); cx <= cellOf( entry.rect.right() ); cx++ )
+			cells[ Cell( cx, cy ) ].append( item );
+}
+
+void LESpatialIndex::unplace( LEItem * item, const QRect & rect )
+{
+	for( int cy = cellOf( rect.top() ); cy <= cellOf( rect.bottom() ); cy++ )
+		for( int cx = cellOf( rect.left() ); cx <= cellOf( rect.right() ); cx++ ){
+			QMap<Cell, QValueList<LEItem*> >::iterator it = cells.find( Cell( cx, cy ) );
+			if( it == cells.end() )
+				continue;
+
+			it.data().remove( item );
+			if( it.data().isEmpty() )
+				cells.remove( it );
+		}
+}
+
+// Celda que contiene la coordenada (divisin entera por defecto)
+int LESpatialIndex::cellOf( int coord )
+{
+	if( coord >= 0 )
+		return coord / CellSize;
+
+	return -( ( -coord - 1 ) / CellSize ) - 1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consulta
+//////////////////////////////////////////////////////////////////////
+
+QCanvasItemList LESpatialIndex::collisions( const QPoint & p )
+{
+	QCanvasItemList result;
+
+	flush();
+
+	QMap<Cell, QValueList<LEItem*> >::iterator itCell = cells.find( Cell( cellOf( p.x() ), cellOf( p.y() ) ) );
+	if( itCell == cells.end() )
+		return result;
+
+	QValueList<LEItem*> & cellItems = itCell.data();
+	for( QValueList<LEItem*>::iterator it = cellItems.begin(); it != cellItems.end(); ++it ){
+		LEItem * item = *it;
+		if( !item->isVisible() )
+			continue;
+
+		const Entry & entry = entries[ item ];
+		if( !entry.rect.contains( p ) || !entry.region.contains( p ) )
+			continue;
+
+		// Insercin ordenada como QCanvasItemList::sort(): z descendente y, a
+		// igual z, direccin (como QCanvasItem) descendente
+		QCanvasItem * canvasItem = item;
+		QCanvasItemList::iterator itRes = result.begin();
+		while( itRes != result.end() &&
+			   ( (*itRes)->z() > canvasItem->z() ||
+				 ( (*itRes)->z() == canvasItem->z() && *itRes > canvasItem ) ) )
+			++itRes;
+
+		result.insert( itRes, canvasItem );
+	}
+
+	return result;
+}
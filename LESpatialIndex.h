@@ -0,0 +1,91 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// LESpatialIndex.h: interface for the LESpatialIndex class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_LESPATIALINDEX_H_)
+#define _LESPATIALINDEX_H_
+
+#include <qcanvas.h>
+#include <qregion.h>
+#include <qmap.h>
+#include <qpair.h>
+#include <qptrdict.h>
+#include <qvaluelist.h>
+
+class LEItem;
+
+////////////////////////////////////////////////////////////////////////////////
+//	LESpatialIndex
+//
+//	ndice espacial de los items de un LogicEditor para las consultas de
+//	colisin (seleccin, mouseOver, conexin de cables).
+//
+//	Divide el lienzo en una rejilla uniforme de celdas de CellSize pxeles;
+//	cada celda guarda los items cuyo area la intersecta. Para cada item se
+//	guarda su rectngulo envolvente y la regin de su areaPoints(), de
+//	forma que una consulta no recalcula la geometra de los items (el
+//	bufferPolygon de los LEWireLine es costoso).
+//
+//	Los items notifican sus cambios de geometra con invalidate(), que
+//	slo los marca como pendientes: la reubicacin en la rejilla se
+//	realiza en la siguiente consulta (un arrastre que mueve un dispositivo
+//	y sus pines se procesa una nica vez y nunca sobre items a medio
+//	construir).
+//
+////////////////////////////////////////////////////////////////////////////////
+class LESpatialIndex
+{
+public:
+	enum { CellSize = 64 };
+
+	LESpatialIndex();
+
+	void clear();
+
+	// Marca la geometra del item como modificada
+	void invalidate( LEItem * item );
+	// Elimina el item del ndice
+	void remove( LEItem * item );
+
+	// Items visibles cuyo area contiene el punto p, ordenados como en
+	// QCanvas::collisions(): z descendente (a igual z, direccin del item descendente)
+	QCanvasItemList collisions( const QPoint & p );
+
+private:
+	typedef QPair<int, int> Cell;
+
+	struct Entry
+	{
+		QRect rect;
+		QRegion region;
+	};
+
+	void flush();
+	void place( LEItem * item );
+	void unplace( LEItem * item, const QRect & rect );
+
+	static int cellOf( int coord );
+
+	QMap<LEItem*, Entry> entries;
+	QMap<Cell, QValueList<LEItem*> > cells;
+	QPtrDict<LEItem> dirty;
+};
+
+#endif
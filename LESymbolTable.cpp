@@ -0,0 +1,112 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// LESymbolTable.cpp: implementation of the LESymbolTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "LESymbolTable.h"
+
+#include "LEItem.h"
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+
+LESymbolTable::LESymbolTable()
+	: items( 211 ), paths( 211 ), nextId( 0 )
+{
+}
+
+void LESymbolTable::clear()
+{
+	items.clear();
+	paths.clear();
+	itemPaths.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Registro
+//////////////////////////////////////////////////////////////////////
+
+void LESymbolTable::insert( LEItem * item )
+{
+	// Los identificadores no se reutilizan: un item conserva el suyo
+	// durante toda su vida
+	if( item->itemId == -1 )
+		item->itemId = nextId++;
+	items.replace( item->itemId, item );
+
+	removePath( item );
+
+	QString path = item->resolvName( ITEM_NAME_SEPARATOR );
+	paths.replace( path, item );
+	itemPaths.replace( item->itemId, path );
+
+	// QDict no crece por s mismo
+	if( paths.count() > paths.size() )
+		paths.resize( 2*paths.size() + 1 );
+	if( items.count() > items.size() )
+		items.resize( 2*items.size() + 1 );
+
+	// La ruta de los hijos ya registrados depende del nombre del item
+	LEItemList & childs = item->childs();
+	for( QPtrListIterator<LEItem> it( childs ); it.current(); ++it )
+		if( it.current()->itemId != -1 && items.find( it.current()->itemId ) == it.current() )
+			insert( it.current() );
+}
+
+void LESymbolTable::remove( LEItem * item )
+{
+	if( item->itemId == -1 || items.find( item->itemId ) != item )
+		return;
+
+	removePath( item );
+	items.remove( item->itemId );
+}
+
+void LESymbolTable::removePath( LEItem * item )
+{
+	QMap<int, QString>::iterator it = itemPaths.find( item->itemId );
+	if( it == itemPaths.end() )
+		return;
+
+	// Slo si la ruta no ha sido ocupada despus por otro item
+	if( paths.find( it.data() ) == item )
+		paths.remove( it.data() );
+	itemPaths.remove( it );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Consultas
+//////////////////////////////////////////////////////////////////////
+
+LEItem * LESymbolTable::item( int id ) const
+{
+	return items.find( id );
+}
+
+LEItem * LESymbolTable::find( const QString & path ) const
+{
+	return paths.find( path );
+}
+
+uint LESymbolTable::count() const
+{
+	return items.count();
+}
@@ -0,0 +1,77 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// LESymbolTable.h: interface for the LESymbolTable class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_LESYMBOLTABLE_H_)
+#define _LESYMBOLTABLE_H_
+
+#include <qdict.h>
+#include <qintdict.h>
+#include <qmap.h>
+#include <qstring.h>
+
+class LEItem;
+
+////////////////////////////////////////////////////////////////////////////////
+//	LESymbolTable
+//
+//	Tabla de smbolos de los items con nombre de un LogicEditor.
+//
+//	Cada item recibe, al registrarse, un identificador entero estable (no
+//	cambia al renombrar el item) y su ruta jerrquica resuelta
+//	(dispositivo.pin) se indexa en una tabla hash, de forma que findItem()
+//	resuelve un nombre compuesto con una nica consulta en lugar de
+//	recorrer los hijos de cada nivel.
+//
+//	Los items notifican sus cambios de nombre con insert(), que reindexa
+//	la ruta del item y la de sus hijos ya registrados.
+//
+////////////////////////////////////////////////////////////////////////////////
+class LESymbolTable
+{
+public:
+	LESymbolTable();
+
+	void clear();
+
+	// Registra el item (asignndole identificador si no lo tena) o
+	// actualiza su ruta y la de sus hijos tras un cambio de nombre
+	void insert( LEItem * item );
+	// Elimina el item de la tabla
+	void remove( LEItem * item );
+
+	// Item con el identificador id (NULL si no est registrado)
+	LEItem * item( int id ) const;
+	// Item cuya ruta resuelta es path (NULL si no existe)
+	LEItem * find( const QString & path ) const;
+
+	uint count() const;
+
+private:
+	void removePath( LEItem * item );
+
+	QIntDict<LEItem> items;
+	QDict<LEItem> paths;
+	QMap<int, QString> itemPaths;
+	int nextId;
+};
+
+#endif
@@ -19,10 +19,12 @@
 #include "LEWireLine.h"
 
 #include <qpainter.h>
+#include <qmemarray.h>
 #include <math.h>
 #include <stdlib.h>
 
 #include "LEConnectionPoint.h"
+#include "LogicEditor.h"
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -33,6 +35,10 @@ LEWireLine::LEWireLine( QCanvas * canvas, LEItem * parentItem )
 {
 	lpLeftCnnct = NULL;
 	lpRightCnnct = NULL;
+	bw = 1;
+	slice = -1;
+	hullValid = false;
+	boundsValid = false;
 }
 
 LEWireLine::~LEWireLine()
@@ -42,6 +48,8 @@ LEWireLine::~LEWireLine()
 
 void LEWireLine::remove()
 {
+	batchWires.removeRef( this );
+
 	if( lpLeftCnnct )
 		lpLeftCnnct->removeConnection(this);
 	
@@ -72,7 +80,13 @@ void LEWireLine::connectLeft( LEConnectionPoint * lpCnnct )
 		lpCnnct->setConnection( this );
 		moveVertex( 0, lpCnnct->x(), lpCnnct->y() );
 	}
+	LEConnectionPoint * lpOld = lpLeftCnnct;
 	lpLeftCnnct = lpCnnct;
+
+	// Notificacin al editor para mantener al da la netlist
+	LogicEditor * lpLE = editor();
+	if( lpLE )
+		lpLE->wireLineConnectionChanged( this, lpOld );
 }
 
 void LEWireLine::connectRight( LEConnectionPoint * lpCnnct )
@@ -84,7 +98,13 @@ void LEWireLine::connectRight( LEConnectionPoint * lpCnnct )
 		lpCnnct->setConnection( this );
 		moveVertex( vertexCount()-1, lpCnnct->x(), lpCnnct->y() );
 	}
+	LEConnectionPoint * lpOld = lpRightCnnct;
 	lpRightCnnct = lpCnnct;
+
+	// Notificacin al editor para mantener al da la netlist
+	LogicEditor * lpLE = editor();
+	if( lpLE )
+		lpLE->wireLineConnectionChanged( this, lpOld );
 }
 
 bool LEWireLine::isLeftConnected() const
@@ -131,98 +151,72 @@ void LEWireLine::connectionRemoved( LEConnectionPoint * lpCnnct )
 
 QPointArray LEWireLine::areaPoints() const
 {
-	return bufferPolygon( 2 );
+	if( !hullValid ){
+		hull = bufferPolygon( BufferWidth );
+		hullValid = true;
+	}
+
+	// QPointArray es compartido explcitamente: se entrega una copia
+	return hull.copy();
 }
 
 QRect LEWireLine::boundingRect() const
 {
-	QRect rv = vertexList.boundingRect();
-	return QRect( rv.x()-1, rv.y()-1, rv.width()+2, rv.height()+2 );
+	if( !boundsValid ){
+		QRect rv = vertexList.boundingRect();
+		bounds = QRect( rv.x()-1, rv.y()-1, rv.width()+2, rv.height()+2 );
+		boundsValid = true;
+	}
+
+	return bounds;
 }
 
 QPointArray LEWireLine::bufferPolygon( double d ) const
 {
-	// El mtodo empleado es el de intersectar las n rectas asociadas a los n segmentos que forman
-	// la linea 'd' unidades desplazadas recorrindola en ambos sentidos (se trata de envolver una
-	// linea). Los puntos de interseccin constituyen los nuevos vrtices del buffer
-	QPointArray rv;
-	if( vertexList.count() == 0 )
-		return rv;
-	else if( vertexList.count() == 1 ){
-		int vx = vertexList[0].x();
-		int vy = vertexList[0].y();
-		int id = (int)d;
-		rv.putPoints( 0, 5, vx-id, vy-id, vx+id,vy-id, vx+id,vy+id, vx-id,vy+id, vx-id,vy-id );
-		return rv;
-	}
+	int n = vertexList.count();
+	QMemArray<double> x( n ), y( n ), ux( n ), uy( n );
 
-	double Alst, Blst, Clst, A, B, C, R, S, X, Y;
-	int i, last = vertexList.count()-1;
-	
-	R = vertexList[1].x() - vertexList[0].x();
-	S = vertexList[1].y() - vertexList[0].y();
-	Alst = S / sqrt( R*R + S*S );
-	Blst = -R / sqrt( R*R + S*S );
-	Clst = Alst*((double)vertexList[0].x())+Blst*((double)vertexList[0].y())+d;
-	
-	for( i=1; i<last; i++ )
-	{
-	if( vertexList[i] != vertexList[i+1] ){
-		R = vertexList[i+1].x() - vertexList[i].x();
-		S = vertexList[i+1].y() - vertexList[i].y();
-		
-		// Vector (A,B) unitario normal al director (R,S) del segmento
-		A = S / sqrt( R*R + S*S );
-		B = -R / sqrt( R*R + S*S );
-		
-		// Constante de desplazamiento
-		C = A*((double)vertexList[i].x())+B*((double)vertexList[i].y())+d;
-
-		// Evitamos divisin por 0 para lineas Verticales/Horizontales 
-		// NOTA: Consideramos Imposible A==B==0, ya que eso supondra haber definido dos puntos consecutivos uno
-		//		sobre el otro. Asumimos correccin en la definicin.
-		if( A == 0 ){
-			if( Alst == 0 )
-				X = vertexList[i].x();
-			else
-				X = (Clst*B - C*Blst) / (B*Alst);
-			Y = C / B;
-		}else if( B == 0){
-			if( Blst == 0 )
-				Y = vertexList[i].y();
-			else
-				Y = (Alst*C - A*Clst) / (-A*Blst);
-			X = C / A;
-		}else{
-			Y = (Alst*C - A*Clst) / (Alst*B - A*Blst);
-			X = (C - B*Y) / A;
-		}
-
-		rv.putPoints( rv.count(), 1, X, Y );
-		Alst = A;
-		Blst = B;
-		Clst = C;
-}			
+	for( int i=0; i<n; i++ ){
+		x[i] = vertexList[i].x();
+		y[i] = vertexList[i].y();
 	}
 
+	segmentDirections( x.data(), y.data(), n, ux.data(), uy.data() );
 
-// Borde "derecho" de la linea
-  // Punto superior
-	// Recta tangente al segmento (n-1, n) : Vector Director paralelo al segmento
-	A = R / sqrt( R*R + S*S );
-	B = S / sqrt( R*R + S*S );
-	C = A*((double)vertexList[last].x())+B*((double)vertexList[last].y())+d;
+	return bufferPolygon( x.data(), y.data(), ux.data(), uy.data(), n, d );
+}
 
+// Vectores directores unitarios (ux, uy) de los n-1 segmentos de la
+// polilnea (x, y). Las iteraciones son independientes entre s, de
+// forma que el bucle (races y divisiones) puede vectorizarse
+void LEWireLine::segmentDirections( const double * x, const double * y, int n, double * ux, double * uy )
+{
+	for( int k=0; k<n-1; k++ ){
+		double R = x[k+1] - x[k];
+		double S = y[k+1] - y[k];
+		double L = sqrt( R*R + S*S );
+		ux[k] = R / L;
+		uy[k] = S / L;
+	}
+}
+
+// Interseccin de la recta A*x+B*y=C con la anterior Alst*x+Blst*y=Clst.
+// (vx, vy) es el vrtice comn, usado cuando ambas son paralelas a un eje
+static inline void intersectLines( double Alst, double Blst, double Clst, double A, double B, double C,
+								   double vx, double vy, double &X, double &Y )
+{
 	// Evitamos divisin por 0 para lineas Verticales/Horizontales 
+	// NOTA: Consideramos Imposible A==B==0, ya que eso supondra haber definido dos puntos consecutivos uno
+	//		sobre el otro. Asumimos correccin en la definicin.
 	if( A == 0 ){
 		if( Alst == 0 )
-			X = vertexList[i].x();
+			X = vx;
 		else
 			X = (Clst*B - C*Blst) / (B*Alst);
 		Y = C / B;
 	}else if( B == 0){
 		if( Blst == 0 )
-			Y = vertexList[i].y();
+			Y = vy;
 		else
 			Y = (Alst*C - A*Clst) / (-A*Blst);
 		X = C / A;
@@ -230,6 +224,61 @@ QPointArray LEWireLine::bufferPolygon( double d ) const
 		Y = (Alst*C - A*Clst) / (Alst*B - A*Blst);
 		X = (C - B*Y) / A;
 	}
+}
+
+QPointArray LEWireLine::bufferPolygon( const double * x, const double * y, const double * ux, const double * uy, int n, double d )
+{
+	// El mtodo empleado es el de intersectar las n rectas asociadas a los n segmentos que forman
+	// la linea 'd' unidades desplazadas recorrindola en ambos sentidos (se trata de envolver una
+	// linea). Los puntos de interseccin constituyen los nuevos vrtices del buffer
+	QPointArray rv;
+	if( n == 0 )
+		return rv;
+	else if( n == 1 ){
+		int vx = (int)x[0];
+		int vy = (int)y[0];
+		int id = (int)d;
+		rv.putPoints( 0, 5, vx-id, vy-id, vx+id,vy-id, vx+id,vy+id, vx-id,vy+id, vx-id,vy-id );
+		return rv;
+	}
+
+	// (U,V): director unitario del ltimo segmento recorrido
+	double Alst, Blst, Clst, A, B, C, U, V, X, Y;
+	int i, last = n-1;
+	
+	U = ux[0];
+	V = uy[0];
+	Alst = V;
+	Blst = -U;
+	Clst = Alst*x[0]+Blst*y[0]+d;
+	
+	for( i=1; i<last; i++ )
+		if( x[i] != x[i+1] || y[i] != y[i+1] ){
+			U = ux[i];
+			V = uy[i];
+
+			// Vector (A,B) unitario normal al director del segmento
+			A = V;
+			B = -U;
+			
+			// Constante de desplazamiento
+			C = A*x[i]+B*y[i]+d;
+
+			intersectLines( Alst, Blst, Clst, A, B, C, x[i], y[i], X, Y );
+			rv.putPoints( rv.count(), 1, X, Y );
+			Alst = A;
+			Blst = B;
+			Clst = C;
+		}
+
+// Borde "derecho" de la linea
+  // Punto superior
+	// Recta tangente al segmento (n-1, n) : Vector Director paralelo al segmento
+	A = U;
+	B = V;
+	C = A*x[last]+B*y[last]+d;
+
+	intersectLines( Alst, Blst, Clst, A, B, C, x[i], y[i], X, Y );
 	rv.putPoints( rv.count(), 1, X, Y );
 	Alst = A;
 	Blst = B;
@@ -238,102 +287,46 @@ QPointArray LEWireLine::bufferPolygon( double d ) const
 
 // Recorrido en sentido contrario
 	for( i = last; i>0; i-- )
-	{
-if( vertexList[i] != vertexList[i-1] ){
-		R = vertexList[i-1].x() - vertexList[i].x();
-		S = vertexList[i-1].y() - vertexList[i].y();
-		
-		// Vector (A,B) unitario normal al director (R,S) del segmento con sentido invertido (-S, R)
-		A = S / sqrt( R*R + S*S );
-		B = -R / sqrt( R*R + S*S );
+		if( x[i] != x[i-1] || y[i] != y[i-1] ){
+			// Director del segmento recorrido en sentido inverso
+			U = -ux[i-1];
+			V = -uy[i-1];
 			
-		// Constante de desplazamiento
-		C = A*((double)vertexList[i].x())+B*((double)vertexList[i].y())+d;
-
-		// Evitamos divisin por 0 para lineas Verticales/Horizontales 
-		// NOTA: Consideramos Imposible A==B==0, ya que eso supondra haber definido dos puntos consecutivos uno
-		//		sobre el otro. Asumimos correccin en la definicin.
-		if( A == 0 ){
-			if( Alst == 0 )
-				X = vertexList[i].x();
-			else
-				X = (Clst*B - C*Blst) / (B*Alst);
-			Y = C / B;
-		}else if( B == 0){
-			if( Blst == 0 )
-				Y = vertexList[i].y();
-			else
-				Y = (Alst*C - A*Clst) / (-A*Blst);
-			X = C / A;
-		}else{
-			Y = (Alst*C - A*Clst) / (Alst*B - A*Blst);
-			X = (C - B*Y) / A;
+			// Vector (A,B) unitario normal al director del segmento con sentido invertido
+			A = V;
+			B = -U;
+				
+			// Constante de desplazamiento
+			C = A*x[i]+B*y[i]+d;
+
+			intersectLines( Alst, Blst, Clst, A, B, C, x[i], y[i], X, Y );
+			rv.putPoints( rv.count(), 1, X, Y );
+			Alst = A;
+			Blst = B;
+			Clst = C;
 		}
 
-		rv.putPoints( rv.count(), 1, X, Y );
-		Alst = A;
-		Blst = B;
-		Clst = C;
-}
-	}
-
 // Penltimo punto (borde "izquierdo inferior")
 	// Recta tangente al segmento (0-1) : Vector Director paralelo al segmento
-	// NOTA: (R-S) ha sido calculado como director de (1-0), as que negamos sus componentes para obtener (0-1)
-	A = R / sqrt( R*R + S*S );
-	B = S / sqrt( R*R + S*S );
-	C = A*((double)vertexList[0].x())+B*((double)vertexList[0].y())+d;
-
-	// Evitamos divisin por 0 para lineas Verticales/Horizontales 
-	if( A == 0 ){
-		if( Alst == 0 )
-			X = vertexList[i].x();
-		else
-			X = (Clst*B - C*Blst) / (B*Alst);
-		Y = C / B;
-	}else if( B == 0){
-		if( Blst == 0 )
-			Y = vertexList[i].y();
-		else
-			Y = (Alst*C - A*Clst) / (-A*Blst);
-		X = C / A;
-	}else{
-		Y = (Alst*C - A*Clst) / (Alst*B - A*Blst);
-		X = (C - B*Y) / A;
-	}
+	A = U;
+	B = V;
+	C = A*x[0]+B*y[0]+d;
 
+	intersectLines( Alst, Blst, Clst, A, B, C, x[i], y[i], X, Y );
 	rv.putPoints( rv.count(), 1, X, Y );
 	Alst = A;
 	Blst = B;
 	Clst = C;
 
 // Primer Punto (borde "izquierdo superior")
-	// Vector (A,B) unitario normal al director (-R,-S) del segmento -NOTA:(R,S) est calculado para (1,0) y no (0,1)
-	A = -S / sqrt( R*R + S*S );
-	B = R / sqrt( R*R + S*S );
+	// Vector (A,B) unitario normal al director del segmento (1-0)
+	A = -V;
+	B = U;
 	
 	// Constante de desplazamiento
-	C = A*((double)vertexList[1].x())+B*((double)vertexList[1].y())+d;
+	C = A*x[1]+B*y[1]+d;
 
-	// Evitamos divisin por 0 para lineas Verticales/Horizontales 
-	// NOTA: Consideramos Imposible A==B==0, ya que eso supondra haber definido dos puntos consecutivos uno
-	//		sobre el otro. Asumimos correccin en la definicin.
-	if( A == 0 ){
-		if( Alst == 0 )
-			X = vertexList[i].x();
-		else
-			X = (Clst*B - C*Blst) / (B*Alst);
-		Y = C / B;
-	}else if( B == 0){
-		if( Blst == 0 )
-			Y = vertexList[i].y();
-		else
-			Y = (Alst*C - A*Clst) / (-A*Blst);
-		X = C / A;
-	}else{
-		Y = (Alst*C - A*Clst) / (Alst*B - A*Blst);
-		X = (C - B*Y) / A;
-	}
+	intersectLines( Alst, Blst, Clst, A, B, C, x[i], y[i], X, Y );
 	rv.putPoints( rv.count(), 1, X, Y );
 
 	// Replicamos el primer punto como ltimo punto
@@ -342,6 +335,81 @@ if( vertexList[i] != vertexList[i-1] ){
 	return rv;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Reclculo por lotes de los envolventes
+//////////////////////////////////////////////////////////////////////
+
+QPtrList<LEWireLine> LEWireLine::batchWires;
+int LEWireLine::batchDepth = 0;
+
+// Recalcula los envolventes de todos los cables en una nica pasada sobre
+// vectores planos de coordenadas: los directores de todos los segmentos se
+// obtienen en un solo bucle y despus se ensambla el envolvente de cada cable
+void LEWireLine::updateHulls( QPtrList<LEWireLine> & wires )
+{
+	LEWireLine * wl;
+	int total = 0, offset = 0;
+
+	for( wl = wires.first(); wl; wl = wires.next() )
+		total += wl->vertexList.count();
+
+	QMemArray<double> x( total ), y( total ), ux( total ), uy( total );
+	for( wl = wires.first(); wl; wl = wires.next() )
+		for( int i=0; i<wl->vertexList.count(); i++, offset++ ){
+			x[offset] = wl->vertexList[i].x();
+			y[offset] = wl->vertexList[i].y();
+		}
+
+	// Los segmentos que unen dos cables consecutivos se calculan pero no se usan
+	segmentDirections( x.data(), y.data(), total, ux.data(), uy.data() );
+
+	offset = 0;
+	for( wl = wires.first(); wl; wl = wires.next() ){
+		int n = wl->vertexList.count();
+		wl->hull = bufferPolygon( x.data()+offset, y.data()+offset, ux.data()+offset, uy.data()+offset, n, BufferWidth );
+		wl->hullValid = true;
+		offset += n;
+	}
+}
+
+// Abre un lote: las ediciones de vrtices no actualizan el lienzo hasta endBatch()
+void LEWireLine::beginBatch()
+{
+	batchDepth++;
+}
+
+// Cierra el lote: recalcula a la vez los envolventes de los cables editados
+// y actualiza el lienzo
+void LEWireLine::endBatch()
+{
+	if( batchDepth == 0 || --batchDepth > 0 )
+		return;
+
+	if( batchWires.isEmpty() )
+		return;
+
+	updateHulls( batchWires );
+	for( LEWireLine * wl = batchWires.first(); wl; wl = batchWires.next() )
+		wl->update();
+
+	batchWires.clear();
+}
+
+// Fin de una edicin de vrtices: invalida la geometra cacheada y
+// actualiza el lienzo (diferido si hay un lote abierto)
+void LEWireLine::vertexsChanged()
+{
+	hullValid = false;
+	boundsValid = false;
+	geometryChanged();
+
+	if( batchDepth > 0 ){
+		if( batchWires.findRef( this ) == -1 )
+			batchWires.append( this );
+	}else
+		update();
+}
+
 //////////////////////////////////////////////////////////////////////
 // Bsqueda por aproximacin
 //////////////////////////////////////////////////////////////////////
@@ -521,7 +589,7 @@ void LEWireLine::moveVertex( int i, QPoint p )
 
 	normalize();
 
-	update();
+	vertexsChanged();
 }
 
 void LEWireLine::setVertexs( QPointArray & vertexs )
@@ -531,7 +599,7 @@ void LEWireLine::setVertexs( QPointArray & vertexs )
 	vertexList = vertexs;
 	normalize();
 
-	update();
+	vertexsChanged();
 }
 
 void LEWireLine::insertVertex( int x, int y, int i )
@@ -558,7 +626,7 @@ void LEWireLine::insertVertex( int x, int y, int i )
 		indx = i;
 	}
 
-	update();
+	vertexsChanged();
 }
 
 void LEWireLine::insertVertex( const QPoint &p, int i )
@@ -583,7 +651,7 @@ void LEWireLine::removeVertex( int i )
 		vertexList = nv;
 	}
 	
-	update();
+	vertexsChanged();
 }
 
 void LEWireLine::normalize()
@@ -600,10 +668,41 @@ void LEWireLine::normalize()
 	vl.putPoints( ++k, 1, vertexList[ ((int)vertexList.count()-1) ].x(), vertexList[ ((int)vertexList.count()-1) ].y() );
 	
 	vertexList = vl;	
+	hullValid = false;
+	boundsValid = false;
+	geometryChanged();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Bus
+//////////////////////////////////////////////////////////////////////
+void LEWireLine::setBusWidth( int w )
+{
+	this->bw = ( w < 1 ) ? 1 : w;
+	update();
+}
+
+int LEWireLine::busWidth() const
+{
+	return bw;
+}
+
+void LEWireLine::setSliceOffset( int offset )
+{
+	this->slice = ( offset < 0 ) ? -1 : offset;
+}
+
+int LEWireLine::sliceOffset() const
+{
+	return slice;
 }
 
 void LEWireLine::drawShape( QPainter & p )
 {
+	// Los buses se dibujan con trazo grueso
+	if( bw > 1 )
+		p.setPen( QPen( p.pen().color(), BusPenWidth ) );
+
 	p.drawPolyline( vertexList );
 	// DEBUG:
 	//QPointArray n = bufferPolygon(2);
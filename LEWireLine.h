@@ -24,12 +24,18 @@
 
 #include "LEItem.h"
 
+#include <qptrlist.h>
+
 class LEConnetionPoint;
 
 class LEWireLine : public LEItem  
 {
+	Q_OBJECT
+	Q_PROPERTY( int busWidth READ busWidth WRITE setBusWidth )
+	Q_PROPERTY( int sliceOffset READ sliceOffset WRITE setSliceOffset )
+
 public:
-	enum { RTTI = LErttiWireLine };
+	enum { RTTI = LErttiWireLine, BufferWidth = 2, BusPenWidth = 2 };
 
 	LEWireLine( QCanvas * canvas, LEItem * parentItem=0 );
 	virtual ~LEWireLine();
@@ -38,13 +44,23 @@ public:
 
 	virtual int rtti() const;
 
-	// Devuelve el area y rectangulos envolventes (~bufferPolygon)
+	// Devuelve el area y rectangulos envolventes (~bufferPolygon). Ambos se
+	// cachean hasta la siguiente edicin de vrtices
 	virtual QPointArray areaPoints() const;
 	virtual QRect boundingRect() const;
 
 	// Genera un buffer envolvente para el conjunto de lineas
 	virtual QPointArray bufferPolygon( double d ) const;
 
+	// Reclculo de los envolventes de varios cables en una nica pasada
+	static void updateHulls( QPtrList<LEWireLine> & wires );
+
+	// Lote de ediciones (p.e. al desplazar un dispositivo con muchos cables
+	// conectados): los envolventes de los cables editados se recalculan
+	// juntos y el lienzo se actualiza al cerrar el lote
+	static void beginBatch();
+	static void endBatch();
+
 	// Devuelve el ndice del vrtice ms prximo al punto p o -1 si no existe ninguna aproximacin viable
 	int nearestVertex( const QPoint &p ) const;
 
@@ -71,12 +87,39 @@ public:
 	virtual void connectionMoved( LEConnectionPoint * lpCnnct );
 	virtual void connectionRemoved( LEConnectionPoint * lpCnnct );
 
+	// Bus: nmero de bits de la red que transporta el cable (1 = escalar).
+	// Un cable conectado a un pin ms estrecho que la red es una derivacin:
+	// sliceOffset indica el bit de la red en que empieza la porcin tomada
+	// por el pin (-1 si no es una derivacin). No hay derivaciones de
+	// concatenacin: los cables de un punto de conexin pertenecen a una
+	// nica red, as que un pin ancho no puede formarse con bits de varias
+	void setBusWidth( int w );
+	int busWidth() const;
+	void setSliceOffset( int offset );
+	int sliceOffset() const;
+
 	// Dibujado
 	virtual void drawShape( QPainter & p );
 
 private:
+	void vertexsChanged();
+
+	static void segmentDirections( const double * x, const double * y, int n, double * ux, double * uy );
+	static QPointArray bufferPolygon( const double * x, const double * y, const double * ux, const double * uy, int n, double d );
+
 	QPointArray vertexList;
 	LEConnectionPoint *lpLeftCnnct, *lpRightCnnct;
+	int bw, slice;
+
+	// Geometra cacheada
+	mutable QPointArray hull;
+	mutable bool hullValid;
+	mutable QRect bounds;
+	mutable bool boundsValid;
+
+	// Cables editados en el lote abierto
+	static QPtrList<LEWireLine> batchWires;
+	static int batchDepth;
 
 };
 
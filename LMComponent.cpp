@@ -167,6 +167,70 @@ bool LMComponent::parse(const QDomElement &element)
 }
 
 
+// Las entradas se sitan a la izquierda y las salidas (y los pins de
+// entrada/salida) a la derecha, repartidas automticamente; la geometra es
+// un rectngulo con altura para el lado con ms pins
+bool LMComponent::parseSignals(const QDomElement &element)
+{
+	QString name = element.attribute( "entity" );
+	if( name.isEmpty() ){
+		qWarning( "Error cargando modelo: No se ha especificado el atributo 'entity' de 'signals'" );
+		return false;
+	}
+
+	setName( name );
+	shps.clear();
+	pins.clear();
+
+	int nLeft=0, nRight=0;
+	for( QDomNode node = element.firstChild(); !node.isNull(); node = node.nextSibling() ){
+		if( node.toElement().tagName() != "signal" )
+			continue;
+
+		LMPinDescription pin;
+		pin.setName( node.toElement().text().stripWhiteSpace() );
+		if( pin.name().isEmpty() ){
+			qWarning( "Error cargando modelo '" + name + "': <signal> sin nombre" );
+			return false;
+		}
+
+		QString data = node.toElement().attribute( "accessMode" ).upper();
+		if( data == "IN" ){
+			pin.setAccessMode( LEPin::Input );
+			pin.setAlignment( LEPin::Left );
+			nLeft++;
+		}else{
+			pin.setAccessMode( data == "OUT" ? LEPin::Output : LEPin::InputOutput );
+			pin.setAlignment( LEPin::Right );
+			nRight++;
+		}
+
+		pin.setActiveLevel( LEPin::HiLevel );
+		pin.setPosition( -1 );
+
+		pin.setBusWidth( 1 );
+		data = node.toElement().attribute( "width" );
+		if( !data.isNull() ){
+			bool ok;
+			int val = data.toInt( &ok );
+			if( !ok || val < 1 ){
+				qWarning( "Error cargando modelo '" + name + "': Ancho incorrecto en el pin '" + pin.name() + "'" );
+				return false;
+			}
+			pin.setBusWidth( val );
+		}
+
+		pins.append( pin );
+	}
+
+	int height = 20 * ( QMAX( nLeft, nRight ) + 1 );
+	QPointArray shape;
+	shape.setPoints( 5, 0,0, 60,0, 60,height, 0,height, 0,0 );
+	shps.append( shape );
+
+	return true;
+}
+
 // Transforma una secuencia de nmeros separados por espacios
 // en un point array
 bool LMComponent::parseShapeString(const QString &shape, QPointArray & points )
@@ -251,6 +315,19 @@ bool LMComponent::parsePinDescription( QDomNode &node, LMPinDescription & pin )
 		if( ok )
 			pin.setPosition( val );
 	}
+
+	// Nmero de bits (1 por omisin: pin escalar)
+	pin.setBusWidth( 1 );
+	data = node.toElement().attribute( "width" );
+	if( !data.isNull() ){
+		bool ok;
+		int val = data.toInt( &ok );
+		if( !ok || val < 1 ){
+			qWarning( "Error cargando componente: Ancho incorrecto en el pin '" + pin.name() + "'" );
+			return false;
+		}
+		pin.setBusWidth( val );
+	}
 	
 	return true;
 }
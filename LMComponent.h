@@ -73,6 +73,10 @@ public:
 	// Construye el componente a partir de una entrada XML
 	bool parse(const QDomElement &element);
 
+	// Construye el componente a partir de la interfaz de un modelo del
+	// proyecto (elemento <signals> de su fichero .sig)
+	bool parseSignals(const QDomElement &element);
+
 	// Transforma una secuencia de nmeros separados por espacios
 	// en un point array
 	static bool parseShapeString(const QString &shape, QPointArray & points );
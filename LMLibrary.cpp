@@ -28,12 +28,14 @@
 
 LMLibrary::LMLibrary()
 {
+	indexedCount = 0;
 	nm = QString::null;
 	setSourceType( None );
 }
 
 LMLibrary::LMLibrary( QIODevice * file )
 {
+	indexedCount = 0;
 	nm = QString::null;
 	setSourceType( None );
 	parseFile( file );	
@@ -41,11 +43,41 @@ LMLibrary::LMLibrary( QIODevice * file )
 
 LMLibrary::LMLibrary( QString & file )
 {
+	indexedCount = 0;
 	nm = QString::null;
 	setSourceType( None );
 	parseFile( file );	
 }
 
+LMLibrary::LMLibrary( const LMLibrary & other )
+	: QValueList<LMComponent>( other )
+{
+	indexedCount = 0;
+	nm = other.nm;
+	autr = other.autr;
+	vr = other.vr;
+	srcTp = other.srcTp;
+	srcSrc = other.srcSrc;
+}
+
+LMLibrary & LMLibrary::operator=( const LMLibrary & other )
+{
+	if( this == &other )
+		return *this;
+
+	QValueList<LMComponent>::operator=( other );
+
+	index.clear();
+	indexedCount = 0;
+	nm = other.nm;
+	autr = other.autr;
+	vr = other.vr;
+	srcTp = other.srcTp;
+	srcSrc = other.srcSrc;
+
+	return *this;
+}
+
 
 //////////////////////////////////////////////////////////////////////
 // Atributos de la librera
@@ -106,11 +138,24 @@ int LMLibrary::version() const
 //////////////////////////////////////////////////////////////////////
 LMComponent * LMLibrary::find( const QString & compName )
 {
+	if( indexedCount != count() )
+		updateIndex();
+
+	return index.find( compName );
+}
+
+// Ante nombres repetidos se indexa el primer componente (como haca la
+// bsqueda lineal)
+void LMLibrary::updateIndex()
+{
+	index.clear();
+	index.resize( 2*count() + 1 );
+
 	for( iterator it = begin(); it != end(); ++it )
-		if( (*it).name() == compName )
-			return &(*it);
-	
-	return NULL;
+		if( !(*it).name().isNull() && !index.find( (*it).name() ) )
+			index.insert( (*it).name(), &(*it) );
+
+	indexedCount = count();
 }
 
 
@@ -183,6 +228,8 @@ bool LMLibrary::parseFile( QIODevice * device )
 		node = node.nextSibling();
 	}
 
+	updateIndex();
+
 	return true;
 }
 
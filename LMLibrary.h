@@ -40,6 +40,7 @@
 #define _LMLIBRARY_H_
 
 #include <qvaluelist.h>
+#include <qdict.h>
 
 #include "LMComponent.h"
 
@@ -56,6 +57,11 @@ public:
 	LMLibrary( );
 	LMLibrary( QIODevice * file );
 	LMLibrary( QString & file );
+
+	// La copia no comparte el ndice: apunta a los componentes de la lista
+	// original, as que se reconstruye en la primera bsqueda
+	LMLibrary( const LMLibrary & other );
+	LMLibrary & operator=( const LMLibrary & other );
 	
 	// Atributos de la librera
 	void setName( const QString &name );
@@ -69,6 +75,7 @@ public:
 	SourceType sourceType() const;
 	int version() const;
 
+	// Bsqueda de un componente por nombre (tabla hash, ver updateIndex)
 	LMComponent * find( const QString & compName );
 
 	// Extrae la informacin de la librera desde el dispositivo device
@@ -77,6 +84,13 @@ public:
 	bool parseFile( const QString &file );
 
 private:
+	// Reconstruye el ndice de componentes por nombre. Se construye al
+	// cargar la librera y se rehace si la lista de componentes ha crecido
+	void updateIndex();
+
+	QDict<LMComponent> index;
+	uint indexedCount;
+
 	QString nm, autr;
 	int vr;
 
@@ -29,6 +29,7 @@ LMPinDescription::LMPinDescription()
 {
 	this->nm = QString::null;
 	this->pos = -1;
+	this->bw = 1;
 }
 
 LMPinDescription::LMPinDescription( const QString &name, LEPin::AccessMode am, LEPin::Alignment al, double position )
@@ -37,6 +38,7 @@ LMPinDescription::LMPinDescription( const QString &name, LEPin::AccessMode am, L
 	this->am = am;
 	this->al = al;
 	this->pos = position;
+	this->bw = 1;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -69,6 +71,12 @@ LEPin::Level LMPinDescription::activeLevel() const
 	return l;
 }
 
+// Nmero de bits del pin (1 para un pin escalar)
+int LMPinDescription::busWidth() const
+{
+	return bw;
+}
+
 void LMPinDescription::setPosition( double pos )
 {
 	this->pos = pos;
@@ -97,4 +105,7 @@ void LMPinDescription::setActiveLevel( LEPin::Level l )
 	this->l = l;
 }
 
-
+void LMPinDescription::setBusWidth( int w )
+{
+	this->bw = ( w < 1 ) ? 1 : w;
+}
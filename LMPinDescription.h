@@ -53,11 +53,13 @@ public:
 	LEPin::Alignment alignment() const;
 	LEPin::AccessMode accessMode() const;
 	LEPin::Level activeLevel() const;
+	int busWidth() const;
 	void setPosition( double pos );
 	void setName( const QString &nm );
 	void setAlignment( LEPin::Alignment al );
 	void setAccessMode( LEPin::AccessMode am );
 	void setActiveLevel( LEPin::Level l );
+	void setBusWidth( int w );
 
 private:
 	QString nm;
@@ -65,6 +67,7 @@ private:
 	LEPin::Alignment al;
 	LEPin::Level l;
 	double pos;
+	int bw;
 
 };
 
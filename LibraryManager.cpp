@@ -32,43 +32,110 @@ LMLibrary * LibraryManager::loadLibrary(  const QString &  libraryFile )
 		remove( it );
 		return NULL;
 	}
+
+	indexLibrary( &(*it) );
 	return &(*it);
 }
 
-// Busca la librera de nombre libName
-LMLibrary * LibraryManager::find( const QString & libName )
+// Ante nombres repetidos prevalece lo primero que se carg, igual que en
+// la bsqueda lineal por la lista
+void LibraryManager::indexLibrary( LMLibrary * lib )
 {
-	for( iterator it = begin(); it != end(); ++it )
-		if( (*it).name() == libName )
-			return &(*it);
-	
-	return NULL;
+	if( !libIndex.find( lib->name() ) )
+		libIndex.insert( lib->name(), lib );
+
+	// Las tablas no crecen solas: se redimensionan al doble de su ocupacin
+	if( cmpIndex.count() + 2*lib->count() > cmpIndex.size() )
+		cmpIndex.resize( 2*( cmpIndex.count() + 2*lib->count() ) + 1 );
+
+	for( LMLibrary::iterator it = lib->begin(); it != lib->end(); ++it )
+		indexComponent( lib, &(*it) );
 }
 
-// Busca el componente 'compName' en todas las libreras instanciadas
-//   Para especificar un componente en una librera concreta se emplear el
-//   separador de campo ':' ( LIBRERIA:COMPONENTE )
-LMComponent * LibraryManager::findComponent( const QString & compName )
+void LibraryManager::indexComponent( LMLibrary * lib, LMComponent * cmp )
 {
-	LMComponent * retval = NULL;
+	if( cmp->name().isNull() )
+		return;
 
-	if( compName.contains(':') ){
+	if( !cmpIndex.find( cmp->name() ) )
+		cmpIndex.insert( cmp->name(), cmp );
 
-		// Bsqueda especfica
-		LMLibrary * lib = find( compName.section( ':', 0, 0 ) );
-		if( lib )
-			retval = lib->find( compName.section( ':', 1, 1 ) );
+	QString fullName = lib->name() + ":" + cmp->name();
+	if( !cmpIndex.find( fullName ) )
+		cmpIndex.insert( fullName, cmp );
+}
 
-	}else{
+LMLibrary * LibraryManager::createLibrary( const QString & libName, LMLibrary::SourceType st, const QString & sourceOrigin )
+{
+	iterator it = append(LMLibrary());
+
+	(*it).setName( libName );
+	(*it).setSourceType( st );
+	(*it).setSourceOrigin( sourceOrigin );
+
+	indexLibrary( &(*it) );
+	return &(*it);
+}
 
-		// Bsqueda global (se devuelve el primer elemento que concuerde)
-		for( iterator it = begin(); it != end(); ++it ){
-			retval = (*it).find(compName);
-			if( retval )
-				break;
-		}
+// Los ndices se reconstruyen con las libreras restantes, en el orden
+// de carga, para que los nombres repetidos se resuelvan como antes
+bool LibraryManager::removeLibrary( LMLibrary * lib )
+{
+	iterator it;
+	for( it = begin(); it != end(); ++it )
+		if( &(*it) == lib )
+			break;
+
+	if( it == end() )
+		return false;
+
+	remove( it );
 
+	libIndex.clear();
+	cmpIndex.clear();
+	for( it = begin(); it != end(); ++it )
+		indexLibrary( &(*it) );
+
+	return true;
+}
+
+LMComponent * LibraryManager::insertComponent( LMLibrary * lib, const LMComponent & cmp )
+{
+	LMComponent * target = lib->find( cmp.name() );
+	if( target ){
+		target->shapeList() = cmp.shapeList();
+		target->pinList() = cmp.pinList();
+		return target;
 	}
 
-	return retval;
+	target = &(*lib->append( cmp ));
+	target->setParentLibrary( lib );
+
+	if( cmpIndex.count() + 2 > cmpIndex.size() )
+		cmpIndex.resize( 2*( cmpIndex.count() + 2 ) + 1 );
+	indexComponent( lib, target );
+
+	return target;
+}
+
+// Busca la librera de nombre libName
+LMLibrary * LibraryManager::find( const QString & libName )
+{
+	if( libName.isNull() )
+		return NULL;
+
+	return libIndex.find( libName );
+}
+
+// Busca el componente 'compName' en todas las libreras instanciadas
+//   Para especificar un componente en una librera concreta se emplear el
+//   separador de campo ':' ( LIBRERIA:COMPONENTE )
+//
+//   Ambas formas se resuelven con una nica consulta al ndice
+LMComponent * LibraryManager::findComponent( const QString & compName )
+{
+	if( compName.isNull() )
+		return NULL;
+
+	return cmpIndex.find( compName );
 }
@@ -20,6 +20,7 @@
 #define _LIBRARYMANAGER_H_
 
 #include <qvaluelist.h>
+#include <qdict.h>
 
 #include "LMLibrary.h"
 
@@ -31,12 +32,33 @@ public:
 	// Carga una librera desde el fichero libraryFile
 	// y la inserta en la lista
 	LMLibrary * loadLibrary( const QString & libraryFile );
+
+	// Librera vaca generada en memoria (p.ej. los modelos del proyecto)
+	// y su eliminacin. Eliminarla invalida sus componentes
+	LMLibrary * createLibrary( const QString & libName, LMLibrary::SourceType st, const QString & sourceOrigin );
+	bool removeLibrary( LMLibrary * lib );
+
+	// Inserta cmp en lib o, si ya existe uno con su nombre, lo actualiza
+	// sin cambiar su direccin (los dispositivos conservan su referencia;
+	// si sus pins cambian, HDLModelGraph::interfaceMatches lo detecta)
+	LMComponent * insertComponent( LMLibrary * lib, const LMComponent & cmp );
 	
 	// Busca lalibrera de nombre libName
 	LMLibrary * find(  const QString &  libName );
 
 	// Busca el componente 'compName' en todas las libreras instanciadas
 	LMComponent * findComponent( const QString & compName );
+
+private:
+	// Inserta en los ndices la librera recin cargada
+	void indexLibrary( LMLibrary * lib );
+	void indexComponent( LMLibrary * lib, LMComponent * cmp );
+
+	// ndices hash construidos al cargar cada librera: libreras por
+	// nombre y componentes por 'COMPONENTE' (el de la primera librera
+	// cargada que lo contenga) y por 'LIBRERIA:COMPONENTE'
+	QDict<LMLibrary> libIndex;
+	QDict<LMComponent> cmpIndex;
 };
 
 #endif 
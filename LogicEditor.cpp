@@ -21,6 +21,7 @@
 #include <qpopupmenu.h>
 #include <qaction.h>
 #include <qwmatrix.h>
+#include <qxml.h>
 
 #include "LogicEditor.h"
 
@@ -28,6 +29,8 @@
 #include "LELabel.h"
 #include "LEWireLine.h"
 #include "LEPin.h"
+#include "LEModelReader.h"
+#include "LEBinaryModel.h"
 
 #include "LMComponent.h"
 #include "LMLibrary.h"
@@ -46,7 +49,7 @@ LogicEditor::~LogicEditor()
 }
 
 LogicEditor::LogicEditor( QCanvas *canvas, QWidget *parent, const char *name )
-	: QCanvasView( parent, name )
+	: QCanvasView( parent, name ), liveGraph( netlst )
 {
 	setCanvas( canvas );
 
@@ -54,6 +57,10 @@ LogicEditor::LogicEditor( QCanvas *canvas, QWidget *parent, const char *name )
 	pendingItem = NULL;
 	lastCnnctPoint = NULL;
 	vertexActive = -1;
+	batchDepth = 0;
+	batchNetlistChanged = false;
+	batchChanged = false;
+	netlst.setTrackChanges( true );
 
 	// Inicialmente no hay ningn objeto seleccionado
 	setActiveItem( NULL );
@@ -65,18 +72,25 @@ LogicEditor::LogicEditor( QCanvas *canvas, QWidget *parent, const char *name )
 	// Zoom inicial
 	zoomFactor = 1.0;
 
+	// Formato de fichero por defecto
+	mdlFormat = XmlFormat;
+
 	// Crea las acciones para la interaccin con el usuario mediante mens
 	createActions();
 
 }
 
 LogicEditor::LogicEditor( QWidget *parent, const char *name )
-	: QCanvasView( parent, name )
+	: QCanvasView( parent, name ), liveGraph( netlst )
 {
 	// Valores no inicializados
 	pendingItem = NULL;
 	lastCnnctPoint = NULL;
 	vertexActive = -1;
+	batchDepth = 0;
+	batchNetlistChanged = false;
+	batchChanged = false;
+	netlst.setTrackChanges( true );
 	hndlActive = NULL;
 	actItem = NULL;
 	
@@ -86,6 +100,9 @@ LogicEditor::LogicEditor( QWidget *parent, const char *name )
 	
 	// Zoom inicial
 	zoomFactor = 1.0;
+
+	// Formato de fichero por defecto
+	mdlFormat = XmlFormat;
 	
 	// Crea las acciones para la interaccin con el usuario mediante mens
 	createActions();
@@ -95,6 +112,16 @@ void LogicEditor::setCanvas( QCanvas * canvas )
 {
 	QCanvasView::setCanvas( canvas );
 
+	// Indexacin de los items ya existentes en el lienzo
+	spatialIndex.clear();
+	symbols.clear();
+	if( canvas ){
+		QCanvasItemList items = canvas->allItems();
+		for( QCanvasItemList::iterator it = items.begin(); it != items.end(); it++ )
+			if( (*it)->rtti() >= LEItem::RTTI )
+				spatialIndex.invalidate( (LEItem*)*it );
+	}
+
 	// Creacin de los agarradores
 	hndlLeftTop = new LEHandle( LEHandle::LeftTop, canvas, 0 );
 	hndlRightTop = new LEHandle( LEHandle::RightTop, canvas, 0 );
@@ -178,8 +205,15 @@ bool LogicEditor::save( QIODevice * device )
 		out << " points=\"";
 		for( int i=0; i < wlIt.current()->vertexCount(); i++ )
 			out << QString("%1 %2 ").arg( wlIt.current()->vertex(i).x() ).arg( wlIt.current()->vertex(i).y() );
+		out << "\"";
+
+		// Bus (slo si no es un cable escalar)
+		if( wlIt.current()->busWidth() > 1 )
+			out << " width=\"" << wlIt.current()->busWidth() << "\"";
+		if( wlIt.current()->sliceOffset() >= 0 )
+			out << " slice=\"" << wlIt.current()->sliceOffset() << "\"";
 		
-		out << "\"></wireline>\n";
+		out << "></wireline>\n";
 	}
 	
 	out << "\n</model>";
@@ -187,118 +221,199 @@ bool LogicEditor::save( QIODevice * device )
 	return true;
 }
 
-bool LogicEditor::load( QIODevice * device )
+// Guarda el modelo en el formato indicado
+bool LogicEditor::save( QIODevice * device, ModelFormat format )
 {
-	int errLine, errCol;
-	QString errStr;
-	QDomDocument doc;
+	if( format == XmlFormat )
+		return save( device );
 
-	// Carga del XML
-	if( !doc.setContent( device, true, &errStr, &errLine, &errCol ) ){
-		qWarning( tr("Error cargando el modelo en la lnea %d, columna %d: %s"), errLine, errCol, errStr.latin1() );
+	if( !device )
 		return false;
+
+	LEBinaryModel model;
+	model.setModelName( name() );
+
+	// Instancias de dispositivos
+	DeviceMapIterator devIt(deviceNames);
+	for( ;devIt.current(); ++devIt )
+		model.addDevice( devIt.currentKey(),
+						 devIt.current()->componentReference()->name(),
+						 devIt.current()->componentReference()->parentLibrary()->name(),
+						 QRect( (int)devIt.current()->x(), (int)devIt.current()->y(), devIt.current()->width(), devIt.current()->height() ) );
+
+	// Instancias de cables
+	WireLineMapIterator wlIt(wireLineNames);
+	for( ; wlIt.current(); ++wlIt ){
+		QString left, right;
+		QPointArray points( wlIt.current()->vertexCount() );
+
+		if( wlIt.current()->leftConnection() && wlIt.current()->leftConnection()->parent() )
+			left = wlIt.current()->leftConnection()->parent()->resolvName();
+		if( wlIt.current()->rightConnection() && wlIt.current()->rightConnection()->parent() )
+			right = wlIt.current()->rightConnection()->parent()->resolvName();
+
+		for( int i=0; i < wlIt.current()->vertexCount(); i++ )
+			points.setPoint( i, wlIt.current()->vertex(i) );
+
+		model.addWireLine( wlIt.currentKey(), left, right, points, wlIt.current()->busWidth(), wlIt.current()->sliceOffset() );
 	}
 
-	// Autentificacin de formato
-	QDomElement root = doc.documentElement();
-	if( root.tagName().lower() != "model" ){
-		qWarning( tr("Error cargando librera: El fichero no es un modelo.") );
+	return model.write( device );
+}
+
+// Carga en un nico recorrido del fichero (lector SAX, ver LEModelReader)
+bool LogicEditor::load( QIODevice * device )
+{
+	LEModelReader reader( this );
+	return reader.read( device );
+}
+
+// Carga de un modelo binario: los registros se leen directamente de la
+// proyeccin del fichero, sin anlisis de texto
+bool LogicEditor::loadBinary( const QString & fileName )
+{
+	LEBinaryModel model;
+	int i;
+
+	if( !model.map( fileName ) ){
+		qWarning( tr("Error cargando modelo: '%1' no es un modelo binario vlido.").arg(fileName) );
 		return false;
 	}
 
 	// Carga de atributos del modelo
-	QString data;
-	data = root.attribute( "name", name() );
-	setName( data );
+	if( !model.modelName().isNull() )
+		setName( model.modelName() );
 
 	// Carga de dispositivos
-	QDomNode node = root.firstChild();
-	while( !node.isNull() ){
-		if( node.toElement().tagName().lower() == "device"){
-			QDomElement elem =  node.toElement();
-			parseDevice( elem );
-		}
-		
-		node = node.nextSibling();
+	for( i=0; i < model.deviceCount(); i++ ){
+		const LEBinaryModel::DeviceRecord & rec = model.device( i );
+
+		LEDevice * dev = loadDevice( model.string( rec.library ), model.string( rec.component ) );
+		if( !dev )
+			continue;
+
+		if( rec.name != -1 )
+			dev->setName( model.string( rec.name ) );
+		dev->move( rec.x, rec.y );
+		dev->setSize( rec.width, rec.height );
+		dev->show();
 	}
 
-	// Carga de dispositivos
-	node = root.firstChild();
-	while( !node.isNull() ){
-		if( node.toElement().tagName().lower() == "wireline"){
-			QDomElement elem =  node.toElement();
-			parseWireLine( elem );
-		}
-		
-		node = node.nextSibling();
+	// Carga de cables
+	for( i=0; i < model.wireLineCount(); i++ ){
+		const LEBinaryModel::WireLineRecord & rec = model.wireLine( i );
+		QPointArray points = model.vertexs( rec );
+
+		LEWireLine * wl = createWireLine( false );
+		wl->setVertexs( points );
+		wl->connectLeft( resolveConnection( model.string( rec.leftConnection ) ) );
+		wl->connectRight( resolveConnection( model.string( rec.rightConnection ) ) );
+
+		if( rec.name != -1 )
+			wl->setName( model.string( rec.name ) );
+		wl->setBusWidth( rec.busWidth );
+		wl->setSliceOffset( rec.sliceOffset );
+
+		wl->show();
 	}
 
 	return true;
 }
 
-bool LogicEditor::parseDevice( QDomElement & element )
+void LogicEditor::setModelFormat( ModelFormat format )
+{
+	mdlFormat = format;
+}
+
+LogicEditor::ModelFormat LogicEditor::modelFormat() const
+{
+	return mdlFormat;
+}
+
+QString LogicEditor::modelExtension( ModelFormat format )
+{
+	return ( format == BinaryFormat ) ? ".lmb" : ".lem";
+}
+
+LEDevice * LogicEditor::loadDevice( const QString & strLib, const QString & strCmp )
+{
+	LMLibrary * lib = app->libraryManager().find( strLib );
+	if( !lib ){
+		qWarning( tr("Error cargando modelo: La librera '%1' no existe en el proyecto actual.").arg(strLib) );
+		return NULL;
+	}
+
+	LMComponent * cmp = lib->find( strCmp );
+	if( !cmp ){
+		qWarning( tr("Error cargando modelo: El componente '%1' no existe en la librera '%2'.").arg(strCmp).arg(strLib) );
+		return NULL;
+	}
+
+	// Creamos el dispositivo sin usar la intefaz grfica para ubicarlo (usingIGU=false)
+	return createDevice( cmp, false );
+}
+
+LEConnectionPoint * LogicEditor::resolveConnection( const QString & pinName )
+{
+	if( pinName.isEmpty() )
+		return NULL;
+
+	LEItem * item = findItem( pinName, true );
+	if( item && item->rtti() == LEPin::RTTI )
+		return ((LEPin*)item)->connectionPoint();
+
+	return NULL;
+}
+
+bool LogicEditor::parseDevice( const QXmlAttributes & attributes )
 {
 	QString strLib, strCmp, strVal;
-	LMLibrary * lib;
-	LMComponent * cmp;
 	
 // Obtencin de atributos ensenciales
-	strLib = element.attribute( "library" );
+	strLib = attributes.value( "library" );
 	if( strLib.isEmpty() ){
 		qWarning( tr("Error cargando modelo: No se ha asignado ningn valor al atributo 'library'") );
 		return false;
 	}
-	element.removeAttribute( "library" );
 	
-	strCmp = element.attribute( "template" );
+	strCmp = attributes.value( "template" );
 	if( strCmp.isEmpty() ){
 		qWarning( tr("Error cargando modelo: No se ha asignado ningn valor al atributo 'template'") );
 		return false;
 	}
-	element.removeAttribute( "template" );
 
 // Proceso y Validacin de atributos esenciales
-	lib = app->libraryManager().find( strLib );
-	if( !lib ){
-		qWarning( tr("Error cargando modelo: La librera '%1' no existe en el proyecto actual.").arg(strLib) );
-		return false;
-	}
-
-	cmp = lib->find( strCmp );
-	if( !cmp ){
-		qWarning( tr("Error cargando modelo: El componente '%1' no existe en la librera '%2'.").arg(strCmp).arg(strLib) );
+	LEDevice * dev = loadDevice( strLib, strCmp );
+	if( !dev )
 		return false;
-	}
-
-	// Creamos el dispositivo sin usar la intefaz grfica para ubicarlo (usingIGU=false)
-	LEDevice * dev = createDevice( cmp, false );
 	
 // Obtencin de Atributos especiales
-	strVal = element.attribute( "name" );
-	if( !strVal.isEmpty() ){
+	strVal = attributes.value( "name" );
+	if( !strVal.isEmpty() )
 		dev->setName( strVal );
-		element.removeAttribute( "name" );
-	}
 		
-	strVal = element.attribute( "offset" );
+	strVal = attributes.value( "offset" );
 	if( !strVal.isEmpty() ){
 		QPoint p = parsePoint( strVal );
 		dev->move( p.x(), p.y() );
-		element.removeAttribute( "offset" );
 	}
 
-	strVal = element.attribute( "size" );
+	strVal = attributes.value( "size" );
 	if( !strVal.isEmpty() ){
 		QPoint p = parsePoint( strVal );
 		dev->setSize( p.x(), p.y() );
-		element.removeAttribute( "size" );
 	}
 
 	// Atributos adicionales
-	QDomNamedNodeMap attributes = element.attributes();
-	for( int i=0; i<attributes.length(); i++ )
-		if( !dev->setProperty( attributes.item(i).toAttr().name(), QVariant( attributes.item(i).toAttr().value() ) ) )
-			qWarning( tr("Cargando '%1': El objeto '%2' de tipo '%3' carece del atributo '%4'.").arg(name()).arg(dev->name()).arg(strLib+":"+strCmp) );
+	for( int i=0; i<attributes.length(); i++ ){
+		QString attrName = attributes.qName( i );
+		if( attrName == "library" || attrName == "template" || attrName == "name" ||
+			attrName == "offset" || attrName == "size" )
+			continue;
+
+		if( !dev->setProperty( attrName, QVariant( attributes.value( i ) ) ) )
+			qWarning( tr("Cargando '%1': El objeto '%2' de tipo '%3' carece del atributo '%4'.").arg(name()).arg(dev->name()).arg(strLib+":"+strCmp).arg(attrName) );
+	}
 
 	// Se muestra el dispositivo
 	dev->show();
@@ -306,7 +421,7 @@ bool LogicEditor::parseDevice( QDomElement & element )
 	return true;
 }
 
-bool LogicEditor::parseWireLine( QDomElement & element )
+bool LogicEditor::parseWireLine( const QXmlAttributes & attributes )
 {
 	QString  strVal;
 	QPointArray points;
@@ -316,7 +431,7 @@ bool LogicEditor::parseWireLine( QDomElement & element )
 	bool hasGeometry=false;
 			
   // Cargamos la geometra
-	strVal = element.attribute( "points" );
+	strVal = attributes.value( "points" );
 	if( !strVal.isEmpty() ){
 
 		// Geometra completametne definida (array de puntos)
@@ -328,7 +443,7 @@ bool LogicEditor::parseWireLine( QDomElement & element )
 
 	}else{
 
-		strVal = element.attribute( "breakPoint" );
+		strVal = attributes.value( "breakPoint" );
 		if( !strVal.isEmpty() ){
 
 			// Geometra automtica con punto de inflexin en 'breakPoint'
@@ -338,41 +453,10 @@ bool LogicEditor::parseWireLine( QDomElement & element )
 		}
 
 	}
-/*
-	QDomNode childNode = element.firstChild();
-	while( !childNode.isNull() ){
-
-		if( childNode.nodeType() == QDomNode::TextNode ){
-			
-			if( !LMComponent::parseShapeString( childNode.toText().data(), points ) ){
-				qWarning( tr("Error cargando modelo: Imposible cargar <wireline>, formato de linea incorrecto.") );
-				return false;
-			}
-			hasGeometry=true;
-
-			break;	
-		}
-
-		childNode = childNode.nextSibling();
-	}
-*/
 
   // Extremos del WireLine
-	strVal = element.attribute( "leftConnection" );
-	if( !strVal.isEmpty() ){
-		LEItem * item = findItem( strVal, true );
-		if( item )
-			if( item->rtti() == LEPin::RTTI )
-				left = ((LEPin*)item)->connectionPoint();
-	}
-
-	strVal = element.attribute( "rightConnection" );
-	if( !strVal.isEmpty() ){
-		LEItem * item = findItem( strVal, true );
-		if( item )
-			if( item->rtti() == LEPin::RTTI )
-				right = ((LEPin*)item)->connectionPoint();
-	}
+	left = resolveConnection( attributes.value( "leftConnection" ) );
+	right = resolveConnection( attributes.value( "rightConnection" ) );
 
  // Creamos el cable sin usar la intefaz grfica para ubicarlo
 	if( hasGeometry ){
@@ -390,10 +474,18 @@ bool LogicEditor::parseWireLine( QDomElement & element )
 	}
 		
 	// Atributos adicionales
-	strVal = element.attribute( "name" );
+	strVal = attributes.value( "name" );
 	if( !strVal.isEmpty() )
 		wl->setName( strVal );
 
+	strVal = attributes.value( "width" );
+	if( !strVal.isEmpty() )
+		wl->setBusWidth( strVal.toInt() );
+
+	strVal = attributes.value( "slice" );
+	if( !strVal.isEmpty() )
+		wl->setSliceOffset( strVal.toInt() );
+
 
 	wl->show();
 
@@ -432,14 +524,46 @@ QPointArray LogicEditor::parsePointArray( QString string )
 // Acciones externas: Manipulacin de objetos
 //////////////////////////////////////////////////////////////////////
 LEDevice * LogicEditor::createDevice( const LMComponent * cmp, bool usingIGU )
+{
+	// Instanciacin del nuevo componente
+	LEDevice * lpDev = newDevice( cmp, cmp->name() );
+
+	// Ubicacin con intefaz grfica
+	if( usingIGU ){
+		// Cancelamos cualquier otro objeto pendiente
+		if( pendingItem )
+			pendingItemCancel( pendingItem );
+
+		// El nuevo componente pasa a ser el objeto pendiente
+		pendingItem = lpDev;
+	}
+
+	return lpDev;
+}
+
+// Crea el dispositivo registrndolo directamente con el nombre name (sin
+// pasar por el nombre del componente) y lo ubica en pos
+LEDevice * LogicEditor::placeDevice( const LMComponent * cmp, const QString & name, const QPoint & pos, int height )
+{
+	LEDevice * lpDev = newDevice( cmp, name );
+
+	if( height >= 0 )
+		lpDev->setSize( lpDev->width(), height );
+	lpDev->move( pos.x(), pos.y() );
+	lpDev->show();
+
+	return lpDev;
+}
+
+// Instancia el componente cmp con el nombre name y sus pins
+LEDevice * LogicEditor::newDevice( const LMComponent * cmp, const QString & name )
 {
 	// Desactivamos los elementos activos
 	if( actItem )
 		setActiveItem( NULL );
 	
-	// Instanciacin del nuevo componente
 	LEDevice * lpDev = new LEDevice( canvas(), NULL );
-	lpDev->setName( cmp->name() );
+	lpDev->setName( name );
 	lpDev->setComponentReference( cmp );
 	lpDev->setShape( cmp->shapeList().first() );
 
@@ -448,16 +572,7 @@ LEDevice * LogicEditor::createDevice( const LMComponent * cmp, bool usingIGU )
 	for( it = cmp->pinList().begin(); it != cmp->pinList().end(); it++ ){
 		LEPin * lpPin = lpDev->insertPin( (*it).alignment(), (*it).accessMode(), (*it).name(), (*it).position(), (*it).activeLevel() );
 		lpPin->setName( (*it).name() );
-	}
-
-	// Ubicacin con intefaz grfica
-	if( usingIGU ){
-		// Cancelamos cualquier otro objeto pendiente
-		if( pendingItem )
-			pendingItemCancel( pendingItem );
-
-		// El nuevo componente pasa a ser el objeto pendiente
-		pendingItem = lpDev;
+		lpPin->setBusWidth( (*it).busWidth() );
 	}
 
 	return lpDev;
@@ -487,10 +602,12 @@ LEDevice * LogicEditor::duplicateDevice( LEDevice * device, bool usingIGU )
 		// Conexin efectiva. La conexin es simtrica para poder notificar el borrado
 		oldPin->connectionPoint()->setConnection( newPin->connectionPoint() );
 		newPin->connectionPoint()->setConnection( oldPin->connectionPoint() );
+		netlst.insertLink( oldPin->connectionPoint(), newPin->connectionPoint() );
 
 		oldPin = srcDevice->pinList().next();
 		newPin = dupDev->pinList().next();
 	}
+	liveGraph.updateNets();
 
 	return dupDev;
 }
@@ -546,63 +663,120 @@ LEWireLine * LogicEditor::createWireLine( LEConnectionPoint * cp1, LEConnectionP
 }
 
 // Iterador de nombres de dispositivos duplicados: Dado un nombre de dispositivo (duplicado o no),
-// itera la lista deviceNames y devuelve el primer elemento si existe (QString::null en otro caso)
+// devuelve el nombre del duplicado de menor ndice si existe (QString::null en otro caso)
 QString LogicEditor::firstDupName( const QString &patternName ) const
 {
-	// Se genera un hipottico elemento 0.
 	QString normalName = normalizeDupName( patternName );
-	QString searchName = normalName + "(" + QString::number(0) + ")";
 
-	// Si existe se devuelve, es el primero y es vlido, en otro caso
-	// se invoca el procedimiento buscar siguiente desde ese elemento
-	if( deviceNames.find( searchName ) )
-		return searchName;
-	else
-		return nextDupName( searchName );
+	DupGroupMap::const_iterator itGroup = dupGroups.find( normalName );
+	if( itGroup == dupGroups.end() || itGroup.data().devices.isEmpty() )
+		return QString::null;
+
+	return normalName + "(" + QString::number( itGroup.data().devices.begin().key() ) + ")";
 }
 
 // Iterador de nombres de dispositivos duplicados: Dado un nombre de dispositivo duplicado
-// itera la lista deviceNames y devuelve el siguiente elemento si existe (QString::null en otro caso)
+// devuelve el del siguiente duplicado del mismo original si existe (QString::null en otro caso)
 QString LogicEditor::nextDupName( const QString &patternName ) const
 {
-	int i, j, minj=65000;
-
 	// Extraemos la informacin del ltimo nombre iterado
 	QString normalName = normalizeDupName( patternName );
-	i = extractDupNameIndex( patternName );
+	int i = extractDupNameIndex( patternName );
 	if( i == -1 )
 		return QString::null;
 
-	// Bsqueda del mnimo ndice siguiente a i
-	DeviceMapIterator it(deviceNames);
-	for( ; it.current(); ++it ){
-		j = extractDupNameIndex( it.currentKey() );
-		if(  j > i && j < minj )
-			minj = j;
-	}
+	DupGroupMap::const_iterator itGroup = dupGroups.find( normalName );
+	if( itGroup == dupGroups.end() )
+		return QString::null;
+
+	const QMap<int, LEDevice*> & devices = itGroup.data().devices;
+	QMap<int, LEDevice*>::const_iterator it = devices.find( i );
 
-	// Fin de la lista (No existe ningn mnimo)
-	if( minj == 65000 )
+	// El nombre iterado ya no existe (p.ej. se ha eliminado durante el
+	// recorrido): se busca el primer ndice posterior
+	if( it == devices.end() ){
+		it = devices.begin();
+		while( it != devices.end() && it.key() < i )
+			++it;
+	}else
+		++it;
+
+	// Fin de la lista
+	if( it == devices.end() )
 		return QString::null;
 	
 	// Devolvemos el siguiente elemento
-	return normalName +"("+QString::number(minj)+")";
-
+	return normalName +"("+QString::number( it.key() )+")";
 }
 
 
-// Devuelve un nombre de duplicado para patternName no usado
+// Devuelve un nombre de duplicado para patternName no usado (el de menor ndice)
 QString LogicEditor::findFreeDupName( const QString & patternName )
 {
-	int i=0;
-	QString retval;
 	QString normalName = normalizeDupName( patternName );
+	int i = 0;
 
-	// Se incrementa el contador hasta encontrar un nombre del tipo name(i) no usado
-	while( deviceNames.find( retval=normalName + "(" + QString::number(i) + ")" ) )
-		i++;
+	DupGroupMap::const_iterator itGroup = dupGroups.find( normalName );
+	if( itGroup != dupGroups.end() ){
+		if( itGroup.data().freeIndexes.isEmpty() )
+			i = itGroup.data().nextIndex;
+		else
+			i = itGroup.data().freeIndexes.begin().key();
+	}
 	
-	return retval;
+	return normalName + "(" + QString::number(i) + ")";
+}
+
+// Registra en el ndice de duplicados el dispositivo dev, llamado name
+// (slo si es un nombre de duplicado: 'original(i)')
+void LogicEditor::insertDupName( const QString & name, LEDevice * dev )
+{
+	int i = extractDupNameIndex( name );
+	if( i == -1 )
+		return;
+
+	DupGroup & group = dupGroups[ normalizeDupName( name ) ];
+	group.devices.insert( i, dev );
+
+	// Los ndices entre el mayor en uso y el nuevo quedan libres
+	if( i >= group.nextIndex ){
+		for( int j = group.nextIndex; j < i; j++ )
+			group.freeIndexes.insert( j, true );
+		group.nextIndex = i + 1;
+	}else
+		group.freeIndexes.remove( i );
+}
+
+void LogicEditor::removeDupName( const QString & name )
+{
+	int i = extractDupNameIndex( name );
+	if( i == -1 )
+		return;
+
+	DupGroupMap::iterator itGroup = dupGroups.find( normalizeDupName( name ) );
+	if( itGroup == dupGroups.end() )
+		return;
+
+	DupGroup & group = itGroup.data();
+	if( !group.devices.contains( i ) )
+		return;
+
+	group.devices.remove( i );
+
+	if( group.devices.isEmpty() ){
+		dupGroups.remove( itGroup );
+		return;
+	}
+
+	// Si era el mayor ndice, los libres que le preceden dejan de contar
+	if( i == group.nextIndex - 1 ){
+		group.nextIndex--;
+		while( group.freeIndexes.contains( group.nextIndex - 1 ) ){
+			group.nextIndex--;
+			group.freeIndexes.remove( group.nextIndex );
+		}
+	}else
+		group.freeIndexes.insert( i, true );
 }
 
 // Busca un item llamado itemName, si mustSolve es TRUE intenta
@@ -621,6 +795,11 @@ LEItem * LogicEditor::findItem( const QString & itemName, bool mustSolve )
 
 	// Resolucin de un nombre compuesto
 	if( mustSolve ){
+		// Ruta indexada en la tabla de smbolos (dispositivo.pin)
+		LEItem * it3 = symbols.find( itemName );
+		if( it3 )
+			return it3;
+
 		QStringList subStrings = QStringList::split( QString("%1").arg(ITEM_NAME_SEPARATOR), itemName );
 		LEItem *lastItem, *item = NULL;
 		for( int i=0; i<subStrings.size(); i++ ){
@@ -628,13 +807,18 @@ LEItem * LogicEditor::findItem( const QString & itemName, bool mustSolve )
 			item = NULL;
 
 			if( lastItem ){
+				// Pins de un dispositivo: bsqueda indexada por nombre
+				if( lastItem->rtti() == LEDevice::RTTI )
+					item = ((LEDevice*)lastItem)->findPin( subStrings[i] );
+
 				// Item hijo: Bsqueda en profundidad
-				for( LEItem * child =lastItem->childs().first(); child; child = lastItem->childs().next() )
-					// Bsqueda entre los hijos activos (entre los pins de un device, ie)
-					if( child->name() == subStrings[i] ){
-						item = child;
-						break;
-					}
+				if( !item )
+					for( LEItem * child =lastItem->childs().first(); child; child = lastItem->childs().next() )
+						// Bsqueda entre los hijos activos (entre los pins de un device, ie)
+						if( child->name() == subStrings[i] ){
+							item = child;
+							break;
+						}
 			}else{
 				// Item base: Bsqueda sin resolucin de nombre por nombres mapeados
 				item = findItem( subStrings[i], false );
@@ -682,14 +866,20 @@ bool LogicEditor::tryUpdateItemName( const QString & itemName, const QString & n
 		case LEDevice::RTTI:
 			deviceNames.remove( itemName );
 			deviceNames.insert( newItemName, (LEDevice*)item );
+			removeDupName( itemName );
+			insertDupName( newItemName, (LEDevice*)item );
 			
-			// Actualizacin de los nombres de los duplicados (si es un LEDevice original)
-			if( extractDupNameIndex( itemName ) == -1 )
-				for( QString dupName = firstDupName( itemName ); dupName != QString::null; dupName = nextDupName( dupName ) ){
-					LEItem * dupDev = findItem( dupName, false );
-					if( dupDev )
-						dupDev->setName( newItemName +"("+QString::number(extractDupNameIndex(dupName))+")" );
+			// Actualizacin de los nombres de los duplicados (si es un LEDevice original).
+			// Cada cambio de nombre traslada el duplicado al grupo del nuevo
+			// nombre, as que se recorre una copia del grupo
+			if( extractDupNameIndex( itemName ) == -1 ){
+				DupGroupMap::iterator itGroup = dupGroups.find( itemName );
+				if( itGroup != dupGroups.end() ){
+					QMap<int, LEDevice*> dups = itGroup.data().devices;
+					for( QMap<int, LEDevice*>::iterator it = dups.begin(); it != dups.end(); ++it )
+						it.data()->setName( newItemName +"("+QString::number( it.key() )+")" );
 				}
+			}
 
 			break;
 		
@@ -698,8 +888,10 @@ bool LogicEditor::tryUpdateItemName( const QString & itemName, const QString & n
 			wireLineNames.insert( newItemName, (LEWireLine*)item );
 			break;
 	}
-	
-	emit changed();	
+
+	liveGraph.updateItem( item );
+	notifyNetlistChanged( item );
+	notifyChanged();
 
 	return true;
 }
@@ -728,16 +920,141 @@ bool LogicEditor::registerItem( LEItem * item, const QString& itemName )
 	switch( item->rtti() ){
 		case LEDevice::RTTI:
 			deviceNames.insert( itemName, (LEDevice*)item );
+			insertDupName( itemName, (LEDevice*)item );
+			netlst.insertDevice( (LEDevice*)item );
+			liveGraph.insertDevice( (LEDevice*)item );
 			break;
 		
 		case LEWireLine::RTTI:
 			wireLineNames.insert( itemName, (LEWireLine*)item );
+			netlst.insertWireLine( (LEWireLine*)item );
+			liveGraph.insertWireLine( (LEWireLine*)item );
 			break;
 	}
 
+	notifyNetlistChanged( item );
+
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Creacin por lotes
+//////////////////////////////////////////////////////////////////////
+void LogicEditor::beginBatch()
+{
+	if( batchDepth++ > 0 )
+		return;
+
+	batchNetlistChanged = false;
+	batchChanged = false;
+	viewport()->setUpdatesEnabled( false );
+}
+
+void LogicEditor::endBatch()
+{
+	if( batchDepth == 0 || --batchDepth > 0 )
+		return;
+
+	viewport()->setUpdatesEnabled( true );
+	if( canvas() )
+		canvas()->update();
+
+	if( batchNetlistChanged )
+		emit netlistChanged( NULL );
+	if( batchChanged )
+		emit changed();
+}
+
+void LogicEditor::notifyNetlistChanged( LEItem * item )
+{
+	if( batchDepth > 0 )
+		batchNetlistChanged = true;
+	else
+		emit netlistChanged( item );
+}
+
+void LogicEditor::notifyChanged()
+{
+	if( batchDepth > 0 )
+		batchChanged = true;
+	else
+		emit changed();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Netlist
+//////////////////////////////////////////////////////////////////////
+HDLNetlist & LogicEditor::netlist()
+{
+	return netlst;
+}
+
+const HDLModelGraph & LogicEditor::modelGraph()
+{
+	return liveGraph.graph();
+}
+
+void LogicEditor::itemPropertyChanged( LEItem * item )
+{
+	if( item->rtti() != LEWireLine::RTTI || !netlst.wireLines().find( (LEWireLine*)item ) )
+		return;
+
+	liveGraph.updateItem( item );
+	notifyNetlistChanged( item );
+}
+
+// Las uniones se aplican directamente; una desconexin slo recalcula
+// la red en la que estaba el extremo desconectado
+void LogicEditor::wireLineConnectionChanged( LEWireLine * wl, LEConnectionPoint * oldCnnct )
+{
+	if( oldCnnct && oldCnnct != wl->leftConnection() && oldCnnct != wl->rightConnection() )
+		netlst.split( oldCnnct );
+
+	// Slo los cables ya registrados (los no registrados se insertan al registrarse)
+	if( netlst.wireLines().find( wl ) ){
+		netlst.insertWireLine( wl );
+		liveGraph.updateItem( wl );
+	}else
+		liveGraph.updateNets();
+
+	notifyNetlistChanged( wl );
+}
+
+//////////////////////////////////////////////////////////////////////
+// ndice espacial y tabla de smbolos
+//////////////////////////////////////////////////////////////////////
+void LogicEditor::itemGeometryChanged( LEItem * item )
+{
+	spatialIndex.invalidate( item );
+}
+
+void LogicEditor::itemRenamed( LEItem * item )
+{
+	symbols.insert( item );
+}
+
+void LogicEditor::itemRemoved( LEItem * item )
+{
+	spatialIndex.remove( item );
+	symbols.remove( item );
+	lastMouseOverItems.remove( item );
+}
+
+const LESymbolTable & LogicEditor::symbolTable() const
+{
+	return symbols;
+}
+
+// Slo los items de un lienzo propio notifican sus cambios al editor,
+// en otro caso se recurre a QCanvas::collisions
+QCanvasItemList LogicEditor::itemsAt( const QPoint& pos )
+{
+	if( canvas()->parent() != this )
+		return canvas()->collisions( pos );
+
+	return spatialIndex.collisions( pos );
+}
+
 
 void LogicEditor::setActiveItem( LEItem * item )
 {
@@ -937,7 +1254,7 @@ void LogicEditor::contentsMouseMoveEvent( QMouseEvent *event )
 	}
 	
 	// Generamos el MouseOverEvent
-	QCanvasItemList items = canvas()->collisions(realPos);
+	QCanvasItemList items = itemsAt(realPos);
 	QCanvasItemList::iterator it;
 	for( it = items.begin(); it != items.end(); it++ )
 		if( (*it)->rtti() >= LEItem::RTTI )
@@ -964,7 +1281,7 @@ void LogicEditor::trySelectItem( const QPoint& pos )
 	hndlActive = NULL;
 	vertexActive = -1;
 
-	QCanvasItemList items = canvas()->collisions(pos);
+	QCanvasItemList items = itemsAt(pos);
 	
 	if( items.empty() )
 	{
@@ -1119,33 +1436,50 @@ void LogicEditor::purgeItem( LEItem * item )
 		if( lastCnnctPoint->parent() == item )
 			lastCnnctPoint = NULL;
 
+	// El borrado de un original con duplicados es un nico cambio de la netlist
+	bool batch = false;
+
 	if( item->rtti() == LEDevice::RTTI ){
 
 		// Borrado de los duplicados
-		if( extractDupNameIndex( item->name() ) == -1 )
+		if( extractDupNameIndex( item->name() ) == -1 ){
 		
-			// Se trata de una instancia original, si tiene duplicados hay que eliminarlos
-			for( QString dupName = firstDupName( item->name() ); dupName != QString::null; dupName = nextDupName( dupName ) ){
-			
-				LEItem *dupItem = findItem( dupName );
-				
-				if( dupItem )
-					purgeItem( dupItem );
+			// Se trata de una instancia original, si tiene duplicados hay que
+			// eliminarlos (cada borrado modifica el grupo: se recorre una copia)
+			DupGroupMap::iterator itGroup = dupGroups.find( item->name() );
+			if( itGroup != dupGroups.end() ){
+				beginBatch();
+				batch = true;
+
+				QMap<int, LEDevice*> dups = itGroup.data().devices;
+				for( QMap<int, LEDevice*>::iterator it = dups.begin(); it != dups.end(); ++it )
+					purgeItem( it.data() );
 			}
+		}
 
 		// Borrado del mapa de dispositivos
 		deviceNames.remove( item->name() );
+		removeDupName( item->name() );
+		netlst.removeDevice( (LEDevice*)item );
+		liveGraph.removeDevice( (LEDevice*)item );
 	}
 
 	if( item->rtti() == LEWireLine::RTTI ){
 		// Borrado del mapa de cables
 		wireLineNames.remove( item->name() );
+		netlst.removeWireLine( (LEWireLine*)item );
+		liveGraph.removeWireLine( (LEWireLine*)item );
 	}
 
+	notifyNetlistChanged( item );
+
 	// Borrado de la lista de eventos MouseOver pendientes (si est en ella)
 	lastMouseOverItems.remove( item );
 
 	item->remove();
+
+	if( batch )
+		endBatch();
 }
 
 
@@ -1163,7 +1497,7 @@ void LogicEditor::moveWireLineVertex( LEWireLine * wlItem, QPoint target )
 {
 	// Buscamos interseccin con LEPin (posible conexin)
 	LEConnectionPoint * connection = NULL;
-	QCanvasItemList items = canvas()->collisions(target);
+	QCanvasItemList items = itemsAt(target);
 	for( QCanvasItemList::iterator it = items.begin(); it != items.end(); it++ )
 		if( (*it)->rtti() == LEConnectionPoint::RTTI ){
 			connection = (LEConnectionPoint*)*it;//((LEPin*)*it)->connectionPoint();
@@ -1274,7 +1608,7 @@ LEItem * LogicEditor::pendingItemPlace( LEItem * item, const QPoint &pos )
 		
 			// Buscamos una posible conexin cercana
 			LEConnectionPoint * connection = NULL;
-			QCanvasItemList items = canvas()->collisions(pos);
+			QCanvasItemList items = itemsAt(pos);
 			for( QCanvasItemList::iterator it = items.begin(); it != items.end(); it++ )
 				if( (*it)->rtti() == LEConnectionPoint::RTTI ){
 					connection = (LEConnectionPoint*)*it;
@@ -45,20 +45,38 @@
 #include "LEDevice.h"
 #include "LEWireLine.h"
 #include "HDLGenerator.h"
+#include "HDLNetlist.h"
+#include "HDLLiveGraph.h"
+#include "LESpatialIndex.h"
+#include "LESymbolTable.h"
 
 class LMComponent;
 class LEItem;
 class LELabel;
 class LEConnectionPoint;
-class QDomElement;
+class QXmlAttributes;
 class QAction;
 
 #include <qdict.h>
+#include <qmap.h>
 typedef QDict<LEDevice> DeviceMap;
 typedef QDictIterator<LEDevice> DeviceMapIterator;
 typedef QDict<LEWireLine> WireLineMap;
 typedef QDictIterator<LEWireLine> WireLineMapIterator;
 
+// Duplicados de un dispositivo original 'name': los dispositivos
+// 'name(i)' ordenados por ndice y los ndices libres menores que
+// nextIndex (el siguiente al mayor en uso)
+struct DupGroup
+{
+	DupGroup() : nextIndex( 0 ) {}
+
+	QMap<int, LEDevice*> devices;
+	QMap<int, bool> freeIndexes;
+	int nextIndex;
+};
+typedef QMap<QString, DupGroup> DupGroupMap;
+
 class LogicEditor : public QCanvasView
 {
 Q_OBJECT
@@ -77,6 +95,16 @@ public:
 	LEDevice * createDevice( const LMComponent * cmp, bool usingIGU = true );
 	LELabel * createLabel( const QString & label = QString::null );
 
+	// Crea el dispositivo con su nombre definitivo y lo ubica y muestra
+	// (height = -1 conserva el alto de la figura del componente)
+	LEDevice * placeDevice( const LMComponent * cmp, const QString & name, const QPoint & pos, int height=-1 );
+
+	// Creacin por lotes: entre beginBatch y endBatch (anidables) no se
+	// repinta la vista ni se emiten netlistChanged y changed por cada
+	// item; se emiten una vez al cerrar el lote
+	void beginBatch();
+	void endBatch();
+
 	LEItem * findItem( const QString & itemName, bool mustSolve = false );	
 	
 	//////////////////////////////////////////////////////////////////////
@@ -109,16 +137,61 @@ public:
 	void setActiveItem( LEItem * item );
 	LEItem * activeItem();
 
+	//////////////////////////////////////////////////////////////////////
+	// Netlist
+	//////////////////////////////////////////////////////////////////////
+
+	// Netlist del modelo, mantenida al da con cada edicin
+	HDLNetlist & netlist();
+
+	// Grafo del modelo para su captura (ver HDLLiveGraph), actualizado slo
+	// en los elementos y redes que cambia cada edicin
+	const HDLModelGraph & modelGraph();
+
+	// Notificacin de LEItem tras cambiar una propiedad (bus de un cable)
+	void itemPropertyChanged( LEItem * item );
+
+	// Notificacin de LEWireLine tras cambiar la conexin de un extremo
+	// (oldCnnct es la conexin previa de ese extremo)
+	void wireLineConnectionChanged( LEWireLine * wl, LEConnectionPoint * oldCnnct );
+
+	//////////////////////////////////////////////////////////////////////
+	// ndice espacial y tabla de smbolos
+	//////////////////////////////////////////////////////////////////////
+
+	// Notificaciones de LEItem: cambio de geometra, de nombre y eliminacin
+	void itemGeometryChanged( LEItem * item );
+	void itemRenamed( LEItem * item );
+	void itemRemoved( LEItem * item );
+
+	// Tabla de smbolos (identificadores y rutas resueltas de los items)
+	const LESymbolTable & symbolTable() const;
+
 //////////////////////////////////////////////////////////////////////
 // Load y Store de modelos
 //////////////////////////////////////////////////////////////////////
+	enum ModelFormat { XmlFormat, BinaryFormat };
+
+	// Formato de fichero del modelo: XML (.lem) o binario (.lmb)
+	void setModelFormat( ModelFormat format );
+	ModelFormat modelFormat() const;
+	static QString modelExtension( ModelFormat format );
+
 	virtual bool load( QIODevice * in );
 	virtual bool save( QIODevice * out );
-	virtual bool parseDevice( QDomElement & element );
-	virtual bool parseWireLine( QDomElement & element );
+	virtual bool save( QIODevice * out, ModelFormat format );
+	// Carga de un modelo binario proyectando el fichero en memoria
+	virtual bool loadBinary( const QString & fileName );
+	virtual bool parseDevice( const QXmlAttributes & attributes );
+	virtual bool parseWireLine( const QXmlAttributes & attributes );
 	static QPoint parsePoint( QString string );
 	static QPointArray parsePointArray( QString string );
 
+	// Instancia el componente 'component' de la librera 'library' (carga de modelos)
+	LEDevice * loadDevice( const QString & library, const QString & component );
+	// Punto de conexin del pin de nombre completo 'pinName' (NULL si no existe)
+	LEConnectionPoint * resolveConnection( const QString & pinName );
+
 
 public slots:
 //////////////////////////////////////////////////////////////////////
@@ -137,6 +210,9 @@ signals:
 	void disconnected( LEItem*item, LEConnectionPoint *cp );
 	void pendingItemCanceled( LEItem *item, bool destroyed );
 	void pendingItemPlaced( LEItem *item );
+	// Cambio de la estructura del modelo (conectividad, instancias, nombres o
+	// buses) en el item indicado (NULL si al cerrar un lote cambian varios)
+	void netlistChanged( LEItem * item );
 
 protected:
 
@@ -179,6 +255,8 @@ private:
 // Manipulacin de objetos
 //////////////////////////////////////////////////////////////////////
 	void trySelectItem( const QPoint& pos );
+	// Items en el punto pos (equivalente a QCanvas::collisions usando el ndice espacial)
+	QCanvasItemList itemsAt( const QPoint& pos );
 	QPoint resizeItem( LEItem * item, QPoint source, QPoint target, LEHandle::HandleAlignment rzSide );
 	void moveItem( LEItem * item, QPoint source, QPoint target );
 	void moveWireLineVertex( LEWireLine * wlItem, QPoint target );
@@ -186,6 +264,9 @@ private:
 	// Elimina toda referencia al elemento item y lo marca para ser destruido
 	void purgeItem( LEItem *item );
 
+	// Instancia el componente (con sus pins) sin ubicarlo
+	LEDevice * newDevice( const LMComponent * cmp, const QString & name );
+
 //////////////////////////////////////////////////////////////////////
 // Variables de estado
 //////////////////////////////////////////////////////////////////////
@@ -210,6 +291,30 @@ private:
 	DeviceMap deviceNames;
 	WireLineMap wireLineNames;
 
+// ndice de duplicados (por nombre del original) y su mantenimiento
+	DupGroupMap dupGroups;
+	void insertDupName( const QString & name, LEDevice * dev );
+	void removeDupName( const QString & name );
+
+// Netlist del modelo y su grafo
+	HDLNetlist netlst;
+	HDLLiveGraph liveGraph;
+
+// ndice espacial de los items del lienzo
+	LESpatialIndex spatialIndex;
+
+// Tabla de smbolos de los items con nombre
+	LESymbolTable symbols;
+
+// Formato de fichero del modelo
+	ModelFormat mdlFormat;
+
+// Creacin por lotes (notificaciones pendientes hasta endBatch)
+	int batchDepth;
+	bool batchNetlistChanged, batchChanged;
+	void notifyNetlistChanged( LEItem * item );
+	void notifyChanged();
+
 //////////////////////////////////////////////////////////////////////
 // Visualizacin
 //////////////////////////////////////////////////////////////////////
@@ -27,15 +27,23 @@
 #include "dlgNewProject.h"
 #include "InterfaceAssistentDialog.h"
 #include "InterfaceDocument.h"
+#include "HDLModelSnapshot.h"
+#include "HDLModelGraph.h"
+#include "HDLModelReader.h"
+#include "HDLBuildScheduler.h"
+#include "HDLJobScheduler.h"
+#include "HDLProcess.h"
 #include "Document.h"
 
 #include "Application.h"
 extern Application * app;
 
 Project::Project( QWidget * parent, const char * name )
-	: QWorkspace( parent, name )
+	: QWorkspace( parent, name ), hierarchy( app->libraryManager() )
 {
 	isChanged = false;
+	hdlBuilding = false;
+	nWorkers = HDLJobScheduler::DefaultWorkers;
 }
 
 ///////////////////////////////////////////////////////////
@@ -92,6 +100,7 @@ bool Project::newProject()
 
 	// Se notifica el cambio en el estado de la aplicacin
 	isChanged = true;
+	hierarchy.attach( path(), documents() );
 	emit projectCreated();
 	emit projectCreated( name() );
 
@@ -131,6 +140,7 @@ bool Project::closeProject()
 		
 	// Vaciamos la lista de documentos
 	documents().clear();
+	hierarchy.detach();
 
 	// Limpiamos todos los registros
 	setName( QString::null );
@@ -223,6 +233,9 @@ bool Project::openProject( const QString & filePath, const QString & fileName )
 	// Actualizacin del estado 
 	isChanged = false;
 
+	// Componentes de los modelos ya construidos
+	hierarchy.attach( path(), documents() );
+
 	emit projectOpened();
 	emit projectOpened( name() );
 
@@ -396,6 +409,21 @@ void Project::setAutor( const QString & at )
 	isChanged = true;
 }
 
+void Project::setBuildWorkers( int count )
+{
+	nWorkers = QMAX( count, 1 );
+}
+
+int Project::buildWorkers() const
+{
+	return nWorkers;
+}
+
+LMLibrary * Project::modelsLibrary() const
+{
+	return hierarchy.library();
+}
+
 ///////////////////////////////////////////////////////////
 // Documentos del proyecto (abiertos o no)
 ///////////////////////////////////////////////////////////
@@ -645,9 +673,9 @@ void Project::zoomOut()
 //		siempre que se invoca alguno de los mtodos del
 //		juego HDL.
 ///////////////////////////////////////////////////////////
-// Accede al directorio dirName ubicado en where, crendolo si no existe.
+// Localiza el directorio dirName ubicado en where, crendolo si no existe.
 // Si dir est establecido, se copia la entrada de directorio en l.
-bool Project::tryEnterDir( const QString& where, const QString& dirName, QDir * dir )
+bool Project::tryMakeDir( const QString& where, const QString& dirName, QDir * dir )
 {
 	QDir resDir( where );
 	if( !resDir.cd( dirName ) ){
@@ -657,6 +685,19 @@ bool Project::tryEnterDir( const QString& where, const QString& dirName, QDir *
 		}
 	}
 	
+	if( dir )
+		*dir = resDir;
+
+	return true;
+}
+
+// Como tryMakeDir, pero adems lo convierte en el directorio actual
+bool Project::tryEnterDir( const QString& where, const QString& dirName, QDir * dir )
+{
+	QDir resDir;
+	if( !tryMakeDir( where, dirName, &resDir ) )
+		return false;
+	
 	QDir::setCurrent( resDir.absPath() );
 	
 	if( dir )
@@ -669,13 +710,14 @@ bool Project::tryEnterDir( const QString& where, const QString& dirName, QDir *
 bool Project::buildModelHDLFile( Document * doc )
 {
 	// Creacin de la ruta para VHDL en el proyecto.
-	if( !tryEnterDir( path(), VHDL_PROJECT_FOLDER ) ){
+	QDir hdlDir;
+	if( !tryMakeDir( path(), VHDL_PROJECT_FOLDER, &hdlDir ) ){
 		emit errorMessage( tr(" No se puede crear el directorio %1 en %2").arg(VHDL_PROJECT_FOLDER).arg(path()) );
 		return false;
 	}
 
 	// Fichero destino
-	QString filename = QString("%1.vhd").arg(doc->name());
+	QString filename = hdlDir.filePath( QString("%1.vhd").arg(doc->name()) );
 	QFile file( filename );
 	if( !file.open( IO_WriteOnly ) ){
 		emit errorMessage( tr(" No se puede crear el fichero %1").arg(filename) );
@@ -689,13 +731,14 @@ bool Project::buildModelHDLFile( Document * doc )
 bool Project::buildModelSignalsFile( Document * doc )
 {
 	// Creacin de la ruta para SIM en el proyecto.
-	if( !tryEnterDir( path(), SIM_PROJECT_FOLDER ) ){
+	QDir sigDir;
+	if( !tryMakeDir( path(), SIM_PROJECT_FOLDER, &sigDir ) ){
 		emit errorMessage( tr(" No se puede crear el directorio %1 en %2").arg(SIM_PROJECT_FOLDER).arg(path()) );
 		return false;
 	}
 
 	// Fichero destino
-	QString filename = QString("%1.sig").arg(doc->name());
+	QString filename = sigDir.filePath( QString("%1.sig").arg(doc->name()) );
 	QFile file( filename );
 	if( !file.open( IO_WriteOnly ) ){
 		emit errorMessage( tr(" No se puede crear el fichero %1").arg(filename) );
@@ -726,29 +769,118 @@ bool Project::buildModelHDL( const QString& docName )
 		return false;
 	}
 
+	// Estado de construccin
+	HDLModelSnapshot snapshot;
+	snapshot.capture( doc->name(), doc );
+
+	QDir hdlDir( path() );
+	hdlDir.cd( VHDL_PROJECT_FOLDER );
+	recordModelHDL( doc->name(), snapshot.hash(), HDLBuildState::hashFile( hdlDir.filePath( QString("%1.vhd").arg(doc->name()) ) ) );
+
 	return true;
 }
 // Construye todos los documentos de la lista ignorando si ya estn al da
 //   Devuelve true si al menos un documento no fracasa (o no hay ninguno)
+//
+// Los documentos se cargan y se capturan (HDLModelSnapshot) en el hilo
+// principal; la escritura de los ficheros se reparte entre los hilos de
+// HDLBuildScheduler mientras se siguen cargando los siguientes.
 bool Project::buildModelsHDL( const QStringList & docs )
 {
-	bool retval=false;
-	
 	if( docs.isEmpty() )
 		return true;
 
+	// La interfaz sigue atendiendo eventos durante la construccin
+	if( hdlBuilding )
+		return false;
+
+	// Rutas absolutas de los ficheros generados
+	QDir hdlDir, sigDir;
+	if( !tryMakeDir( path(), VHDL_PROJECT_FOLDER, &hdlDir ) ){
+		emit errorMessage( tr(" No se puede crear el directorio %1 en %2").arg(VHDL_PROJECT_FOLDER).arg(path()) );
+		return false;
+	}
+	if( !tryMakeDir( path(), SIM_PROJECT_FOLDER, &sigDir ) ){
+		emit errorMessage( tr(" No se puede crear el directorio %1 en %2").arg(SIM_PROJECT_FOLDER).arg(path()) );
+		return false;
+	}
+
+	hdlBuilding = true;
+
+	HDLBuildScheduler scheduler;
+	scheduler.setOutputDirs( hdlDir.absPath(), sigDir.absPath() );
+	connect( &scheduler, SIGNAL(errorMessage(const QString&)), this, SIGNAL(errorMessage(const QString&)) );
+	connect( &scheduler, SIGNAL(outputMessage(const QString&)), this, SIGNAL(outputMessage(const QString&)) );
+	connect( &scheduler, SIGNAL(indentMessage(int)), this, SIGNAL(indentMessage(int)) );
+	connect( &scheduler, SIGNAL(modelBuilt(const QString&, const QString&, const QString&)),
+			 this, SLOT(recordModelHDL(const QString&, const QString&, const QString&)) );
+
 	// Generamos el HDL de todos los documentos
 	for( QStringList::const_iterator it = docs.begin(); it != docs.end(); ++it ){
-		emit outputMessage(tr( "Analizando %1...").arg(*it) );
-		emit indentMessage( 1 );
-		if( buildModelHDL( *it ) )
-			retval = true;
-		emit indentMessage( -1 );
+		HDLModelSnapshot * snapshot = NULL;
+
+		// Los documentos que no estn cargados se leen sin instanciarlos
+		HDLModelGraph graph;
+		QString entity;
+		if( loadModelGraph( *it, graph, entity ) ){
+			snapshot = new HDLModelSnapshot;
+			snapshot->capture( entity, graph );
+		}
+
+		scheduler.addJob( *it, snapshot );
 	}
 
+	bool retval = scheduler.finish();
+
+	hdlBuilding = false;
 	return retval;
 }
 
+// Modelo del documento doc: el del editor si el documento est cargado o,
+// en otro caso, el ledo de su fichero (.lem o .lmb) sin crear el
+// documento. En entity se devuelve el nombre de la entidad
+bool Project::loadModelGraph( const QString & doc, HDLModelGraph & graph, QString & entity )
+{
+	Document * lpDoc = findDocument( doc );
+	if( lpDoc ){
+		graph.build( lpDoc->netlist() );
+		entity = lpDoc->name();
+		return true;
+	}
+
+	HDLModelReader reader( app->libraryManager(), graph );
+	if( !reader.readFile( HDLModelReader::modelFile( path(), doc ).filePath() ) )
+		return false;
+
+	entity = reader.modelName().isNull() ? doc : reader.modelName();
+	return true;
+}
+
+// Componentes instanciados por el documento doc (ver HDLGenerator::componentDependences)
+bool Project::modelDependences( const QString & doc, QPtrList<LMComponent> & comps )
+{
+	Document * lpDoc = findDocument( doc );
+	if( lpDoc ){
+		comps = lpDoc->hdlGenerator()->componentDependences();
+		return true;
+	}
+
+	HDLModelGraph graph;
+	QString entity;
+	if( !loadModelGraph( doc, graph, entity ) )
+		return false;
+
+	comps.clear();
+	for( int i=0; i < graph.deviceCount(); i++ ){
+		LMComponent * cmp = graph.deviceComponent( i );
+		if( LogicEditor::extractDupNameIndex( graph.deviceName( i ) ) == -1 &&
+			!cmp->isExternSolving() && !comps.containsRef( cmp ) )
+			comps.append( cmp );
+	}
+
+	return true;
+}
+
 // Construye el documento activo
 //   Devuelve true si se completa con xito
 bool Project::buildActiveModelHDL()
@@ -763,18 +895,12 @@ bool Project::buildActiveModelHDL()
 
 	emit outputMessage( tr("Construyendo componente %1").arg(doc->name()) );
 
-	// Construimos su VHDL si es preciso
-	if( !checkHDLuptoDate( doc->name() ) ){
-		emit indentMessage( 1 );
-		bool retval = buildModelHDL( doc->name() );
-		emit indentMessage( -1 );
-		return retval;
-	}else{
-		emit outputMessage( tr("El componente %1 est al da. No se hace nada.").arg(doc->name()) );
-		return true;
-	}
+	// Construimos su VHDL, y el de sus submodelos, si es preciso
+	emit indentMessage( 1 );
+	bool retval = buildHierarchyHDL( hierarchyOf( doc->name() ) );
+	emit indentMessage( -1 );
 
-	emit outputMessage("");
+	return retval;
 } 
 
 // Construye todos los documentos, si alguno no ha sido instanciado, se carga.
@@ -788,27 +914,97 @@ bool Project::buildAllHDL()
 
 	emit outputMessage( tr("Construyendo todos los componentes") );
 
-	// Generamos los objetivos a construir
-	QStringList targets;
-	for( QStringList::iterator it = documents().begin(); it != documents().end(); ++it )
-		if( !checkHDLuptoDate( *it ) )
-			targets.append( *it );
-		else
-			emit outputMessage( tr("El componente %1 est al da. No se hace nada.").arg( *it ) );
-	
-	if( targets.isEmpty() )
-		return true;
-
-	// Construccin
-	emit indentMessage( 1 );
-	retval = buildModelsHDL( targets );
-	emit indentMessage( -1 );
+	retval = buildHierarchyHDL( documents() );
 
 	emit outputMessage("");
 
 	return retval;
 }
 
+// Construye los documentos de docs que no estn al da, por niveles: los
+// submodelos antes que los documentos que los instancian, de forma que
+// stos se comparan y generan con la interfaz ya actualizada. Un documento
+// slo se reconstruye si cambia su netlist o la interfaz de sus submodelos
+//   Devuelve true si no fracasa ningn nivel
+bool Project::buildHierarchyHDL( const QStringList & docs )
+{
+	bool retval = true;
+
+	QValueList<QStringList> levels;
+	QStringList cyclic;
+	if( !HDLModelHierarchy::levels( docs, submodelMap( docs ), levels, cyclic ) ){
+		emit errorMessage( tr("Instanciacin recursiva de modelos: no se construirn %1").arg( cyclic.join(", ") ) );
+		retval = false;
+	}
+
+	for( QValueList<QStringList>::iterator itLevel = levels.begin(); itLevel != levels.end(); ++itLevel ){
+
+		// Generamos los objetivos a construir
+		QStringList targets;
+		for( QStringList::iterator it = (*itLevel).begin(); it != (*itLevel).end(); ++it )
+			if( !checkHDLuptoDate( *it ) )
+				targets.append( *it );
+			else
+				emit outputMessage( tr("El componente %1 est al da. No se hace nada.").arg( *it ) );
+
+		if( targets.isEmpty() )
+			continue;
+
+		// Construccin
+		emit indentMessage( 1 );
+		if( !buildModelsHDL( targets ) )
+			retval = false;
+		emit indentMessage( -1 );
+	}
+
+	return retval;
+}
+
+// Submodelos de doc: los del editor si el documento est cargado o, en
+// otro caso, los referenciados por su fichero
+QStringList Project::submodels( const QString & doc )
+{
+	Document * lpDoc = findDocument( doc );
+	if( !lpDoc )
+		return hierarchy.submodels( doc );
+
+	HDLModelGraph graph;
+	graph.build( lpDoc->netlist() );
+
+	QStringList list;
+	for( int i=0; i < graph.deviceCount(); i++ ){
+		LMComponent * cmp = graph.deviceComponent( i );
+		if( cmp->parentLibrary() == hierarchy.library() && !list.contains( cmp->name() ) )
+			list.append( cmp->name() );
+	}
+
+	return list;
+}
+
+QMap<QString, QStringList> Project::submodelMap( const QStringList & docs )
+{
+	QMap<QString, QStringList> children;
+	for( QStringList::const_iterator it = docs.begin(); it != docs.end(); ++it )
+		children.insert( *it, submodels( *it ) );
+
+	return children;
+}
+
+// doc y los documentos del proyecto que instancia, directa o indirectamente
+QStringList Project::hierarchyOf( const QString & doc )
+{
+	QStringList result( doc );
+
+	for( uint i=0; i < result.count(); i++ ){
+		QStringList children = submodels( result[i] );
+		for( QStringList::iterator it = children.begin(); it != children.end(); ++it )
+			if( documents().contains( *it ) && !result.contains( *it ) )
+				result.append( *it );
+	}
+
+	return result;
+}
+
 ///////////////////////////////////////////////////////////
 // Compilacin: generacin de binarios (ModelTech)
 ///////////////////////////////////////////////////////////
@@ -821,26 +1017,117 @@ bool Project::compileModels( const QStringList & docs )
 	if( docs.count() == 0 )
 		return true;
 
+	HDLJobScheduler * scheduler = createJobScheduler();
+
+	QMap<LMLibrary*, int> libJobs;
+	addModelJobs( scheduler, docs, libJobs );
+
+	return scheduler->start();
+}
+
+// Planificador de los trabajos de compilacin. Se destruye al terminar
+HDLJobScheduler * Project::createJobScheduler()
+{
+	HDLJobScheduler * scheduler = new HDLJobScheduler( this, "compileScheduler" );
+	scheduler->setWorkers( buildWorkers() );
+
+	connect( scheduler, SIGNAL(errorMessage(const QString&)), this, SIGNAL(errorMessage(const QString&)) );
+	connect( scheduler, SIGNAL(outputMessage(const QString&)), this, SIGNAL(outputMessage(const QString&)) );
+	connect( scheduler, SIGNAL(finished(bool)), scheduler, SLOT(deleteLater()) );
+
+	return scheduler;
+}
+
+// Aade la compilacin (vlib y vcom) de las libreras de las que dependen
+// los documentos del proyecto. En libJobs se devuelve el trabajo vcom de
+// cada librera
+void Project::addLibraryJobs( HDLJobScheduler * scheduler, QMap<LMLibrary*, int> & libJobs )
+{
+	QPtrList<LMLibrary> libs;
+
+	emit outputMessage( tr("Calculando dependencias...") );
+	
+	// Para cada documento del proyecto
+	for( QStringList::iterator it = documents().begin(); it != documents().end(); ++it ){
+
+		// Para cada componente del documento, se accede a su librera y se inserta en la lista libs
+		emit outputMessage( tr("Analizando %1...").arg(*it) );
+		emit indentMessage( 1 );
+		QPtrList<LMComponent> comps;
+		bool ok = modelDependences( *it, comps );
+		emit indentMessage( -1 );
+
+		if( ok ){
+			// Los modelos del proyecto no son una librera externa
+			for( LMComponent * itComp = comps.first(); itComp; itComp = comps.next() )
+				if( itComp->parentLibrary() != hierarchy.library() && !libs.contains( itComp->parentLibrary() ) )
+					libs.append( itComp->parentLibrary() );
+		}else
+			emit errorMessage( tr("No se puede acceder al documento %1 (El docuemnto ser ignorado)").arg(*it) );
+	}
+
+	// Compilacin de las libreras: vlib (su fallo indica que ya existe) y vcom
+	for( LMLibrary * itLib = libs.first(); itLib; itLib = libs.next() ){
+
+		QString libPath = QDir::convertSeparators(app->vhdlPath()) + QDir::separator() + itLib->sourceOrigin();
+
+		int vlibJob = scheduler->addJob( new HDLProcLibBuilder( libPath, scheduler, "vlib" ), tr("vlib %1").arg(itLib->name()), false );
+
+		HDLProcCompiler * vcom = new HDLProcCompiler( scheduler, "vcom" );
+		vcom->setWorkLibrary( libPath );
+		int vcomJob = scheduler->addJob( vcom, tr("vcom %1").arg(itLib->name()) );
+		scheduler->setJobLock( vcomJob, libPath );
+
+		scheduler->addDependence( vcomJob, vlibJob );
+		libJobs.insert( itLib, vcomJob );
+	}
+}
+
+// Aade la compilacin de los documentos docs en la librera del proyecto.
+// Cada documento se compila por separado, despus de las libreras y de los
+// documentos del proyecto que instancia. Todos escriben en la misma
+// librera de trabajo, as que comparten cerrojo: se ejecutan de uno en
+// uno (en paralelo, como mucho, con la compilacin de otras libreras)
+void Project::addModelJobs( HDLJobScheduler * scheduler, const QStringList & docs, const QMap<LMLibrary*, int> & libJobs )
+{
   //Preparacin de datos
 	// Rutas
 	QString base = QDir::convertSeparators(path());
 	QString binPath = QString("%1%2%3").arg(base).arg(QDir::separator()).arg(BIN_PROJECT_FOLDER);
 	QString vhdlPath = QString("%1%2%3").arg(base).arg(QDir::separator()).arg(VHDL_PROJECT_FOLDER);
 
-	
-	// Objetivos: modelos a compilar
-	QStringList targets;
-	for(QStringList::const_iterator it = docs.begin(); it != docs.end(); ++it )
-		targets.append( QString("%1%2%3.vhd").arg(vhdlPath).arg(QDir::separator()).arg(*it) );
+	// Construccin de la librera del proyecto (si ya existe no se hace nada)
+	int vlibJob = scheduler->addJob( new HDLProcLibBuilder( binPath, scheduler, "vlib" ), tr("vlib %1").arg(BIN_PROJECT_FOLDER), false );
 
-	// Construccin de la librera del proyecto
-	QDir dir( path() );
-	if( !dir.cd( BIN_PROJECT_FOLDER ) )
-		// La librera no existe, se crea y se indican los objetivos (no ser necesario invocar la compilacin explcitamente)
-		return app->HDLEngine().createSourceLibrary( binPath, targets );
+	// Objetivos: modelos a compilar
+	QMap<QString, int> docJobs;
+	QStringList::const_iterator it;
+	for( it = docs.begin(); it != docs.end(); ++it ){
+		QString target = QString("%1%2%3.vhd").arg(vhdlPath).arg(QDir::separator()).arg(*it);
+
+		int job = scheduler->addJob( new HDLProcCompiler( QStringList( target ), binPath, scheduler, "vcom" ), tr("vcom %1").arg(*it) );
+		scheduler->addDependence( job, vlibJob );
+		scheduler->setJobLock( job, binPath );
+		docJobs.insert( *it, job );
+	}
 
-	// Compilacin explcita de los objetivos del proyecto
-	return app->HDLEngine().buildProject( targets, binPath );
+	// Orden de compilacin: libreras y entidades instanciadas
+	for( it = docs.begin(); it != docs.end(); ++it ){
+		QPtrList<LMComponent> comps;
+		if( !modelDependences( *it, comps ) )
+			continue;
+
+		int job = docJobs[ *it ];
+		for( LMComponent * itComp = comps.first(); itComp; itComp = comps.next() ){
+			QMap<LMLibrary*, int>::ConstIterator itLib = libJobs.find( itComp->parentLibrary() );
+			if( itLib != libJobs.end() )
+				scheduler->addDependence( job, itLib.data() );
+
+			QMap<QString, int>::ConstIterator itDoc = docJobs.find( itComp->name() );
+			if( itDoc != docJobs.end() )
+				scheduler->addDependence( job, itDoc.data() );
+		}
+	}
 }
 
 // Mtodo facilitado por comodidad, funciona esencialmente como el
@@ -871,14 +1158,21 @@ bool Project::compileActiveModel()
 	}
 	emit indentMessage( -1 );
 
-	// Se chequea si el componente est al da
-	if( checkBINuptoDate( doc->name() ) ){
+	// Se chequea si el componente y sus submodelos estn al da. Un
+	// submodelo recompilado obliga a recompilar los que lo instancian
+	QStringList tree = hierarchyOf( doc->name() );
+	QStringList targets;
+	for( QStringList::iterator it = tree.begin(); it != tree.end(); ++it )
+		if( !checkBINuptoDate( *it ) )
+			targets.append( *it );
+
+	if( targets.isEmpty() ){
 		emit outputMessage( tr("No se hace nada, '%1' est al da.").arg(doc->name()) );
 		return true;
 	}
 	
 	// Finalmente se compila
-	bool retval = compileModel( doc->name() );
+	bool retval = compileModels( HDLModelHierarchy::dependents( targets, tree, submodelMap( tree ) ) );
 
 	emit outputMessage("");
 
@@ -901,9 +1195,17 @@ bool Project::compileAll()
 	}
 
 	emit indentMessage( -1 );
+
+	// Un nico grafo de trabajos: las libreras se compilan antes que los
+	// documentos que las usan, y el fallo de una cancela sus dependientes
+	HDLJobScheduler * scheduler = createJobScheduler();
+
 	// Compilando dependencias
-	if( !compileDependences() )
-		emit errorMessage( tr("Error compilando dependencias... (omitido)") );
+	emit outputMessage( tr("Compilando dependencias del proyecto...") );
+	emit indentMessage( 1 );
+	QMap<LMLibrary*, int> libJobs;
+	addLibraryJobs( scheduler, libJobs );
+	emit indentMessage( -1 );
 
 	// Lista de objetivos
 	QStringList targets;
@@ -911,15 +1213,13 @@ bool Project::compileAll()
 		if( !checkBINuptoDate( *it ) )
 			targets.append( *it );
 
-	if( targets.isEmpty() ){
+	if( targets.isEmpty() )
 		emit outputMessage( tr(" No se hace nada, Todos los componentes estn al da.") );
-		return true;
-	}
+	else
+		addModelJobs( scheduler, HDLModelHierarchy::dependents( targets, documents(), submodelMap( documents() ) ), libJobs );
 
 	// Compilacin efectiva
-	emit indentMessage( 1 );
-	bool retval = compileModels( targets );
-	emit indentMessage( -1 );
+	bool retval = scheduler->start();
 
 	emit outputMessage("");
 
@@ -928,53 +1228,43 @@ bool Project::compileAll()
 
 bool Project::compileDependences()
 {
-	// Lista de objetivos
-	QPtrList<LMLibrary> libs;
+	HDLJobScheduler * scheduler = createJobScheduler();
 
 	emit outputMessage( tr("Compilando dependencias del proyecto...") );
 	emit indentMessage( 1 );
-	emit outputMessage( tr("Calculando dependencias...") );
+
+	QMap<LMLibrary*, int> libJobs;
+	addLibraryJobs( scheduler, libJobs );
 	
-	// Para cada documento del proyecto
-	for( QStringList::iterator it = documents().begin(); it != documents().end(); ++it ){
+	emit indentMessage( -1 );
+	emit outputMessage("");
 
-		// Busca el documento, cargndolo si es preciso, aunque mantenindolo oculto en tal caso
-		Document * doc = findDocument( *it, true, false );
-		if( doc ){
-		
-			// Para cada componente del documento, se accede a su librera y se inserta en la lista libs
-			emit outputMessage( tr("Analizando %1...").arg(*it) );
-			emit indentMessage( 1 );
-			QPtrList<LMComponent> comps = doc->hdlGenerator()->componentDependences();
-			emit indentMessage( -1 );
+	return scheduler->start();
+}
 
-			for( LMComponent * itComp = comps.first(); itComp; itComp = comps.next() )
-				if( !libs.contains( itComp->parentLibrary() ) )
-					libs.append( itComp->parentLibrary() );
-					
+// Estado de construccin del proyecto (se carga al cambiar de proyecto)
+HDLBuildState & Project::buildState()
+{
+	if( bstate.path() != path() )
+		bstate.load( path() );
 
-		}else
-			emit errorMessage( tr("No se puede acceder al documento %1 (El docuemnto ser ignorado)").arg(*it) );
-	}
+	return bstate;
+}
 
-	// Compilacin de las libreras
-	for( LMLibrary * itLib = libs.first(); itLib; itLib = libs.next() ){
+void Project::recordModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash )
+{
+	HDLBuildState & state = buildState();
 
-		emit outputMessage( tr("  Compilando librera %1...").arg(itLib->name()) );
+	state.setModelHDL( doc, netlistHash, hdlHash, HDLModelReader::modelFile( path(), doc ).lastModified() );
+	state.setHash( "interfaces:" + doc, hierarchy.interfacesHash( submodels( doc ) ) );
+	state.save();
 
-		QString libPath = QDir::convertSeparators(app->vhdlPath()) + QDir::separator() + itLib->sourceOrigin();
-		
-		emit indentMessage( 1 );
-		if( !app->HDLEngine().createSourceLibrary( libPath ) )
-			emit errorMessage( tr("Imposible compilar la librera %1 en %2").arg(itLib->name()).arg(libPath) );
-		emit indentMessage( -1 );
-	}
-	
-	emit indentMessage( -1 );
-	emit outputMessage("");
-	return true;
+	// Interfaz del modelo como componente para los documentos que lo instancian
+	hierarchy.updateComponent( doc );
 }
 
+// El HDL de doc slo est anticuado si ha cambiado la netlist del modelo
+// desde la ltima generacin (o el fichero .vhd)
 bool Project::checkHDLuptoDate(const QString & doc)
 {
 	QDir projectDir( path() );
@@ -988,14 +1278,39 @@ bool Project::checkHDLuptoDate(const QString & doc)
 	if( !vhdFile.exists() )
 		return false;
 
-	// Volvemos al directorio base del proyecto
-	projectDir.cdUp();
+	QFileInfo lemFile = HDLModelReader::modelFile( path(), doc );
 
-	// El fichero documento.vhd no est al da respecto al modelo
-	QFileInfo lemFile( projectDir, QString("%1.lem").arg(doc) );
+	// Sin estado de construccin se comparan las fechas de modificacin
+	HDLBuildState & state = buildState();
+	QString netlistHash = state.hash( "netlist:" + doc );
+	if( netlistHash.isNull() )
+		return (vhdFile.lastModified() >= lemFile.lastModified());
 
-	return (vhdFile.lastModified() >= lemFile.lastModified());
-	
+	// El fichero documento.vhd ha cambiado desde que se gener
+	if( HDLBuildState::hashFile( vhdFile.filePath() ) != state.hash( "vhdl:" + doc ) )
+		return false;
+
+	// El modelo no se ha vuelto a guardar ni ha cambiado la interfaz de sus submodelos
+	QString modelTime = QString::number( lemFile.lastModified().toTime_t() );
+	QString interfaces = hierarchy.interfacesHash( submodels( doc ) );
+	if( modelTime == state.hash( "modeltime:" + doc ) && interfaces == state.hash( "interfaces:" + doc ) )
+		return true;
+
+	// Se compara su netlist (que incluye la interfaz de los componentes) con la registrada
+	HDLModelGraph graph;
+	QString entity;
+	if( !loadModelGraph( doc, graph, entity ) )
+		return false;
+
+	HDLModelSnapshot snapshot;
+	snapshot.capture( entity, graph );
+	if( snapshot.hash() != netlistHash )
+		return false;
+
+	state.setHash( "modeltime:" + doc, modelTime );
+	state.setHash( "interfaces:" + doc, interfaces );
+	state.save();
+	return true;
 }
 
 // Esta funcin es dependiente del compilador!!!
@@ -1013,14 +1328,14 @@ bool Project::checkBINuptoDate(const QString & doc)
 	if( !binFile.exists() )
 		return false;
 
-	// Comparacin con la ltima modificacin del vhd
+	// Comparacin con el contenido del vhd que compil vcom (registrado
+	// por HDLProcCompiler en el estado de la carpeta VHDL)
 	projectDir.cdUp();
 	if( projectDir.cd( VHDL_PROJECT_FOLDER ) ){
-	
-		// El fichero documento.vhd no est al da respecto al modelo
 		QFileInfo vhdFile( projectDir, QString("%1.vhd").arg(doc) );
+		HDLBuildState state( projectDir.absPath() );
 
-		return (binFile.lastModified() >= vhdFile.lastModified());
+		return state.isCompiled( vhdFile.filePath(), binFile.filePath() );
 	}else
 		return true;
 	
@@ -40,10 +40,19 @@
 #define _PROJECT_H_
 
 #include <qworkspace.h>
+#include <qmap.h>
+#include <qptrlist.h>
+
+#include "HDLBuildState.h"
+#include "HDLModelHierarchy.h"
 
 class Document;
 class IAInterface;
 class QDir;
+class LMLibrary;
+class LMComponent;
+class HDLJobScheduler;
+class HDLModelGraph;
 
 #define VHDL_PROJECT_FOLDER "vhdl"
 #define BIN_PROJECT_FOLDER "bin"
@@ -76,6 +85,14 @@ public:
 	// Devuelve NULL si en ningn caso se consigue cargar el documento
 	Document * findDocument( const QString& docName, bool mustLoad=false, bool mustShowWhenLoad=false );
 
+	// Nmero mximo de procesos de compilacin simultneos
+	void setBuildWorkers( int count );
+	int buildWorkers() const;
+
+	// Librera con los modelos del proyecto como componentes (NULL si no
+	// hay proyecto abierto)
+	LMLibrary * modelsLibrary() const;
+
 
 protected:
 	QStringList& documents();
@@ -141,21 +158,45 @@ protected:
 	bool buildModelHDL( const QString & doc );
 	bool buildModelsHDL( const QStringList & docs );
 
+	// Modelo de un documento sin instanciarlo: si no est cargado se lee
+	// del fichero en un HDLModelGraph, sin editor ni lienzo
+	bool loadModelGraph( const QString & doc, HDLModelGraph & graph, QString & entity );
+	bool modelDependences( const QString & doc, QPtrList<LMComponent> & comps );
+
+	// Modelos jerrquicos (ver HDLModelHierarchy)
+	QStringList submodels( const QString & doc );
+	QMap<QString, QStringList> submodelMap( const QStringList & docs );
+	QStringList hierarchyOf( const QString & doc );
+	bool buildHierarchyHDL( const QStringList & docs );
+
 	// Compilacin (Binaria)
 	bool compileModels( const QStringList & docs );
 	bool compileModel( const QString & doc );
+	HDLJobScheduler * createJobScheduler();
+	void addLibraryJobs( HDLJobScheduler * scheduler, QMap<LMLibrary*, int> & libJobs );
+	void addModelJobs( HDLJobScheduler * scheduler, const QStringList & docs, const QMap<LMLibrary*, int> & libJobs );
 
-	// Comprobacin de cambios entre ficheros
+	// Comprobacin de cambios entre ficheros (por contenido, ver HDLBuildState)
 	bool checkHDLuptoDate(const QString & doc);
 	bool checkBINuptoDate(const QString & doc);
+	HDLBuildState & buildState();
 	
 	// Utilidades: Manejo de directorios
+	bool tryMakeDir( const QString& where, const QString& dirName, QDir * dir=0 );
 	bool tryEnterDir( const QString& where, const QString& dirName, QDir * dir=0 );
 
+protected slots:
+	// Registra el estado de construccin del HDL de un documento
+	void recordModelHDL( const QString & doc, const QString & netlistHash, const QString & hdlHash );
+
 private:
 	bool saveProjectFile();
 
 	bool isChanged;
+	bool hdlBuilding;
+	int nWorkers;
+	HDLBuildState bstate;
+	HDLModelHierarchy hierarchy;
 
 	QString pth, at;
 	QStringList docs;
@@ -0,0 +1,92 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+// hdlbuild.cpp: generacin del HDL de proyectos sin interfaz grfica.
+//
+//	hdlbuild [-L dirLibreras] [-j hilos] [-O] proyecto.lep ...
+//
+//	-O optimiza la netlist de cada modelo antes de volcarla (ver
+//	HDLNetlistOptimizer)
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <stdio.h>
+
+#include "HDLBatchBuilder.h"
+#include "HDLNetlistOptimizer.h"
+
+static void usage( const char * program )
+{
+	fprintf( stderr, "Uso: %s [-L dirLibreras] [-j hilos] [-O] proyecto.lep ...\n", program );
+}
+
+int main( int argc, char ** argv )
+{
+	// Sin conexin con el servidor grfico
+	QApplication a( argc, argv, FALSE );
+
+	QString libDir = "lib";
+	int workers = 0;
+	QStringList projects;
+
+	for( int i = 1; i < a.argc(); i++ ){
+		QString arg = a.argv()[i];
+
+		if( ( arg == "-L" || arg == "-j" ) && i + 1 < a.argc() ){
+			QString value = a.argv()[++i];
+			if( arg == "-L" )
+				libDir = value;
+			else{
+				bool ok;
+				workers = value.toInt( &ok );
+				if( !ok || workers < 1 ){
+					usage( a.argv()[0] );
+					return 2;
+				}
+			}
+		}
+		else if( arg == "-O" )
+			HDLNetlistOptimizer::setEnabled( true );
+		else if( arg.startsWith( "-" ) ){
+			usage( a.argv()[0] );
+			return 2;
+		}
+		else
+			projects.append( arg );
+	}
+
+	if( projects.isEmpty() ){
+		usage( a.argv()[0] );
+		return 2;
+	}
+
+	HDLBatchBuilder builder;
+	if( workers > 0 )
+		builder.setWorkers( workers );
+
+	if( !builder.loadLibraries( libDir ) )
+		fprintf( stderr, "Aviso: no se ha cargado ninguna librera de %s\n", (const char*)libDir.local8Bit() );
+
+	bool ok = true;
+	for( QStringList::const_iterator it = projects.begin(); it != projects.end(); ++it )
+		if( !builder.build( *it ) )
+			ok = false;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// tst_IAPortMap.cpp: pruebas de IAPortMap (y de IAAddressMap).
+//
+//	Aplica secuencias aleatorias de inserciones, desplazamientos, cambios
+//	de tamao, reservas y borrados a un IAPortMap y a un modelo de
+//	referencia que guarda los puertos en una lista y los comprueba
+//	linealmente, como IAInterface::checkFreeRange. Tras cada operacin
+//	compara los rangos libres, size(), dataSize() y los puertos.
+//	Se enlaza con IAPortMap, IAAddressMap e IAPort. Devuelve 0 si todas
+//	las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <qvaluelist.h>
+
+#include "IAPortMap.h"
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador determinista (las secuencias se repiten en cada ejecucin)
+static Q_UINT32 seed = 12345;
+static Q_UINT32 rnd( Q_UINT32 n )
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 8 ) % n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Modelo de referencia
+//////////////////////////////////////////////////////////////////////
+
+struct RefPort{
+	QString name;
+	Q_UINT32 base, size;
+	bool hasBase, hasSize;
+	bool readable, writable;
+
+	bool initialized() const { return hasBase && hasSize; }
+};
+
+class RefInterface
+{
+public:
+	QValueList<RefPort> ports;
+
+	RefPort * find( const QString & name )
+	{
+		for( QValueList<RefPort>::iterator it = ports.begin(); it != ports.end(); ++it )
+			if( (*it).name == name )
+				return &(*it);
+		return 0;
+	}
+
+	bool checkFreeRange( Q_UINT32 addr, Q_UINT32 size, const QString & except ) const
+	{
+		Q_ULLONG end = (Q_ULLONG)addr + ( size ? size : 1 );
+		if( end > ( (Q_ULLONG)1 << 32 ) )
+			return false;
+
+		for( QValueList<RefPort>::const_iterator it = ports.begin(); it != ports.end(); ++it )
+			if( (*it).initialized() && (*it).name != except )
+				if( addr < (Q_ULLONG)(*it).base + (*it).size && end > (*it).base )
+					return false;
+
+		return true;
+	}
+
+	Q_UINT32 size() const
+	{
+		Q_ULLONG max = 0;
+		for( QValueList<RefPort>::const_iterator it = ports.begin(); it != ports.end(); ++it )
+			if( (*it).initialized() && (Q_ULLONG)(*it).base + (*it).size > max )
+				max = (Q_ULLONG)(*it).base + (*it).size;
+
+		if( max % 4 )
+			max += 4 - max % 4;
+		return (Q_UINT32)max;
+	}
+
+	Q_UINT32 dataSize() const
+	{
+		Q_UINT32 sz = 0;
+		for( QValueList<RefPort>::const_iterator it = ports.begin(); it != ports.end(); ++it )
+			if( (*it).initialized() ){
+				if( (*it).readable )
+					sz += (*it).size;
+				if( (*it).writable )
+					sz += (*it).size;
+			}
+		return sz;
+	}
+
+	void insertPort( const QString & name )
+	{
+		if( find( name ) )
+			return;
+
+		RefPort p;
+		p.name = name;
+		p.base = size();
+		p.size = 1;
+		p.hasBase = p.hasSize = true;
+		p.readable = p.writable = true;
+		ports.append( p );
+	}
+
+	void insertUninitialized( const QString & name )
+	{
+		if( find( name ) )
+			return;
+
+		RefPort p;
+		p.name = name;
+		p.base = p.size = 0;
+		p.hasBase = p.hasSize = false;
+		p.readable = p.writable = true;
+		ports.append( p );
+	}
+
+	void removePort( const QString & name )
+	{
+		for( QValueList<RefPort>::iterator it = ports.begin(); it != ports.end(); ++it )
+			if( (*it).name == name ){
+				ports.remove( it );
+				return;
+			}
+	}
+
+	void setPortAddress( const QString & name, Q_UINT32 addr )
+	{
+		RefPort * p = find( name );
+		if( p && checkFreeRange( addr, p->hasSize ? p->size : 1, name ) ){
+			p->base = addr;
+			p->hasBase = true;
+		}
+	}
+
+	void setPortSize( const QString & name, Q_UINT32 sz )
+	{
+		RefPort * p = find( name );
+		if( p && checkFreeRange( p->hasBase ? p->base : size(), sz, name ) ){
+			p->size = sz;
+			p->hasSize = true;
+		}
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Comparacin
+//////////////////////////////////////////////////////////////////////
+
+static QString portName( int i )
+{
+	return QString( "P%1" ).arg( i );
+}
+
+static void compare( const IAPortMap & map, RefInterface & ref, int step, Q_UINT32 space )
+{
+	QString at = QString( " (paso %1)" ).arg( step );
+
+	check( map.count() == ref.ports.count(), "count" + at );
+	check( map.size() == ref.size(), QString( "size %1 != %2" ).arg( map.size() ).arg( ref.size() ) + at );
+	check( map.dataSize() == ref.dataSize(), "dataSize" + at );
+
+	for( QValueList<RefPort>::iterator it = ref.ports.begin(); it != ref.ports.end(); ++it ){
+		check( map.contains( (*it).name ), "contains " + (*it).name + at );
+		check( map.isInitialized( (*it).name ) == (*it).initialized(), "isInitialized " + (*it).name + at );
+		if( (*it).hasBase )
+			check( map.portAddress( (*it).name ) == (*it).base, "portAddress " + (*it).name + at );
+		if( (*it).hasSize )
+			check( map.portSize( (*it).name ) == (*it).size, "portSize " + (*it).name + at );
+	}
+
+	// Rangos libres: cualquier posicin y tamao, con y sin excepcin
+	for( int q=0; q < 40; q++ ){
+		Q_UINT32 addr = rnd( space ), size = rnd( 12 );
+		QString except = rnd( 3 ) ? QString::null : portName( rnd( 16 ) );
+		check( map.checkFreeRange( addr, size, except ) == ref.checkFreeRange( addr, size, except ),
+			   QString( "checkFreeRange(%1, %2, %3)" ).arg( addr ).arg( size ).arg( except ) + at );
+	}
+}
+
+// Secuencia aleatoria de operaciones sobre 16 nombres de puerto en un
+// espacio pequeo (para que haya solapes y puertos de tamao 0)
+static void testOperations()
+{
+	const Q_UINT32 space = 96;
+	IAPortMap map;
+	RefInterface ref;
+
+	for( int step=0; step < 4000; step++ ){
+		QString name = portName( rnd( 16 ) );
+
+		switch( rnd( 8 ) ){
+		case 0:
+			map.insertPort( name );
+			ref.insertPort( name );
+			break;
+		case 1:
+			map.insertUninitialized( name );
+			ref.insertUninitialized( name );
+			break;
+		case 2:
+		case 3:{
+			Q_UINT32 addr = rnd( space );
+			map.setPortAddress( name, addr );
+			ref.setPortAddress( name, addr );
+			break;
+		}
+		case 4:
+		case 5:{
+			Q_UINT32 size = rnd( 10 );
+			map.setPortSize( name, size );
+			ref.setPortSize( name, size );
+			break;
+		}
+		case 6:{
+			// La reserva slo se compara con el modelo: el rango elegido
+			// debe estar libre y alineado
+			Q_UINT32 size = 1 + rnd( 8 ), align = 1 << rnd( 3 );
+			bool free = !ref.find( name );
+			if( map.allocatePort( name, size, align ) ){
+				check( free, "allocatePort de un nombre existente" );
+				Q_UINT32 addr = map.portAddress( name );
+				check( addr % align == 0, "allocatePort alineado" );
+				check( ref.checkFreeRange( addr, size, QString::null ), "allocatePort en un rango libre" );
+
+				RefPort p;
+				p.name = name;
+				p.base = addr;
+				p.size = size;
+				p.hasBase = p.hasSize = true;
+				p.readable = p.writable = true;
+				ref.ports.append( p );
+			}else
+				check( !free, "allocatePort falla con espacio libre" );
+			break;
+		}
+		default:
+			map.removePort( name );
+			ref.removePort( name );
+			break;
+		}
+
+		compare( map, ref, step, space );
+		if( failures > 20 )
+			return;
+	}
+}
+
+// Carga de los puertos de una interfaz, con puertos sin inicializar y de
+// tamao 0, y rechazo de los solapes
+static void testLoad()
+{
+	QValueList<IAPort> ports;
+	RefInterface ref;
+
+	for( int i=0; i < 200; i++ ){
+		IAPort p( i * 8, ( i % 5 ) ? 4 : 0 );
+		p.setName( portName( i ) );
+		ports.append( p );
+
+		RefPort r;
+		r.name = p.name();
+		r.base = p.baseAddress();
+		r.size = p.size();
+		r.hasBase = r.hasSize = true;
+		r.readable = p.readable();
+		r.writable = p.writable();
+		ref.ports.append( r );
+	}
+
+	IAPort unset;
+	unset.setName( "SIN_INICIALIZAR" );
+	ports.append( unset );
+	ref.insertUninitialized( "SIN_INICIALIZAR" );
+	ref.find( "SIN_INICIALIZAR" )->readable = unset.readable();
+	ref.find( "SIN_INICIALIZAR" )->writable = unset.writable();
+
+	IAPortMap map;
+	QString error;
+	check( map.load( ports, &error ), "load: " + error );
+	compare( map, ref, -1, 200 * 8 );
+
+	// El puerto nuevo se solapa con P1
+	IAPort overlap( 10, 4 );
+	overlap.setName( "SOLAPE" );
+	ports.append( overlap );
+	check( !map.load( ports, &error ), "load con solapes" );
+	check( map.count() == 0, "load con solapes no carga ningn puerto" );
+}
+
+int main( int argc, char ** argv )
+{
+	QApplication app( argc, argv, FALSE );
+
+	testOperations();
+	testLoad();
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,251 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_LEBinaryModel.cpp: medida de la carga de modelos binarios (.lmb).
+//
+//	Genera copias ampliadas de Example/Model01.lem (10, 100 y 1000
+//	rplicas), las convierte a .lmb y compara la carga de ambos formatos:
+//	slo la lectura del fichero (QXmlSimpleReader frente a la proyeccin
+//	de LEBinaryModel) y la carga completa en un LogicEditor. El objetivo
+//	del formato binario es cargar al menos 10 veces ms rpido que el XML.
+//	Se enlaza con Application, LogicEditor, LEBinaryModel, los items LE*,
+//	las libreras LM* y sus dependencias. Se ejecuta desde la raz del
+//	proyecto.
+//
+//	Uso: bench_LEBinaryModel [rplicas...]   (por omisin 10 100 1000)
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qdom.h>
+#include <qxml.h>
+#include <qtextstream.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEBinaryModel.h"
+
+Application * app;
+
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 40000, 40000 );
+		setCanvas( canvas );
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Modelos ampliados
+//////////////////////////////////////////////////////////////////////
+
+static QString shifted( const QDomAttr & attr, const QString & prefix, int dx, int dy )
+{
+	QString value = attr.value();
+
+	if( attr.name() == "name" )
+		return prefix + value;
+
+	if( attr.name() == "leftConnection" || attr.name() == "rightConnection" )
+		return ( value.isEmpty() || value == "null" ) ? value : prefix + value;
+
+	if( attr.name() == "offset" ){
+		QPoint p = LogicEditor::parsePoint( value );
+		return QString( "%1x%2" ).arg( p.x() + dx ).arg( p.y() + dy );
+	}
+
+	if( attr.name() == "points" ){
+		QStringList coords = QStringList::split( ' ', value );
+		QString s;
+		for( uint i=0; i + 1 < coords.count(); i += 2 )
+			s += QString( "%1 %2 " ).arg( coords[i].toInt() + dx ).arg( coords[i+1].toInt() + dy );
+		return s;
+	}
+
+	return value;
+}
+
+// Rplicas del modelo en una rejilla (dispositivos y cables renombrados)
+static bool scaleModel( const QString & source, int copies, const QString & target )
+{
+	QFile in( source );
+	QDomDocument doc;
+	if( !in.open( IO_ReadOnly ) || !doc.setContent( &in ) )
+		return false;
+
+	QFile out( target );
+	if( !out.open( IO_WriteOnly ) )
+		return false;
+
+	QTextStream ts( &out );
+	QDomElement root = doc.documentElement();
+	const char * tags[] = { "device", "wireline" };
+
+	ts << "<model name=\"" << root.attribute( "name" ) << copies << "\">\n";
+	for( int t=0; t < 2; t++ ){
+		QDomNodeList list = root.elementsByTagName( tags[t] );
+		for( int k=0; k < copies; k++ ){
+			QString prefix = QString( "K%1_" ).arg( k );
+			int dx = ( k % 40 ) * 900, dy = ( k / 40 ) * 500;
+
+			for( uint i=0; i < list.count(); i++ ){
+				QDomNamedNodeMap map = list.item( i ).toElement().attributes();
+				ts << "\t<" << tags[t];
+				for( uint a=0; a < map.length(); a++ )
+					ts << " " << map.item( a ).toAttr().name() << "=\"" << shifted( map.item( a ).toAttr(), prefix, dx, dy ) << "\"";
+				ts << "></" << tags[t] << ">\n";
+			}
+		}
+	}
+	ts << "</model>\n";
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Medida
+//////////////////////////////////////////////////////////////////////
+
+// Lectura del XML sin crear items
+static int parseXml( const QString & fileName )
+{
+	QFile file( fileName );
+	file.open( IO_ReadOnly );
+
+	QXmlInputSource source( &file );
+	QXmlSimpleReader reader;
+	QXmlDefaultHandler handler;
+	reader.setContentHandler( &handler );
+
+	QTime t;
+	t.start();
+	reader.parse( &source );
+	return t.elapsed();
+}
+
+// Lectura del binario sin crear items: proyeccin y acceso a todos los
+// registros, cadenas y vrtices
+static int parseBinary( const QString & fileName )
+{
+	QTime t;
+	t.start();
+
+	LEBinaryModel model;
+	model.map( fileName );
+	int i;
+	for( i=0; i < model.deviceCount(); i++ ){
+		model.string( model.device( i ).name );
+		model.string( model.device( i ).component );
+		model.string( model.device( i ).library );
+	}
+	for( i=0; i < model.wireLineCount(); i++ ){
+		model.string( model.wireLine( i ).leftConnection );
+		model.string( model.wireLine( i ).rightConnection );
+		model.vertexs( model.wireLine( i ) );
+	}
+
+	return t.elapsed();
+}
+
+static int loadEditor( const QString & fileName, bool binary )
+{
+	QTime t;
+	t.start();
+
+	TestEditor editor;
+	if( binary )
+		editor.loadBinary( fileName );
+	else{
+		QFile file( fileName );
+		file.open( IO_ReadOnly );
+		editor.load( &file );
+	}
+
+	return t.elapsed();
+}
+
+static QString ratio( int xml, int binary )
+{
+	if( binary == 0 )
+		return xml == 0 ? QString( "-" ) : QString( ">%1x" ).arg( xml );
+	return QString( "%1x" ).arg( (double)xml / binary, 0, 'f', 1 );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	QValueList<int> sizes;
+	for( int i=1; i < argc; i++ )
+		sizes.append( QString( argv[i] ).toInt() );
+	if( sizes.isEmpty() )
+		sizes << 10 << 100 << 1000;
+
+	bool parseTarget = true, loadTarget = true;
+	for( QValueList<int>::iterator it = sizes.begin(); it != sizes.end(); ++it ){
+		QString lem = QDir::temp().filePath( QString( "bench_Model01_x%1.lem" ).arg( *it ) );
+		QString lmb = QDir::temp().filePath( QString( "bench_Model01_x%1.lmb" ).arg( *it ) );
+
+		if( !scaleModel( "Example/Model01.lem", *it, lem ) ){
+			qWarning( "No se puede generar %s", lem.latin1() );
+			return 1;
+		}
+
+		// Conversin a binario
+		{
+			TestEditor editor;
+			QFile in( lem ), out( lmb );
+			if( !in.open( IO_ReadOnly ) || !editor.load( &in ) ||
+				!out.open( IO_WriteOnly ) || !editor.save( &out, LogicEditor::BinaryFormat ) ){
+				qWarning( "No se puede convertir %s", lem.latin1() );
+				return 1;
+			}
+		}
+
+		int xmlParse = parseXml( lem ), binParse = parseBinary( lmb );
+		int xmlLoad = loadEditor( lem, false ), binLoad = loadEditor( lmb, true );
+
+		qDebug( "%5d rplicas (%8d / %8d bytes):", *it, (int)QFileInfo( lem ).size(), (int)QFileInfo( lmb ).size() );
+		qDebug( "  lectura: .lem %6d ms, .lmb %6d ms (%s)", xmlParse, binParse, ratio( xmlParse, binParse ).latin1() );
+		qDebug( "  carga:   .lem %6d ms, .lmb %6d ms (%s)", xmlLoad, binLoad, ratio( xmlLoad, binLoad ).latin1() );
+
+		if( binParse * 10 > xmlParse )
+			parseTarget = false;
+		if( binLoad * 10 > xmlLoad )
+			loadTarget = false;
+
+		QFile::remove( lem );
+		QFile::remove( lmb );
+	}
+
+	qDebug( "Objetivo 10x: lectura %s, carga completa %s",
+			parseTarget ? "alcanzado" : "NO alcanzado", loadTarget ? "alcanzado" : "NO alcanzado" );
+	return 0;
+}
@@ -0,0 +1,302 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// tst_LEBinaryModel.cpp: pruebas del formato binario de modelos (.lmb).
+//
+//	Comprueba que LEBinaryModel lee exactamente lo que escribe (cadenas
+//	nulas, vacas y no ASCII, buses y derivaciones, modelos vacos), que
+//	rechaza ficheros truncados o con referencias fuera de rango, y que la
+//	conversin .lem -> .lmb -> .lem de Example/Model01.lem (con cables de
+//	bus aadidos) no pierde informacin.
+//	Se enlaza con Application, LogicEditor, LEBinaryModel, los items LE*,
+//	las libreras LM* y sus dependencias. Se ejecuta desde la raz del
+//	proyecto. Devuelve 0 si todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qstringlist.h>
+#include <qregexp.h>
+#include <string.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEBinaryModel.h"
+#include "LEConnectionPoint.h"
+#include "LEPin.h"
+#include "LMComponent.h"
+
+Application * app;
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+static QString tempFile( const QString & name )
+{
+	return QDir::temp().filePath( name );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Formato
+//////////////////////////////////////////////////////////////////////
+
+static bool writeModel( const LEBinaryModel & model, const QString & fileName )
+{
+	QFile file( fileName );
+	return file.open( IO_WriteOnly ) && model.write( &file );
+}
+
+// Escritura y lectura de todos los campos
+static void testRecords()
+{
+	QString fileName = tempFile( "tst_LEBinaryModel.lmb" );
+	QString unicode = QString::fromUtf8( "se\xc3\xb1" "al_\xc3\xa1" );
+
+	LEBinaryModel out;
+	out.setModelName( unicode );
+	out.addDevice( "INV1", "INV", "Seleccion", QRect( -10, 20, 41, 41 ) );
+	out.addDevice( QString::null, "AND2", "Seleccion", QRect( 300, 400, 91, 101 ) );
+	out.addDevice( "", "Input", "I/O", QRect( 0, 0, 18, 11 ) );
+
+	QPointArray points;
+	points.putPoints( 0, 3, 1,2, 3,4, -5,-6 );
+	out.addWireLine( "W1", "INV1.I", QString::null, points );
+	out.addWireLine( "BUS", "A.Q", "B.D", points, 8, -1 );
+	out.addWireLine( "TAP", "BUS", "C.I", QPointArray(), 8, 3 );
+	check( writeModel( out, fileName ), "escritura" );
+
+	LEBinaryModel in;
+	check( in.map( fileName ), "lectura" );
+	check( in.modelName() == unicode, "nombre del modelo no ASCII" );
+
+	check( in.deviceCount() == 3, "nmero de dispositivos" );
+	if( in.deviceCount() == 3 ){
+		const LEBinaryModel::DeviceRecord & d0 = in.device( 0 );
+		check( in.string( d0.name ) == "INV1" && in.string( d0.component ) == "INV" && in.string( d0.library ) == "Seleccion",
+			   "cadenas del dispositivo" );
+		check( d0.x == -10 && d0.y == 20 && d0.width == 41 && d0.height == 41, "geometra del dispositivo" );
+		check( in.device( 1 ).name == -1 && in.string( in.device( 1 ).name ).isNull(), "nombre nulo" );
+		check( in.string( in.device( 2 ).name ).isEmpty() && !in.string( in.device( 2 ).name ).isNull(), "nombre vaco" );
+		check( in.device( 0 ).library == in.device( 1 ).library, "cadenas sin repeticiones" );
+	}
+
+	check( in.wireLineCount() == 3, "nmero de cables" );
+	if( in.wireLineCount() == 3 ){
+		const LEBinaryModel::WireLineRecord & w0 = in.wireLine( 0 );
+		check( in.string( w0.leftConnection ) == "INV1.I" && in.string( w0.rightConnection ).isNull(), "extremos del cable" );
+		check( in.vertexs( w0 ) == points, "vrtices del cable" );
+		check( w0.busWidth == 1 && w0.sliceOffset == -1, "cable escalar" );
+		check( in.wireLine( 1 ).busWidth == 8 && in.wireLine( 1 ).sliceOffset == -1, "bus" );
+		check( in.wireLine( 2 ).busWidth == 8 && in.wireLine( 2 ).sliceOffset == 3, "derivacin" );
+		check( in.vertexs( in.wireLine( 2 ) ).isEmpty(), "cable sin vrtices" );
+	}
+
+	// Modelo vaco
+	LEBinaryModel empty, emptyIn;
+	check( writeModel( empty, fileName ), "escritura del modelo vaco" );
+	check( emptyIn.map( fileName ), "lectura del modelo vaco" );
+	check( emptyIn.deviceCount() == 0 && emptyIn.wireLineCount() == 0 && emptyIn.modelName().isNull(), "modelo vaco" );
+
+	QFile::remove( fileName );
+}
+
+// Ficheros daados: todo truncamiento y toda referencia a vrtices o
+// cadenas fuera de su seccin se rechazan
+static void testCorrupt()
+{
+	QString fileName = tempFile( "tst_LEBinaryModel.lmb" );
+	QString damaged = tempFile( "tst_LEBinaryModel_damaged.lmb" );
+
+	LEBinaryModel out;
+	out.setModelName( "M" );
+	out.addDevice( "D", "INV", "Seleccion", QRect( 0, 0, 1, 1 ) );
+	QPointArray points;
+	points.putPoints( 0, 2, 0,0, 10,0 );
+	out.addWireLine( "W", "D.I", "D.O", points );
+	check( writeModel( out, fileName ), "escritura" );
+
+	QFile file( fileName );
+	file.open( IO_ReadOnly );
+	QByteArray data = file.readAll();
+	file.close();
+
+	LEBinaryModel in;
+	for( uint size=0; size < data.size(); size++ ){
+		QFile f( damaged );
+		f.open( IO_WriteOnly );
+		f.writeBlock( data.data(), size );
+		f.close();
+		if( in.map( damaged ) ){
+			check( false, QString( "fichero truncado a %1 bytes aceptado" ).arg( size ) );
+			break;
+		}
+	}
+
+	// Cada entero de la cabecera y de las secciones con valores extremos:
+	// el fichero se rechaza o se lee sin salirse de la proyeccin
+	for( uint offset=12; offset + 4 <= data.size(); offset += 4 ){
+		Q_INT32 values[] = { -1, 0x7fffffff, 0x40000000 };
+		for( int v=0; v < 3; v++ ){
+			QByteArray copy = data.copy();
+			memcpy( copy.data() + offset, &values[v], 4 );
+
+			QFile f( damaged );
+			f.open( IO_WriteOnly );
+			f.writeBlock( copy );
+			f.close();
+
+			if( in.map( damaged ) ){
+				for( int i=0; i < in.deviceCount(); i++ )
+					in.string( in.device( i ).name );
+				for( int i=0; i < in.wireLineCount(); i++ )
+					in.vertexs( in.wireLine( i ) );
+			}
+		}
+	}
+
+	in.unmap();
+	QFile::remove( fileName );
+	QFile::remove( damaged );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Conversin .lem <-> .lmb
+//////////////////////////////////////////////////////////////////////
+
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 10000, 10000 );
+		setCanvas( canvas );
+	}
+};
+
+static QString endOf( LEConnectionPoint * cp )
+{
+	if( !cp || !cp->parent() )
+		return "-";
+	return cp->parent()->resolvName();
+}
+
+// Descripcin cannica del modelo (ordenada)
+static QStringList describe( LogicEditor & editor )
+{
+	QStringList lines;
+	lines.append( "M " + QString( editor.name() ) );
+
+	QCanvasItemList items = editor.canvas()->allItems();
+	for( QCanvasItemList::iterator it = items.begin(); it != items.end(); ++it )
+		if( (*it)->rtti() == LEDevice::RTTI ){
+			LEDevice * dev = (LEDevice*)*it;
+			lines.append( QString( "D %1 %2 %3 %4,%5 %6x%7" ).arg( dev->name() )
+						  .arg( dev->componentReference()->parentLibrary()->name() )
+						  .arg( dev->componentReference()->name() )
+						  .arg( dev->x() ).arg( dev->y() ).arg( dev->width() ).arg( dev->height() ) );
+		}else if( (*it)->rtti() == LEWireLine::RTTI ){
+			LEWireLine * wl = (LEWireLine*)*it;
+			QString points;
+			for( int i=0; i < wl->vertexCount(); i++ )
+				points += QString( "%1,%2 " ).arg( wl->vertex( i ).x() ).arg( wl->vertex( i ).y() );
+			lines.append( QString( "W %1 %2 %3 %4 %5 %6" ).arg( wl->name() )
+						  .arg( endOf( wl->leftConnection() ) ).arg( endOf( wl->rightConnection() ) )
+						  .arg( wl->busWidth() ).arg( wl->sliceOffset() ).arg( points ) );
+		}
+
+	lines.sort();
+	return lines;
+}
+
+static bool loadFile( LogicEditor & editor, const QString & fileName )
+{
+	if( fileName.endsWith( LogicEditor::modelExtension( LogicEditor::BinaryFormat ) ) )
+		return editor.loadBinary( fileName );
+
+	QFile file( fileName );
+	return file.open( IO_ReadOnly ) && editor.load( &file );
+}
+
+static bool saveFile( LogicEditor & editor, const QString & fileName, LogicEditor::ModelFormat format )
+{
+	QFile file( fileName );
+	return file.open( IO_WriteOnly ) && editor.save( &file, format );
+}
+
+static void testConversion()
+{
+	QString lmb = tempFile( "tst_Model01.lmb" ), lem = tempFile( "tst_Model01.lem" );
+
+	TestEditor source;
+	check( loadFile( source, "Example/Model01.lem" ), "carga de Example/Model01.lem" );
+
+	// Cables de bus y derivaciones (Model01 slo tiene cables escalares)
+	int i = 0;
+	QCanvasItemList items = source.canvas()->allItems();
+	for( QCanvasItemList::iterator it = items.begin(); it != items.end(); ++it )
+		if( (*it)->rtti() == LEWireLine::RTTI && i++ % 3 == 0 ){
+			((LEWireLine*)*it)->setBusWidth( 8 );
+			((LEWireLine*)*it)->setSliceOffset( i % 2 ? 2 : -1 );
+		}
+
+	QStringList expected = describe( source );
+	check( expected.grep( QRegExp( "^W " ) ).count() > 0, "modelo sin cables" );
+
+	// .lem -> .lmb
+	check( saveFile( source, lmb, LogicEditor::BinaryFormat ), "escritura .lmb" );
+	TestEditor binary;
+	check( loadFile( binary, lmb ), "carga .lmb" );
+	check( describe( binary ) == expected, ".lem -> .lmb pierde informacin" );
+
+	// .lmb -> .lem
+	check( saveFile( binary, lem, LogicEditor::XmlFormat ), "escritura .lem" );
+	TestEditor xml;
+	check( loadFile( xml, lem ), "carga .lem" );
+	check( describe( xml ) == expected, ".lmb -> .lem pierde informacin" );
+
+	QFile::remove( lmb );
+	QFile::remove( lem );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	testRecords();
+	testCorrupt();
+	testConversion();
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
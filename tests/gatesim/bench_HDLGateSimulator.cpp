@@ -0,0 +1,364 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_HDLGateSimulator.cpp: medida y pruebas de HDLGateSimulator.
+//
+//	Simula dos modelos y comprueba sus salidas con las esperadas:
+//
+//	  - libsrc/miXOR.lem, ledo sin editor (HDLModelReader) contra las
+//	    libreras con las que se dibuj (I/O con pins i/o y Estandar con
+//	    And2, Or2 e Inv, ver libsrc/miXOR.sig y libsrc/*.vhd), que se
+//	    declaran en memoria.
+//	  - Una interfaz generada con los mdulos ID* (funciones de seleccin
+//	    de 6 y 14 bits con INV, NAND2/4/8 y OR2/OR3, un decodificador MUX2)
+//	    ms un Registro8bits y un Buffer8bits de lib/datos.clb.
+//
+//	Informa de los eventos por segundo de cada simulacin.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM*, los mdulos ID*, HDLModelReader, HDLModelGraph, HDLModelSnapshot y
+//	HDLGateSimulator. Se ejecuta desde la raz del proyecto (usa
+//	libsrc/miXOR.lem y las libreras de lib). Devuelve 0 si todas las
+//	pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEDevice.h"
+#include "LEPin.h"
+#include "LibraryManager.h"
+#include "LMComponent.h"
+#include "HDLModelReader.h"
+#include "HDLModelGraph.h"
+#include "HDLModelSnapshot.h"
+#include "HDLGateSimulator.h"
+#include "IDInterfaceSelectorFunction.h"
+#include "IDPortSelectorMux.h"
+
+Application * app;
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador pseudoaleatorio determinista
+static unsigned int seed = 12345;
+static unsigned int rnd()
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 16 ) & 0x7fff;
+}
+
+static char bit( unsigned int value, int i )
+{
+	return ( value >> i ) & 1 ? '1' : '0';
+}
+
+static void report( const char * what, unsigned long events, int ms )
+{
+	qDebug( "%s: %lu eventos en %d ms (%.0f eventos/s)", what, events, ms,
+			ms > 0 ? 1000.0 * events / ms : 0.0 );
+}
+
+//////////////////////////////////////////////////////////////////////
+// miXOR
+//////////////////////////////////////////////////////////////////////
+
+static void addComponent( LibraryManager & libs, LMLibrary * lib, const QString & name,
+						  const QStringList & inputs, const QString & output )
+{
+	LMComponent cmp( lib );
+	cmp.setName( name );
+	cmp.shapeList().append( QPointArray( QRect( 0, 0, 60, 40 ) ) );
+
+	QStringList::const_iterator it;
+	for( it = inputs.begin(); it != inputs.end(); ++it )
+		cmp.pinList().append( LMPinDescription( *it, LEPin::Input, LEPin::Left ) );
+	if( !output.isNull() )
+		cmp.pinList().append( LMPinDescription( output, LEPin::Output, LEPin::Right ) );
+
+	libs.insertComponent( lib, cmp );
+}
+
+static void testXOR()
+{
+	// Libreras con las que se dibuj el modelo
+	LibraryManager libs;
+	LMLibrary * io = libs.createLibrary( "I/O", LMLibrary::None, QString::null );
+	addComponent( libs, io, "Input", QStringList( "i" ), QString::null );
+	addComponent( libs, io, "Output", QStringList( "o" ), QString::null );
+
+	LMLibrary * estandar = libs.createLibrary( "Estandar", LMLibrary::HDL, "estandar" );
+	addComponent( libs, estandar, "And2", QStringList::split( ' ', "A B" ), "C" );
+	addComponent( libs, estandar, "Or2", QStringList::split( ' ', "A B" ), "C" );
+	addComponent( libs, estandar, "Inv", QStringList( "I" ), "O" );
+
+	HDLModelGraph graph;
+	HDLModelReader reader( libs, graph );
+	check( reader.readFile( "libsrc/miXOR.lem" ), "lectura de libsrc/miXOR.lem" );
+
+	HDLModelSnapshot snapshot;
+	check( snapshot.capture( "miXOR", graph ), "captura de miXOR" );
+
+	HDLGateSimulator sim;
+	if( !sim.load( snapshot ) ){
+		check( false, "carga de miXOR: " + sim.errorString() );
+		return;
+	}
+
+	// Tabla de verdad
+	for( unsigned int v=0; v < 4; v++ ){
+		SignalValues inputs, outputs;
+		inputs.insert( "A_i", bit( v, 0 ) );
+		inputs.insert( "B_i", bit( v, 1 ) );
+		outputs.insert( "C_o", 'U' );
+
+		check( sim.simulate( inputs, outputs ) && outputs["C_o"] == bit( v ^ ( v >> 1 ), 0 ),
+			   QString( "miXOR con A=%1 B=%2" ).arg( bit( v, 0 ) ).arg( bit( v, 1 ) ) );
+	}
+
+	// Eventos por segundo con vectores aleatorios
+	sim.reset();
+	QTime t;
+	t.start();
+	for( int i=0; i < 200000; i++ ){
+		unsigned int v = rnd();
+		sim.force( "A_i", bit( v, 0 ) );
+		sim.force( "B_i", bit( v, 1 ) );
+		sim.run();
+	}
+	report( "miXOR, 200000 vectores", sim.eventCount(), t.elapsed() );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Interfaz generada
+//////////////////////////////////////////////////////////////////////
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 10000, 10000 );
+		setCanvas( canvas );
+	}
+};
+
+static LEConnectionPoint * pin( LogicEditor & editor, LEDevice * dev, const QString & pinName )
+{
+	return dev ? editor.resolveConnection( QString( "%1%2%3" ).arg( dev->name() ).arg( ITEM_NAME_SEPARATOR ).arg( pinName ) ) : 0;
+}
+
+static bool connect( LogicEditor & editor, LEConnectionPoint * cp1, LEConnectionPoint * cp2 )
+{
+	return cp1 && cp2 && editor.createWireLine( cp1, cp2 );
+}
+
+// Funcin de seleccin de la direccin pattern (length bits, ADDRi es el
+// bit length-1-i) que habilita un decodificador MUX2 (entradas PORTi,
+// salidas Si), y un registro CLK/Di con su buffer triestado OE/Qi
+static bool buildInterface( LogicEditor & editor, unsigned int pattern, unsigned int length )
+{
+	LibraryManager & libs = app->libraryManager();
+	LMComponent * input = libs.findComponent( "I/O:Input" );
+	LMComponent * output = libs.findComponent( "I/O:Output" );
+	LMComponent * reg = libs.findComponent( "Datos:Registro8bits" );
+	LMComponent * buf = libs.findComponent( "Datos:Buffer8bits" );
+	if( !input || !output || !reg || !buf )
+		return false;
+
+	// La funcin de seleccin compara el patrn desde su bit 31
+	IDInterfaceSelectorFunction sel( pattern << ( 32 - length ), length );
+	IDPortSelectorMux mux( 2 );
+	if( !sel.create( &editor, 200, 40 ) || !mux.create( &editor, 800, 40 ) )
+		return false;
+
+	bool ok = true;
+	unsigned int i;
+
+	editor.beginBatch();
+	for( i=0; i < length; i++ ){
+		LEDevice * dev = editor.placeDevice( input, QString( "ADDR%1" ).arg( i ), QPoint( 20, 40 + 45*i ) );
+		ok = ok && connect( editor, pin( editor, dev, "I" ), sel.in( i ) );
+	}
+	ok = ok && connect( editor, sel.out(), mux.enable() );
+
+	for( i=0; i < mux.inCount(); i++ ){
+		LEDevice * dev = editor.placeDevice( input, QString( "PORT%1" ).arg( i ), QPoint( 700, 200 + 45*i ) );
+		ok = ok && connect( editor, pin( editor, dev, "I" ), mux.in( i ) );
+	}
+	for( i=0; i < mux.outCount(); i++ ){
+		LEDevice * dev = editor.placeDevice( output, QString( "S%1" ).arg( i ), QPoint( 1000, 40 + 45*i ) );
+		ok = ok && connect( editor, mux.out( i ), pin( editor, dev, "O" ) );
+	}
+
+	LEDevice * devReg = editor.placeDevice( reg, "REG", QPoint( 200, 1200 ) );
+	LEDevice * devBuf = editor.placeDevice( buf, "BUF", QPoint( 200, 1500 ) );
+	LEDevice * clk = editor.placeDevice( input, "CLK", QPoint( 20, 1250 ) );
+	LEDevice * oe = editor.placeDevice( input, "OE", QPoint( 20, 1550 ) );
+	ok = ok && connect( editor, pin( editor, clk, "I" ), pin( editor, devReg, "CLK" ) );
+	ok = ok && connect( editor, pin( editor, oe, "I" ), pin( editor, devBuf, "OE" ) );
+
+	for( i=0; i < 8; i++ ){
+		QString k = QString::number( i );
+		LEDevice * d = editor.placeDevice( input, "D" + k, QPoint( 200 + 30*i, 1100 ) );
+		LEDevice * q = editor.placeDevice( output, "Q" + k, QPoint( 200 + 30*i, 1700 ) );
+		ok = ok && connect( editor, pin( editor, d, "I" ), pin( editor, devReg, "I" + k ) );
+		ok = ok && connect( editor, pin( editor, devReg, "O" + k ), pin( editor, devBuf, "I" + k ) );
+		ok = ok && connect( editor, pin( editor, devBuf, "O" + k ), pin( editor, q, "O" ) );
+	}
+	editor.endBatch();
+
+	return ok;
+}
+
+// Valor de las salidas Qi como byte ('U', 'Z'... si alguna no es 0 o 1)
+static QString outputsQ( const HDLGateSimulator & sim )
+{
+	QString q;
+	for( int i=7; i >= 0; i-- )
+		q += sim.value( QString( "Q%1_O" ).arg( i ) );
+	return q;
+}
+
+static QString byteString( unsigned int value )
+{
+	QString s;
+	for( int i=7; i >= 0; i-- )
+		s += bit( value, i );
+	return s;
+}
+
+static void setByte( HDLGateSimulator & sim, unsigned int value )
+{
+	for( int i=0; i < 8; i++ )
+		sim.force( QString( "D%1_I" ).arg( i ), bit( value, i ) );
+}
+
+static void testInterface( unsigned int pattern, unsigned int length )
+{
+	QString what = QString( "interfaz de %1 bits" ).arg( length );
+
+	TestEditor editor;
+	if( !buildInterface( editor, pattern, length ) ){
+		check( false, "generacin de la " + what );
+		return;
+	}
+
+	HDLModelSnapshot snapshot;
+	check( snapshot.capture( "interfaz", &editor ), "captura de la " + what );
+
+	HDLGateSimulator sim;
+	if( !sim.load( snapshot ) ){
+		check( false, "carga de la " + what + ": " + sim.errorString() );
+		return;
+	}
+
+	// Registro8bits y Buffer8bits: captura en el flanco de subida de CLK,
+	// salidas en alta impedancia con OE a nivel alto
+	sim.force( "CLK_I", '0' );
+	sim.force( "OE_I", '1' );
+	setByte( sim, 0x5a );
+	sim.run();
+	check( outputsQ( sim ) == "ZZZZZZZZ", what + ": buffer deshabilitado" );
+
+	sim.force( "OE_I", '0' );
+	sim.run();
+	check( outputsQ( sim ) == "UUUUUUUU", what + ": registro sin cargar" );
+
+	sim.force( "CLK_I", '1' );
+	sim.run();
+	check( outputsQ( sim ) == byteString( 0x5a ), what + ": carga del registro" );
+
+	setByte( sim, 0xa5 );
+	sim.run();
+	check( outputsQ( sim ) == byteString( 0x5a ), what + ": registro estable sin flanco" );
+
+	sim.force( "CLK_I", '0' );
+	sim.run();
+	check( outputsQ( sim ) == byteString( 0x5a ), what + ": registro estable en el flanco de bajada" );
+
+	sim.force( "CLK_I", '1' );
+	sim.run();
+	check( outputsQ( sim ) == byteString( 0xa5 ), what + ": segunda carga del registro" );
+
+	sim.force( "OE_I", '1' );
+	sim.run();
+	check( outputsQ( sim ) == "ZZZZZZZZ", what + ": buffer deshabilitado de nuevo" );
+
+	// Seleccin (INV, NAND-n y OR-n, activa a nivel bajo) y decodificador:
+	// todas las direcciones y puertos
+	sim.reset();
+	int errors = 0;
+	QTime t;
+	t.start();
+	for( unsigned int addr=0; addr < ( 1u << length ); addr++ ){
+		for( unsigned int i=0; i < length; i++ )
+			sim.force( QString( "ADDR%1_I" ).arg( i ), bit( addr, length - 1 - i ) );
+
+		for( unsigned int port=0; port < 4; port++ ){
+			sim.force( "PORT0_I", bit( port, 0 ) );
+			sim.force( "PORT1_I", bit( port, 1 ) );
+			sim.run();
+
+			for( unsigned int s=0; s < 4; s++ ){
+				char expected = ( addr == pattern && s == port ) ? '1' : '0';
+				if( sim.value( QString( "S%1_O" ).arg( s ) ) != expected && errors++ < 10 )
+					check( false, what + QString( ": S%1 con direccin %2 y puerto %3" ).arg( s ).arg( addr ).arg( port ) );
+			}
+		}
+	}
+	int ms = t.elapsed();
+	check( errors == 0, what + QString( ": %1 salidas errneas" ).arg( errors ) );
+
+	report( QString( "%1, %2 vectores" ).arg( what ).arg( 4 << length ).latin1(), sim.eventCount(), ms );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	testXOR();
+
+	// NAND4 + NAND2 -> OR2 y NAND8 + NAND4 + NAND2 -> OR3, con patrones
+	// que mezclan bits a 0 (con inversor) y a 1
+	testInterface( 0x2d, 6 );
+	testInterface( 0x2b5c, 14 );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,337 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// tst_HDLJobScheduler.cpp: pruebas de HDLJobScheduler.
+//
+//	Se ejecutan contra los vlib/vcom simulados de este directorio (o del
+//	indicado como primer argumento), puestos en el PATH de los procesos
+//	con setEnvironment(), de forma que no hace falta ModelSim. Cada prueba
+//	reconstruye a partir del registro de los guiones el orden y la
+//	simultaneidad de los trabajos.
+//	Se enlaza con HDLJobScheduler, HDLProcess y HDLBuildState (y sus moc).
+//	Devuelve 0 si todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <qdatetime.h>
+#include <qfileinfo.h>
+#include <qfile.h>
+#include <qdir.h>
+#include <qtextstream.h>
+#include <qmap.h>
+#include <stdlib.h>
+
+#include "HDLJobScheduler.h"
+#include "HDLProcess.h"
+
+extern char ** environ;
+
+static QString stubDir;
+static QString workDir;
+static QString logFile;
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Entorno y trabajos
+//////////////////////////////////////////////////////////////////////
+
+// Entorno de la aplicacin con los guiones simulados al principio del
+// PATH y el registro en STUB_LOG
+static QStringList stubEnvironment()
+{
+	QStringList env;
+	QString path = stubDir;
+
+	for( char ** var = environ; *var; var++ ){
+		QString entry = QString::fromLocal8Bit( *var );
+		if( entry.startsWith( "PATH=" ) )
+			path += ":" + entry.mid( 5 );
+		else if( !entry.startsWith( "STUB_" ) )
+			env.append( entry );
+	}
+
+	env.append( "PATH=" + path );
+	env.append( "STUB_LOG=" + logFile );
+	env.append( "STUB_DELAY=0.3" );
+	return env;
+}
+
+static void newScheduler( HDLJobScheduler & scheduler, int workers )
+{
+	QFile::remove( logFile );
+	scheduler.setWorkers( workers );
+	scheduler.setEnvironment( stubEnvironment() );
+}
+
+// vlib sobre la librera lib (su fallo es tolerable, como en Project)
+static int addVlib( HDLJobScheduler & scheduler, const QString & lib )
+{
+	QString path = QDir( workDir ).filePath( lib );
+	return scheduler.addJob( new HDLProcLibBuilder( path, &scheduler, "vlib" ), "vlib " + lib, false );
+}
+
+// vcom de target.vhd en la librera lib, con el cerrojo de la librera
+static int addVcom( HDLJobScheduler & scheduler, const QString & target, const QString & lib )
+{
+	QString source = QDir( workDir ).filePath( target + ".vhd" );
+	QFile file( source );
+	if( file.open( IO_WriteOnly ) ){
+		QTextStream ts( &file );
+		ts << "-- " << target << "\n";
+	}
+
+	QString path = QDir( workDir ).filePath( lib );
+	int job = scheduler.addJob( new HDLProcCompiler( QStringList( source ), path, &scheduler, "vcom" ), "vcom " + target );
+	scheduler.setJobLock( job, path );
+	return job;
+}
+
+// Ejecuta el grafo hasta que terminan todos los trabajos
+static bool run( HDLJobScheduler & scheduler, int ms=20000 )
+{
+	if( !scheduler.start() )
+		return false;
+
+	QTime t;
+	t.start();
+	while( scheduler.isRunning() && t.elapsed() < ms )
+		qApp->processEvents( 50 );
+
+	// Destruccin de los procesos terminados (deleteLater)
+	qApp->processEvents( 50 );
+
+	return !scheduler.isRunning();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Registro de los guiones
+//////////////////////////////////////////////////////////////////////
+
+struct Trace
+{
+	QMap<QString, int> starts, ends;	// Lnea del registro de cada evento
+	int maxRunning;
+	QMap<QString, int> maxRunningPerLib;
+
+	bool started( const QString & target ) const { return starts.contains( target ); }
+
+	// a termin antes de que empezase b
+	bool before( const QString & a, const QString & b ) const
+	{
+		return ends.contains( a ) && starts.contains( b ) && ends[a] < starts[b];
+	}
+};
+
+static Trace readTrace()
+{
+	Trace trace;
+	trace.maxRunning = 0;
+
+	QMap<QString, int> runningPerLib;
+	int running = 0, line = 0;
+
+	QFile file( logFile );
+	if( !file.open( IO_ReadOnly ) )
+		return trace;
+
+	QTextStream ts( &file );
+	QString text;
+	while( !( text = ts.readLine() ).isNull() ){
+		QStringList fields = QStringList::split( ' ', text );
+		if( fields.count() != 3 )
+			continue;
+
+		if( fields[0] == "start" ){
+			trace.starts[ fields[1] ] = line;
+			running++;
+			runningPerLib[ fields[2] ]++;
+			trace.maxRunning = QMAX( trace.maxRunning, running );
+			trace.maxRunningPerLib[ fields[2] ] = QMAX( trace.maxRunningPerLib[ fields[2] ], runningPerLib[ fields[2] ] );
+		}else{
+			trace.ends[ fields[1] ] = line;
+			running--;
+			runningPerLib[ fields[2] ]--;
+		}
+		line++;
+	}
+
+	return trace;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pruebas
+//////////////////////////////////////////////////////////////////////
+
+// Cada trabajo empieza despus de que terminen todos aquellos de los que
+// depende (cadena vlib -> vcom y rombo entre libreras)
+static void testDependencies()
+{
+	HDLJobScheduler scheduler;
+	newScheduler( scheduler, 4 );
+
+	int libA = addVlib( scheduler, "liba" );
+	int libB = addVlib( scheduler, "libb" );
+	int a = addVcom( scheduler, "a", "liba" );
+	int b = addVcom( scheduler, "b", "libb" );
+	int top = addVcom( scheduler, "top", "work" );
+	scheduler.addDependence( a, libA );
+	scheduler.addDependence( b, libB );
+	scheduler.addDependence( top, a );
+	scheduler.addDependence( top, b );
+
+	check( run( scheduler ), "dependencias: el grafo termina" );
+
+	Trace trace = readTrace();
+	check( trace.before( "liba", "a" ) && trace.before( "libb", "b" ), "vcom empieza tras su vlib" );
+	check( trace.before( "a", "top" ) && trace.before( "b", "top" ), "top empieza tras a y b" );
+	check( trace.maxRunning > 1, "los trabajos independientes se ejecutan a la vez" );
+
+	for( int i=0; i < scheduler.jobCount(); i++ )
+		check( scheduler.jobState( i ) == HDLJobScheduler::Succeeded, "dependencias: " + scheduler.jobLabel( i ) );
+}
+
+// Nunca hay ms procesos simultneos que el lmite fijado
+static void testWorkerLimit()
+{
+	HDLJobScheduler scheduler;
+	newScheduler( scheduler, 2 );
+
+	for( int i=0; i < 6; i++ )
+		addVcom( scheduler, QString( "w%1" ).arg( i ), QString( "lib%1" ).arg( i ) );
+
+	check( run( scheduler ), "lmite: el grafo termina" );
+
+	Trace trace = readTrace();
+	check( trace.starts.count() == 6, "lmite: se ejecutan todos los trabajos" );
+	check( trace.maxRunning == 2, QString( "lmite de 2 procesos (mximo simultneo: %1)" ).arg( trace.maxRunning ) );
+}
+
+// Los vcom de una misma librera se serializan aunque sean independientes
+// y haya procesos libres; los de otras libreras siguen en paralelo
+static void testLibraryLock()
+{
+	HDLJobScheduler scheduler;
+	newScheduler( scheduler, 4 );
+
+	for( int i=0; i < 4; i++ )
+		addVcom( scheduler, QString( "s%1" ).arg( i ), "shared" );
+	addVcom( scheduler, "o0", "other" );
+	addVcom( scheduler, "o1", "another" );
+
+	check( run( scheduler ), "cerrojo: el grafo termina" );
+
+	Trace trace = readTrace();
+	check( trace.starts.count() == 6, "cerrojo: se ejecutan todos los trabajos" );
+	check( trace.maxRunningPerLib["shared"] == 1, "un nico vcom a la vez sobre la misma librera" );
+	check( trace.maxRunning > 1, "las dems libreras se compilan en paralelo" );
+}
+
+// El fracaso de un trabajo cancela (transitivamente) a sus dependientes,
+// pero no a los independientes ni a los de un fracaso tolerable
+static void testFailure()
+{
+	HDLJobScheduler scheduler;
+	newScheduler( scheduler, 2 );
+
+	int vlib = addVlib( scheduler, "libfail" );		// Fracaso tolerable
+	int bad = addVcom( scheduler, "fail", "liba" );
+	int child = addVcom( scheduler, "child", "liba" );
+	int grandChild = addVcom( scheduler, "grandchild", "work" );
+	int afterVlib = addVcom( scheduler, "aftervlib", "libfail" );
+	int independent = addVcom( scheduler, "independent", "libb" );
+	scheduler.addDependence( child, bad );
+	scheduler.addDependence( grandChild, child );
+	scheduler.addDependence( afterVlib, vlib );
+
+	check( run( scheduler ), "fracaso: el grafo termina" );
+
+	Trace trace = readTrace();
+	check( scheduler.jobState( bad ) == HDLJobScheduler::Failed, "el trabajo que falla" );
+	check( scheduler.jobState( child ) == HDLJobScheduler::Cancelled && !trace.started( "child" ), "dependiente cancelado" );
+	check( scheduler.jobState( grandChild ) == HDLJobScheduler::Cancelled && !trace.started( "grandchild" ), "dependiente indirecto cancelado" );
+	check( scheduler.jobState( vlib ) == HDLJobScheduler::Succeeded, "fracaso tolerable de vlib" );
+	check( scheduler.jobState( afterVlib ) == HDLJobScheduler::Succeeded, "dependiente de un fracaso tolerable" );
+	check( scheduler.jobState( independent ) == HDLJobScheduler::Succeeded, "trabajo independiente" );
+}
+
+// Los trabajos de un ciclo, y los que dependen de l, se cancelan sin
+// ejecutarse; el resto del grafo se ejecuta
+static void testCycle()
+{
+	HDLJobScheduler scheduler;
+	newScheduler( scheduler, 2 );
+
+	int a = addVcom( scheduler, "cyclea", "liba" );
+	int b = addVcom( scheduler, "cycleb", "libb" );
+	int c = addVcom( scheduler, "cyclec", "libc" );
+	int dependent = addVcom( scheduler, "oncycle", "work" );
+	int outside = addVcom( scheduler, "outside", "libd" );
+	scheduler.addDependence( a, c );
+	scheduler.addDependence( b, a );
+	scheduler.addDependence( c, b );
+	scheduler.addDependence( dependent, b );
+
+	check( run( scheduler ), "ciclo: el grafo termina" );
+
+	Trace trace = readTrace();
+	check( scheduler.jobState( a ) == HDLJobScheduler::Cancelled &&
+		   scheduler.jobState( b ) == HDLJobScheduler::Cancelled &&
+		   scheduler.jobState( c ) == HDLJobScheduler::Cancelled, "trabajos del ciclo cancelados" );
+	check( scheduler.jobState( dependent ) == HDLJobScheduler::Cancelled, "dependiente del ciclo cancelado" );
+	check( !trace.started( "cyclea" ) && !trace.started( "cycleb" ) &&
+		   !trace.started( "cyclec" ) && !trace.started( "oncycle" ), "el ciclo no se ejecuta" );
+	check( scheduler.jobState( outside ) == HDLJobScheduler::Succeeded && trace.started( "outside" ), "trabajo fuera del ciclo" );
+}
+
+int main( int argc, char ** argv )
+{
+	QApplication app( argc, argv, FALSE );
+
+	if( argc > 1 )
+		stubDir = QDir( argv[1] ).absPath();
+	else
+		stubDir = QFileInfo( argv[0] ).dir( true ).absPath();
+
+	QDir temp = QDir::temp();
+	temp.mkdir( "tst_HDLJobScheduler" );
+	workDir = temp.filePath( "tst_HDLJobScheduler" );
+	logFile = QDir( workDir ).filePath( "stub.log" );
+
+	// QProcess busca el programa en el PATH de la aplicacin, no en el del
+	// entorno indicado: los guiones se ponen tambin al principio de ste
+	setenv( "PATH", QString( stubDir + ":" + getenv( "PATH" ) ).local8Bit(), 1 );
+
+	testDependencies();
+	testWorkerLimit();
+	testLibraryLock();
+	testFailure();
+	testCycle();
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,298 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_LibraryManager.cpp: medida y pruebas de los ndices de libreras.
+//
+//	Genera cuatro libreras de 2000 componentes cada una (la mitad de los
+//	nombres se repite en la librera siguiente) y un modelo con 50000
+//	dispositivos que las instancian. Comprueba que LibraryManager y
+//	LMLibrary resuelven cada nombre ('COMPONENTE' y 'LIBRERIA:COMPONENTE')
+//	igual que la bsqueda lineal anterior, que las copias de LMLibrary
+//	reconstruyen su ndice, y mide las bsquedas y la carga del modelo.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM* y sus dependencias. Devuelve 0 si todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+#include <qptrlist.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LibraryManager.h"
+#include "LMLibrary.h"
+#include "LMComponent.h"
+
+Application * app;
+
+enum { Libraries = 4, Components = 2000, Devices = 50000 };
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador pseudoaleatorio determinista
+static unsigned int seed = 12345;
+static unsigned int rnd()
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 16 ) & 0x7fff;
+}
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 40000, 40000 );
+		setCanvas( canvas );
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Ficheros generados
+//////////////////////////////////////////////////////////////////////
+
+static QString libraryName( int lib )
+{
+	return QString( "Bench%1" ).arg( lib );
+}
+
+// La librera lib contiene los componentes C<lib*Components/2> ...
+static QString componentName( int lib, int cmp )
+{
+	return "C" + QString::number( lib*Components/2 + cmp ).rightJustify( 5, '0' );
+}
+
+static bool writeLibrary( int lib, const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly | IO_Truncate ) )
+		return false;
+
+	QTextStream ts( &file );
+	ts << "<library name=\"" << libraryName( lib ) << "\" version=\"1.0\" srcType=\"HDL\">\n";
+	for( int i=0; i < Components; i++ ){
+		ts << "  <component name=\"" << componentName( lib, i ) << "\">\n";
+		ts << "    <shape>0 0 40 0 40 40 0 40 0 0</shape>\n";
+		ts << "    <pin name=\"O\" accessmode=\"output\" alignment=\"Right\"></pin>\n";
+		for( int k=0; k < 1 + i % 3; k++ )
+			ts << "    <pin name=\"I" << k << "\" accessmode=\"input\" alignment=\"Left\"></pin>\n";
+		ts << "  </component>\n";
+	}
+	ts << "</library>\n";
+
+	return true;
+}
+
+static bool writeModel( const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly | IO_Truncate ) )
+		return false;
+
+	QTextStream ts( &file );
+	ts << "<model name=\"Bench\">\n";
+	for( int i=0; i < Devices; i++ ){
+		int lib = rnd() % Libraries;
+		ts << "  <device name=\"D" << i << "\" template=\"" << componentName( lib, rnd() % Components )
+		   << "\" library=\"" << libraryName( lib ) << "\" offset=\""
+		   << 60*( i % 500 ) << "x" << 60*( i / 500 ) << "\"></device>\n";
+	}
+	ts << "</model>\n";
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Bsqueda lineal anterior a los ndices
+//////////////////////////////////////////////////////////////////////
+
+static LMComponent * linearFind( LMLibrary * lib, const QString & compName )
+{
+	for( LMLibrary::iterator it = lib->begin(); it != lib->end(); ++it )
+		if( (*it).name() == compName )
+			return &(*it);
+	return 0;
+}
+
+static LMComponent * linearFindComponent( QPtrList<LMLibrary> & libs, const QString & name )
+{
+	int sep = name.find( ':' );
+	QString libName = ( sep != -1 ) ? name.left( sep ) : QString::null;
+	QString compName = ( sep != -1 ) ? name.mid( sep + 1 ) : name;
+
+	for( LMLibrary * lib = libs.first(); lib; lib = libs.next() ){
+		if( !libName.isNull() ){
+			if( lib->name() == libName )
+				return linearFind( lib, compName );
+			continue;
+		}
+
+		LMComponent * cmp = linearFind( lib, compName );
+		if( cmp )
+			return cmp;
+	}
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pruebas
+//////////////////////////////////////////////////////////////////////
+
+// Nombres consultados: con y sin librera, incluidos algunos inexistentes
+static QStringList queries()
+{
+	QStringList names;
+	for( int i=0; i < Devices; i++ ){
+		int lib = rnd() % Libraries;
+		QString cmp = componentName( lib, rnd() % ( Components + 100 ) );
+		names.append( ( i % 2 ) ? cmp : libraryName( ( lib + i % 3 ) % Libraries ) + ":" + cmp );
+	}
+	return names;
+}
+
+static void testLookups( LibraryManager & manager, QPtrList<LMLibrary> & libs )
+{
+	QStringList names = queries();
+	QStringList::iterator it;
+
+	int errors = 0;
+	for( it = names.begin(); it != names.end(); ++it )
+		if( manager.findComponent( *it ) != linearFindComponent( libs, *it ) && errors++ < 10 )
+			check( false, "resolucin de " + *it );
+	check( errors == 0, QString( "%1 nombres resueltos de forma distinta" ).arg( errors ) );
+
+	for( LMLibrary * lib = libs.first(); lib; lib = libs.next() )
+		check( manager.find( lib->name() ) == lib, "librera " + lib->name() );
+	check( !manager.find( "NoExiste" ), "librera inexistente" );
+
+	QTime t;
+	t.start();
+	int found = 0;
+	for( it = names.begin(); it != names.end(); ++it )
+		if( manager.findComponent( *it ) )
+			found++;
+	int msHash = t.elapsed();
+
+	t.restart();
+	for( it = names.begin(); it != names.end(); ++it )
+		if( linearFindComponent( libs, *it ) )
+			found--;
+	int msLinear = t.elapsed();
+
+	check( found == 0, "nmero de componentes encontrados" );
+	qDebug( "%d bsquedas: %d ms con ndices, %d ms con bsqueda lineal", names.count(), msHash, msLinear );
+}
+
+// Las copias de una librera resuelven sobre sus propios componentes
+static void testCopies( LMLibrary * lib )
+{
+	QString name = componentName( 0, Components - 1 );
+	LMComponent * original = lib->find( name );
+	check( original != 0, "bsqueda en la librera original" );
+
+	LMLibrary copy( *lib );
+	LMComponent * copied = copy.find( name );
+	check( copied && copied != original && copied->name() == name, "bsqueda en una copia" );
+	check( copy.name() == lib->name() && copy.sourceType() == lib->sourceType(), "atributos de una copia" );
+
+	LMLibrary assigned;
+	check( !assigned.find( name ), "bsqueda en una librera vaca" );
+	assigned = *lib;
+	copied = assigned.find( name );
+	check( copied && copied != original && copied->name() == name, "bsqueda en una librera asignada" );
+
+	assigned = LMLibrary();
+	check( !assigned.find( name ), "bsqueda tras asignar una librera vaca" );
+}
+
+static void testLoad( const QString & fileName )
+{
+	TestEditor editor;
+
+	QFile file( fileName );
+	check( file.open( IO_ReadOnly ), "apertura de " + fileName );
+
+	QTime t;
+	t.start();
+	check( editor.load( &file ), "carga de " + fileName );
+	int ms = t.elapsed();
+
+	int missing = 0;
+	for( int i=0; i < Devices; i++ )
+		if( !editor.findItem( QString( "D%1" ).arg( i ) ) )
+			missing++;
+	check( missing == 0, QString( "%1 dispositivos sin cargar" ).arg( missing ) );
+
+	qDebug( "Carga de %d dispositivos con %d libreras de %d componentes: %d ms",
+			(int)Devices, (int)Libraries, (int)Components, ms );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QPtrList<LMLibrary> libs;
+	QStringList files;
+	int i;
+
+	QTime t;
+	t.start();
+	for( i=0; i < Libraries; i++ ){
+		QString fileName = QDir::temp().filePath( QString( "bench_%1.clb" ).arg( libraryName( i ) ) );
+		files.append( fileName );
+		check( writeLibrary( i, fileName ), "generacin de " + fileName );
+
+		LMLibrary * lib = a.libraryManager().loadLibrary( fileName );
+		check( lib != 0, "carga de " + fileName );
+		if( lib )
+			libs.append( lib );
+	}
+	qDebug( "Carga de %d libreras de %d componentes: %d ms", (int)Libraries, (int)Components, t.elapsed() );
+
+	QString modelName = QDir::temp().filePath( "bench_LibraryManager.lem" );
+	files.append( modelName );
+	check( writeModel( modelName ), "generacin de " + modelName );
+
+	if( (int)libs.count() == Libraries ){
+		testLookups( a.libraryManager(), libs );
+		testCopies( libs.first() );
+		testLoad( modelName );
+	}
+
+	for( QStringList::iterator it = files.begin(); it != files.end(); ++it )
+		QFile::remove( *it );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_HDLModelGraph.cpp: memoria por pin del grafo y de los items LE*.
+//
+//	Genera un modelo de 20000 dispositivos (NAND8 y Registro8bits
+//	encadenados por cables) y mide la memoria dinmica que ocupa:
+//
+//	  - ledo sin editor en un HDLModelGraph (HDLModelReader);
+//	  - cargado en un editor (items LE*, netlist y tablas del editor);
+//	  - el grafo vivo del editor (HDLLiveGraph) al consultarlo.
+//
+//	Informa de los bytes por pin de cada representacin y de la relacin
+//	entre el editor y el grafo. Comprueba que el grafo ledo del fichero y
+//	el del editor tienen los mismos dispositivos, pins, cables y pins
+//	conectados.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM*, HDLModelReader y HDLModelGraph. Se ejecuta desde la raz del
+//	proyecto (usa las libreras de lib). Devuelve 0 si todas las
+//	comprobaciones pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qstringlist.h>
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#endif
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEPin.h"
+#include "LELabel.h"
+#include "LEConnectionPoint.h"
+#include "HDLModelReader.h"
+#include "HDLModelGraph.h"
+
+Application * app;
+
+enum { Devices = 20000 };
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Bytes de memoria dinmica en uso (-1 si no se conoce)
+static long heapInUse()
+{
+#ifdef Q_OS_LINUX
+	return mallinfo().uordblks;
+#else
+	return -1;
+#endif
+}
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 40000, 40000 );
+		setCanvas( canvas );
+	}
+};
+
+// Dispositivos alternos NAND8 y Registro8bits: la salida de cada uno se
+// conecta a una entrada del siguiente
+static bool writeModel( const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly | IO_Truncate ) )
+		return false;
+
+	QTextStream ts( &file );
+	ts << "<model name=\"Memoria\">\n";
+	for( int i=0; i < Devices; i++ ){
+		bool reg = ( i % 2 == 1 );
+		ts << "\t<device name=\"D" << i << "\" template=\"" << ( reg ? "Registro8bits" : "NAND8" )
+		   << "\" library=\"" << ( reg ? "Datos" : "Seleccion" ) << "\" offset=\""
+		   << 300*( i % 100 ) << "x" << 200*( i / 100 ) << "\"></device>\n";
+	}
+	for( int i=1; i < Devices; i++ ){
+		QString out = ( i % 2 == 1 ) ? "O" : "O0";
+		ts << "\t<wireline name=\"W" << i << "\" leftConnection=\"D" << i-1 << "." << out
+		   << "\" rightConnection=\"D" << i << ".I" << ( i % 8 ) << "\"></wireline>\n";
+	}
+	ts << "</model>\n";
+
+	return true;
+}
+
+static double perPin( long bytes, int pins )
+{
+	return ( bytes >= 0 && pins > 0 ) ? (double)bytes / pins : -1.0;
+}
+
+static int connectedPins( const HDLModelGraph & graph )
+{
+	int connected = 0;
+	for( int i=0; i < graph.pinCount(); i++ )
+		if( graph.pinNet( i ) != -1 )
+			connected++;
+	return connected;
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	QString fileName = QDir::temp().filePath( "bench_HDLModelGraph.lem" );
+	check( writeModel( fileName ), "generacin de " + fileName );
+
+	qDebug( "sizeof: LEItem %d, LEPin %d, LELabel %d, LEConnectionPoint %d bytes",
+			(int)sizeof(LEItem), (int)sizeof(LEPin), (int)sizeof(LELabel), (int)sizeof(LEConnectionPoint) );
+
+	// Grafo ledo sin editor
+	long before = heapInUse();
+	HDLModelGraph * graph = new HDLModelGraph;
+	{
+		HDLModelReader reader( a.libraryManager(), *graph );
+		check( reader.readFile( fileName ), "lectura de " + fileName );
+	}
+	long graphBytes = heapInUse() - before;
+	int pins = graph->pinCount();
+	check( graph->deviceCount() == Devices, "dispositivos del grafo ledo" );
+
+	// Editor (el lienzo vaco se crea antes de medir)
+	TestEditor * editor = new TestEditor;
+	before = heapInUse();
+	QFile file( fileName );
+	check( file.open( IO_ReadOnly ) && editor->load( &file ), "carga de " + fileName );
+	file.close();
+	long editorBytes = heapInUse() - before;
+
+	before = heapInUse();
+	const HDLModelGraph & live = editor->modelGraph();
+	long liveBytes = heapInUse() - before;
+
+	check( live.deviceCount() == graph->deviceCount() && live.pinCount() == pins &&
+		   live.wireCount() == graph->wireCount(), "mismo nmero de dispositivos, pins y cables" );
+	check( connectedPins( live ) == connectedPins( *graph ) && connectedPins( *graph ) == 2*( Devices - 1 ),
+		   "mismos pins conectados en el editor y en el grafo ledo" );
+
+	if( before < 0 )
+		qDebug( "%d pins: memoria dinmica no disponible en esta plataforma", pins );
+	else{
+		double graphPin = perPin( graphBytes, pins ), editorPin = perPin( editorBytes, pins );
+		qDebug( "%d pins:", pins );
+		qDebug( "  grafo ledo del fichero: %8.1f bytes/pin", graphPin );
+		qDebug( "  editor (items LE*):      %8.1f bytes/pin", editorPin );
+		qDebug( "  grafo vivo del editor:   %8.1f bytes/pin", perPin( liveBytes, pins ) );
+		qDebug( "  relacin editor/grafo:   %8.1fx (objetivo 10x)", graphPin > 0 ? editorPin / graphPin : 0.0 );
+	}
+
+	delete editor;
+	delete graph;
+	QFile::remove( fileName );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
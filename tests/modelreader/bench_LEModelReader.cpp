@@ -0,0 +1,354 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_LEModelReader.cpp: medida y pruebas de la carga de modelos.
+//
+//	Genera copias ampliadas de Example/Model01.lem (1, 10, 100 y 1000
+//	rplicas del circuito) en las que la mitad de las rplicas escriben
+//	sus cables antes que sus dispositivos. Comprueba que la carga SAX
+//	(LEModelReader) y la carga DOM anterior producen los mismos
+//	dispositivos, cables y redes, y mide el tiempo de carga y la memoria
+//	mxima (VmHWM) de cada lector en un proceso independiente.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM* y sus dependencias. Se ejecuta desde la raz del proyecto (usa
+//	Example/Model01.lem y las libreras de lib). Devuelve 0 si todas las
+//	comprobaciones pasan.
+//
+//	Uso: bench_LEModelReader
+//	     bench_LEModelReader -measure sax|dom modelo.lem   (un nico lector)
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qregexp.h>
+#include <qdom.h>
+#include <qxml.h>
+#include <qtextstream.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+#include <stdlib.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEConnectionPoint.h"
+#include "LEPin.h"
+#include "LMComponent.h"
+
+Application * app;
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Memoria residente mxima del proceso en KB (-1 si no se conoce)
+static int peakRSS()
+{
+#ifdef Q_OS_LINUX
+	QFile status( "/proc/self/status" );
+	if( status.open( IO_ReadOnly ) ){
+		QTextStream ts( &status );
+		QString line;
+		while( !( line = ts.readLine() ).isNull() )
+			if( line.startsWith( "VmHWM:" ) )
+				return line.mid( 6 ).stripWhiteSpace().section( ' ', 0, 0 ).toInt();
+	}
+#endif
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Lectores
+//////////////////////////////////////////////////////////////////////
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 40000, 40000 );
+		setCanvas( canvas );
+	}
+};
+
+static QXmlAttributes attributesOf( const QDomElement & element )
+{
+	QXmlAttributes atts;
+	QDomNamedNodeMap map = element.attributes();
+	for( uint i=0; i < map.length(); i++ ){
+		QDomAttr attr = map.item( i ).toAttr();
+		atts.append( attr.name(), QString::null, attr.name(), attr.value() );
+	}
+	return atts;
+}
+
+// Carga DOM anterior a LEModelReader: el documento completo en memoria,
+// un recorrido para los dispositivos y otro para los cables
+static bool loadDOM( LogicEditor & editor, QIODevice * device )
+{
+	QDomDocument doc;
+	if( !doc.setContent( device, true ) )
+		return false;
+
+	QDomElement root = doc.documentElement();
+	if( root.tagName().lower() != "model" )
+		return false;
+
+	editor.setName( root.attribute( "name", editor.name() ) );
+
+	QDomNode node;
+	for( node = root.firstChild(); !node.isNull(); node = node.nextSibling() )
+		if( node.toElement().tagName().lower() == "device" )
+			editor.parseDevice( attributesOf( node.toElement() ) );
+
+	for( node = root.firstChild(); !node.isNull(); node = node.nextSibling() )
+		if( node.toElement().tagName().lower() == "wireline" )
+			editor.parseWireLine( attributesOf( node.toElement() ) );
+
+	return true;
+}
+
+static bool load( LogicEditor & editor, const QString & fileName, bool dom )
+{
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) )
+		return false;
+
+	return dom ? loadDOM( editor, &file ) : editor.load( &file );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Netlist cargada
+//////////////////////////////////////////////////////////////////////
+
+static QString pointsOf( LEWireLine * wl )
+{
+	QString s;
+	for( int i=0; i < wl->vertexCount(); i++ )
+		s += QString( "%1,%2 " ).arg( wl->vertex( i ).x() ).arg( wl->vertex( i ).y() );
+	return s;
+}
+
+static QString endOf( LEConnectionPoint * cp )
+{
+	if( !cp || !cp->parent() )
+		return "-";
+	return cp->parent()->resolvName();
+}
+
+// Descripcin cannica del modelo: dispositivos, cables (con sus extremos
+// y vrtices) y redes (pins de cada red), ordenados
+static QStringList describe( LogicEditor & editor )
+{
+	QStringList devices, wires, nets;
+	QMap<int, QStringList> netPins;
+
+	QCanvasItemList items = editor.canvas()->allItems();
+	for( QCanvasItemList::iterator it = items.begin(); it != items.end(); ++it )
+		if( (*it)->rtti() == LEDevice::RTTI ){
+			LEDevice * dev = (LEDevice*)*it;
+			devices.append( QString( "D %1 %2 %3,%4 %5x%6" ).arg( dev->name() )
+							.arg( dev->componentReference() ? dev->componentReference()->name() : QString( "?" ) )
+							.arg( dev->x() ).arg( dev->y() ).arg( dev->width() ).arg( dev->height() ) );
+
+			QPtrList<LEPin> & pins = dev->pinList();
+			for( LEPin * pin = pins.first(); pin; pin = pins.next() ){
+				int n = editor.netlist().net( pin->connectionPoint() );
+				if( n != -1 )
+					netPins[n].append( pin->resolvName() );
+			}
+		}else if( (*it)->rtti() == LEWireLine::RTTI ){
+			LEWireLine * wl = (LEWireLine*)*it;
+			wires.append( QString( "W %1 %2 %3 %4" ).arg( wl->name() )
+						  .arg( endOf( wl->leftConnection() ) ).arg( endOf( wl->rightConnection() ) ).arg( pointsOf( wl ) ) );
+		}
+
+	for( QMap<int, QStringList>::iterator itNet = netPins.begin(); itNet != netPins.end(); ++itNet ){
+		itNet.data().sort();
+		nets.append( "N " + itNet.data().join( " " ) );
+	}
+
+	devices.sort();
+	wires.sort();
+	nets.sort();
+	return devices + wires + nets;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Modelos ampliados
+//////////////////////////////////////////////////////////////////////
+
+static QString shiftPoints( const QString & points, int dx, int dy )
+{
+	QStringList coords = QStringList::split( ' ', points );
+	QString s;
+	for( uint i=0; i + 1 < coords.count(); i += 2 )
+		s += QString( "%1 %2 " ).arg( coords[i].toInt() + dx ).arg( coords[i+1].toInt() + dy );
+	return s;
+}
+
+static QString shiftPoint( const QString & point, int dx, int dy )
+{
+	QPoint p = LogicEditor::parsePoint( point );
+	return QString( "%1x%2" ).arg( p.x() + dx ).arg( p.y() + dy );
+}
+
+static QString renamed( const QString & cnnct, const QString & prefix )
+{
+	if( cnnct.isEmpty() || cnnct == "null" )
+		return cnnct;
+	return prefix + cnnct;
+}
+
+static void writeElement( QTextStream & ts, const QString & tag, const QDomElement & elem, const QString & prefix, int dx, int dy )
+{
+	ts << "\t<" << tag;
+
+	QDomNamedNodeMap map = elem.attributes();
+	for( uint i=0; i < map.length(); i++ ){
+		QDomAttr attr = map.item( i ).toAttr();
+		QString value = attr.value();
+
+		if( attr.name() == "name" )
+			value = prefix + value;
+		else if( attr.name() == "leftConnection" || attr.name() == "rightConnection" )
+			value = renamed( value, prefix );
+		else if( attr.name() == "offset" )
+			value = shiftPoint( value, dx, dy );
+		else if( attr.name() == "points" )
+			value = shiftPoints( value, dx, dy );
+
+		ts << " " << attr.name() << "=\"" << value << "\"";
+	}
+
+	ts << "></" << tag << ">\n";
+}
+
+// Rplicas del modelo en una rejilla. Las rplicas impares escriben sus
+// cables antes que sus dispositivos (extremos an no cargados)
+static bool scaleModel( const QString & source, int copies, const QString & target )
+{
+	QFile in( source );
+	QDomDocument doc;
+	if( !in.open( IO_ReadOnly ) || !doc.setContent( &in ) )
+		return false;
+
+	QFile out( target );
+	if( !out.open( IO_WriteOnly ) )
+		return false;
+
+	QTextStream ts( &out );
+	QDomElement root = doc.documentElement();
+	QDomNodeList devices = root.elementsByTagName( "device" );
+	QDomNodeList wires = root.elementsByTagName( "wireline" );
+
+	ts << "<model name=\"" << root.attribute( "name" ) << copies << "\">\n";
+	for( int k=0; k < copies; k++ ){
+		QString prefix = QString( "K%1_" ).arg( k );
+		int dx = ( k % 40 ) * 900, dy = ( k / 40 ) * 500;
+
+		for( int pass=0; pass < 2; pass++ ){
+			bool writeWires = ( pass == 0 ) == ( k % 2 == 1 );
+			QDomNodeList & list = writeWires ? wires : devices;
+			for( uint i=0; i < list.count(); i++ )
+				writeElement( ts, writeWires ? "wireline" : "device", list.item( i ).toElement(), prefix, dx, dy );
+		}
+	}
+	ts << "</model>\n";
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pruebas y medida
+//////////////////////////////////////////////////////////////////////
+
+// Medida de un nico lector (en su propio proceso, para aislar VmHWM)
+static int measure( const QString & reader, const QString & fileName )
+{
+	int before = peakRSS();
+	QTime t;
+	t.start();
+
+	TestEditor editor;
+	if( !load( editor, fileName, reader == "dom" ) ){
+		qWarning( "Error cargando %s", fileName.latin1() );
+		return 1;
+	}
+
+	int ms = t.elapsed();
+	qDebug( "  %s: %6d ms, VmHWM %7d KB (%+d KB)", reader.latin1(), ms, peakRSS(), peakRSS() - before );
+	return 0;
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	if( argc == 4 && QString( argv[1] ) == "-measure" )
+		return measure( argv[2], argv[3] );
+
+	int sizes[] = { 1, 10, 100, 1000 };
+	for( int i=0; i < 4; i++ ){
+		QString fileName = QDir::temp().filePath( QString( "bench_Model01_x%1.lem" ).arg( sizes[i] ) );
+		if( !scaleModel( "Example/Model01.lem", sizes[i], fileName ) ){
+			check( false, "no se puede generar " + fileName );
+			continue;
+		}
+
+		// Ambas cargas producen la misma netlist
+		{
+			TestEditor sax, dom;
+			check( load( sax, fileName, false ), "carga SAX de " + fileName );
+			check( load( dom, fileName, true ), "carga DOM de " + fileName );
+
+			QStringList saxModel = describe( sax ), domModel = describe( dom );
+			check( saxModel.count() > 0 && saxModel == domModel,
+				   QString( "SAX y DOM difieren en %1 rplicas" ).arg( sizes[i] ) );
+			check( saxModel.grep( QRegExp( "^W \\S+ (\\S+ )?- " ) ).isEmpty(),
+				   QString( "cables sin conectar en %1 rplicas" ).arg( sizes[i] ) );
+		}
+
+		qDebug( "%d rplicas (%d bytes):", sizes[i], (int)QFileInfo( fileName ).size() );
+		for( int r=0; r < 2; r++ ){
+			QString cmd = QString( "\"%1\" -measure %2 \"%3\"" ).arg( argv[0] ).arg( r ? "dom" : "sax" ).arg( fileName );
+			check( system( cmd.local8Bit() ) == 0, "medida de " + fileName );
+		}
+
+		QFile::remove( fileName );
+	}
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
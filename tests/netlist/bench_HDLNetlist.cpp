@@ -0,0 +1,278 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_HDLNetlist.cpp: medida y pruebas de la extraccin de redes.
+//
+//	Genera lienzos sintticos de 1000 a 100000 cables (redes de pocos
+//	cables entre puntos de conexin de pines, ms algunas redes grandes
+//	como las de reloj) y compara la construccin de HDLNetlist con el
+//	recorrido por pin que haca HDLGenerator::buildSignals. Comprueba que
+//	ambos dan las mismas redes, tambin tras eliminar cables.
+//	Se enlaza con HDLNetlist, los items LE* y sus dependencias. Devuelve 0 si
+//	todas las comprobaciones pasan.
+//
+//	Uso: bench_HDLNetlist [cables...]   (por omisin 1000 10000 100000)
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <qcanvas.h>
+#include <qdatetime.h>
+#include <qptrdict.h>
+#include <qvaluevector.h>
+
+#include "HDLNetlist.h"
+#include "LEConnectionPoint.h"
+#include "LEWireLine.h"
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador determinista (los lienzos se repiten en cada ejecucin)
+static Q_UINT32 seed = 12345;
+static Q_UINT32 rnd( Q_UINT32 n )
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 8 ) % n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Lienzo sinttico
+//////////////////////////////////////////////////////////////////////
+
+// Puntos de conexin de pines, puntos de bifurcacin y cables. Los
+// enlaces punto-punto simulan los pines de dispositivos duplicados
+struct Canvas
+{
+	QValueVector<LEConnectionPoint*> pins;
+	QValueVector<LEWireLine*> wires;
+	int links;
+};
+
+static LEConnectionPoint * newPoint( QCanvas * canvas )
+{
+	LEConnectionPoint * cp = new LEConnectionPoint( canvas );
+	cp->move( rnd( canvas->width() ), rnd( canvas->height() ) );
+	return cp;
+}
+
+static LEWireLine * newWire( QCanvas * canvas, LEConnectionPoint * left, LEConnectionPoint * right )
+{
+	LEWireLine * wl = new LEWireLine( canvas );
+	wl->insertVertex( left->x(), left->y() );
+	wl->insertVertex( right->x(), right->y() );
+	wl->connectLeft( left );
+	wl->connectRight( right );
+	return wl;
+}
+
+// Redes de 1 a 8 cables en rbol sobre pines y bifurcaciones; una de cada
+// 500 redes es grande (hasta 2000 cables). Aproximadamente uno de cada 50
+// pines se enlaza con el pin de otra red
+static void generate( QCanvas * canvas, int wireCount, Canvas & c )
+{
+	c.links = 0;
+
+	while( (int)c.wires.count() < wireCount ){
+		int size = rnd( 500 ) ? 1 + rnd( 8 ) : 200 + rnd( 1800 );
+		QValueVector<LEConnectionPoint*> net;
+
+		net.push_back( newPoint( canvas ) );
+		c.pins.push_back( net[0] );
+
+		for( int i=0; i < size && (int)c.wires.count() < wireCount; i++ ){
+			LEConnectionPoint * from = net[ rnd( net.count() ) ];
+			LEConnectionPoint * to = newPoint( canvas );
+			if( rnd( 3 ) )
+				c.pins.push_back( to );
+			net.push_back( to );
+			c.wires.push_back( newWire( canvas, from, to ) );
+		}
+	}
+
+	for( int i=0; i < (int)c.pins.count() / 50; i++ ){
+		LEConnectionPoint * a = c.pins[ rnd( c.pins.count() ) ];
+		LEConnectionPoint * b = c.pins[ rnd( c.pins.count() ) ];
+		if( a != b && !a->connectionList().containsRef( b ) ){
+			a->setConnection( b );
+			b->setConnection( a );
+			c.links++;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Extraccin
+//////////////////////////////////////////////////////////////////////
+
+// Pasada de HDLGenerator::buildSignals: uniones de cables y enlaces
+static void buildNetlist( QCanvas * canvas, HDLNetlist & netlist )
+{
+	QCanvasItemList items = canvas->allItems();
+	for( QCanvasItemList::iterator it = items.begin(); it != items.end(); ++it )
+		if( (*it)->rtti() == LEWireLine::RTTI )
+			netlist.insertWireLine( (LEWireLine*)*it );
+		else if( (*it)->rtti() == LEConnectionPoint::RTTI ){
+			LEConnectionPoint * cp = (LEConnectionPoint*)*it;
+			for( LEItem * item = cp->connectionList().first(); item; item = cp->connectionList().next() )
+				if( item->rtti() == LEConnectionPoint::RTTI )
+					netlist.insertLink( cp, (LEConnectionPoint*)item );
+		}
+}
+
+// Recorrido por pin anterior a HDLNetlist: exploracin del grafo de cables
+// desde el pin con listas de nodos activos y visitados. A diferencia del
+// original, sigue los enlaces punto-punto de todos los nodos y no slo
+// del pin de partida (las redes de HDLNetlist incluyen esos enlaces).
+// Devuelve los cables alcanzados
+static QPtrList<LEWireLine> walk( LEConnectionPoint * pin, const QPtrDict<LEWireLine> & removed )
+{
+	QPtrList<LEWireLine> reached;
+	QPtrList<LEConnectionPoint> activeNodes;
+	QPtrList<LEConnectionPoint> oldNodes;
+
+	activeNodes.append( pin );
+	while( !activeNodes.isEmpty() ){
+		LEConnectionPoint * cp = activeNodes.take();
+		ConnectionList & cnncts = cp->connectionList();
+
+		for( LEItem * item = cnncts.first(); item; item = cnncts.next() ){
+			LEConnectionPoint * next = 0;
+
+			if( item->rtti() == LEWireLine::RTTI ){
+				LEWireLine * wl = (LEWireLine*)item;
+				if( removed.find( wl ) )
+					continue;
+
+				if( !reached.containsRef( wl ) )
+					reached.append( wl );
+
+				next = ( cp == wl->leftConnection() ) ? wl->rightConnection() : wl->leftConnection();
+			}else if( item->rtti() == LEConnectionPoint::RTTI )
+				next = (LEConnectionPoint*)item;
+
+			if( next && !oldNodes.containsRef( next ) && !activeNodes.containsRef( next ) )
+				activeNodes.append( next );
+		}
+
+		oldNodes.append( cp );
+	}
+
+	return reached;
+}
+
+// Las redes de la netlist y las del recorrido por pin coinciden: los
+// cables alcanzados desde cada pin son exactamente los de su red
+static void compare( Canvas & c, HDLNetlist & netlist, const QPtrDict<LEWireLine> & removed, const QString & what )
+{
+	// Tamao de cada red en cables
+	QMap<int, int> netSizes;
+	for( uint i=0; i < c.wires.count(); i++ )
+		if( !removed.find( c.wires[i] ) )
+			netSizes[ netlist.net( c.wires[i] ) ]++;
+
+	int errors = 0;
+	for( uint i=0; i < c.pins.count() && errors < 10; i++ ){
+		QPtrList<LEWireLine> reached = walk( c.pins[i], removed );
+		int n = netlist.net( c.pins[i] );
+
+		bool same = ( reached.isEmpty() || n != -1 ) && (int)reached.count() == ( n == -1 ? 0 : netSizes[n] );
+		for( LEWireLine * wl = reached.first(); wl && same; wl = reached.next() )
+			same = netlist.net( wl ) == n;
+
+		if( !same )
+			errors++;
+	}
+
+	check( errors == 0, what + ": las redes difieren del recorrido por pin" );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Medida
+//////////////////////////////////////////////////////////////////////
+
+static void run( int wireCount )
+{
+	QCanvas canvas( 20000, 20000 );
+	Canvas c;
+	generate( &canvas, wireCount, c );
+
+	// Extraccin con HDLNetlist y consulta de la red de cada pin
+	QTime t;
+	t.start();
+	HDLNetlist netlist;
+	buildNetlist( &canvas, netlist );
+	int connected = 0;
+	for( uint i=0; i < c.pins.count(); i++ )
+		if( netlist.net( c.pins[i] ) != -1 )
+			connected++;
+	int unionFind = t.elapsed();
+
+	// Recorrido por pin
+	QPtrDict<LEWireLine> removed( 20011 );
+	t.start();
+	int reached = 0;
+	for( uint i=0; i < c.pins.count(); i++ )
+		reached += walk( c.pins[i], removed ).count();
+	int perPin = t.elapsed();
+
+	qDebug( "%6d cables, %6d pines, %4d enlaces: union-find %5d ms, recorrido por pin %6d ms",
+			wireCount, c.pins.count(), c.links, unionFind, perPin );
+
+	check( connected > 0 && reached > 0, "lienzo sin redes" );
+	compare( c, netlist, removed, QString( "%1 cables" ).arg( wireCount ) );
+
+	// Eliminacin de un 10% de los cables: slo se recalculan sus redes
+	t.start();
+	for( uint i=0; i < c.wires.count() / 10; i++ ){
+		LEWireLine * wl = c.wires[ rnd( c.wires.count() ) ];
+		if( removed.find( wl ) )
+			continue;
+
+		netlist.removeWireLine( wl );
+		removed.insert( wl, wl );
+	}
+	qDebug( "%6d cables: eliminacin de %d cables %5d ms", wireCount, removed.count(), t.elapsed() );
+
+	compare( c, netlist, removed, QString( "%1 cables tras eliminar" ).arg( wireCount ) );
+}
+
+int main( int argc, char ** argv )
+{
+	QApplication app( argc, argv, FALSE );
+
+	QValueList<int> sizes;
+	for( int i=1; i < argc; i++ )
+		sizes.append( QString( argv[i] ).toInt() );
+	if( sizes.isEmpty() )
+		sizes << 1000 << 10000 << 100000;
+
+	for( QValueList<int>::iterator it = sizes.begin(); it != sizes.end(); ++it )
+		run( *it );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
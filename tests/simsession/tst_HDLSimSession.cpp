@@ -0,0 +1,155 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// tst_HDLSimSession.cpp: pruebas de HDLSimSession.
+//
+//	Se ejecutan contra el vsim simulado de este directorio (o el programa
+//	indicado como primer argumento), de forma que no hace falta ModelSim.
+//	Se enlaza con HDLSimSession, HDLProcess y HDLVectorTable (y sus moc).
+//	Devuelve 0 si todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <qdatetime.h>
+#include <qfileinfo.h>
+#include <qdir.h>
+
+#include "HDLSimSession.h"
+
+static QString stubProgram;
+static int failures = 0;
+
+static void check( bool condition, const char * what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what );
+		failures++;
+	}
+}
+
+// Procesa eventos durante ms milisegundos o hasta que no queden
+// simulaciones pendientes (si untilIdle)
+static void wait( HDLSimSession & session, int ms, bool untilIdle=TRUE )
+{
+	QTime t;
+	t.start();
+	while( t.elapsed() < ms && !( untilIdle && session.pendingCount() == 0 ) )
+		qApp->processEvents( 50 );
+}
+
+static bool simulateA( HDLSimSession & session, char value )
+{
+	SignalValues inputs, outputs;
+	inputs.insert( "a", value );
+	outputs.insert( "a", 'U' );
+
+	if( !session.simulate( inputs, outputs ) )
+		return false;
+
+	wait( session, 3000 );
+	return session.pendingCount() == 0 && session.outputSignals()["a"] == value;
+}
+
+// Varias simulaciones seguidas sobre el mismo proceso
+static void testSimulate()
+{
+	HDLSimSession session( "model", QStringList() );
+	session.setProgram( stubProgram );
+
+	check( session.open(), "open" );
+	check( simulateA( session, '1' ), "primera simulacin" );
+	check( simulateA( session, '0' ), "simulacin tras restart" );
+	check( session.isOpen(), "la sesin sigue abierta" );
+
+	session.close();
+}
+
+// Una sesin cerrada y abierta de nuevo no se termina al vencer el plazo
+// de terminacin forzada del proceso anterior
+static void testReopen()
+{
+	HDLSimSession session( "model", QStringList() );
+	session.setProgram( stubProgram );
+
+	check( session.open(), "open" );
+	check( simulateA( session, '1' ), "simulacin antes de cerrar" );
+
+	session.close();
+	check( session.open(), "reopen" );
+	check( simulateA( session, '0' ), "simulacin tras reabrir" );
+
+	wait( session, 6000, FALSE );
+	check( session.isOpen(), "la sesin reabierta sobrevive al plazo de cierre" );
+	check( simulateA( session, '1' ), "simulacin tras el plazo de cierre" );
+
+	session.close();
+}
+
+// Un simulador que no atiende "quit" se termina por la fuerza
+static void testKillOnClose()
+{
+	HDLSimSession session( "hang", QStringList() );
+	session.setProgram( stubProgram );
+
+	check( session.open(), "open" );
+	session.close();
+
+	wait( session, 6000, FALSE );
+	check( !session.isOpen(), "el proceso que no atiende quit se termina" );
+}
+
+// La simulacin que hace terminar al simulador falla y la sesin se relanza
+static void testCrash()
+{
+	HDLSimSession session( "model", QStringList() );
+	session.setProgram( stubProgram );
+
+	check( session.open(), "open" );
+
+	SignalValues inputs, outputs;
+	inputs.insert( "crash", '1' );
+	check( session.simulate( inputs, outputs ), "simulacin que termina el proceso" );
+	wait( session, 3000 );
+	check( session.pendingCount() == 0, "la simulacin fallida termina" );
+
+	wait( session, 500, FALSE );
+	check( session.isOpen(), "la sesin se relanza" );
+	check( simulateA( session, '1' ), "simulacin tras relanzar" );
+
+	session.close();
+}
+
+int main( int argc, char ** argv )
+{
+	QApplication app( argc, argv, FALSE );
+
+	if( argc > 1 )
+		stubProgram = argv[1];
+	else
+		stubProgram = QFileInfo( QFileInfo( argv[0] ).dir(), "vsim" ).absFilePath();
+
+	testSimulate();
+	testReopen();
+	testKillOnClose();
+	testCrash();
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,511 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_HDLModelSnapshot.cpp: medida y pruebas del volcado VHDL.
+//
+//	Compara la salida de HDLModelSnapshot::writeHDL y writeSignals (tablas
+//	indexadas por red y escritura en bloques) con la del emisor original
+//	de HDLGenerator, reproducido aqu sobre los items y la netlist del
+//	editor, para modelos escalares: Example/Model01.lem (tambin contra
+//	Example/vhdl/Model01.vhd y Example/sim/Model01.sig, sin tener en
+//	cuenta el orden de las lneas) y modelos generados de puertas de
+//	lib/seleccion.clb. Mide el caudal de ambos emisores en MB/s escribiendo
+//	en un fichero.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM*, HDLNetlist, HDLModelGraph y HDLModelSnapshot. Se ejecuta desde la
+//	raz del proyecto (usa Example y las libreras de lib). Devuelve 0 si
+//	todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+#include <qptrlist.h>
+#include <qmap.h>
+#include <qvaluevector.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEDevice.h"
+#include "LEWireLine.h"
+#include "LEPin.h"
+#include "LEConnectionPoint.h"
+#include "LMComponent.h"
+#include "HDLNetlist.h"
+#include "HDLModelSnapshot.h"
+
+Application * app;
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador pseudoaleatorio determinista
+static unsigned int seed = 12345;
+static unsigned int rnd()
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 16 ) & 0x7fff;
+}
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 40000, 40000 );
+		setCanvas( canvas );
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Emisor original (HDLGenerator::buildHDL y buildSignalsFile)
+//////////////////////////////////////////////////////////////////////
+
+typedef QMap<QString, LEItem*> SignalMapper;
+
+class BaselineEmitter
+{
+public:
+	BaselineEmitter( LogicEditor & editor );
+
+	bool buildHDL( const QString & entity, QTextOStream * dataOut );
+	bool buildSignalsFile( const QString & entity, QTextOStream * dataOut );
+
+private:
+	static LEItem * firstWireLine( LEPin * pin );
+	static const char * portMode( LEItem * portItem );
+
+	QPtrList<LEDevice> insts, extInsts;
+	SignalMapper sigs, extSigs;
+	QPtrList<LEItem> portExtSignals;
+	QPtrList<LMComponent> comps;
+};
+
+// Listas de instancias, seales, puerto y componentes (buildInstances,
+// buildSignals y buildDependences)
+BaselineEmitter::BaselineEmitter( LogicEditor & editor )
+{
+	HDLNetlist & netlist = editor.netlist();
+
+	QPtrList<LEDevice> devs = netlist.devices();
+	for( LEDevice * dev = devs.first(); dev; dev = devs.next() )
+		if( LogicEditor::extractDupNameIndex( dev->name() ) == -1 ){
+			if( dev->componentReference()->isExternSolving() )
+				extInsts.append( dev );
+			else
+				insts.append( dev );
+		}
+
+	QMap<int, LEItem*> extNets, intNets;
+	LEDevice * it;
+
+	for( it = extInsts.first(); it; it = extInsts.next() ){
+		QPtrList<LEPin> & lsPin = it->pinList();
+		for( LEPin * pin = lsPin.first(); pin; pin = lsPin.next() ){
+			int n = netlist.net( pin->connectionPoint() );
+			if( n != -1 && !extNets.contains( n ) )
+				extNets.insert( n, pin );
+		}
+	}
+
+	for( it = insts.first(); it; it = insts.next() ){
+		QPtrList<LEPin> & lsPin = it->pinList();
+		for( LEPin * pin = lsPin.first(); pin; pin = lsPin.next() ){
+			int n = netlist.net( pin->connectionPoint() );
+			if( n == -1 || extNets.contains( n ) || intNets.contains( n ) )
+				continue;
+
+			LEItem * wl = firstWireLine( pin );
+			if( wl )
+				intNets.insert( n, wl );
+		}
+	}
+
+	for( QPtrDictIterator<LEWireLine> itWl( netlist.wireLines() ); itWl.current(); ++itWl ){
+		LEWireLine * wl = itWl.current();
+		int n = netlist.net( wl );
+		if( n == -1 )
+			continue;
+
+		QMap<int, LEItem*>::iterator itNet = extNets.find( n );
+		if( itNet != extNets.end() )
+			extSigs.insert( wl->resolvName('_'), itNet.data() );
+		else{
+			itNet = intNets.find( n );
+			if( itNet != intNets.end() )
+				sigs.insert( wl->resolvName('_'), itNet.data() );
+		}
+	}
+
+	for( SignalMapper::iterator itSigs = extSigs.begin(); itSigs != extSigs.end(); ++itSigs )
+		if( !portExtSignals.contains( itSigs.data() ) )
+			portExtSignals.append( itSigs.data() );
+
+	for( LEDevice * dev = insts.first(); dev; dev = insts.next() ){
+		LMComponent * cmp = (LMComponent*)dev->componentReference();
+		if( !comps.contains( cmp ) )
+			comps.append( cmp );
+	}
+}
+
+LEItem * BaselineEmitter::firstWireLine( LEPin * pin )
+{
+	ConnectionList & cnncts = pin->connectionPoint()->connectionList();
+	for( LEItem * item = cnncts.first(); item; item = cnncts.next() )
+		if( item->rtti() == LEWireLine::RTTI )
+			return item;
+	return 0;
+}
+
+// Sentido del puerto de la entidad visto desde el pin externo
+const char * BaselineEmitter::portMode( LEItem * portItem )
+{
+	if( portItem->rtti() != LEPin::RTTI )
+		return "";
+
+	switch( ((LEPin*)portItem)->accessMode() ){
+	case LEPin::Input:
+		return "OUT";
+	case LEPin::Output:
+		return "IN";
+	default:
+		return "INOUT";
+	}
+}
+
+bool BaselineEmitter::buildHDL( const QString & entity, QTextOStream * dataOut )
+{
+	if( portExtSignals.count() <= 0 )
+		return false;
+
+	// ENTITY
+	*dataOut << "ENTITY " << entity << " IS\n";
+	LEItem * portItem = portExtSignals.first();
+	*dataOut << "\tPORT( " << portItem->resolvName('_') << " : " << portMode( portItem ) << " BIT";
+	for( portItem = portExtSignals.next(); portItem; portItem = portExtSignals.next() )
+		*dataOut << "; " << portItem->resolvName('_') << " : " << portMode( portItem ) << " BIT";
+	*dataOut << ");\nEND " << entity << ";\n\n";
+
+	// ARCHITECTURE
+	*dataOut << "ARCHITECTURE estructural OF " << entity << " IS\n";
+
+	for( LMComponent * cmp = comps.first(); cmp; cmp = comps.next() ){
+		*dataOut << "\tCOMPONENT " << cmp->name() << "\n";
+
+		PinList::iterator pinIt = cmp->pinList().begin();
+		for( ; pinIt != cmp->pinList().end(); ++pinIt ){
+			*dataOut << ( pinIt == cmp->pinList().begin() ? "\t\tPORT( " : "; " ) << (*pinIt).name() << " : ";
+			if( (*pinIt).accessMode() == LEPin::Input )
+				*dataOut << "IN";
+			else if( (*pinIt).accessMode() == LEPin::Output )
+				*dataOut << "OUT";
+			else
+				*dataOut << "INOUT";
+			*dataOut << " BIT";
+		}
+		*dataOut << ");\n\tEND COMPONENT;\n";
+	}
+	*dataOut << "\n";
+
+	// SIGNAL
+	if( sigs.count() > 0 ){
+		SignalMapper::iterator it = sigs.begin();
+		QString sigName = it.data()->resolvName('_');
+		*dataOut << "\tSIGNAL " << sigName;
+		for( ++it; it != sigs.end(); ++it )
+			if( it.data()->resolvName('_') != sigName ){
+				sigName = it.data()->resolvName('_');
+				*dataOut << ", " << sigName;
+			}
+		*dataOut << ": BIT;\n\n";
+	}
+
+	// BEGIN
+	*dataOut << "\tBEGIN\n";
+
+	for( LEDevice * lpDev = insts.first(); lpDev; lpDev = insts.next() ){
+		*dataOut << "\t\t" << lpDev->name() << " : " << lpDev->componentReference()->name() << " PORT MAP( ";
+
+		bool first = true;
+		for( LEPin * lpPin = lpDev->pinList().first(); lpPin; lpPin = lpDev->pinList().next(), first = false ){
+			LEItem * lpCnnct = firstWireLine( lpPin );
+			if( !lpCnnct )
+				continue;
+
+			// Primero se comprueba si est conectado a una seal externa
+			LEItem * sigItem = 0;
+			if( extSigs.contains( lpCnnct->name() ) )
+				sigItem = extSigs[ lpCnnct->name() ];
+			else if( sigs.contains( lpCnnct->name() ) )
+				sigItem = sigs[ lpCnnct->name() ];
+			if( !sigItem )
+				continue;
+
+			if( !first )
+				*dataOut << ", ";
+			*dataOut << sigItem->resolvName('_');
+		}
+
+		*dataOut << ");\n\n";
+	}
+
+	*dataOut << "END estructural;";
+
+	return true;
+}
+
+bool BaselineEmitter::buildSignalsFile( const QString & entity, QTextOStream * dataOut )
+{
+	if( portExtSignals.count() <= 0 )
+		return false;
+
+	*dataOut << "<signals entity=\"" << entity << "\">\n\n";
+
+	for( LEItem * portItem = portExtSignals.first(); portItem; portItem = portExtSignals.next() )
+		*dataOut << "\t<signal accessMode=\"" << portMode( portItem ) << "\">" << portItem->resolvName('_') << "</signal>\n";
+
+	*dataOut << "\n</signals>\n\n";
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Modelos
+//////////////////////////////////////////////////////////////////////
+
+// Modelo de gates puertas alimentadas por las inputs entradas del modelo
+// o por las salidas de puertas anteriores; las ltimas alimentan las
+// salidas. Los cables de cada excitador tienen nombres consecutivos para
+// que el emisor original no repita seales en SIGNAL
+static bool writeModel( const QString & fileName, int gates, int inputs )
+{
+	const char * types[] = { "INV", "AND2", "OR2", "NAND4" };
+	const char * outPins[] = { "O", "C", "O", "O" };
+	const int inCounts[] = { 1, 2, 2, 4 };
+	const int outputs = 8;
+
+	QFile file( fileName );
+	if( !file.open( IO_WriteOnly | IO_Truncate ) )
+		return false;
+
+	// Excitador de cada entrada de puerta y de cada salida
+	QValueVector<int> gateTypes( gates );
+	QMap<int, QStringList> fanout;		// Excitador -> pins que alimenta
+	int g, k;
+	for( g=0; g < gates; g++ ){
+		gateTypes[g] = rnd() % 4;
+		for( k=0; k < inCounts[ gateTypes[g] ]; k++ ){
+			int driver = rnd() % ( inputs + g );
+			fanout[driver].append( QString( "G%1.I%2" ).arg( g ).arg( gateTypes[g] == 0 ? QString::null : QString::number( k ) ) );
+		}
+	}
+	for( k=0; k < outputs; k++ )
+		fanout[ inputs + gates - 1 - k ].append( QString( "OUT%1.O" ).arg( k ) );
+
+	QTextStream ts( &file );
+	ts << "<model name=\"Puertas\">\n";
+	for( k=0; k < inputs; k++ )
+		ts << "\t<device name=\"IN" << k << "\" template=\"Input\" library=\"I/O\" offset=\"20x" << 40*k << "\"></device>\n";
+	for( g=0; g < gates; g++ )
+		ts << "\t<device name=\"G" << g << "\" template=\"" << types[ gateTypes[g] ] << "\" library=\"Seleccion\" offset=\""
+		   << 200 + 150*( g % 200 ) << "x" << 150*( g / 200 ) << "\"></device>\n";
+	for( k=0; k < outputs; k++ )
+		ts << "\t<device name=\"OUT" << k << "\" template=\"Output\" library=\"I/O\" offset=\"39000x" << 40*k << "\"></device>\n";
+
+	QMap<int, QStringList>::iterator it;
+	for( it = fanout.begin(); it != fanout.end(); ++it ){
+		int driver = it.key();
+		QString from = ( driver < inputs ) ? QString( "IN%1.I" ).arg( driver )
+										   : QString( "G%1.%2" ).arg( driver - inputs ).arg( outPins[ gateTypes[ driver - inputs ] ] );
+		for( k=0; k < (int)it.data().count(); k++ )
+			ts << "\t<wireline name=\"W" << QString::number( driver ).rightJustify( 6, '0' ) << "_" << k
+			   << "\" leftConnection=\"" << from << "\" rightConnection=\"" << it.data()[k] << "\"></wireline>\n";
+	}
+	ts << "</model>\n";
+
+	return true;
+}
+
+static bool load( LogicEditor & editor, const QString & fileName )
+{
+	QFile file( fileName );
+	return file.open( IO_ReadOnly ) && editor.load( &file );
+}
+
+static QString readFile( const QString & fileName )
+{
+	QFile file( fileName );
+	if( !file.open( IO_ReadOnly ) )
+		return QString::null;
+
+	QTextStream ts( &file );
+	return ts.read();
+}
+
+static QStringList sortedLines( const QString & text )
+{
+	QStringList lines = QStringList::split( '\n', text );
+	lines.sort();
+	return lines;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pruebas
+//////////////////////////////////////////////////////////////////////
+
+// Ambos emisores producen el mismo .vhd y el mismo .sig
+static void compare( LogicEditor & editor, const QString & entity, QString & vhd, QString & sig )
+{
+	HDLModelSnapshot snapshot;
+	check( snapshot.capture( entity, &editor ), "captura de " + entity );
+
+	QString newVhd, newSig;
+	{
+		QTextStream hdl( &newVhd, IO_WriteOnly ), sigs( &newSig, IO_WriteOnly );
+		check( snapshot.writeHDL( hdl ) && snapshot.writeSignals( sigs ), "volcado de " + entity );
+	}
+
+	BaselineEmitter baseline( editor );
+	vhd = sig = QString::null;
+	{
+		QTextOStream hdl( &vhd ), sigs( &sig );
+		check( baseline.buildHDL( entity, &hdl ) && baseline.buildSignalsFile( entity, &sigs ), "volcado original de " + entity );
+	}
+
+	check( !newVhd.isEmpty() && newVhd == vhd, entity + ": el .vhd difiere del emisor original" );
+	check( !newSig.isEmpty() && newSig == sig, entity + ": el .sig difiere del emisor original" );
+}
+
+static void testExample()
+{
+	TestEditor editor;
+	check( load( editor, "Example/Model01.lem" ), "carga de Example/Model01.lem" );
+
+	QString vhd, sig;
+	compare( editor, "Model01", vhd, sig );
+
+	// Ficheros generados por la versin original (en el orden de los items
+	// del lienzo)
+	check( sortedLines( vhd ) == sortedLines( readFile( "Example/vhdl/Model01.vhd" ) ), "Model01.vhd difiere de Example/vhdl" );
+	check( sortedLines( sig ) == sortedLines( readFile( "Example/sim/Model01.sig" ) ), "Model01.sig difiere de Example/sim" );
+}
+
+static void testGenerated( int gates )
+{
+	QString fileName = QDir::temp().filePath( QString( "bench_Puertas%1.lem" ).arg( gates ) );
+	check( writeModel( fileName, gates, 32 ), "generacin de " + fileName );
+
+	TestEditor editor;
+	check( load( editor, fileName ), "carga de " + fileName );
+
+	QString vhd, sig;
+	compare( editor, QString( "Puertas%1" ).arg( gates ), vhd, sig );
+
+	QFile::remove( fileName );
+}
+
+// Caudal de cada emisor escribiendo en un fichero
+static void benchmark( int gates )
+{
+	QString fileName = QDir::temp().filePath( QString( "bench_Puertas%1.lem" ).arg( gates ) );
+	QString outName = QDir::temp().filePath( "bench_Puertas.vhd" );
+	check( writeModel( fileName, gates, 64 ), "generacin de " + fileName );
+
+	TestEditor editor;
+	check( load( editor, fileName ), "carga de " + fileName );
+
+	const int runs = 5;
+	QString entity = "Puertas";
+	QTime t;
+
+	HDLModelSnapshot snapshot;
+	t.start();
+	check( snapshot.capture( entity, &editor ), "captura de " + fileName );
+	int msCapture = t.elapsed();
+
+	long bytes = 0;
+	t.restart();
+	for( int r=0; r < runs; r++ ){
+		QFile out( outName );
+		out.open( IO_WriteOnly | IO_Truncate );
+		QTextStream ts( &out );
+		snapshot.writeHDL( ts );
+		snapshot.writeSignals( ts );
+		out.close();
+		bytes += out.size();
+	}
+	int msNew = t.elapsed();
+
+	long bytesOld = 0;
+	t.restart();
+	for( int r=0; r < runs; r++ ){
+		BaselineEmitter baseline( editor );
+		QFile out( outName );
+		out.open( IO_WriteOnly | IO_Truncate );
+		QTextOStream ts( &out );
+		baseline.buildHDL( entity, &ts );
+		baseline.buildSignalsFile( entity, &ts );
+		out.close();
+		bytesOld += out.size();
+	}
+	int msOld = t.elapsed();
+
+	check( bytes == bytesOld, QString( "%1 puertas: tamaos de salida distintos" ).arg( gates ) );
+
+	double mb = bytes / ( 1024.0 * 1024.0 );
+	qDebug( "%d puertas (%.1f MB por volcado, captura %d ms):", gates, mb / runs, msCapture );
+	qDebug( "  HDLModelSnapshot: %7.1f MB/s", msNew > 0 ? 1000.0 * mb / msNew : 0.0 );
+	qDebug( "  emisor original:  %7.1f MB/s", msOld > 0 ? 1000.0 * mb / msOld : 0.0 );
+
+	QFile::remove( fileName );
+	QFile::remove( outName );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	testExample();
+	testGenerated( 50 );
+	testGenerated( 2000 );
+
+	benchmark( 2000 );
+	benchmark( 20000 );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_LESpatialIndex.cpp: medida y pruebas del ndice espacial.
+//
+//	Crea un lienzo de 10000 items (dispositivos, etiquetas, cables y
+//	puntos de conexin) en un LogicEditor y recorre una traza de ratn
+//	midiendo la latencia de cada evento de movimiento y la de
+//	LogicEditor::itemsAt() frente a QCanvas::collisions(). Durante la
+//	traza se mueven y redimensionan items y se comprueba que itemsAt()
+//	devuelve los mismos items, en el mismo orden, que QCanvas::collisions().
+//	Se enlaza con LogicEditor, los items LE* y sus dependencias. Devuelve
+//	0 si todas las comprobaciones pasan.
+//
+//	Uso: bench_LESpatialIndex [items [eventos]]   (por omisin 10000 20000)
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qapplication.h>
+#include <qcanvas.h>
+#include <qdatetime.h>
+#include <qvaluevector.h>
+
+#include "LogicEditor.h"
+#include "LEConnectionPoint.h"
+#include "LELabel.h"
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador determinista (el lienzo y la traza se repiten en cada ejecucin)
+static Q_UINT32 seed = 12345;
+static Q_UINT32 rnd( Q_UINT32 n )
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 8 ) % n;
+}
+
+// Acceso a la consulta y a los eventos protegidos del editor
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" ) {}
+
+	QCanvasItemList query( const QPoint & p ) { return itemsAt( p ); }
+
+	void mouseMove( const QPoint & p )
+	{
+		QMouseEvent event( QEvent::MouseMove, p, NoButton, NoButton );
+		contentsMouseMoveEvent( &event );
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Lienzo
+//////////////////////////////////////////////////////////////////////
+
+static const int CanvasSize = 6000;
+
+// Items de tamao tpico en posiciones aleatorias. Los z se toman de un
+// conjunto pequeo para que haya empates (orden por direccin del item)
+static void populate( QCanvas * canvas, int count, QValueVector<LEItem*> & items )
+{
+	for( int i=0; i < count; i++ ){
+		int x = rnd( CanvasSize - 100 ), y = rnd( CanvasSize - 100 );
+		LEItem * item;
+
+		switch( rnd( 4 ) ){
+		case 0:{
+			LEDevice * dev = new LEDevice( canvas );
+			dev->setShape( QPointArray( QRect( 0, 0, 40, 30 ) ) );
+			dev->setSize( 20 + rnd( 60 ), 20 + rnd( 60 ) );
+			dev->move( x, y );
+			item = dev;
+			break;
+		}
+		case 1:{
+			LELabel * lab = new LELabel( canvas );
+			lab->setText( QString( "L%1" ).arg( i ) );
+			lab->move( x, y );
+			item = lab;
+			break;
+		}
+		case 2:{
+			LEWireLine * wl = new LEWireLine( canvas );
+			wl->insertVertex( x, y );
+			wl->insertVertex( x + rnd( 100 ), y );
+			wl->insertVertex( x + rnd( 100 ), y + rnd( 100 ) );
+			item = wl;
+			break;
+		}
+		default:{
+			LEConnectionPoint * cp = new LEConnectionPoint( canvas );
+			cp->move( x, y );
+			item = cp;
+			break;
+		}
+		}
+
+		item->setZ( rnd( 3 ) );
+		item->show();
+		items.push_back( item );
+	}
+}
+
+// Mueve o redimensiona un item al azar
+static void edit( QValueVector<LEItem*> & items )
+{
+	LEItem * item = items[ rnd( items.count() ) ];
+	int dx = (int)rnd( 41 ) - 20, dy = (int)rnd( 41 ) - 20;
+
+	switch( item->rtti() ){
+	case LEDevice::RTTI:
+		if( rnd( 2 ) )
+			item->setSize( 20 + rnd( 60 ), 20 + rnd( 60 ) );
+		else
+			item->moveBy( dx, dy );
+		break;
+	case LEWireLine::RTTI:{
+		LEWireLine * wl = (LEWireLine*)item;
+		if( rnd( 2 ) ){
+			QPoint v = wl->vertex( rnd( wl->vertexCount() ) );
+			wl->moveVertex( rnd( wl->vertexCount() ), v.x() + dx, v.y() + dy );
+		}else
+			wl->moveBy( dx, dy );
+		break;
+	}
+	default:
+		item->moveBy( dx, dy );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pruebas y medida
+//////////////////////////////////////////////////////////////////////
+
+static bool sameItems( const QCanvasItemList & a, const QCanvasItemList & b )
+{
+	if( a.count() != b.count() )
+		return false;
+
+	QCanvasItemList::const_iterator ia = a.begin(), ib = b.begin();
+	for( ; ia != a.end(); ++ia, ++ib )
+		if( *ia != *ib )
+			return false;
+
+	return true;
+}
+
+// Traza de ratn: paseo aleatorio por el lienzo, con saltos ocasionales
+static QValueVector<QPoint> trace( int count )
+{
+	QValueVector<QPoint> points;
+	QPoint p( CanvasSize / 2, CanvasSize / 2 );
+
+	for( int i=0; i < count; i++ ){
+		if( rnd( 200 ) == 0 )
+			p = QPoint( rnd( CanvasSize ), rnd( CanvasSize ) );
+		else
+			p += QPoint( (int)rnd( 11 ) - 5, (int)rnd( 11 ) - 5 );
+
+		p.setX( QMAX( 0, QMIN( CanvasSize - 1, p.x() ) ) );
+		p.setY( QMAX( 0, QMIN( CanvasSize - 1, p.y() ) ) );
+		points.push_back( p );
+	}
+
+	return points;
+}
+
+int main( int argc, char ** argv )
+{
+	QApplication app( argc, argv );
+
+	int itemCount = argc > 1 ? QString( argv[1] ).toInt() : 10000;
+	int eventCount = argc > 2 ? QString( argv[2] ).toInt() : 20000;
+
+	TestEditor editor;
+	QCanvas * canvas = new QCanvas( &editor, "Canvas" );
+	canvas->resize( CanvasSize, CanvasSize );
+	editor.setCanvas( canvas );
+
+	QValueVector<LEItem*> items;
+	populate( canvas, itemCount, items );
+
+	QValueVector<QPoint> points = trace( eventCount );
+	QTime t;
+
+	// Coincidencia con QCanvas::collisions() en puntos de la traza, con
+	// ediciones intercaladas (el ndice se actualiza en la consulta)
+	int mismatches = 0, hits = 0;
+	for( uint i=0; i < points.count(); i++ ){
+		if( i % 10 == 0 )
+			edit( items );
+
+		QCanvasItemList expected = canvas->collisions( points[i] );
+		if( !expected.isEmpty() )
+			hits++;
+		if( !sameItems( editor.query( points[i] ), expected ) )
+			mismatches++;
+	}
+	check( hits > 0, "la traza no pasa por ningn item" );
+	check( mismatches == 0, QString( "itemsAt difiere de QCanvas::collisions en %1 puntos" ).arg( mismatches ) );
+
+	// Consulta aislada: ndice frente a QCanvas::collisions()
+	t.start();
+	for( uint i=0; i < points.count(); i++ )
+		editor.query( points[i] );
+	int indexMs = t.elapsed();
+
+	t.start();
+	for( uint i=0; i < points.count(); i++ )
+		canvas->collisions( points[i] );
+	int canvasMs = t.elapsed();
+
+	// Latencia de los eventos de movimiento del ratn (mouseOver/mouseOut
+	// incluidos), con ediciones intercaladas como durante un arrastre
+	int worst = 0;
+	QTime total;
+	total.start();
+	for( uint i=0; i < points.count(); i++ ){
+		if( i % 10 == 0 )
+			edit( items );
+
+		t.start();
+		editor.mouseMove( points[i] );
+		worst = QMAX( worst, t.elapsed() );
+	}
+	int traceMs = total.elapsed();
+
+	qDebug( "%d items, %d eventos", itemCount, eventCount );
+	qDebug( "  itemsAt:                %8.2f us/consulta", 1000.0 * indexMs / eventCount );
+	qDebug( "  QCanvas::collisions:    %8.2f us/consulta", 1000.0 * canvasMs / eventCount );
+	qDebug( "  evento de movimiento:   %8.2f us de media, %d ms el peor", 1000.0 * traceMs / eventCount, worst );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,356 @@
+//  Interface Editor: a basic circuit editor
+//  Copyright (C) 2004  David Yuste Romero (david.yuste@gmail.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// bench_HDLTruthTable.cpp: medida y pruebas de HDLTruthTable.
+//
+//	Evala la tabla de verdad de dos modelos y la compara con la
+//	simulacin por eventos de HDLGateSimulator y con la funcin esperada:
+//
+//	  - libsrc/miXOR.lem, ledo sin editor (HDLModelReader) contra las
+//	    libreras con las que se dibuj, declaradas en memoria (como en
+//	    tests/gatesim).
+//	  - Decodificadores de direccin de 20 y 24 entradas generados con los
+//	    mdulos ID*: dos funciones de seleccin (INV, NAND2/4/8 y OR2) que
+//	    comparan la parte alta y la baja de la direccin, unidas con un
+//	    OR2 que habilita un decodificador MUX2. Una sola funcin no pasa
+//	    de 14 bits: la NAND16 de lib/seleccion.clb est mal declarada.
+//
+//	Informa de los vectores por segundo de cada tabla. La evaluacin se
+//	hace en el hilo que la invoca, as que la medida es por ncleo.
+//	Se enlaza con Application, LogicEditor, los items LE*, las libreras
+//	LM*, los mdulos ID*, HDLModelReader, HDLModelGraph, HDLModelSnapshot,
+//	HDLGateSimulator y HDLTruthTable. Se ejecuta desde la raz del
+//	proyecto (usa libsrc/miXOR.lem y las libreras de lib). Devuelve 0 si
+//	todas las pruebas pasan.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <qdir.h>
+#include <qdatetime.h>
+#include <qstringlist.h>
+
+#include "Application.h"
+#include "LogicEditor.h"
+#include "LEDevice.h"
+#include "LEPin.h"
+#include "LibraryManager.h"
+#include "LMComponent.h"
+#include "HDLModelReader.h"
+#include "HDLModelGraph.h"
+#include "HDLModelSnapshot.h"
+#include "HDLGateSimulator.h"
+#include "HDLTruthTable.h"
+#include "IDInterfaceSelectorFunction.h"
+#include "IDPortSelectorMux.h"
+
+Application * app;
+
+static int failures = 0;
+
+static void check( bool condition, const QString & what )
+{
+	if( !condition ){
+		qWarning( "FALLO: %s", what.latin1() );
+		failures++;
+	}
+}
+
+// Generador pseudoaleatorio determinista
+static unsigned int seed = 12345;
+static unsigned int rnd()
+{
+	seed = seed * 1103515245 + 12345;
+	return ( seed >> 16 ) & 0x7fff;
+}
+
+static char bit( unsigned int value, int i )
+{
+	return ( value >> i ) & 1 ? '1' : '0';
+}
+
+// Vectores por segundo repitiendo la evaluacin durante al menos 200 ms
+static void benchmark( const QString & what, HDLTruthTable & table )
+{
+	int runs = 0, ms;
+	QTime t;
+	t.start();
+	do{
+		table.evaluate();
+		runs++;
+	}while( ( ms = t.elapsed() ) < 200 );
+
+	double vectors = (double)table.vectorCount() * runs;
+	qDebug( "%s: %d entradas, %d niveles, %.0f vectores en %d ms (%.3g vectores/s por ncleo)",
+			what.latin1(), table.inputNames().count(), table.depth(), vectors, ms,
+			1000.0 * vectors / ( ms > 0 ? ms : 1 ) );
+}
+
+// Compara el vector v de la tabla con la simulacin por eventos
+static bool sameAsSimulator( const HDLTruthTable & table, HDLGateSimulator & sim, uint v )
+{
+	SignalValues inputs, outputs;
+	uint i;
+	for( i=0; i < table.inputNames().count(); i++ )
+		inputs.insert( table.inputNames()[i], bit( v, i ) );
+	for( i=0; i < table.outputNames().count(); i++ )
+		outputs.insert( table.outputNames()[i], 'U' );
+
+	if( !sim.simulate( inputs, outputs ) )
+		return false;
+
+	for( i=0; i < table.outputNames().count(); i++ )
+		if( outputs[ table.outputNames()[i] ] != ( table.value( i, v ) ? '1' : '0' ) )
+			return false;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// miXOR
+//////////////////////////////////////////////////////////////////////
+
+static void addComponent( LibraryManager & libs, LMLibrary * lib, const QString & name,
+						  const QStringList & inputs, const QString & output )
+{
+	LMComponent cmp( lib );
+	cmp.setName( name );
+	cmp.shapeList().append( QPointArray( QRect( 0, 0, 60, 40 ) ) );
+
+	QStringList::const_iterator it;
+	for( it = inputs.begin(); it != inputs.end(); ++it )
+		cmp.pinList().append( LMPinDescription( *it, LEPin::Input, LEPin::Left ) );
+	if( !output.isNull() )
+		cmp.pinList().append( LMPinDescription( output, LEPin::Output, LEPin::Right ) );
+
+	libs.insertComponent( lib, cmp );
+}
+
+static void testXOR()
+{
+	// Libreras con las que se dibuj el modelo
+	LibraryManager libs;
+	LMLibrary * io = libs.createLibrary( "I/O", LMLibrary::None, QString::null );
+	addComponent( libs, io, "Input", QStringList( "i" ), QString::null );
+	addComponent( libs, io, "Output", QStringList( "o" ), QString::null );
+
+	LMLibrary * estandar = libs.createLibrary( "Estandar", LMLibrary::HDL, "estandar" );
+	addComponent( libs, estandar, "And2", QStringList::split( ' ', "A B" ), "C" );
+	addComponent( libs, estandar, "Or2", QStringList::split( ' ', "A B" ), "C" );
+	addComponent( libs, estandar, "Inv", QStringList( "I" ), "O" );
+
+	HDLModelGraph graph;
+	HDLModelReader reader( libs, graph );
+	check( reader.readFile( "libsrc/miXOR.lem" ), "lectura de libsrc/miXOR.lem" );
+
+	HDLModelSnapshot snapshot;
+	check( snapshot.capture( "miXOR", graph ), "captura de miXOR" );
+
+	HDLTruthTable table;
+	HDLGateSimulator sim;
+	if( !table.load( snapshot ) || !sim.load( snapshot ) ){
+		check( false, "carga de miXOR: " + table.errorString() + sim.errorString() );
+		return;
+	}
+
+	check( table.evaluate() && table.vectorCount() == 4, "evaluacin de miXOR" );
+
+	int a = table.inputNames().findIndex( "A_i" ), b = table.inputNames().findIndex( "B_i" );
+	int c = table.outputNames().findIndex( "C_o" );
+	check( a != -1 && b != -1 && c != -1, "puertos de miXOR" );
+
+	for( uint v=0; v < table.vectorCount(); v++ ){
+		check( table.value( c, v ) == ( ( ( v >> a ) ^ ( v >> b ) ) & 1 ), QString( "miXOR: vector %1" ).arg( v ) );
+		check( sameAsSimulator( table, sim, v ), QString( "miXOR: vector %1 distinto del simulador" ).arg( v ) );
+	}
+
+	benchmark( "miXOR", table );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Decodificador de direccin
+//////////////////////////////////////////////////////////////////////
+
+// Editor con su propio lienzo (como Document)
+class TestEditor : public LogicEditor
+{
+public:
+	TestEditor() : LogicEditor( 0, "TestEditor" )
+	{
+		QCanvas * canvas = new QCanvas( this, "Canvas" );
+		canvas->resize( 10000, 10000 );
+		setCanvas( canvas );
+	}
+};
+
+static LEConnectionPoint * pin( LogicEditor & editor, LEDevice * dev, const QString & pinName )
+{
+	return dev ? editor.resolveConnection( QString( "%1%2%3" ).arg( dev->name() ).arg( ITEM_NAME_SEPARATOR ).arg( pinName ) ) : 0;
+}
+
+static bool connect( LogicEditor & editor, LEConnectionPoint * cp1, LEConnectionPoint * cp2 )
+{
+	return cp1 && cp2 && editor.createWireLine( cp1, cp2 );
+}
+
+// Seleccin de la direccin pattern (length bits, ADDRi es el bit
+// length-1-i) que habilita un decodificador MUX2 (entradas PORTi, salidas
+// Si). Los lengthHi bits altos y los restantes se comparan con sendas
+// funciones de seleccin, activas a nivel bajo, unidas con un OR2
+static bool buildDecoder( LogicEditor & editor, unsigned int pattern, unsigned int length, unsigned int lengthHi )
+{
+	LibraryManager & libs = app->libraryManager();
+	LMComponent * input = libs.findComponent( "I/O:Input" );
+	LMComponent * output = libs.findComponent( "I/O:Output" );
+	LMComponent * or2 = libs.findComponent( "Seleccion:OR2" );
+	if( !input || !output || !or2 )
+		return false;
+
+	// Las funciones de seleccin comparan el patrn desde su bit 31
+	unsigned int lengthLo = length - lengthHi;
+	IDInterfaceSelectorFunction selHi( ( pattern >> lengthLo ) << ( 32 - lengthHi ), lengthHi );
+	IDInterfaceSelectorFunction selLo( pattern << ( 32 - lengthLo ), lengthLo );
+	IDPortSelectorMux mux( 2 );
+	if( !selHi.create( &editor, 200, 40 ) || !selLo.create( &editor, 200, 40 + 45*lengthHi ) ||
+		!mux.create( &editor, 800, 40 ) )
+		return false;
+
+	bool ok = true;
+	unsigned int i;
+
+	editor.beginBatch();
+	for( i=0; i < length; i++ ){
+		LEDevice * dev = editor.placeDevice( input, QString( "ADDR%1" ).arg( i ), QPoint( 20, 40 + 45*i ) );
+		ok = ok && connect( editor, pin( editor, dev, "I" ), i < lengthHi ? selHi.in( i ) : selLo.in( i - lengthHi ) );
+	}
+
+	LEDevice * sel = editor.placeDevice( or2, "SELDIR", QPoint( 600, 40 ) );
+	ok = ok && connect( editor, selHi.out(), pin( editor, sel, "I0" ) );
+	ok = ok && connect( editor, selLo.out(), pin( editor, sel, "I1" ) );
+	ok = ok && connect( editor, pin( editor, sel, "O" ), mux.enable() );
+
+	for( i=0; i < mux.inCount(); i++ ){
+		LEDevice * dev = editor.placeDevice( input, QString( "PORT%1" ).arg( i ), QPoint( 700, 1200 + 45*i ) );
+		ok = ok && connect( editor, pin( editor, dev, "I" ), mux.in( i ) );
+	}
+	for( i=0; i < mux.outCount(); i++ ){
+		LEDevice * dev = editor.placeDevice( output, QString( "S%1" ).arg( i ), QPoint( 1000, 40 + 45*i ) );
+		ok = ok && connect( editor, mux.out( i ), pin( editor, dev, "O" ) );
+	}
+	editor.endBatch();
+
+	return ok;
+}
+
+static void testDecoder( unsigned int pattern, unsigned int length, unsigned int lengthHi )
+{
+	QString what = QString( "decodificador de %1 entradas" ).arg( length + 2 );
+
+	TestEditor editor;
+	if( !buildDecoder( editor, pattern, length, lengthHi ) ){
+		check( false, "generacin del " + what );
+		return;
+	}
+
+	HDLModelSnapshot snapshot;
+	check( snapshot.capture( "decodificador", &editor ), "captura del " + what );
+
+	HDLTruthTable table;
+	HDLGateSimulator sim;
+	if( !table.load( snapshot ) || !sim.load( snapshot ) ){
+		check( false, "carga del " + what + ": " + table.errorString() + sim.errorString() );
+		return;
+	}
+
+	check( table.evaluate() && table.vectorCount() == ( 1u << ( length + 2 ) ), "evaluacin del " + what );
+
+	// Posicin de cada entrada en el ndice del vector
+	QValueVector<int> addr( length ), port( 2 ), s( 4 );
+	unsigned int i;
+	bool found = true;
+	for( i=0; i < length; i++ )
+		found = found && ( addr[i] = table.inputNames().findIndex( QString( "ADDR%1_I" ).arg( i ) ) ) != -1;
+	for( i=0; i < 2; i++ )
+		found = found && ( port[i] = table.inputNames().findIndex( QString( "PORT%1_I" ).arg( i ) ) ) != -1;
+	for( i=0; i < 4; i++ )
+		found = found && ( s[i] = table.outputNames().findIndex( QString( "S%1_O" ).arg( i ) ) ) != -1;
+	if( !found ){
+		check( false, what + ": puertos" );
+		return;
+	}
+
+	// Todos los vectores contra la funcin esperada: Si a 1 slo con la
+	// direccin del patrn y el puerto i
+	int errors = 0;
+	for( uint v=0; v < table.vectorCount(); v++ ){
+		unsigned int a = 0, p = 0;
+		for( i=0; i < length; i++ )
+			a |= ( ( v >> addr[i] ) & 1 ) << ( length - 1 - i );
+		for( i=0; i < 2; i++ )
+			p |= ( ( v >> port[i] ) & 1 ) << i;
+
+		for( i=0; i < 4; i++ )
+			if( table.value( s[i], v ) != ( a == pattern && p == i ) && errors++ < 10 )
+				check( false, what + QString( ": S%1 con direccin %2 y puerto %3" ).arg( i ).arg( a ).arg( p ) );
+	}
+	check( errors == 0, what + QString( ": %1 salidas errneas" ).arg( errors ) );
+
+	// Una muestra de vectores contra el simulador: los de la direccin del
+	// patrn (todos los puertos) y vectores aleatorios
+	uint selected = 0;
+	for( i=0; i < length; i++ )
+		selected |= ( ( pattern >> ( length - 1 - i ) ) & 1 ) << addr[i];
+
+	errors = 0;
+	for( uint n=0; n < 2004; n++ ){
+		uint v;
+		if( n < 4 )
+			v = selected | ( ( n & 1 ) << port[0] ) | ( ( n >> 1 ) << port[1] );
+		else
+			v = ( ( rnd() << 15 ) | rnd() ) & ( table.vectorCount() - 1 );
+
+		if( !sameAsSimulator( table, sim, v ) && errors++ < 10 )
+			check( false, what + QString( ": vector %1 distinto del simulador" ).arg( v ) );
+	}
+	check( errors == 0, what + QString( ": %1 vectores distintos del simulador" ).arg( errors ) );
+
+	benchmark( what, table );
+}
+
+int main( int argc, char ** argv )
+{
+	Application a( argc, argv );
+	app = &a;
+
+	QDir libDir( "lib" );
+	QStringList libs = libDir.entryList( "*.clb" );
+	for( QStringList::iterator it = libs.begin(); it != libs.end(); ++it )
+		a.libraryManager().loadLibrary( libDir.filePath( *it ) );
+
+	testXOR();
+
+	// Funciones de 12 y 6 bits (NAND8 + NAND4 -> OR2 y NAND4 + NAND2 -> OR2)
+	// y de 12 y 10 bits (... y NAND8 + NAND2 -> OR2). Cada funcin necesita
+	// longitud par y al menos dos NAND (no hay OR1, ver
+	// IDInterfaceSelectorFunction)
+	testDecoder( 0x2b5c9, 18, 12 );
+	testDecoder( 0x2d6b3a, 22, 12 );
+
+	if( failures )
+		qWarning( "%d pruebas fallidas", failures );
+
+	return failures ? 1 : 0;
+}